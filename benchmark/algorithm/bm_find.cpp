@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/algorithm/find.h"
+#include "qs/config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // `n` elements, none equal to the searched value but the last one: every search scans the whole span.
+    template<class T>
+    static std::vector<T> haystack(std::size_t n)
+    {
+        std::vector<T> v(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] = static_cast<T>(i % 97 + 1);
+        v.back() = T(0);
+        return v;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    }
+
+    static bool set_level(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() == static_cast<simd_level>(state.range(1)))
+            return true;
+        state.SkipWithError("instruction set not supported by this CPU");
+        return false;
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n: {1 << 8, 1 << 12, 1 << 20})
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"});
+    }
+
+    static void std_args(benchmark::internal::Benchmark* b)
+    {
+        for(int n: {1 << 8, 1 << 12, 1 << 20})
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    template<class T>
+    static void BM_Find_std(benchmark::State& state)
+    {
+        auto const v = haystack<T>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::find(v.begin(), v.end(), T(0)));
+        set_counters(state, v.size() * sizeof(T));
+    }
+    BENCHMARK(BM_Find_std<std::int32_t>)->Apply(std_args);
+    BENCHMARK(BM_Find_std<float>)->Apply(std_args);
+    BENCHMARK(BM_Find_std<char>)->Apply(std_args);
+
+    template<class T>
+    static void BM_Find(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const v = haystack<T>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+            benchmark::DoNotOptimize(find(make_span(v), T(0)));
+        set_counters(state, v.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_Find<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_Find<float>)->Apply(args);
+    BENCHMARK(BM_Find<char>)->Apply(args);
+
+    // The byte search libc already vectorizes.
+    static void BM_Find_memchr(benchmark::State& state)
+    {
+        auto const v = haystack<char>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::memchr(v.data(), 0, v.size()));
+        set_counters(state, v.size());
+    }
+    BENCHMARK(BM_Find_memchr)->Apply(std_args);
+
+    template<class T>
+    static void BM_Count_std(benchmark::State& state)
+    {
+        auto const v = haystack<T>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::count(v.begin(), v.end(), T(5)));
+        set_counters(state, v.size() * sizeof(T));
+    }
+    BENCHMARK(BM_Count_std<std::int32_t>)->Apply(std_args);
+    BENCHMARK(BM_Count_std<char>)->Apply(std_args);
+
+    template<class T>
+    static void BM_Count(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const v = haystack<T>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+            benchmark::DoNotOptimize(count(make_span(v), T(5)));
+        set_counters(state, v.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_Count<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_Count<char>)->Apply(args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/algorithm/lower_bound.h"
+#include "qs/config.h"
+#include "qs/containers/static_search_tree.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Sorted even keys, so that half of the random queries fall between two of them.
+    static std::vector<std::int32_t> sorted_keys(std::size_t n)
+    {
+        std::vector<std::int32_t> v(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] = static_cast<std::int32_t>(2 * i);
+        return v;
+    }
+
+    // Enough random queries that their order is not learned, a power of two to wrap around with a mask.
+    static constexpr std::size_t query_count = 1 << 16;
+
+    static std::vector<std::int32_t> queries(std::size_t n)
+    {
+        std::mt19937_64           gen(42);
+        std::vector<std::int32_t> q(query_count);
+        for(auto& x: q)
+            x = static_cast<std::int32_t>(gen() % (2 * n));
+        return q;
+    }
+
+    // 4 KB (L1) to 128 MB (DRAM) of keys.
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int n = 1 << 10; n <= 1 << 25; n <<= 3)
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    static void tree_args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n = 1 << 10; n <= 1 << 25; n <<= 3)
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"});
+    }
+
+    static void set_counters(benchmark::State& state)
+    {
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+
+    static void BM_LowerBound_std(benchmark::State& state)
+    {
+        auto const  v = sorted_keys(static_cast<std::size_t>(state.range(0)));
+        auto const  q = queries(v.size());
+        std::size_t i = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::lower_bound(v.begin(), v.end(), q[i++ & (query_count - 1)]));
+        set_counters(state);
+    }
+    BENCHMARK(BM_LowerBound_std)->Apply(args);
+
+    static void BM_LowerBound(benchmark::State& state)
+    {
+        auto const  v = sorted_keys(static_cast<std::size_t>(state.range(0)));
+        auto const  q = queries(v.size());
+        std::size_t i = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(lower_bound(make_span(v), q[i++ & (query_count - 1)]));
+        set_counters(state);
+    }
+    BENCHMARK(BM_LowerBound)->Apply(args);
+
+    static void BM_StaticSearchTree(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(1)))
+        {
+            state.SkipWithError("instruction set not supported by this CPU");
+            return;
+        }
+        auto const                             v = sorted_keys(static_cast<std::size_t>(state.range(0)));
+        auto const                             q = queries(v.size());
+        static_search_tree<std::int32_t> const tree(make_span(v));
+        std::size_t                            i = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(tree.lower_bound(q[i++ & (query_count - 1)]));
+        set_counters(state);
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_StaticSearchTree)->Apply(tree_args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/algorithm/radix_sort.h"
+#include "qs/config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if __has_include(<boost/sort/pdqsort/pdqsort.hpp>)
+#include <boost/sort/pdqsort/pdqsort.hpp>
+#define QS_BENCHMARK_PDQSORT 1
+#endif
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    template<class T>
+    static std::vector<T> random_keys(std::size_t n)
+    {
+        std::mt19937_64 gen(42);
+        std::vector<T>  v(n);
+        for(auto& x: v)
+            x = static_cast<T>(static_cast<std::int64_t>(gen()));
+        return v;
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int n: {1 << 10, 1 << 16, 1 << 20, 10000000})
+            b->Args({n});
+        b->ArgNames({"n"})->Unit(benchmark::kMicrosecond);
+    }
+
+    // Every iteration sorts a fresh copy of the same keys, the copy untimed.
+    template<class T, class Sort>
+    static void run(benchmark::State& state, Sort sort)
+    {
+        auto const     original = random_keys<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<T> keys(original.size());
+        for(auto _: state)
+        {
+            state.PauseTiming();
+            keys = original;
+            state.ResumeTiming();
+            sort(keys);
+            benchmark::DoNotOptimize(keys.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * keys.size()));
+    }
+
+    template<class T>
+    static void BM_Sort_std(benchmark::State& state)
+    {
+        run<T>(state, [](std::vector<T>& keys) { std::sort(keys.begin(), keys.end()); });
+    }
+    BENCHMARK(BM_Sort_std<std::uint32_t>)->Apply(args);
+    BENCHMARK(BM_Sort_std<std::uint64_t>)->Apply(args);
+    BENCHMARK(BM_Sort_std<float>)->Apply(args);
+
+#if QS_BENCHMARK_PDQSORT
+    template<class T>
+    static void BM_Sort_pdqsort(benchmark::State& state)
+    {
+        run<T>(state, [](std::vector<T>& keys) { boost::sort::pdqsort_branchless(keys.begin(), keys.end()); });
+    }
+    BENCHMARK(BM_Sort_pdqsort<std::uint32_t>)->Apply(args);
+    BENCHMARK(BM_Sort_pdqsort<std::uint64_t>)->Apply(args);
+    BENCHMARK(BM_Sort_pdqsort<float>)->Apply(args);
+#endif
+
+    // With a scratch buffer reused across sorts, as for batches of updates.
+    template<class T>
+    static void BM_RadixSort(benchmark::State& state)
+    {
+        std::vector<T> scratch(static_cast<std::size_t>(state.range(0)));
+        run<T>(state, [&scratch](std::vector<T>& keys) { radix_sort(make_span(keys), make_span(scratch)); });
+    }
+    BENCHMARK(BM_RadixSort<std::uint32_t>)->Apply(args);
+    BENCHMARK(BM_RadixSort<std::uint64_t>)->Apply(args);
+    BENCHMARK(BM_RadixSort<float>)->Apply(args);
+
+    // Indices below 2^24, the top digit shared by all keys.
+    static void BM_RadixSort_indices(benchmark::State& state)
+    {
+        auto const                 n = static_cast<std::size_t>(state.range(0));
+        std::vector<std::uint32_t> scratch(n);
+        auto                       original = random_keys<std::uint32_t>(n);
+        for(auto& x: original)
+            x &= 0xFFFFFF;
+        std::vector<std::uint32_t> keys(n);
+        for(auto _: state)
+        {
+            state.PauseTiming();
+            keys = original;
+            state.ResumeTiming();
+            radix_sort(make_span(keys), make_span(scratch));
+            benchmark::DoNotOptimize(keys.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+    BENCHMARK(BM_RadixSort_indices)->Apply(args);
+
+    // Key and payload pairs: an array of pairs for the comparison sorts, two arrays for the radix sort.
+    static void BM_SortPairs_std(benchmark::State& state)
+    {
+        auto const keys = random_keys<std::uint32_t>(static_cast<std::size_t>(state.range(0)));
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> original(keys.size()), pairs(keys.size());
+        for(std::size_t i = 0; i < keys.size(); ++i)
+            original[i] = {keys[i], static_cast<std::uint32_t>(i)};
+        for(auto _: state)
+        {
+            state.PauseTiming();
+            pairs = original;
+            state.ResumeTiming();
+            std::sort(pairs.begin(), pairs.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+            benchmark::DoNotOptimize(pairs.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * pairs.size()));
+    }
+    BENCHMARK(BM_SortPairs_std)->Apply(args);
+
+    static void BM_RadixSortByKey(benchmark::State& state)
+    {
+        auto const                 n    = static_cast<std::size_t>(state.range(0));
+        auto const                 keys = random_keys<std::uint32_t>(n);
+        std::vector<std::uint32_t> k(n), v(n), k_scratch(n), v_scratch(n);
+        for(auto _: state)
+        {
+            state.PauseTiming();
+            k = keys;
+            for(std::size_t i = 0; i < n; ++i)
+                v[i] = static_cast<std::uint32_t>(i);
+            state.ResumeTiming();
+            radix_sort_by_key(make_span(k), make_span(v), make_span(k_scratch), make_span(v_scratch));
+            benchmark::DoNotOptimize(k.data());
+            benchmark::DoNotOptimize(v.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+    BENCHMARK(BM_RadixSortByKey)->Apply(args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/algorithm/reduce.h"
+#include "qs/config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    template<class T>
+    static std::vector<T> random_values(std::size_t n, std::uint32_t seed)
+    {
+        std::mt19937   gen(seed);
+        std::vector<T> v(n);
+        for(auto& x: v)
+            x = static_cast<T>(static_cast<int>(gen() % 2001) - 1000);
+        return v;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    }
+
+    static bool set_level(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() == static_cast<simd_level>(state.range(1)))
+            return true;
+        state.SkipWithError("instruction set not supported by this CPU");
+        return false;
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n: {1 << 12, 1 << 20})
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"});
+    }
+
+    static void std_args(benchmark::internal::Benchmark* b)
+    {
+        for(int n: {1 << 12, 1 << 20})
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    // std::minmax_element and std::min_element: the index-tracking loops libstdc++ does not vectorize.
+
+    template<class T>
+    static void BM_MinMax_std(benchmark::State& state)
+    {
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::minmax_element(v.begin(), v.end()));
+        set_counters(state, v.size() * sizeof(T));
+    }
+    BENCHMARK(BM_MinMax_std<std::int32_t>)->Apply(std_args);
+    BENCHMARK(BM_MinMax_std<float>)->Apply(std_args);
+
+    template<class T>
+    static void BM_MinMax(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(minmax_value(make_span(v)));
+        set_counters(state, v.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_MinMax<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_MinMax<float>)->Apply(args);
+
+    template<class T>
+    static void BM_ArgMin_std(benchmark::State& state)
+    {
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::min_element(v.begin(), v.end()));
+        set_counters(state, v.size() * sizeof(T));
+    }
+    BENCHMARK(BM_ArgMin_std<float>)->Apply(std_args);
+
+    template<class T>
+    static void BM_ArgMin(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(argmin(make_span(v)));
+        set_counters(state, v.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_ArgMin<float>)->Apply(args);
+
+    // std::accumulate: a serial chain of additions, 32-bit integers widened one at a time.
+
+    template<class T, class Acc>
+    static void BM_Sum_std(benchmark::State& state)
+    {
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), Acc(0)));
+        set_counters(state, v.size() * sizeof(T));
+    }
+    BENCHMARK(BM_Sum_std<std::int32_t, std::int64_t>)->Apply(std_args);
+    BENCHMARK(BM_Sum_std<std::uint8_t, std::uint64_t>)->Apply(std_args);
+    BENCHMARK(BM_Sum_std<float, float>)->Apply(std_args);
+
+    template<class T>
+    static void BM_Sum(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const v = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        for(auto _: state)
+            benchmark::DoNotOptimize(sum(make_span(v)));
+        set_counters(state, v.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_Sum<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_Sum<std::uint8_t>)->Apply(args);
+    BENCHMARK(BM_Sum<float>)->Apply(args);
+
+    template<class T, class Acc>
+    static void BM_Dot_std(benchmark::State& state)
+    {
+        auto const a = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        auto const b = random_values<T>(a.size(), 2);
+        for(auto _: state)
+            benchmark::DoNotOptimize(std::inner_product(a.begin(), a.end(), b.begin(), Acc(0)));
+        set_counters(state, 2 * a.size() * sizeof(T));
+    }
+    BENCHMARK(BM_Dot_std<std::int32_t, std::int64_t>)->Apply(std_args);
+    BENCHMARK(BM_Dot_std<float, float>)->Apply(std_args);
+
+    template<class T>
+    static void BM_Dot(benchmark::State& state)
+    {
+        if(!set_level(state))
+            return;
+        auto const a = random_values<T>(static_cast<std::size_t>(state.range(0)), 1);
+        auto const b = random_values<T>(a.size(), 2);
+        for(auto _: state)
+            benchmark::DoNotOptimize(dot(make_span(a), make_span(b)));
+        set_counters(state, 2 * a.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_Dot<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_Dot<float>)->Apply(args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/algorithm/scan.h"
+#include "qs/config.h"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__cpp_lib_execution)
+#include <execution>
+#endif
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    template<class T>
+    static std::vector<T> values(std::size_t n)
+    {
+        std::vector<T> v(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] = static_cast<T>(i % 13);
+        return v;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n: {1 << 10, 1 << 16, 1 << 22})
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"});
+    }
+
+    static void std_args(benchmark::internal::Benchmark* b)
+    {
+        for(int n: {1 << 10, 1 << 16, 1 << 22})
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    template<class T>
+    static void BM_PrefixSum_std(benchmark::State& state)
+    {
+        auto const     in = values<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<T> out(in.size());
+        for(auto _: state)
+        {
+            std::partial_sum(in.begin(), in.end(), out.begin());
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, in.size() * sizeof(T));
+    }
+    BENCHMARK(BM_PrefixSum_std<std::int32_t>)->Apply(std_args);
+    BENCHMARK(BM_PrefixSum_std<float>)->Apply(std_args);
+
+    template<class T>
+    static void BM_PrefixSum(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(1)))
+            return state.SkipWithError("instruction set not supported by this CPU");
+
+        auto const     in = values<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<T> out(in.size());
+        for(auto _: state)
+        {
+            inclusive_scan<T>(make_span(in), make_span(out));
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, in.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_PrefixSum<std::int32_t>)->Apply(args);
+    BENCHMARK(BM_PrefixSum<float>)->Apply(args);
+
+    template<class T>
+    static void BM_ExclusivePrefixSum(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(1)))
+            return state.SkipWithError("instruction set not supported by this CPU");
+
+        auto const     in = values<T>(static_cast<std::size_t>(state.range(0)));
+        std::vector<T> out(in.size());
+        for(auto _: state)
+        {
+            exclusive_scan<T>(make_span(in), make_span(out));
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, in.size() * sizeof(T));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_ExclusivePrefixSum<std::int32_t>)->Apply(args);
+
+    // 1K to 1G elements in place (4 GiB at the top), serial and on every hardware thread. Unsigned, since the
+    // repeated scans overflow.
+    static void large_args(benchmark::internal::Benchmark* b)
+    {
+        for(int threads: {1, 0})
+            for(std::int64_t n = 1 << 10; n <= std::int64_t(1) << 30; n <<= 4)
+                b->Args({n, threads});
+        b->ArgNames({"n", "threads"})->Unit(benchmark::kMicrosecond);
+    }
+
+#if defined(__cpp_lib_execution)
+    static void BM_PrefixSumLarge_std_par_unseq(benchmark::State& state)
+    {
+        auto v = values<std::uint32_t>(static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+        {
+            if(state.range(1) == 1)
+                std::inclusive_scan(v.begin(), v.end(), v.begin());
+            else
+                std::inclusive_scan(std::execution::par_unseq, v.begin(), v.end(), v.begin());
+            benchmark::DoNotOptimize(v.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, v.size() * sizeof(std::uint32_t));
+    }
+    BENCHMARK(BM_PrefixSumLarge_std_par_unseq)->Apply(large_args);
+#endif
+
+    static void BM_PrefixSumLarge(benchmark::State& state)
+    {
+        auto           v       = values<std::uint32_t>(static_cast<std::size_t>(state.range(0)));
+        unsigned const threads = static_cast<unsigned>(state.range(1));
+        for(auto _: state)
+        {
+            inclusive_scan(make_span(v), threads);
+            benchmark::DoNotOptimize(v.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, v.size() * sizeof(std::uint32_t));
+    }
+    BENCHMARK(BM_PrefixSumLarge)->Apply(large_args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
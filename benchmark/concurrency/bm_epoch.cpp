@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/concurrency/epoch.h"
+#include "qs/config.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static epoch_domain& bench_domain()
+    {
+        static epoch_domain domain(256);
+        return domain;
+    }
+
+    static std::atomic<int*> shared_value{nullptr};
+
+    // Cost of entering and leaving a critical section (reader side overhead)
+    static void BM_Epoch_pin(benchmark::State& state)
+    {
+        auto h = bench_domain().register_thread();
+        for(auto _: state)
+        {
+            auto guard = h.pin();
+            benchmark::DoNotOptimize(guard);
+        }
+    }
+    BENCHMARK(BM_Epoch_pin)->ThreadRange(1, 8)->UseRealTime();
+
+    // Same read path protected by a shared_mutex, for reference
+    static void BM_SharedMutex_read(benchmark::State& state)
+    {
+        static std::shared_mutex mtx;
+        int                      value = 0;
+        for(auto _: state)
+        {
+            std::shared_lock<std::shared_mutex> lock(mtx);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    BENCHMARK(BM_SharedMutex_read)->ThreadRange(1, 8)->UseRealTime();
+
+    // Reader dereferences a pointer that a single writer keeps swapping and retiring
+    static void BM_Epoch_readUnderReclamation(benchmark::State& state)
+    {
+        auto h = bench_domain().register_thread();
+        if(state.thread_index() == 0)
+        {
+            delete shared_value.exchange(new int(0));
+            for(auto _: state)
+            {
+                auto guard = h.pin();
+                int* old   = shared_value.exchange(new int(1), std::memory_order_acq_rel);
+                h.retire(old);
+            }
+        }
+        else
+        {
+            for(auto _: state)
+            {
+                auto guard = h.pin();
+                int  v     = *shared_value.load(std::memory_order_acquire);
+                benchmark::DoNotOptimize(v);
+            }
+        }
+        h.flush();
+    }
+    BENCHMARK(BM_Epoch_readUnderReclamation)->ThreadRange(2, 8)->UseRealTime();
+
+    // Retire + batched reclamation throughput, compared against an immediate delete
+    static void BM_Epoch_retire(benchmark::State& state)
+    {
+        epoch_domain domain(1, static_cast<std::size_t>(state.range(0)));
+        auto         h = domain.register_thread();
+        for(auto _: state)
+            h.retire(new int(1));
+        h.flush();
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Epoch_retire)->RangeMultiplier(4)->Range(1, 1024);
+
+    static void BM_Delete(benchmark::State& state)
+    {
+        for(auto _: state)
+        {
+            auto* p = new int(1);
+            benchmark::DoNotOptimize(p);
+            delete p;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Delete);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/concurrency/seqlock.h"
+#include "qs/config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Snapshot of a few cache lines, as published by a market data / config writer
+    struct Snapshot
+    {
+        std::uint64_t fields[24];
+    };
+
+    // Thread 0 rewrites the snapshot in a loop, the remaining threads measure read latency
+    template<class Store, class Load>
+    static void run_under_write_load(benchmark::State& state, Store store, Load load)
+    {
+        if(state.thread_index() == 0)
+        {
+            Snapshot      s{};
+            std::uint64_t n = 0;
+            for(auto _: state)
+            {
+                s.fields[0] = ++n;
+                store(s);
+            }
+        }
+        else
+        {
+            for(auto _: state)
+            {
+                Snapshot const s = load();
+                benchmark::DoNotOptimize(s);
+            }
+        }
+    }
+
+    static void BM_Seqlock_readUnderWrite(benchmark::State& state)
+    {
+        static seqlock<Snapshot> lock;
+        run_under_write_load(state, [](Snapshot const& s) { lock.store(s); }, [] { return lock.load(); });
+    }
+    BENCHMARK(BM_Seqlock_readUnderWrite)->ThreadRange(2, 16)->UseRealTime();
+
+    static void BM_SharedMutex_readUnderWrite(benchmark::State& state)
+    {
+        static std::shared_mutex mtx;
+        static Snapshot          value{};
+        run_under_write_load(
+            state,
+            [](Snapshot const& s)
+            {
+                std::unique_lock<std::shared_mutex> lock(mtx);
+                value = s;
+            },
+            []
+            {
+                std::shared_lock<std::shared_mutex> lock(mtx);
+                return value;
+            });
+    }
+    BENCHMARK(BM_SharedMutex_readUnderWrite)->ThreadRange(2, 16)->UseRealTime();
+
+    static void BM_Mutex_readUnderWrite(benchmark::State& state)
+    {
+        static std::mutex mtx;
+        static Snapshot   value{};
+        run_under_write_load(
+            state,
+            [](Snapshot const& s)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                value = s;
+            },
+            []
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                return value;
+            });
+    }
+    BENCHMARK(BM_Mutex_readUnderWrite)->ThreadRange(2, 16)->UseRealTime();
+
+    // Uncontended read, lower bound of the reader latency
+    static void BM_Seqlock_read(benchmark::State& state)
+    {
+        static seqlock<Snapshot> lock;
+        for(auto _: state)
+        {
+            Snapshot const s = lock.load();
+            benchmark::DoNotOptimize(s);
+        }
+    }
+    BENCHMARK(BM_Seqlock_read)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
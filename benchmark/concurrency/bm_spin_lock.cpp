@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/concurrency/spin_lock.h"
+#include "qs/config.h"
+
+#include <cstdint>
+#include <mutex>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Critical section of `len` dependent multiply-adds on shared state, roughly a FenwickTree update at len ~ 16
+    template<class Lockable>
+    static void BM_Lock_contention(benchmark::State& state)
+    {
+        static Lockable      m;
+        static std::uint64_t shared = 1;
+
+        auto const len = state.range(0);
+        for(auto _: state)
+        {
+            std::lock_guard<Lockable> lock(m);
+            std::uint64_t             x = shared;
+            for(int64_t i = 0; i < len; ++i)
+                x = x * 6364136223846793005ull + 1442695040888963407ull;
+            shared = x;
+        }
+        benchmark::DoNotOptimize(shared);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+#define QS_BM_LOCK_CONTENTION(Lockable)                                                                                \
+    BENCHMARK_TEMPLATE(BM_Lock_contention, Lockable)                                                                   \
+        ->ArgName("cs_len")                                                                                            \
+        ->RangeMultiplier(8)                                                                                           \
+        ->Range(1, 512)                                                                                                \
+        ->ThreadRange(1, 8)                                                                                            \
+        ->UseRealTime()
+
+    QS_BM_LOCK_CONTENTION(spin_lock);
+    QS_BM_LOCK_CONTENTION(hybrid_mutex);
+    QS_BM_LOCK_CONTENTION(std::mutex);
+
+#undef QS_BM_LOCK_CONTENTION
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
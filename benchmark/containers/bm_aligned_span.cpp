@@ -0,0 +1,181 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/aligned_span.h"
+#include "qs/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static constexpr std::size_t alignment = 64;
+
+    // `n` elements starting on a cache line, carved out of a slightly larger vector.
+    template<class T>
+    struct aligned_buffer
+    {
+        std::vector<T>             storage;
+        aligned_span<T, alignment> view;
+
+        explicit aligned_buffer(std::size_t n)
+            : storage(n + alignment / sizeof(T))
+        {
+            for(std::size_t i = 0; i < storage.size(); ++i)
+                storage[i] = static_cast<T>(i % 7);
+            view = split_aligned<alignment>(make_span(storage)).second.first(n);
+        }
+    };
+
+    static void set_counters(benchmark::State& state, std::size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    }
+
+    // Integer sums: the plain loops vectorize at -O3 only (-O2 refuses the epilogue), the blocked one at both.
+
+    static void BM_SumInt_span(benchmark::State& state)
+    {
+        aligned_buffer<std::int32_t> const buffer(static_cast<std::size_t>(state.range(0)));
+        span<std::int32_t const> const     s = buffer.view;
+        for(auto _: state)
+        {
+            std::int32_t sum = 0;
+            for(std::int32_t x: s)
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size_bytes());
+    }
+    BENCHMARK(BM_SumInt_span)->Arg(4096)->Arg(1 << 20);
+
+    static void BM_SumInt_aligned_span(benchmark::State& state)
+    {
+        aligned_buffer<std::int32_t> const                buffer(static_cast<std::size_t>(state.range(0)));
+        aligned_span<std::int32_t const, alignment> const s = buffer.view;
+        for(auto _: state)
+        {
+            std::int32_t sum = 0;
+            for(std::int32_t x: s)
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size_bytes());
+    }
+    BENCHMARK(BM_SumInt_aligned_span)->Arg(4096)->Arg(1 << 20);
+
+    static void BM_SumInt_aligned_blocks(benchmark::State& state)
+    {
+        using view_type = aligned_span<std::int32_t const, alignment>;
+        aligned_buffer<std::int32_t> const buffer(static_cast<std::size_t>(state.range(0)));
+        view_type const                    s = buffer.view;
+        for(auto _: state)
+        {
+            std::int32_t acc[view_type::block_size] = {};
+            s.for_each_block([&](span<std::int32_t const, view_type::block_size> block) {
+                for(std::size_t l = 0; l < block.size(); ++l)
+                    acc[l] += block[l];
+            });
+            std::int32_t sum = 0;
+            for(std::int32_t x: acc)
+                sum += x;
+            for(std::int32_t x: s.tail())
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size_bytes());
+    }
+    BENCHMARK(BM_SumInt_aligned_blocks)->Arg(4096)->Arg(1 << 20);
+
+    // Float sums: without -ffast-math the plain loop is one serial chain of additions, the lanes of the blocked
+    // loop are independent accumulators (a different, but equally valid, summation order).
+
+    static void BM_SumFloat_span(benchmark::State& state)
+    {
+        aligned_buffer<float> const buffer(static_cast<std::size_t>(state.range(0)));
+        span<float const> const     s = buffer.view;
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(float x: s)
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size_bytes());
+    }
+    BENCHMARK(BM_SumFloat_span)->Arg(4096)->Arg(1 << 20);
+
+    static void BM_SumFloat_aligned_blocks(benchmark::State& state)
+    {
+        using view_type = aligned_span<float const, alignment>;
+        aligned_buffer<float> const buffer(static_cast<std::size_t>(state.range(0)));
+        view_type const             s = buffer.view;
+        for(auto _: state)
+        {
+            float acc[view_type::block_size] = {};
+            s.for_each_block([&](span<float const, view_type::block_size> block) {
+                for(std::size_t l = 0; l < block.size(); ++l)
+                    acc[l] += block[l];
+            });
+            float sum = 0;
+            for(float x: acc)
+                sum += x;
+            for(float x: s.tail())
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size_bytes());
+    }
+    BENCHMARK(BM_SumFloat_aligned_blocks)->Arg(4096)->Arg(1 << 20);
+
+    // Dot product of two aligned arrays, blocked through the aligned pointers.
+
+    static void BM_DotFloat_span(benchmark::State& state)
+    {
+        auto const                  n = static_cast<std::size_t>(state.range(0));
+        aligned_buffer<float> const a(n), b(n);
+        span<float const> const     x = a.view, y = b.view;
+        for(auto _: state)
+        {
+            float dot = 0;
+            for(std::size_t i = 0; i < n; ++i)
+                dot += x[i] * y[i];
+            benchmark::DoNotOptimize(dot);
+        }
+        set_counters(state, 2 * x.size_bytes());
+    }
+    BENCHMARK(BM_DotFloat_span)->Arg(4096)->Arg(1 << 20);
+
+    static void BM_DotFloat_aligned_blocks(benchmark::State& state)
+    {
+        using view_type                 = aligned_span<float const, alignment>;
+        constexpr std::size_t       lanes = view_type::block_size;
+        auto const                  n     = static_cast<std::size_t>(state.range(0));
+        aligned_buffer<float> const a(n), b(n);
+        view_type const             x = a.view, y = b.view;
+        for(auto _: state)
+        {
+            float const* const px         = x.data();
+            float const* const py         = y.data();
+            float              acc[lanes] = {};
+            for(std::size_t i = 0; i + lanes <= n; i += lanes)
+                for(std::size_t l = 0; l < lanes; ++l)
+                    acc[l] += px[i + l] * py[i + l];
+            float dot = 0;
+            for(float v: acc)
+                dot += v;
+            for(std::size_t i = n / lanes * lanes; i < n; ++i)
+                dot += px[i] * py[i];
+            benchmark::DoNotOptimize(dot);
+        }
+        set_counters(state, 2 * x.size_bytes());
+    }
+    BENCHMARK(BM_DotFloat_aligned_blocks)->Arg(4096)->Arg(1 << 20);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/chunks.h"
+#include "qs/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static std::vector<float> make_values(std::size_t n)
+    {
+        std::vector<float> values(n);
+        for(std::size_t i = 0; i < n; ++i)
+            values[i] = static_cast<float>(i % 13);
+        return values;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t n)
+    {
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+
+    // Sum of squares over a span: one serial chain of floating-point additions.
+    static void BM_SumSquares_loop(benchmark::State& state)
+    {
+        auto const              values = make_values(static_cast<std::size_t>(state.range(0)));
+        span<float const> const s      = make_span(values);
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(float x: s)
+                sum += x * x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size());
+    }
+    BENCHMARK(BM_SumSquares_loop)->Arg(4096)->Arg(1 << 20);
+
+    // Static chunks: the inner loop has a constant trip count, unrolled into `N` independent accumulators.
+    template<std::size_t N>
+    static void BM_SumSquares_static_chunks(benchmark::State& state)
+    {
+        auto const              values = make_values(static_cast<std::size_t>(state.range(0)));
+        span<float const> const s      = make_span(values);
+        for(auto _: state)
+        {
+            float      acc[N] = {};
+            auto const view   = chunks<N>(s);
+            for(span<float const, N> chunk: view)
+                for(std::size_t l = 0; l < N; ++l)
+                    acc[l] += chunk[l] * chunk[l];
+            float sum = 0;
+            for(float a: acc)
+                sum += a;
+            for(float x: view.tail())
+                sum += x * x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size());
+    }
+    BENCHMARK(BM_SumSquares_static_chunks<8>)->Arg(4096)->Arg(1 << 20);
+    BENCHMARK(BM_SumSquares_static_chunks<16>)->Arg(4096)->Arg(1 << 20);
+
+    // Same blocking with the chunk size known only at run time: no unrolling, no vectorization.
+    static void BM_SumSquares_dynamic_chunks(benchmark::State& state)
+    {
+        constexpr std::size_t   n      = 16;
+        auto const              values = make_values(static_cast<std::size_t>(state.range(0)));
+        span<float const> const s      = make_span(values);
+        std::size_t             size   = n;
+        benchmark::DoNotOptimize(size); // hidden from the optimizer
+        for(auto _: state)
+        {
+            float acc[n] = {};
+            for(span<float const> chunk: chunks(s, size))
+                for(std::size_t l = 0; l < chunk.size(); ++l)
+                    acc[l] += chunk[l] * chunk[l];
+            float sum = 0;
+            for(float a: acc)
+                sum += a;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, s.size());
+    }
+    BENCHMARK(BM_SumSquares_dynamic_chunks)->Arg(4096)->Arg(1 << 20);
+
+    // Cost of cutting a span into parts and visiting them, per part.
+    static void BM_SplitEven(benchmark::State& state)
+    {
+        auto const              values = make_values(1 << 20);
+        span<float const> const s      = make_span(values);
+        auto const              parts  = static_cast<std::size_t>(state.range(0));
+        for(auto _: state)
+        {
+            std::size_t total = 0;
+            for(span<float const> part: split_even(s, parts))
+                total += part.size();
+            benchmark::DoNotOptimize(total);
+        }
+        set_counters(state, parts);
+    }
+    BENCHMARK(BM_SplitEven)->Arg(7)->Arg(64);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
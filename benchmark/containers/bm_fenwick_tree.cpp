@@ -2,7 +2,10 @@
 
 #include "qs/config.h"
 #include "qs/containers/fenwick_tree.h"
+#include "qs/memory/huge_page_allocator.h"
 
+#include <cstdint>
+#include <random>
 #include <vector>
 
 QS_NAMESPACE_BEGIN
@@ -120,6 +123,42 @@ namespace bench
         ->Complexity()
         ->DisplayAggregatesOnly();
 
+    // Random queries over a tree much larger than the TLB reach of 4K pages, `Pages` picks the backing page size.
+    template<page_size Pages>
+    static void BM_FenwickTree_randomQueryPages(benchmark::State& state)
+    {
+        auto const N = static_cast<std::size_t>(state.range(0));
+
+        huge_page_options opts;
+        opts.pages = Pages;
+        FenwickTree<int, huge_page_allocator<int>> tree(N, huge_page_allocator<int>(opts));
+        for(std::size_t i = 0; i < N; ++i)
+            tree.update(i, 1);
+
+        std::mt19937_64                            gen(42);
+        std::uniform_int_distribution<std::size_t> dist(1, N);
+        std::vector<std::size_t>                   idx(4096);
+        for(auto& i: idx)
+            i = dist(gen);
+
+        std::size_t k   = 0;
+        int         val = 0;
+        for(auto _: state)
+        {
+            val += tree.query(idx[k]);
+            k = (k + 1) & (idx.size() - 1);
+        }
+
+        benchmark::DoNotOptimize(val);
+        state.SetComplexityN(static_cast<std::int64_t>(N));
+    }
+    BENCHMARK_TEMPLATE(BM_FenwickTree_randomQueryPages, page_size::standard)
+        ->RangeMultiplier(8)
+        ->Range(1 << 16, 1 << 25);
+    BENCHMARK_TEMPLATE(BM_FenwickTree_randomQueryPages, page_size::huge_2m)
+        ->RangeMultiplier(8)
+        ->Range(1 << 16, 1 << 25);
+
 } // namespace bench
 
 QS_NAMESPACE_END
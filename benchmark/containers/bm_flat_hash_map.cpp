@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/containers/flat_hash_map.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // splitmix64 is a bijection: the keys `key(i)` are distinct, those past `n` miss a map of the first `n`.
+    static std::uint64_t key(std::uint64_t i)
+    {
+        i += 0x9e3779b97f4a7c15u;
+        i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9u;
+        i = (i ^ (i >> 27)) * 0x94d049bb133111ebu;
+        return i ^ (i >> 31);
+    }
+
+    static std::vector<std::uint64_t> keys(std::size_t first, std::size_t n)
+    {
+        std::vector<std::uint64_t> v(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] = key(first + i);
+        return v;
+    }
+
+    static constexpr std::size_t query_count = 1 << 16;
+
+    // Random picks among `key(first) ... key(first + n - 1)`.
+    static std::vector<std::uint64_t> queries(std::size_t first, std::size_t n)
+    {
+        std::mt19937_64            gen(11);
+        std::vector<std::uint64_t> q(query_count);
+        for(auto& x: q)
+            x = key(first + gen() % n);
+        return q;
+    }
+
+    // From L1-resident to far past the last-level cache. 100M keys take about 2.5 GB as `flat_hash_map` and
+    // twice that as `std::unordered_map`.
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(std::int64_t n: {1'000, 32'000, 1'000'000, 16'000'000, 100'000'000})
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    template<class Map>
+    static Map build(std::vector<std::uint64_t> const& v)
+    {
+        Map map;
+        for(auto k: v)
+            map.try_emplace(k, k);
+        return map;
+    }
+
+    template<class Map>
+    static void BM_FindHit(benchmark::State& state)
+    {
+        auto const  n   = static_cast<std::size_t>(state.range(0));
+        auto const  map = build<Map>(keys(0, n));
+        auto const  q   = queries(0, n);
+        std::size_t i   = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(map.find(q[i++ & (query_count - 1)])->second);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+    BENCHMARK(BM_FindHit<std::unordered_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+    BENCHMARK(BM_FindHit<flat_hash_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+
+    template<class Map>
+    static void BM_FindMiss(benchmark::State& state)
+    {
+        auto const  n   = static_cast<std::size_t>(state.range(0));
+        auto const  map = build<Map>(keys(0, n));
+        auto const  q   = queries(n, n);
+        std::size_t i   = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(map.find(q[i++ & (query_count - 1)]) == map.end());
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+    BENCHMARK(BM_FindMiss<std::unordered_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+    BENCHMARK(BM_FindMiss<flat_hash_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+
+    // Whole map built one insert at a time, growing from empty or reserved up front.
+    template<class Map, bool Reserve>
+    static void BM_Insert(benchmark::State& state)
+    {
+        auto const v = keys(0, static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+        {
+            Map map;
+            if(Reserve)
+                map.reserve(v.size());
+            for(auto k: v)
+                map.try_emplace(k, k);
+            benchmark::DoNotOptimize(map.size());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+    }
+    BENCHMARK(BM_Insert<std::unordered_map<std::uint64_t, std::uint64_t>, false>)->Apply(args);
+    BENCHMARK(BM_Insert<flat_hash_map<std::uint64_t, std::uint64_t>, false>)->Apply(args);
+    BENCHMARK(BM_Insert<std::unordered_map<std::uint64_t, std::uint64_t>, true>)->Apply(args);
+    BENCHMARK(BM_Insert<flat_hash_map<std::uint64_t, std::uint64_t>, true>)->Apply(args);
+
+    // Every key erased, in insertion order.
+    template<class Map>
+    static void BM_Erase(benchmark::State& state)
+    {
+        auto const v = keys(0, static_cast<std::size_t>(state.range(0)));
+        for(auto _: state)
+        {
+            state.PauseTiming();
+            Map map = build<Map>(v);
+            state.ResumeTiming();
+            for(auto k: v)
+                map.erase(k);
+            benchmark::DoNotOptimize(map.size());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+    }
+    BENCHMARK(BM_Erase<std::unordered_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+    BENCHMARK(BM_Erase<flat_hash_map<std::uint64_t, std::uint64_t>>)->Apply(args);
+
+    // Symbol lookups from a `std::string_view` out of a message: heterogeneous for `flat_hash_map`, through a
+    // temporary `std::string` for `std::unordered_map` before C++20.
+    template<class Map>
+    static void BM_FindSymbol(benchmark::State& state)
+    {
+        auto const               n = static_cast<std::size_t>(state.range(0));
+        std::vector<std::string> symbols(n);
+        Map                      map;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            symbols[i] = "SYM" + std::to_string(key(i) % 100'000'000);
+            map.try_emplace(symbols[i], i);
+        }
+        std::mt19937_64               gen(13);
+        std::vector<std::string_view> q(query_count);
+        for(auto& s: q)
+            s = symbols[gen() % n];
+        std::size_t i = 0;
+        for(auto _: state)
+        {
+            std::string_view const s = q[i++ & (query_count - 1)];
+            if constexpr(std::is_same<Map, std::unordered_map<std::string, std::size_t>>::value)
+                benchmark::DoNotOptimize(map.find(std::string(s)));
+            else
+                benchmark::DoNotOptimize(map.find(s));
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+    BENCHMARK(BM_FindSymbol<std::unordered_map<std::string, std::size_t>>)->Arg(1'000)->Arg(32'000);
+    BENCHMARK(BM_FindSymbol<flat_hash_map<std::string, std::size_t, string_hash, std::equal_to<>>>)
+        ->Arg(1'000)
+        ->Arg(32'000);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
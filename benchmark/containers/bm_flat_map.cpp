@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/containers/flat_map.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Price levels, random order, with the payload of a quantity.
+    static std::vector<std::pair<std::int64_t, std::uint32_t>> levels(std::size_t n, std::uint64_t seed)
+    {
+        std::mt19937_64                                     gen(seed);
+        std::vector<std::pair<std::int64_t, std::uint32_t>> v(n);
+        for(auto& kv: v)
+            kv = {static_cast<std::int64_t>(gen() % (4 * n)), static_cast<std::uint32_t>(gen())};
+        return v;
+    }
+
+    static constexpr std::size_t query_count = 1 << 12;
+
+    static std::vector<std::int64_t> queries(std::size_t n)
+    {
+        std::mt19937_64           gen(7);
+        std::vector<std::int64_t> q(query_count);
+        for(auto& x: q)
+            x = static_cast<std::int64_t>(gen() % (4 * n));
+        return q;
+    }
+
+    // Hundreds to tens of thousands of entries.
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int n: {16, 256, 4096, 65536})
+            b->Args({n});
+        b->ArgNames({"n"});
+    }
+
+    template<class Map>
+    static void BM_Find(benchmark::State& state)
+    {
+        auto const  n = static_cast<std::size_t>(state.range(0));
+        auto const  v = levels(n, 1);
+        Map const   map(v.begin(), v.end());
+        auto const  q = queries(n);
+        std::size_t i = 0;
+        for(auto _: state)
+            benchmark::DoNotOptimize(map.find(q[i++ & (query_count - 1)]));
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+    BENCHMARK(BM_Find<std::map<std::int64_t, std::uint32_t>>)->Apply(args);
+    BENCHMARK(BM_Find<flat_map<std::int64_t, std::uint32_t>>)->Apply(args);
+
+    // Whole map built from a batch in random order: one insert per element against one `insert_range`.
+    template<class Map>
+    static void BM_InsertEach(benchmark::State& state)
+    {
+        auto const v = levels(static_cast<std::size_t>(state.range(0)), 2);
+        for(auto _: state)
+        {
+            Map map;
+            for(auto const& kv: v)
+                map.insert(kv);
+            benchmark::DoNotOptimize(map);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+    }
+    BENCHMARK(BM_InsertEach<std::map<std::int64_t, std::uint32_t>>)->Apply(args);
+    BENCHMARK(BM_InsertEach<flat_map<std::int64_t, std::uint32_t>>)->Apply(args);
+
+    static void BM_InsertRange(benchmark::State& state)
+    {
+        auto const v = levels(static_cast<std::size_t>(state.range(0)), 2);
+        for(auto _: state)
+        {
+            flat_map<std::int64_t, std::uint32_t> map;
+            map.insert_range(v);
+            benchmark::DoNotOptimize(map);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+    }
+    BENCHMARK(BM_InsertRange)->Apply(args);
+
+    // Full iteration, summing the payloads.
+    template<class Map>
+    static void BM_Iterate(benchmark::State& state)
+    {
+        auto const v = levels(static_cast<std::size_t>(state.range(0)), 3);
+        Map const  map(v.begin(), v.end());
+        for(auto _: state)
+        {
+            std::uint64_t sum = 0;
+            for(auto const& kv: map)
+                sum += kv.second;
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * map.size()));
+    }
+    BENCHMARK(BM_Iterate<std::map<std::int64_t, std::uint32_t>>)->Apply(args);
+    BENCHMARK(BM_Iterate<flat_map<std::int64_t, std::uint32_t>>)->Apply(args);
+
+    // Tiny maps, in place against on the heap.
+    template<class Map>
+    static void BM_TinyBuildFind(benchmark::State& state)
+    {
+        auto const  v = levels(8, 4);
+        auto const  q = queries(8);
+        std::size_t i = 0;
+        for(auto _: state)
+        {
+            Map map;
+            for(auto const& kv: v)
+                map.insert(kv);
+            benchmark::DoNotOptimize(map.find(q[i++ & (query_count - 1)]));
+        }
+    }
+    BENCHMARK(BM_TinyBuildFind<std::map<std::int64_t, std::uint32_t>>);
+    BENCHMARK(BM_TinyBuildFind<flat_map<std::int64_t, std::uint32_t>>);
+    BENCHMARK(BM_TinyBuildFind<inplace_flat_map<std::int64_t, std::uint32_t, 8>>);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
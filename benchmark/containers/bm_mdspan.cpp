@@ -0,0 +1,223 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/mdspan.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Each view kernel has a raw pointer twin with the offsets written out by hand: the pairs should run at the
+    // same speed, the views adding no work to the index arithmetic.
+
+    static constexpr std::size_t static_n = 512;
+
+    static std::vector<float> make_matrix(std::size_t n)
+    {
+        std::vector<float> m(n * n);
+        std::iota(m.begin(), m.end(), 0.0f);
+        return m;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t elements)
+    {
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * elements));
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * elements * sizeof(float)));
+    }
+
+    // Row-major traversal of a row-major matrix.
+
+    static void BM_RowSum_raw(benchmark::State& state)
+    {
+        auto const         n = static_cast<std::size_t>(state.range(0));
+        auto const         m = make_matrix(n);
+        float const* const p = m.data();
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t i = 0; i < n; ++i)
+                for(std::size_t j = 0; j < n; ++j)
+                    sum += p[i * n + j];
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n * n);
+    }
+    BENCHMARK(BM_RowSum_raw)->Arg(static_n)->Arg(2048);
+
+    static void BM_RowSum_mdspan(benchmark::State& state)
+    {
+        auto const                                          n = static_cast<std::size_t>(state.range(0));
+        auto const                                          m = make_matrix(n);
+        mdspan<float const, dextents<std::size_t, 2>> const v(m.data(), n, n);
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t i = 0; i < v.extent(0); ++i)
+                for(std::size_t j = 0; j < v.extent(1); ++j)
+                    sum += v(i, j);
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n * n);
+    }
+    BENCHMARK(BM_RowSum_mdspan)->Arg(static_n)->Arg(2048);
+
+    static void BM_RowSum_raw_static(benchmark::State& state)
+    {
+        auto const         m = make_matrix(static_n);
+        float const* const p = m.data();
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t i = 0; i < static_n; ++i)
+                for(std::size_t j = 0; j < static_n; ++j)
+                    sum += p[i * static_n + j];
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, static_n * static_n);
+    }
+    BENCHMARK(BM_RowSum_raw_static);
+
+    static void BM_RowSum_mdspan_static(benchmark::State& state)
+    {
+        using matrix = mdspan<float const, extents<std::size_t, static_n, static_n>>;
+        auto const   m = make_matrix(static_n);
+        matrix const v(m.data());
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t i = 0; i < v.extent(0); ++i)
+                for(std::size_t j = 0; j < v.extent(1); ++j)
+                    sum += v(i, j);
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, static_n * static_n);
+    }
+    BENCHMARK(BM_RowSum_mdspan_static);
+
+    // Matrix product `c = a * b` in i-k-j order, three accesses per inner iteration. Both inner loops compile to the
+    // same instructions, so a gap between the two is code placement (loop alignment), not index arithmetic.
+
+    static void BM_MatMul_raw(benchmark::State& state)
+    {
+        auto const         n = static_cast<std::size_t>(state.range(0));
+        auto const         a = make_matrix(n), b = make_matrix(n);
+        std::vector<float> c(n * n);
+        for(auto _: state)
+        {
+            std::fill(c.begin(), c.end(), 0.0f);
+            for(std::size_t i = 0; i < n; ++i)
+                for(std::size_t k = 0; k < n; ++k)
+                    for(std::size_t j = 0; j < n; ++j)
+                        c[i * n + j] += a[i * n + k] * b[k * n + j];
+            benchmark::DoNotOptimize(c.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, n * n * n);
+    }
+    BENCHMARK(BM_MatMul_raw)->Arg(256);
+
+    static void BM_MatMul_mdspan(benchmark::State& state)
+    {
+        using matrix             = mdspan<float, dextents<std::size_t, 2>>;
+        using const_matrix       = mdspan<float const, dextents<std::size_t, 2>>;
+        auto const         n     = static_cast<std::size_t>(state.range(0));
+        auto const         a_buf = make_matrix(n), b_buf = make_matrix(n);
+        std::vector<float> c_buf(n * n);
+        const_matrix const a(a_buf.data(), n, n), b(b_buf.data(), n, n);
+        matrix const       c(c_buf.data(), n, n);
+        for(auto _: state)
+        {
+            std::fill(c_buf.begin(), c_buf.end(), 0.0f);
+            for(std::size_t i = 0; i < n; ++i)
+                for(std::size_t k = 0; k < n; ++k)
+                    for(std::size_t j = 0; j < n; ++j)
+                        c(i, j) += a(i, k) * b(k, j);
+            benchmark::DoNotOptimize(c_buf.data());
+            benchmark::ClobberMemory();
+        }
+        set_counters(state, n * n * n);
+    }
+    BENCHMARK(BM_MatMul_mdspan)->Arg(256);
+
+    // Column-major traversal of a column-major matrix.
+
+    static void BM_ColumnMajorSum_raw(benchmark::State& state)
+    {
+        auto const         n = static_cast<std::size_t>(state.range(0));
+        auto const         m = make_matrix(n);
+        float const* const p = m.data();
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t j = 0; j < n; ++j)
+                for(std::size_t i = 0; i < n; ++i)
+                    sum += p[i + j * n];
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n * n);
+    }
+    BENCHMARK(BM_ColumnMajorSum_raw)->Arg(2048);
+
+    static void BM_ColumnMajorSum_mdspan(benchmark::State& state)
+    {
+        auto const                                                       n = static_cast<std::size_t>(state.range(0));
+        auto const                                                       m = make_matrix(n);
+        mdspan<float const, dextents<std::size_t, 2>, layout_left> const v(m.data(), n, n);
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t j = 0; j < n; ++j)
+                for(std::size_t i = 0; i < n; ++i)
+                    sum += v(i, j);
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n * n);
+    }
+    BENCHMARK(BM_ColumnMajorSum_mdspan)->Arg(2048);
+
+    // One column of a row-major matrix, the stride known only at run time.
+
+    static void BM_ColumnSum_raw(benchmark::State& state)
+    {
+        auto const         n = static_cast<std::size_t>(state.range(0));
+        auto const         m = make_matrix(n);
+        float const* const p = m.data() + n / 2;
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(std::size_t i = 0; i < n; ++i)
+                sum += p[i * n];
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n);
+    }
+    BENCHMARK(BM_ColumnSum_raw)->Arg(2048);
+
+    static void BM_ColumnSum_strided_span(benchmark::State& state)
+    {
+        auto const                                          n = static_cast<std::size_t>(state.range(0));
+        auto const                                          m = make_matrix(n);
+        mdspan<float const, dextents<std::size_t, 2>> const v(m.data(), n, n);
+        strided_span<float const> const                     column_view = column(v, n / 2);
+        for(auto _: state)
+        {
+            float sum = 0;
+            for(float x: column_view)
+                sum += x;
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, n);
+    }
+    BENCHMARK(BM_ColumnSum_strided_span)->Arg(2048);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    struct wire_record
+    {
+        std::uint32_t id;
+        std::uint16_t port;
+        std::uint16_t flags;
+        std::uint64_t bytes;
+    };
+
+    // A received buffer of `n` records, as raw bytes.
+    static std::vector<wire_record> make_buffer(std::size_t n)
+    {
+        std::vector<wire_record> records(n);
+        for(std::size_t i = 0; i < n; ++i)
+            records[i] = {static_cast<std::uint32_t>(i), static_cast<std::uint16_t>(i % 1024),
+                          static_cast<std::uint16_t>(i % 3), i * 7};
+        return records;
+    }
+
+    static std::uint64_t process(wire_record const& r) noexcept
+    {
+        return r.flags == 1 ? r.bytes + r.port : r.id;
+    }
+
+    static void set_counters(benchmark::State& state, std::size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    }
+
+    // Decoding into an owned copy first: allocation plus a full pass over memory before any work.
+    static void BM_Decode_copy(benchmark::State& state)
+    {
+        std::vector<wire_record> const records = make_buffer(static_cast<std::size_t>(state.range(0)));
+        span<byte const> const         bytes   = as_bytes(make_span(records));
+        for(auto _: state)
+        {
+            std::vector<wire_record> decoded(bytes.size() / sizeof(wire_record));
+            std::memcpy(decoded.data(), bytes.data(), bytes.size());
+            std::uint64_t sum = 0;
+            for(wire_record const& r: decoded)
+                sum += process(r);
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, bytes.size());
+    }
+    BENCHMARK(BM_Decode_copy)->Arg(1024)->Arg(1 << 18);
+
+    // memcpy of each record into a local: compiles to plain loads, the reference for the zero-copy view.
+    static void BM_Decode_memcpy_each(benchmark::State& state)
+    {
+        std::vector<wire_record> const records = make_buffer(static_cast<std::size_t>(state.range(0)));
+        span<byte const> const         bytes   = as_bytes(make_span(records));
+        for(auto _: state)
+        {
+            std::uint64_t sum = 0;
+            for(std::size_t offset = 0; offset < bytes.size(); offset += sizeof(wire_record))
+            {
+                wire_record r;
+                std::memcpy(&r, bytes.data() + offset, sizeof(r));
+                sum += process(r);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, bytes.size());
+    }
+    BENCHMARK(BM_Decode_memcpy_each)->Arg(1024)->Arg(1 << 18);
+
+    static void BM_Decode_span_cast(benchmark::State& state)
+    {
+        std::vector<wire_record> const records = make_buffer(static_cast<std::size_t>(state.range(0)));
+        span<byte const> const         bytes   = as_bytes(make_span(records));
+        for(auto _: state)
+        {
+            std::uint64_t sum = 0;
+            for(wire_record const& r: span_cast<wire_record const>(bytes))
+                sum += process(r);
+            benchmark::DoNotOptimize(sum);
+        }
+        set_counters(state, bytes.size());
+    }
+    BENCHMARK(BM_Decode_span_cast)->Arg(1024)->Arg(1 << 18);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/binomial.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    using mint = mod_int<998244353>;
+
+    static constexpr std::size_t query_count = 1024;
+
+    static std::vector<std::pair<std::uint32_t, std::uint32_t>> random_queries(std::uint32_t max_n)
+    {
+        std::mt19937                                         gen(42);
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> queries(query_count);
+        std::uniform_int_distribution<std::uint32_t>         dist(0, max_n);
+        for(auto& q: queries)
+        {
+            q.first  = dist(gen);
+            q.second = std::uniform_int_distribution<std::uint32_t>(0, q.first)(gen);
+        }
+        return queries;
+    }
+
+    // C(n, k) = n (n-1) ... (n-k+1) / k!, one inversion per query
+    static mint binomial_recompute(std::uint32_t n, std::uint32_t k)
+    {
+        k = std::min(k, n - k);
+        mint num(1), den(1);
+        for(std::uint32_t i = 0; i < k; ++i)
+        {
+            num *= mint(n - i);
+            den *= mint(i + 1);
+        }
+        return num / den;
+    }
+
+    static void BM_Binomial_recompute(benchmark::State& state)
+    {
+        auto const queries = random_queries(static_cast<std::uint32_t>(state.range(0)));
+        for(auto _: state)
+        {
+            for(auto const& q: queries)
+                benchmark::DoNotOptimize(binomial_recompute(q.first, q.second));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(query_count));
+    }
+    BENCHMARK(BM_Binomial_recompute)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+    static void BM_Binomial_table(benchmark::State& state)
+    {
+        auto const                 max_n   = static_cast<std::uint32_t>(state.range(0));
+        auto const                 queries = random_queries(max_n);
+        binomial_table<mint> const table(max_n);
+        for(auto _: state)
+        {
+            for(auto const& q: queries)
+                benchmark::DoNotOptimize(table(q.first, q.second));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(query_count));
+    }
+    BENCHMARK(BM_Binomial_table)->RangeMultiplier(16)->Range(1 << 8, 1 << 24);
+
+    static void BM_Binomial_tableBuild(benchmark::State& state)
+    {
+        for(auto _: state)
+        {
+            binomial_table<mint> table(static_cast<std::uint64_t>(state.range(0)));
+            benchmark::DoNotOptimize(table.factorial(0));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_Binomial_tableBuild)->RangeMultiplier(16)->Range(1 << 8, 1 << 24);
+
+    static void BM_Binomial_lucas(benchmark::State& state)
+    {
+        binomial_table<mod_int<65537>> const table(65536);
+        std::mt19937_64                      gen(42);
+        std::vector<std::uint64_t>           ns(query_count), ks(query_count);
+        for(std::size_t i = 0; i < query_count; ++i)
+        {
+            ns[i] = gen();
+            ks[i] = ns[i] & gen();
+        }
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < query_count; ++i)
+                benchmark::DoNotOptimize(table(ns[i], ks[i]));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(query_count));
+    }
+    BENCHMARK(BM_Binomial_lucas);
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/crt.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Up to 8 primes below 2^31, so that products of up to two of them fit the naive 64-bit arithmetic.
+    static constexpr std::uint32_t moduli[] = {2147483647, 2147483629, 2147483587, 2147483579,
+                                               2147483563, 2147483549, 2147483543, 2147483497};
+
+    static constexpr std::size_t count = 1 << 16;
+
+    static std::vector<std::uint32_t> random_residues(std::size_t k)
+    {
+        std::mt19937_64            gen(42);
+        std::vector<std::uint32_t> residues(count * k);
+        for(std::size_t i = 0; i < residues.size(); ++i)
+            residues[i] = static_cast<std::uint32_t>(gen() % moduli[i % k]);
+        return residues;
+    }
+
+    // Garner's algorithm with the inverses precomputed too, but every reduction a hardware `%`.
+    static std::uint64_t garner_naive(std::uint32_t const* r, std::size_t k, std::vector<std::uint64_t> const& inv)
+    {
+        std::uint64_t v[8];
+        std::uint64_t x = 0, weight = 1;
+        for(std::size_t j = 0; j < k; ++j)
+        {
+            std::uint64_t const m   = moduli[j];
+            std::uint64_t       acc = 0, prefix = 1;
+            for(std::size_t i = 0; i < j; ++i)
+            {
+                acc    = (acc + v[i] * prefix) % m;
+                prefix = prefix * moduli[i] % m;
+            }
+            v[j] = (r[j] + m - acc) % m * inv[j] % m;
+            x += v[j] * weight;
+            weight *= moduli[j];
+        }
+        return x;
+    }
+
+    static void BM_Reconstruct_naive(benchmark::State& state)
+    {
+        auto const                 k        = static_cast<std::size_t>(state.range(0));
+        auto const                 residues = random_residues(k);
+        std::vector<std::uint64_t> out(count), inv(k);
+        for(std::size_t j = 0; j < k; ++j)
+        {
+            std::uint64_t prefix = 1;
+            for(std::size_t i = 0; i < j; ++i)
+                prefix = prefix * moduli[i] % moduli[j];
+            inv[j] = intl::crt_inverse(static_cast<std::uint32_t>(prefix), moduli[j]);
+        }
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+                out[i] = garner_naive(residues.data() + i * k, k, inv);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+    }
+    BENCHMARK(BM_Reconstruct_naive)->Arg(3)->Arg(5)->Arg(8)->ArgName("moduli");
+
+    static void BM_Reconstruct(benchmark::State& state)
+    {
+        auto const                 k        = static_cast<std::size_t>(state.range(0));
+        auto const                 residues = random_residues(k);
+        std::vector<std::uint64_t> out(count);
+        crt_basis const            basis(span<std::uint32_t const>(moduli, k));
+        for(auto _: state)
+        {
+            basis.reconstruct(make_span(residues), make_span(out));
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+    }
+    BENCHMARK(BM_Reconstruct)->Arg(3)->Arg(5)->Arg(8)->ArgName("moduli");
+
+    // Folding the congruences one by one with `crt`, Bezout coefficients recomputed for each element.
+    static void BM_Reconstruct_pairwise(benchmark::State& state)
+    {
+        auto const                 k        = static_cast<std::size_t>(state.range(0));
+        auto const                 residues = random_residues(k);
+        std::vector<std::uint64_t> out(count);
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                congruence c{};
+                for(std::size_t j = 0; j < k; ++j)
+                    c = *crt(c, {residues[i * k + j], moduli[j]});
+                out[i] = c.remainder;
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+    }
+    BENCHMARK(BM_Reconstruct_pairwise)->Arg(2)->ArgName("moduli");
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/fast_divider.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static constexpr std::size_t count = 1 << 14;
+
+    template<class T>
+    static std::vector<T> random_values(std::uint64_t seed)
+    {
+        std::mt19937_64 gen(seed);
+        std::vector<T>  v(count);
+        for(auto& x: v)
+            x = static_cast<T>(gen());
+        return v;
+    }
+
+    // A divisor only known at runtime, so that the compiler cannot strength-reduce the hardware division itself.
+    template<class T>
+    static T runtime_divisor()
+    {
+        T d = static_cast<T>(std::is_signed<T>::value ? -1000003 : 1000003);
+        benchmark::DoNotOptimize(d);
+        return d;
+    }
+
+    template<class T>
+    static void finish(benchmark::State& state)
+    {
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+    }
+
+    // Hardware `div` per element.
+    template<class T>
+    static void BM_Divide_hardware(benchmark::State& state)
+    {
+        auto const     in = random_values<T>(1);
+        std::vector<T> out(count);
+        T const        d = runtime_divisor<T>();
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+                out[i] = in[i] / d;
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        finish<T>(state);
+    }
+    BENCHMARK_TEMPLATE(BM_Divide_hardware, std::uint32_t);
+    BENCHMARK_TEMPLATE(BM_Divide_hardware, std::int32_t);
+    BENCHMARK_TEMPLATE(BM_Divide_hardware, std::uint64_t);
+    BENCHMARK_TEMPLATE(BM_Divide_hardware, std::int64_t);
+
+    // `fast_divider` per element, left to the auto-vectorizer.
+    template<class T>
+    static void BM_Divide_fastDivider(benchmark::State& state)
+    {
+        auto const            in = random_values<T>(1);
+        std::vector<T>        out(count);
+        fast_divider<T> const d(runtime_divisor<T>());
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+                out[i] = in[i] / d;
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        finish<T>(state);
+    }
+    BENCHMARK_TEMPLATE(BM_Divide_fastDivider, std::uint32_t);
+    BENCHMARK_TEMPLATE(BM_Divide_fastDivider, std::int32_t);
+    BENCHMARK_TEMPLATE(BM_Divide_fastDivider, std::uint64_t);
+    BENCHMARK_TEMPLATE(BM_Divide_fastDivider, std::int64_t);
+
+    // The batch kernels, simd level as argument.
+    template<class T>
+    static void BM_Divide_batch(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(0)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(0)))
+            state.SkipWithError("instruction set not supported by this CPU");
+
+        auto const            in = random_values<T>(1);
+        std::vector<T>        out(count);
+        fast_divider<T> const d(runtime_divisor<T>());
+        for(auto _: state)
+        {
+            d.divide(make_span(in), make_span(out));
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        finish<T>(state);
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK_TEMPLATE(BM_Divide_batch, std::uint32_t)->DenseRange(0, 2)->ArgName("simd");
+    BENCHMARK_TEMPLATE(BM_Divide_batch, std::int32_t)->DenseRange(0, 2)->ArgName("simd");
+    BENCHMARK_TEMPLATE(BM_Divide_batch, std::uint64_t)->Arg(0)->ArgName("simd");
+    BENCHMARK_TEMPLATE(BM_Divide_batch, std::int64_t)->Arg(0)->ArgName("simd");
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
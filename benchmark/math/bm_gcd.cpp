@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/gcd.h"
+#include "qs/math/mod_arithmetic.h"
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    template<class T>
+    static std::vector<T> random_values(std::size_t n, std::uint64_t seed)
+    {
+        std::mt19937_64 gen(seed);
+        std::vector<T>  v(n);
+        for(auto& x: v)
+            x = static_cast<T>(gen() >> 2); // keeps signed values positive and within binary_extended_gcd range
+        return v;
+    }
+
+    static constexpr std::size_t count = 1024;
+
+    template<class T, class Fn>
+    static void run_pairs(benchmark::State& state, Fn fn)
+    {
+        auto const a = random_values<T>(count, 1);
+        auto const b = random_values<T>(count, 2);
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+                benchmark::DoNotOptimize(fn(a[i], b[i]));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+    }
+
+    template<class T>
+    static void BM_Gcd_std(benchmark::State& state)
+    {
+        run_pairs<T>(state, [](T a, T b) { return std::gcd(a, b); });
+    }
+    BENCHMARK_TEMPLATE(BM_Gcd_std, std::uint32_t);
+    BENCHMARK_TEMPLATE(BM_Gcd_std, std::uint64_t);
+
+    template<class T>
+    static void BM_Gcd_euclid(benchmark::State& state)
+    {
+        run_pairs<T>(state, [](T a, T b) { return intl::extended_gcd_impl(a, b).first; });
+    }
+    BENCHMARK_TEMPLATE(BM_Gcd_euclid, std::uint32_t);
+    BENCHMARK_TEMPLATE(BM_Gcd_euclid, std::uint64_t);
+
+    template<class T>
+    static void BM_Gcd_binary(benchmark::State& state)
+    {
+        run_pairs<T>(state, [](T a, T b) { return gcd(a, b); });
+    }
+    BENCHMARK_TEMPLATE(BM_Gcd_binary, std::uint32_t);
+    BENCHMARK_TEMPLATE(BM_Gcd_binary, std::uint64_t);
+
+    template<class T>
+    static void BM_ExtendedGcd_euclid(benchmark::State& state)
+    {
+        run_pairs<T>(state, [](T a, T b) { return extended_gcd(a, b); });
+    }
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_euclid, std::int32_t);
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_euclid, std::int64_t);
+
+    template<class T>
+    static void BM_ExtendedGcd_binary(benchmark::State& state)
+    {
+        run_pairs<T>(state, [](T a, T b) { return binary_extended_gcd(a, b); });
+    }
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_binary, std::int32_t);
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_binary, std::int64_t);
+
+    // range(0) is the simd_level
+    template<class T>
+    static void BM_ExtendedGcd_range(benchmark::State& state)
+    {
+        auto const     values = random_values<T>(static_cast<std::size_t>(state.range(0)), 3);
+        std::vector<T> coefficients(values.size());
+        for(auto _: state)
+        {
+            benchmark::DoNotOptimize(extended_gcd(make_span(values), make_span(coefficients)));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_range, std::int32_t)->RangeMultiplier(10)->Range(10, 1000000);
+    BENCHMARK_TEMPLATE(BM_ExtendedGcd_range, std::int64_t)->RangeMultiplier(10)->Range(10, 1000000);
+
+    template<class T>
+    static void BM_Gcd_batch(benchmark::State& state)
+    {
+        limit_simd_level(static_cast<simd_level>(state.range(0)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(0)))
+            state.SkipWithError("instruction set not supported by this CPU");
+
+        auto const     a = random_values<T>(count, 1);
+        auto const     b = random_values<T>(count, 2);
+        std::vector<T> out(count);
+        for(auto _: state)
+        {
+            gcd(make_span(a), make_span(b), make_span(out));
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK_TEMPLATE(BM_Gcd_batch, std::uint32_t)->DenseRange(0, 2)->ArgName("simd");
+    BENCHMARK_TEMPLATE(BM_Gcd_batch, std::uint64_t)->DenseRange(0, 2)->ArgName("simd");
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
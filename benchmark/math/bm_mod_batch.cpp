@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/mod_batch.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if QS_X86_64 || QS_X86
+#include <x86intrin.h>
+#endif
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static constexpr std::uint32_t modulus = 998244353;
+
+    static std::vector<std::uint32_t> random_residues(std::size_t n, std::uint32_t seed)
+    {
+        std::mt19937                                 gen(seed);
+        std::uniform_int_distribution<std::uint32_t> dist(0, modulus - 1);
+        std::vector<std::uint32_t>                   v(n);
+        for(auto& x: v)
+            x = dist(gen);
+        return v;
+    }
+
+    // Reference cycles from the TSC, close to core cycles when the frequency is pinned.
+    static std::uint64_t cycles() noexcept
+    {
+#if QS_X86_64 || QS_X86
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    static void report(benchmark::State& state, std::size_t n, std::uint64_t elapsed)
+    {
+        auto const items = static_cast<double>(state.iterations()) * static_cast<double>(n);
+        state.SetItemsProcessed(static_cast<std::int64_t>(items));
+        if(elapsed != 0)
+            state.counters["elem/cycle"] = items / static_cast<double>(elapsed);
+    }
+
+    template<class Kernel>
+    static void run(benchmark::State& state, Kernel kernel)
+    {
+        auto const n = static_cast<std::size_t>(state.range(0));
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(1)))
+            state.SkipWithError("instruction set not supported by this CPU");
+
+        auto const                 a = random_residues(n, 1);
+        auto const                 b = random_residues(n, 2);
+        std::vector<std::uint32_t> out(n);
+        dynamic_modulus const      mod(modulus);
+
+        std::uint64_t const start = cycles();
+        for(auto _: state)
+        {
+            kernel(make_span(a), make_span(b), make_span(out), mod);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        report(state, n, cycles() - start);
+        limit_simd_level(simd_level::avx512);
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n: {1 << 10, 1 << 16})
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"});
+    }
+
+    // A per-element `%` loop, what the kernels replace.
+    static void BM_MulMod_naiveLoop(benchmark::State& state)
+    {
+        auto const                 n = static_cast<std::size_t>(state.range(0));
+        auto const                 a = random_residues(n, 1);
+        auto const                 b = random_residues(n, 2);
+        std::vector<std::uint32_t> out(n);
+        std::uint32_t              m = modulus;
+        benchmark::DoNotOptimize(m); // runtime modulus, as in the kernels
+
+        std::uint64_t const start = cycles();
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < n; ++i)
+                out[i] = static_cast<std::uint32_t>(std::uint64_t(a[i]) * b[i] % m);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        report(state, n, cycles() - start);
+    }
+    BENCHMARK(BM_MulMod_naiveLoop)->Arg(1 << 10)->Arg(1 << 16);
+
+    static void BM_MulMod(benchmark::State& state)
+    {
+        run(state, [](auto a, auto b, auto out, auto const& mod) { mul_mod(a, b, out, mod); });
+    }
+    BENCHMARK(BM_MulMod)->Apply(args);
+
+    static void BM_AddMod(benchmark::State& state)
+    {
+        run(state, [](auto a, auto b, auto out, auto const& mod) { add_mod(a, b, out, mod); });
+    }
+    BENCHMARK(BM_AddMod)->Apply(args);
+
+    static void BM_PowMod(benchmark::State& state)
+    {
+        run(state, [](auto a, auto, auto out, auto const& mod) { pow_mod(a, mod.modulus() - 2, out, mod); });
+    }
+    BENCHMARK(BM_PowMod)->Apply(args);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,161 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/mod_int.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static constexpr std::uint32_t modulus = 998244353;
+
+    static std::vector<std::uint32_t> random_residues(std::size_t n, std::uint32_t m)
+    {
+        std::mt19937                                 gen(42);
+        std::uniform_int_distribution<std::uint32_t> dist(1, m - 1);
+        std::vector<std::uint32_t>                   v(n);
+        for(auto& x: v)
+            x = dist(gen);
+        return v;
+    }
+
+    // The modulus is only known at runtime, as it would be when read from configuration.
+    static std::uint32_t runtime_modulus(benchmark::State const& state)
+    {
+        return static_cast<std::uint32_t>(state.range(0));
+    }
+
+    // Dependent chain of products: measures the latency of one modular multiplication.
+    static void BM_ModMul_naive(benchmark::State& state)
+    {
+        std::uint32_t const m = runtime_modulus(state);
+        auto const          v = random_residues(1024, m);
+        std::uint64_t       acc = 1;
+        for(auto _: state)
+        {
+            for(auto x: v)
+                acc = acc * x % m;
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(v.size()));
+    }
+    BENCHMARK(BM_ModMul_naive)->Arg(modulus);
+
+    static void BM_ModMul_dynamicModulus(benchmark::State& state)
+    {
+        dynamic_modulus const mod(runtime_modulus(state));
+        auto const            v   = random_residues(1024, mod.modulus());
+        std::uint32_t         acc = 1;
+        for(auto _: state)
+        {
+            for(auto x: v)
+                acc = mod.mul(acc, x);
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(v.size()));
+    }
+    BENCHMARK(BM_ModMul_dynamicModulus)->Arg(modulus);
+
+    static void BM_ModMul_montgomery(benchmark::State& state)
+    {
+        montgomery_reduction const red(runtime_modulus(state));
+        auto                       v = random_residues(1024, red.modulus());
+        for(auto& x: v)
+            x = red.to_rep(x);
+        std::uint32_t acc = red.to_rep(1);
+        for(auto _: state)
+        {
+            for(auto x: v)
+                acc = red.mul(acc, x);
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(v.size()));
+    }
+    BENCHMARK(BM_ModMul_montgomery)->Arg(modulus);
+
+    static void BM_ModMul_modInt(benchmark::State& state)
+    {
+        using mint = mod_int<modulus>;
+        auto const        raw = random_residues(1024, modulus);
+        std::vector<mint> v(raw.begin(), raw.end());
+        mint              acc = 1;
+        for(auto _: state)
+        {
+            for(auto x: v)
+                acc *= x;
+            benchmark::DoNotOptimize(acc);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(v.size()));
+    }
+    BENCHMARK(BM_ModMul_modInt)->Arg(modulus);
+
+    // Independent products: measures throughput.
+    static void BM_ModMulArray_naive(benchmark::State& state)
+    {
+        std::uint32_t const        m = runtime_modulus(state);
+        auto const                 a = random_residues(1024, m);
+        auto                       b = random_residues(1024, m ^ 1);
+        std::vector<std::uint32_t> c(a.size());
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < a.size(); ++i)
+                c[i] = static_cast<std::uint32_t>(std::uint64_t(a[i]) * b[i] % m);
+            benchmark::DoNotOptimize(c.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(a.size()));
+    }
+    BENCHMARK(BM_ModMulArray_naive)->Arg(modulus);
+
+    static void BM_ModMulArray_dynamicModulus(benchmark::State& state)
+    {
+        dynamic_modulus const      mod(runtime_modulus(state));
+        auto const                 a = random_residues(1024, mod.modulus());
+        auto                       b = random_residues(1024, mod.modulus() ^ 1);
+        std::vector<std::uint32_t> c(a.size());
+        for(auto _: state)
+        {
+            for(std::size_t i = 0; i < a.size(); ++i)
+                c[i] = mod.mul(a[i], b[i]);
+            benchmark::DoNotOptimize(c.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(a.size()));
+    }
+    BENCHMARK(BM_ModMulArray_dynamicModulus)->Arg(modulus);
+
+    static void BM_ModPow_naive(benchmark::State& state)
+    {
+        std::uint64_t const m = runtime_modulus(state);
+        std::uint64_t       x = 3;
+        for(auto _: state)
+        {
+            std::uint64_t r = 1, b = x;
+            for(std::uint64_t e = m - 2; e != 0; e >>= 1, b = b * b % m)
+                if(e & 1)
+                    r = r * b % m;
+            x = r;
+            benchmark::DoNotOptimize(x);
+        }
+    }
+    BENCHMARK(BM_ModPow_naive)->Arg(modulus);
+
+    static void BM_ModPow_dynamicModulus(benchmark::State& state)
+    {
+        dynamic_modulus const mod(runtime_modulus(state));
+        std::uint32_t         x = 3;
+        for(auto _: state)
+        {
+            x = mod.pow(x, mod.modulus() - 2);
+            benchmark::DoNotOptimize(x);
+        }
+    }
+    BENCHMARK(BM_ModPow_dynamicModulus)->Arg(modulus);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/ntt.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    static constexpr std::uint32_t modulus = 469762049; // supports 2^26 points
+
+    template<class T>
+    static std::vector<T> random_values(std::size_t n)
+    {
+        std::mt19937_64 gen(42);
+        std::vector<T>  v(n);
+        for(auto& x: v)
+            x = T(static_cast<std::uint32_t>(gen()));
+        return v;
+    }
+
+    static void args(benchmark::internal::Benchmark* b)
+    {
+        for(int level: {0, 1, 2})
+            for(int n = 1 << 10; n <= 1 << 24; n <<= 2)
+                b->Args({n, level});
+        b->ArgNames({"n", "simd"})->Unit(benchmark::kMicrosecond);
+    }
+
+    static void BM_Ntt_forwardInverse(benchmark::State& state)
+    {
+        auto const n = static_cast<std::size_t>(state.range(0));
+        limit_simd_level(static_cast<simd_level>(state.range(1)));
+        if(active_simd_level() != static_cast<simd_level>(state.range(1)))
+            state.SkipWithError("instruction set not supported by this CPU");
+
+        ntt<modulus> const plan(n);
+        auto               a = random_values<mod_int<modulus>>(n);
+        for(auto _: state)
+        {
+            plan.forward(make_span(a));
+            plan.inverse(make_span(a));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        limit_simd_level(simd_level::avx512);
+    }
+    BENCHMARK(BM_Ntt_forwardInverse)->Apply(args);
+
+    // exact convolution of two sequences of n/2 values, over transforms of n points
+    static void BM_Ntt_convolveExact(benchmark::State& state)
+    {
+        auto const                 n = static_cast<std::size_t>(state.range(0));
+        auto const                 a = random_values<std::uint32_t>(n / 2);
+        auto const                 b = random_values<std::uint32_t>(n / 2);
+        std::vector<std::uint64_t> c(n);
+        for(auto _: state)
+        {
+            convolve_exact(make_span(a), make_span(b), make_span(c));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_Ntt_convolveExact)->RangeMultiplier(4)->Range(1 << 10, 1 << 24)->Unit(benchmark::kMicrosecond);
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/math/primes.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // Textbook sieve: one byte per integer, the whole range at once, for reference.
+    static std::uint64_t count_primes_naive(std::uint64_t n)
+    {
+        std::vector<bool> composite(n, false);
+        std::uint64_t     count = 0;
+        for(std::uint64_t i = 2; i < n; ++i)
+        {
+            if(composite[i])
+                continue;
+            ++count;
+            for(std::uint64_t j = i * i; j < n; j += i)
+                composite[j] = true;
+        }
+        return count;
+    }
+
+    static void BM_CountPrimes_naive(benchmark::State& state)
+    {
+        auto const n = static_cast<std::uint64_t>(state.range(0));
+        for(auto _: state)
+            benchmark::DoNotOptimize(count_primes_naive(n));
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+    BENCHMARK(BM_CountPrimes_naive)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond);
+
+    // Segmented sieve over `[0, n)`, threads as second argument (0: one per hardware thread).
+    static void BM_CountPrimes(benchmark::State& state)
+    {
+        auto const n = static_cast<std::uint64_t>(state.range(0));
+        for(auto _: state)
+            benchmark::DoNotOptimize(count_primes(0, n, static_cast<unsigned>(state.range(1))));
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+    BENCHMARK(BM_CountPrimes)
+        ->Args({10'000'000, 1})
+        ->Args({1'000'000'000, 1})
+        ->Args({1'000'000'000, 0})
+        ->ArgNames({"n", "threads"})
+        ->Unit(benchmark::kMillisecond);
+
+    // Enumerating every prime below `n` through the callback.
+    static void BM_ForEachPrime(benchmark::State& state)
+    {
+        auto const n = static_cast<std::uint64_t>(state.range(0));
+        for(auto _: state)
+        {
+            std::uint64_t sum = 0;
+            for_each_prime(0, n, [&sum](std::uint64_t p) { sum += p; });
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+    }
+    BENCHMARK(BM_ForEachPrime)->Arg(1'000'000'000)->Unit(benchmark::kMillisecond);
+
+    static void BM_IsPrime(benchmark::State& state)
+    {
+        std::mt19937_64            gen(7);
+        std::vector<std::uint64_t> values(1024);
+        for(auto& v: values)
+            v = (gen() >> (64 - state.range(0))) | 1;
+        for(auto _: state)
+        {
+            for(std::uint64_t v: values)
+                benchmark::DoNotOptimize(is_prime(v));
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+    }
+    BENCHMARK(BM_IsPrime)->Arg(32)->Arg(64)->ArgName("bits");
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/containers/fenwick_tree.h"
+#include "qs/memory/arena.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    // One request-handling cycle: a handful of short-lived vectors and a FenwickTree, all discarded at the end
+    template<class Alloc>
+    static std::int64_t handle_request(std::int64_t n, Alloc const& alloc)
+    {
+        using int_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<int>;
+        int_alloc const ia(alloc);
+
+        std::int64_t total = 0;
+        for(int k = 0; k < 8; ++k)
+        {
+            std::vector<int, int_alloc> v(ia);
+            for(std::int64_t i = 0; i < n; ++i)
+                v.push_back(static_cast<int>(i ^ k));
+            total += v.back();
+        }
+
+        FenwickTree<int, int_alloc> tree(static_cast<std::size_t>(n), ia);
+        for(std::int64_t i = 0; i < n; ++i)
+            tree.update(static_cast<std::size_t>(i), 1);
+        return total + tree.query(static_cast<std::size_t>(n));
+    }
+
+    static void BM_Request_stdAllocator(benchmark::State& state)
+    {
+        std::allocator<int> alloc;
+        for(auto _: state)
+            benchmark::DoNotOptimize(handle_request(state.range(0), alloc));
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Request_stdAllocator)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+    static void BM_Request_arenaReset(benchmark::State& state)
+    {
+        arena a;
+        for(auto _: state)
+        {
+            benchmark::DoNotOptimize(handle_request(state.range(0), arena_allocator<int>(a)));
+            a.reset();
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Request_arenaReset)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+    static void BM_Request_inlineArenaScoped(benchmark::State& state)
+    {
+        inline_arena<16 * 1024> a;
+        for(auto _: state)
+        {
+            arena::scoped_rewind scope(a);
+            benchmark::DoNotOptimize(handle_request(state.range(0), arena_allocator<int>(a)));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Request_inlineArenaScoped)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+    // Raw allocation cost
+    static void BM_Arena_allocate(benchmark::State& state)
+    {
+        arena a;
+        std::int64_t n = 0;
+        for(auto _: state)
+        {
+            benchmark::DoNotOptimize(a.allocate(32, 8));
+            if(++n == 4096)
+            {
+                a.reset();
+                n = 0;
+            }
+        }
+    }
+    BENCHMARK(BM_Arena_allocate);
+
+    static void BM_OperatorNew_allocate(benchmark::State& state)
+    {
+        for(auto _: state)
+        {
+            void* p = ::operator new(32);
+            benchmark::DoNotOptimize(p);
+            ::operator delete(p);
+        }
+    }
+    BENCHMARK(BM_OperatorNew_allocate);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
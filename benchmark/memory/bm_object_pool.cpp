@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include "qs/config.h"
+#include "qs/memory/object_pool.h"
+
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+QS_NAMESPACE_BEGIN
+
+namespace bench
+{
+    struct Order
+    {
+        Order(std::uint64_t id, std::int64_t px, std::int64_t qty)
+            : id(id),
+              price(px),
+              quantity(qty)
+        {}
+
+        std::uint64_t id;
+        std::int64_t  price;
+        std::int64_t  quantity;
+        char          payload[40];
+    };
+
+    // Churn pattern of an order book: keep `live` orders around and replace a random one per iteration
+    template<class Create, class Destroy>
+    static void run_churn(benchmark::State& state, Create create, Destroy destroy)
+    {
+        auto const          live = static_cast<std::size_t>(state.range(0));
+        std::vector<Order*> orders(live);
+        for(std::size_t i = 0; i < live; ++i)
+            orders[i] = create(i);
+
+        std::mt19937_64                            eng(42);
+        std::uniform_int_distribution<std::size_t> dist(0, live - 1);
+        std::vector<std::size_t>                   slots(4096);
+        for(auto& s: slots)
+            s = dist(eng);
+
+        std::size_t k = 0;
+        for(auto _: state)
+        {
+            std::size_t const slot = slots[k++ & 4095];
+            destroy(orders[slot]);
+            orders[slot] = create(k);
+            benchmark::DoNotOptimize(orders[slot]);
+        }
+
+        for(auto* o: orders)
+            destroy(o);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    static void BM_Churn_newDelete(benchmark::State& state)
+    {
+        run_churn(
+            state, [](std::size_t i) { return new Order(i, 100, 1); }, [](Order* o) { delete o; });
+    }
+    BENCHMARK(BM_Churn_newDelete)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+    static void BM_Churn_objectPool(benchmark::State& state)
+    {
+        object_pool<Order> pool;
+        run_churn(
+            state, [&](std::size_t i) { return pool.create(i, 100, 1); }, [&](Order* o) { pool.destroy(o); });
+    }
+    BENCHMARK(BM_Churn_objectPool)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+    static void BM_Churn_concurrentObjectPoolLocalCache(benchmark::State& state)
+    {
+        concurrent_object_pool<Order> pool;
+        auto                          cache = pool.make_local_cache();
+        run_churn(
+            state, [&](std::size_t i) { return cache.create(i, 100, 1); }, [&](Order* o) { cache.destroy(o); });
+    }
+    BENCHMARK(BM_Churn_concurrentObjectPoolLocalCache)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+    static void BM_Churn_pmrUnsynchronizedPool(benchmark::State& state)
+    {
+        std::pmr::unsynchronized_pool_resource  resource;
+        std::pmr::polymorphic_allocator<Order> alloc(&resource);
+        run_churn(
+            state,
+            [&](std::size_t i)
+            {
+                Order* o = alloc.allocate(1);
+                alloc.construct(o, i, 100, 1);
+                return o;
+            },
+            [&](Order* o)
+            {
+                o->~Order();
+                alloc.deallocate(o, 1);
+            });
+    }
+    BENCHMARK(BM_Churn_pmrUnsynchronizedPool)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+    // Node-based container through the standard allocator adaptor
+    static void BM_PoolAllocator_list(benchmark::State& state)
+    {
+        pool_resource resource;
+        for(auto _: state)
+        {
+            std::list<Order, pool_allocator<Order>> lst{pool_allocator<Order>(resource)};
+            for(int64_t i = 0; i < state.range(0); ++i)
+                lst.emplace_back(i, 100, 1);
+            benchmark::DoNotOptimize(lst);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_PoolAllocator_list)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+    static void BM_StdAllocator_list(benchmark::State& state)
+    {
+        for(auto _: state)
+        {
+            std::list<Order> lst;
+            for(int64_t i = 0; i < state.range(0); ++i)
+                lst.emplace_back(i, 100, 1);
+            benchmark::DoNotOptimize(lst);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_StdAllocator_list)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+} // namespace bench
+
+QS_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,253 @@
+#ifndef QS_ALGORITHM_FIND_H
+#define QS_ALGORITHM_FIND_H
+
+#include <qs/algorithm/simd_ops.h>
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Kernels on raw pointers, returning the index of the first match (`n` when none) or the number of matches.
+
+    // libstdc++ unrolls `std::find` already.
+    template<class T>
+    inline std::size_t find_scalar(T const* p, std::size_t n, T value) noexcept
+    {
+        return static_cast<std::size_t>(std::find(p, p + n, value) - p);
+    }
+
+    // Fixed-width blocks of independent comparisons, which compilers vectorize for targets without a kernel.
+    template<class T>
+    inline std::size_t count_scalar(T const* p, std::size_t n, T value) noexcept
+    {
+        constexpr std::size_t lanes = 16;
+        std::size_t           count = 0;
+        std::size_t           i     = 0;
+        for(; i + lanes <= n; i += lanes)
+        {
+            std::size_t block = 0;
+            for(std::size_t l = 0; l < lanes; ++l)
+                block += p[i + l] == value ? 1 : 0;
+            count += block;
+        }
+        for(; i < n; ++i)
+            count += p[i] == value ? 1 : 0;
+        return count;
+    }
+
+
+#if QS_HAS_X86_DISPATCH
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX2, four vectors per iteration: one test of their OR keeps the loop at a load and a compare per vector.
+    // ---------------------------------------------------------------------------------------------------------
+
+    template<class T>
+    QS_TARGET_AVX2 std::size_t find_avx2(T const* p, std::size_t n, T value) noexcept
+    {
+        using ops                   = avx2_ops<T>;
+        constexpr std::size_t lanes = ops::lanes;
+        auto const            v     = ops::set1(value);
+        std::size_t           i     = 0;
+        for(; i + 4 * lanes <= n; i += 4 * lanes)
+        {
+            __m256i const e0  = ops::eq(ops::load(p + i), v);
+            __m256i const e1  = ops::eq(ops::load(p + i + lanes), v);
+            __m256i const e2  = ops::eq(ops::load(p + i + 2 * lanes), v);
+            __m256i const e3  = ops::eq(ops::load(p + i + 3 * lanes), v);
+            __m256i const any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+            if(!_mm256_testz_si256(any, any))
+            {
+                std::uint64_t const lo = ops::bits(e0) | std::uint64_t(ops::bits(e1)) << lanes;
+                if(lo != 0)
+                    return i + static_cast<std::size_t>(countr_zero(lo));
+                std::uint64_t const hi = ops::bits(e2) | std::uint64_t(ops::bits(e3)) << lanes;
+                return i + 2 * lanes + static_cast<std::size_t>(countr_zero(hi));
+            }
+        }
+        for(; i + lanes <= n; i += lanes)
+            if(std::uint32_t const bits = ops::bits(ops::eq(ops::load(p + i), v)))
+                return i + static_cast<std::size_t>(countr_zero(bits));
+        return i + find_scalar(p + i, n - i, value);
+    }
+
+    // Matches are subtracted as -1 lanes, flushed before a lane can wrap (every 255 vectors for bytes).
+    template<class T>
+    QS_TARGET_AVX2 std::size_t count_avx2(T const* p, std::size_t n, T value) noexcept
+    {
+        using ops                           = avx2_ops<T>;
+        constexpr std::size_t lanes         = ops::lanes;
+        constexpr std::size_t block_vectors = sizeof(T) == 1 ? 255 : std::size_t(0xFFFFFFFF);
+        auto const            v             = ops::set1(value);
+        std::size_t           count         = 0;
+        std::size_t           i             = 0;
+        while(i + lanes <= n)
+        {
+            std::size_t const vectors = (n - i) / lanes < block_vectors ? (n - i) / lanes : block_vectors;
+            __m256i           acc     = _mm256_setzero_si256();
+            for(std::size_t k = 0; k < vectors; ++k, i += lanes)
+            {
+                __m256i const e = ops::eq(ops::load(p + i), v);
+                acc             = sizeof(T) == 1 ? _mm256_sub_epi8(acc, e) : _mm256_sub_epi32(acc, e);
+            }
+            if(sizeof(T) == 1)
+                acc = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+            else
+                acc = _mm256_add_epi64(_mm256_and_si256(acc, _mm256_set1_epi64x(0xFFFFFFFF)),
+                                       _mm256_srli_epi64(acc, 32));
+            __m128i const s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            count += static_cast<std::size_t>(_mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1));
+        }
+        return count + count_scalar(p + i, n - i, value);
+    }
+
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX-512, compares give bit masks directly, the tail is a masked load.
+    // ---------------------------------------------------------------------------------------------------------
+
+    template<class T>
+    QS_TARGET_AVX512 std::size_t find_avx512(T const* p, std::size_t n, T value) noexcept
+    {
+        using ops                   = avx512_ops<T>;
+        using mask                  = typename ops::mask;
+        constexpr std::size_t lanes = ops::lanes;
+        auto const            v     = ops::set1(value);
+        std::size_t           i     = 0;
+        for(; i + 4 * lanes <= n; i += 4 * lanes)
+        {
+            mask const m0 = ops::eq(ops::load(p + i), v);
+            mask const m1 = ops::eq(ops::load(p + i + lanes), v);
+            mask const m2 = ops::eq(ops::load(p + i + 2 * lanes), v);
+            mask const m3 = ops::eq(ops::load(p + i + 3 * lanes), v);
+            if((m0 | m1 | m2 | m3) != 0)
+            {
+                mask const  m[4] = {m0, m1, m2, m3};
+                std::size_t k    = 0;
+                while(m[k] == 0)
+                    ++k;
+                return i + k * lanes + static_cast<std::size_t>(countr_zero(m[k]));
+            }
+        }
+        for(; i < n; i += lanes)
+        {
+            mask const tail = n - i < lanes ? ops::tail(n - i) : mask(~mask(0));
+            if(mask const m = ops::eq(ops::load(p + i, tail, v), v) & tail)
+                return i + static_cast<std::size_t>(countr_zero(m));
+        }
+        return n;
+    }
+
+    template<class T>
+    QS_TARGET_AVX512 std::size_t count_avx512(T const* p, std::size_t n, T value) noexcept
+    {
+        using ops                   = avx512_ops<T>;
+        using mask                  = typename ops::mask;
+        constexpr std::size_t lanes = ops::lanes;
+        auto const            v     = ops::set1(value);
+        std::size_t           count = 0;
+        std::size_t           i     = 0;
+        for(; i + lanes <= n; i += lanes)
+            count += static_cast<std::size_t>(popcount(ops::eq(ops::load(p + i), v)));
+        if(i < n)
+        {
+            mask const tail = ops::tail(n - i);
+            count += static_cast<std::size_t>(popcount(mask(ops::eq(ops::load(p + i, tail, v), v) & tail)));
+        }
+        return count;
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+
+
+    template<class T>
+    QS_INLINE std::size_t find_dispatch(T const* p, std::size_t n, T value) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return find_avx512(p, n, value);
+            case simd_level::avx2: return find_avx2(p, n, value);
+            case simd_level::scalar: break;
+        }
+#endif
+        return find_scalar(p, n, value);
+    }
+
+    template<class T>
+    QS_INLINE std::size_t count_dispatch(T const* p, std::size_t n, T value) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return count_avx512(p, n, value);
+            case simd_level::avx2: return count_avx2(p, n, value);
+            case simd_level::scalar: break;
+        }
+#endif
+        return count_scalar(p, n, value);
+    }
+
+    // `value` as the kernel's lane type, bit for bit.
+    template<class Lane, class T>
+    QS_INLINE Lane as_lane(T const& value) noexcept
+    {
+        static_assert(sizeof(Lane) == sizeof(T), "as_lane: size mismatch");
+        Lane lane;
+        std::memcpy(&lane, &value, sizeof(lane));
+        return lane;
+    }
+} // namespace intl
+
+
+/**
+ * `std::find` and `std::count` over a span, vectorized with AVX-512/AVX2 when the CPU supports it (see
+ * `active_simd_level()`) for 1-byte types (a `memchr`), 4-byte integers and `float`. Other types, and other
+ * targets, run a plain loop. `find` returns an iterator to the first element equal to `value`, or `s.end()`.
+ * Floats compare with `==`: `-0.f` finds `0.f` and NaN finds nothing.
+ *
+ * Usage:
+ *      if(qs::find(ids, id) != ids.end())   // ids: qs::span<std::int32_t const>
+ *          ...
+ *      std::size_t newlines = qs::count(qs::span<char const>(text, size), '\n');
+ */
+template<class T, size_t E>
+QS_NODISCARD typename span<T, E>::iterator find(span<T, E> s, type_identity_t<remove_cv_t<T>> const& value) noexcept
+{
+    using value_type = remove_cv_t<T>;
+    using lane       = intl::simd_equality_lane_t<value_type>;
+    if constexpr(std::is_void<lane>::value)
+        return s.begin() + intl::find_scalar<value_type>(s.data(), s.size(), value);
+    else
+        return s.begin() + intl::find_dispatch(reinterpret_cast<lane const*>(s.data()), s.size(),
+                                               intl::as_lane<lane>(value));
+}
+
+template<class T, size_t E>
+QS_NODISCARD std::size_t count(span<T, E> s, type_identity_t<remove_cv_t<T>> const& value) noexcept
+{
+    using value_type = remove_cv_t<T>;
+    using lane       = intl::simd_equality_lane_t<value_type>;
+    if constexpr(std::is_void<lane>::value)
+        return intl::count_scalar<value_type>(s.data(), s.size(), value);
+    else
+        return intl::count_dispatch(reinterpret_cast<lane const*>(s.data()), s.size(), intl::as_lane<lane>(value));
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_FIND_H
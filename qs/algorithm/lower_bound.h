@@ -0,0 +1,47 @@
+#ifndef QS_ALGORITHM_LOWER_BOUND_H
+#define QS_ALGORITHM_LOWER_BOUND_H
+
+#include <qs/config.h>
+#include <qs/span.h>
+
+#include <cstddef>
+#include <functional>
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * `std::lower_bound` over a sorted span without a data-dependent branch: the range halves on every step whatever
+ * the comparison gives, and the comparison only selects the next base with a conditional move. The loop runs
+ * ceil(log2(n)) steps with nothing for the branch predictor to miss. Both elements the next step can probe are
+ * prefetched, which overlaps the cache misses of two steps once the span outgrows the caches.
+ *
+ * Returns an iterator to the first element `e` for which `comp(e, value)` is false, or `s.end()`.
+ * For repeated lookups into a fixed set, `static_search_tree` touches fewer cache lines.
+ *
+ * Usage:
+ *      auto it = qs::lower_bound(qs::span<std::int64_t const>(prices), price);
+ */
+template<class T, size_t E, class U, class Compare = std::less<>>
+QS_NODISCARD typename span<T, E>::iterator lower_bound(span<T, E> s, U const& value, Compare comp = Compare())
+{
+    if(s.empty())
+        return s.end();
+
+    T*          base = s.data();
+    std::size_t n    = s.size();
+    while(n > 1)
+    {
+        std::size_t const half = n / 2;
+        n -= half;
+        QS_PREFETCH(base + n / 2);
+        QS_PREFETCH(base + half + n / 2);
+        base = comp(base[half], value) ? base + half : base;
+    }
+    return s.begin() + ((base - s.data()) + (comp(*base, value) ? 1 : 0));
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_LOWER_BOUND_H
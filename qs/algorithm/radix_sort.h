@@ -0,0 +1,365 @@
+#ifndef QS_ALGORITHM_RADIX_SORT_H
+#define QS_ALGORITHM_RADIX_SORT_H
+
+#include <qs/config.h>
+#include <qs/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if QS_X86_64
+#include <emmintrin.h>
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Unsigned image of a key with the same order: signed integers flip the sign bit, floating-point values flip
+    // every bit when negative and the sign bit otherwise (so -0 sorts before +0, and NaNs at the ends by sign).
+    template<class K, class = void>
+    struct radix_key_traits;
+
+    template<class K>
+    struct radix_key_traits<K, enable_if_t<std::is_integral<K>::value && !std::is_same<K, bool>::value>>
+    {
+        using bits_type = typename std::make_unsigned<K>::type;
+
+        QS_INLINE static bits_type to_bits(K key) noexcept
+        {
+            constexpr bits_type sign = std::is_signed<K>::value ? bits_type(bits_type(1) << (8 * sizeof(K) - 1)) : 0;
+            return static_cast<bits_type>(static_cast<bits_type>(key) ^ sign);
+        }
+    };
+
+    template<class K>
+    struct radix_key_traits<K, enable_if_t<std::is_floating_point<K>::value && (sizeof(K) == 4 || sizeof(K) == 8)>>
+    {
+        using bits_type = conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>;
+
+        QS_INLINE static bits_type to_bits(K key) noexcept
+        {
+            constexpr unsigned sign_shift = 8 * sizeof(K) - 1;
+            bits_type          bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            bits_type const flip = static_cast<bits_type>(bits_type(0) - (bits >> sign_shift)) |
+                                   static_cast<bits_type>(bits_type(1) << sign_shift);
+            return bits ^ flip;
+        }
+    };
+
+    template<class K, class = void>
+    struct is_radix_key : std::false_type
+    {};
+
+    template<class K>
+    struct is_radix_key<K, void_t<decltype(radix_key_traits<K>::to_bits(std::declval<K>()))>> : std::true_type
+    {};
+
+    // Stands for the payload of key-only sorts: every operation on it compiles to nothing.
+    struct radix_no_payload
+    {};
+
+    constexpr std::size_t radix_buckets = 256;
+
+    // At or below this size an insertion sort beats the histogram setup.
+    constexpr std::size_t radix_insertion_max = 64;
+
+    // Histograms are counted by several threads from this many keys per thread.
+    constexpr std::size_t radix_parallel_min_part = std::size_t(1) << 17;
+
+    // Scatter passes buffer keys per bucket from this size, when the destination no longer fits in cache.
+    constexpr std::size_t radix_buffered_min = std::size_t(1) << 18;
+
+    template<class K>
+    QS_INLINE std::size_t radix_digit(K key, unsigned shift) noexcept
+    {
+        return static_cast<std::size_t>((radix_key_traits<K>::to_bits(key) >> shift) & 0xFF);
+    }
+
+    template<class K, class V>
+    void radix_insertion_sort(K* keys, V* values, std::size_t n) noexcept
+    {
+        constexpr bool has_payload = !std::is_same<V, radix_no_payload>::value;
+        for(std::size_t i = 1; i < n; ++i)
+        {
+            K const     key  = keys[i];
+            auto const  bits = radix_key_traits<K>::to_bits(key);
+            std::size_t j    = i;
+            if(has_payload)
+            {
+                V const value = values[i];
+                for(; j > 0 && bits < radix_key_traits<K>::to_bits(keys[j - 1]); --j)
+                {
+                    keys[j]   = keys[j - 1];
+                    values[j] = values[j - 1];
+                }
+                values[j] = value;
+            }
+            else
+            {
+                for(; j > 0 && bits < radix_key_traits<K>::to_bits(keys[j - 1]); --j)
+                    keys[j] = keys[j - 1];
+            }
+            keys[j] = key;
+        }
+    }
+
+    // Counts of every digit of `keys[0, n)` in one read, `counts[d]` for the digit at bit `8 * d`.
+    template<class K>
+    void radix_count(K const* keys, std::size_t n, std::size_t (*counts)[radix_buckets]) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            auto const bits = radix_key_traits<K>::to_bits(keys[i]);
+            for(std::size_t d = 0; d < sizeof(K); ++d)
+                ++counts[d][static_cast<std::size_t>((bits >> (8 * d)) & 0xFF)];
+        }
+    }
+
+    // Same, split among `threads` threads (0 for one per hardware thread) that count their part into private
+    // histograms, summed at the end.
+    template<class K>
+    void radix_count(K const* keys, std::size_t n, std::size_t (*counts)[radix_buckets], unsigned threads)
+    {
+        std::size_t const max_parts = n / radix_parallel_min_part;
+        if(max_parts <= 1 || threads == 1)
+            return radix_count(keys, n, counts);
+        if(threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t const parts = std::min<std::size_t>(threads, max_parts);
+        if(parts <= 1)
+            return radix_count(keys, n, counts);
+
+        constexpr std::size_t    size = sizeof(K) * radix_buckets;
+        std::vector<std::size_t> private_counts((parts - 1) * size);
+        std::size_t const        part = (n + parts - 1) / parts;
+        std::vector<std::thread> workers;
+        workers.reserve(parts - 1);
+        for(std::size_t t = 1; t < parts; ++t)
+        {
+            auto* const local = reinterpret_cast<std::size_t(*)[radix_buckets]>(&private_counts[(t - 1) * size]);
+            std::size_t const first = std::min(n, t * part), last = std::min(n, (t + 1) * part);
+            workers.emplace_back([=] { radix_count(keys + first, last - first, local); });
+        }
+        radix_count(keys, std::min(n, part), counts);
+        for(auto& w: workers)
+            w.join();
+        for(std::size_t i = 0; i < private_counts.size(); ++i)
+            counts[i % size / radix_buckets][i % radix_buckets] += private_counts[i];
+    }
+
+    // Copies a whole cache line to `dst`, aligned, with non-temporal stores where available: the line is not
+    // read first (it is entirely overwritten) and does not evict the buffers from the cache.
+    QS_INLINE void stream_line(void* dst, void const* src) noexcept
+    {
+#if QS_X86_64
+        for(std::size_t i = 0; i < QS_CACHELINE_SIZE / sizeof(__m128i); ++i)
+            _mm_stream_si128(static_cast<__m128i*>(dst) + i, _mm_load_si128(static_cast<__m128i const*>(src) + i));
+#else
+        std::memcpy(dst, src, QS_CACHELINE_SIZE);
+#endif
+    }
+
+    // Orders the non-temporal stores before the stores that follow.
+    QS_INLINE void stream_fence() noexcept
+    {
+#if QS_X86_64
+        _mm_sfence();
+#endif
+    }
+
+    // One stable scatter by the digit at `shift`, `offsets` holding where each bucket starts in `dst`.
+    template<class K, class V>
+    void radix_scatter(K const* src, K* dst, V const* values, V* values_dst, std::size_t n, unsigned shift,
+                       std::size_t* offsets) noexcept
+    {
+        constexpr bool has_payload = !std::is_same<V, radix_no_payload>::value;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            std::size_t const p = offsets[radix_digit(src[i], shift)]++;
+            dst[p]              = src[i];
+            if(has_payload)
+                values_dst[p] = values[i];
+        }
+    }
+
+    // Same through software write-combining: each bucket collects its keys in a cache line sized buffer that
+    // mirrors the destination line they go to, streamed out whole once the line is complete. The 256 buffers
+    // stay in L1 and every destination line is written once, without being read, instead of one store per key
+    // each missing the cache and the TLB. Payloads ride along in buffers of the same number of elements.
+    template<class K, class V>
+    void radix_scatter_buffered(K const* src, K* dst, V const* values, V* values_dst, std::size_t n,
+                                unsigned shift, std::size_t* offsets) noexcept
+    {
+        constexpr bool        has_payload = !std::is_same<V, radix_no_payload>::value;
+        constexpr std::size_t line        = QS_CACHELINE_SIZE / sizeof(K);
+        // `first[b]`: where bucket `b` starts in `dst`, its first line may be partial
+        std::size_t first[radix_buckets];
+        std::memcpy(first, offsets, sizeof(first));
+        // position of `dst[0]` within its cache line, in elements
+        std::size_t const skew = (reinterpret_cast<std::uintptr_t>(dst) / sizeof(K)) % line;
+
+        alignas(QS_CACHELINE_SIZE) K buffer[radix_buckets][line];
+        alignas(QS_CACHELINE_SIZE) V value_buffer[has_payload ? radix_buckets : 1][line];
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            std::size_t const b    = radix_digit(src[i], shift);
+            std::size_t const p    = offsets[b]++;
+            std::size_t const slot = (p + skew) % line;
+            buffer[b][slot]        = src[i];
+            if(has_payload)
+                value_buffer[b][slot] = values[i];
+            if(slot == line - 1)
+            {
+                // the whole line, or its part from where the bucket starts
+                std::size_t const count = std::min(line, p + 1 - first[b]);
+                if(count == line)
+                    stream_line(dst + p + 1 - line, buffer[b]);
+                else
+                    std::memcpy(dst + p + 1 - count, &buffer[b][line - count], count * sizeof(K));
+                if(has_payload && count == line)
+                    std::memcpy(values_dst + p + 1 - line, value_buffer[b], sizeof(value_buffer[b]));
+                else if(has_payload)
+                    std::memcpy(values_dst + p + 1 - count, &value_buffer[b][line - count], count * sizeof(V));
+            }
+        }
+        stream_fence();
+        // partial last lines
+        for(std::size_t b = 0; b < radix_buckets; ++b)
+        {
+            std::size_t const end   = offsets[b];
+            std::size_t const count = std::min((end + skew) % line, end - first[b]);
+            if(count == 0)
+                continue;
+            std::size_t const slot = (end + skew - count) % line;
+            std::memcpy(dst + end - count, &buffer[b][slot], count * sizeof(K));
+            if(has_payload)
+                std::memcpy(values_dst + end - count, &value_buffer[b][slot], count * sizeof(V));
+        }
+    }
+
+    // LSD radix sort of `keys` (and `values` alongside) by 8-bit digits, `scratch` holding as many elements.
+    // Digits equal in every key cost no pass. The result ends in `keys`, copied back after an odd number of
+    // passes.
+    template<class K, class V>
+    void radix_sort(K* keys, K* scratch, V* values, V* values_scratch, std::size_t n, unsigned threads)
+    {
+        constexpr bool has_payload = !std::is_same<V, radix_no_payload>::value;
+        if(n <= radix_insertion_max)
+            return radix_insertion_sort(keys, values, n);
+
+        std::size_t counts[sizeof(K)][radix_buckets] = {};
+        radix_count(keys, n, counts, threads);
+
+        // no buffered scatters with payloads whose buffers would not fit in L1 next to the keys'
+        constexpr bool bufferable = !has_payload || sizeof(V) <= 2 * sizeof(K);
+        K*             src        = keys;
+        K*             dst        = scratch;
+        V*             vsrc       = values;
+        V*             vdst       = values_scratch;
+        for(unsigned d = 0; d < sizeof(K); ++d)
+        {
+            unsigned const shift = 8 * d;
+            if(counts[d][radix_digit(src[0], shift)] == n)
+                continue;
+
+            std::size_t offsets[radix_buckets];
+            std::size_t sum = 0;
+            for(std::size_t b = 0; b < radix_buckets; ++b)
+            {
+                offsets[b] = sum;
+                sum += counts[d][b];
+            }
+            if constexpr(bufferable)
+            {
+                if(n >= radix_buffered_min)
+                    radix_scatter_buffered(src, dst, vsrc, vdst, n, shift, offsets);
+                else
+                    radix_scatter(src, dst, vsrc, vdst, n, shift, offsets);
+            }
+            else
+                radix_scatter(src, dst, vsrc, vdst, n, shift, offsets);
+            std::swap(src, dst);
+            std::swap(vsrc, vdst);
+        }
+        if(src != keys)
+        {
+            std::memcpy(keys, src, n * sizeof(K));
+            if(has_payload)
+                std::memcpy(values, vsrc, n * sizeof(V));
+        }
+    }
+} // namespace intl
+
+
+/**
+ * Sorts integer or floating-point keys in ascending order with an LSD radix sort: 8-bit digits, the counts of
+ * every digit taken in a single read, then one stable scatter per digit that differs between keys. Large inputs
+ * scatter through cache line sized buffers (software write-combining) streamed to memory. O(n) time for a fixed
+ * key width, against O(n log n) comparisons for `std::sort`, which is as fast up to about a thousand keys.
+ *
+ * Signed keys sort as integers, floating-point keys as their values, with `-0.0` before `+0.0` and NaNs at
+ * the ends (at the start with the sign bit set, at the end otherwise).
+ *
+ * The `scratch` overloads are allocation free: `scratch` needs at least as many elements as `keys` (its
+ * contents are overwritten). With `threads` other than 1 (0 for one per hardware thread), large inputs count
+ * digits in parallel, which starts threads and allocates their histograms.
+ *
+ * Usage:
+ *      qs::radix_sort(qs::make_span(indices));
+ *      qs::radix_sort(qs::make_span(indices), qs::make_span(scratch));   // reuses `scratch` between batches
+ */
+template<class K>
+void radix_sort(span<K> keys, span<K> scratch, unsigned threads = 1)
+{
+    static_assert(intl::is_radix_key<K>::value, "radix_sort: keys must be integers or floating-point");
+    QS_VERIFY(scratch.size() >= keys.size(), "radix_sort: scratch smaller than keys");
+    intl::radix_no_payload* none = nullptr;
+    intl::radix_sort(keys.data(), scratch.data(), none, none, keys.size(), threads);
+}
+
+template<class K>
+void radix_sort(span<K> keys, unsigned threads = 1)
+{
+    std::vector<K> scratch(keys.size());
+    radix_sort(keys, make_span(scratch), threads);
+}
+
+/**
+ * Same, moving `values[i]` along with `keys[i]` (a stable sort of the pairs by key), the payload being
+ * trivially copyable. `value_scratch` needs at least as many elements as `values`.
+ *
+ * Usage:
+ *      qs::radix_sort_by_key(qs::make_span(update_index), qs::make_span(update_delta));
+ */
+template<class K, class V>
+void radix_sort_by_key(span<K> keys, span<V> values, span<K> scratch, span<V> value_scratch, unsigned threads = 1)
+{
+    static_assert(intl::is_radix_key<K>::value, "radix_sort_by_key: keys must be integers or floating-point");
+    static_assert(std::is_trivially_copyable<V>::value, "radix_sort: values must be trivially copyable");
+    QS_VERIFY(values.size() == keys.size(), "radix_sort_by_key: keys and values size mismatch");
+    QS_VERIFY(scratch.size() >= keys.size() && value_scratch.size() >= keys.size(),
+              "radix_sort_by_key: scratch smaller than keys");
+    intl::radix_sort(keys.data(), scratch.data(), values.data(), value_scratch.data(), keys.size(), threads);
+}
+
+template<class K, class V>
+void radix_sort_by_key(span<K> keys, span<V> values, unsigned threads = 1)
+{
+    std::vector<K> scratch(keys.size());
+    std::vector<V> value_scratch(keys.size());
+    radix_sort_by_key(keys, values, make_span(scratch), make_span(value_scratch), threads);
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_RADIX_SORT_H
@@ -0,0 +1,490 @@
+#ifndef QS_ALGORITHM_REDUCE_H
+#define QS_ALGORITHM_REDUCE_H
+
+#include <qs/algorithm/find.h>
+#include <qs/algorithm/simd_ops.h>
+#include <qs/config.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Integers are summed in 64 bits whatever their width, floating-point values in their own type.
+    template<class T>
+    using sum_result_t = conditional_t<std::is_floating_point<T>::value, T,
+                                       conditional_t<std::is_signed<T>::value, std::int64_t, std::uint64_t>>;
+
+    // Kernels on raw pointers. The scalar ones keep `lanes` independent accumulators, the same shape as the vector
+    // kernels, which lets compilers vectorize them for targets without a kernel (and floating-point sums too).
+
+    template<class T>
+    inline std::pair<T, T> minmax_scalar(T const* p, std::size_t n) noexcept
+    {
+        T lo = p[0], hi = p[0];
+        for(std::size_t i = 1; i < n; ++i)
+        {
+            lo = p[i] < lo ? p[i] : lo;
+            hi = hi < p[i] ? p[i] : hi;
+        }
+        return {lo, hi};
+    }
+
+    template<class T>
+    inline sum_result_t<T> sum_scalar(T const* p, std::size_t n) noexcept
+    {
+        using result                = sum_result_t<T>;
+        constexpr std::size_t lanes = 16;
+        result                acc[lanes] = {};
+        std::size_t           i          = 0;
+        for(; i + lanes <= n; i += lanes)
+            for(std::size_t l = 0; l < lanes; ++l)
+                acc[l] += static_cast<result>(p[i + l]);
+        result sum = 0;
+        for(result x: acc)
+            sum += x;
+        for(; i < n; ++i)
+            sum += static_cast<result>(p[i]);
+        return sum;
+    }
+
+    template<class T>
+    inline sum_result_t<T> dot_scalar(T const* a, T const* b, std::size_t n) noexcept
+    {
+        using result                = sum_result_t<T>;
+        constexpr std::size_t lanes = 16;
+        result                acc[lanes] = {};
+        std::size_t           i          = 0;
+        for(; i + lanes <= n; i += lanes)
+            for(std::size_t l = 0; l < lanes; ++l)
+                acc[l] += static_cast<result>(a[i + l]) * static_cast<result>(b[i + l]);
+        result dot = 0;
+        for(result x: acc)
+            dot += x;
+        for(; i < n; ++i)
+            dot += static_cast<result>(a[i]) * static_cast<result>(b[i]);
+        return dot;
+    }
+
+
+#if QS_HAS_X86_DISPATCH
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX2. Integer sums widen to 64-bit lanes, float sums and dot products run four vector accumulators.
+    // ---------------------------------------------------------------------------------------------------------
+
+    template<class T>
+    QS_TARGET_AVX2 std::pair<T, T> minmax_avx2(T const* p, std::size_t n) noexcept
+    {
+        using ops                   = avx2_ops<T>;
+        constexpr std::size_t lanes = ops::lanes;
+        if(n < 2 * lanes)
+            return minmax_scalar(p, n);
+
+        auto        lo0 = ops::load(p), lo1 = ops::load(p + lanes);
+        auto        hi0 = lo0, hi1 = lo1;
+        std::size_t i   = 2 * lanes;
+        for(; i + 2 * lanes <= n; i += 2 * lanes)
+        {
+            auto const x0 = ops::load(p + i);
+            auto const x1 = ops::load(p + i + lanes);
+            lo0           = ops::min(lo0, x0);
+            lo1           = ops::min(lo1, x1);
+            hi0           = ops::max(hi0, x0);
+            hi1           = ops::max(hi1, x1);
+        }
+        lo0 = ops::min(lo0, lo1);
+        hi0 = ops::max(hi0, hi1);
+        for(; i + lanes <= n; i += lanes)
+        {
+            auto const x = ops::load(p + i);
+            lo0          = ops::min(lo0, x);
+            hi0          = ops::max(hi0, x);
+        }
+        // The last vector overlaps elements already seen, harmless for min and max.
+        auto const x = ops::load(p + n - lanes);
+        lo0          = ops::min(lo0, x);
+        hi0          = ops::max(hi0, x);
+
+        T los[lanes], his[lanes];
+        ops::store(los, lo0);
+        ops::store(his, hi0);
+        std::pair<T, T> const l = minmax_scalar(los, lanes), h = minmax_scalar(his, lanes);
+        return {l.first, h.second};
+    }
+
+    QS_TARGET_AVX2 inline std::int64_t hsum_epi64_avx2(__m256i v) noexcept
+    {
+        __m128i const s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+    }
+
+    QS_TARGET_AVX2 inline float hsum_ps_avx2(__m256 v) noexcept
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s        = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s        = _mm_add_ss(s, _mm_movehdup_ps(s));
+        return _mm_cvtss_f32(s);
+    }
+
+    QS_TARGET_AVX2 inline std::uint64_t sum_avx2(std::uint8_t const* p, std::size_t n) noexcept
+    {
+        __m256i const zero = _mm256_setzero_si256();
+        __m256i       acc0 = zero, acc1 = zero;
+        std::size_t   i    = 0;
+        for(; i + 64 <= n; i += 64)
+        {
+            acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(avx2_ops<std::uint8_t>::load(p + i), zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(avx2_ops<std::uint8_t>::load(p + i + 32), zero));
+        }
+        auto const sum = static_cast<std::uint64_t>(hsum_epi64_avx2(_mm256_add_epi64(acc0, acc1)));
+        return sum + sum_scalar(p + i, n - i);
+    }
+
+    // Signed and unsigned 32-bit integers, sign- or zero-extended.
+    template<class T>
+    QS_TARGET_AVX2 sum_result_t<T> sum_avx2(T const* p, std::size_t n) noexcept
+    {
+        __m256i     acc0 = _mm256_setzero_si256(), acc1 = acc0;
+        std::size_t i    = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const x  = avx2_ops<T>::load(p + i);
+            __m128i const lo = _mm256_castsi256_si128(x), hi = _mm256_extracti128_si256(x, 1);
+            if(std::is_signed<T>::value)
+            {
+                acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(lo));
+                acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(hi));
+            }
+            else
+            {
+                acc0 = _mm256_add_epi64(acc0, _mm256_cvtepu32_epi64(lo));
+                acc1 = _mm256_add_epi64(acc1, _mm256_cvtepu32_epi64(hi));
+            }
+        }
+        auto const sum = static_cast<sum_result_t<T>>(hsum_epi64_avx2(_mm256_add_epi64(acc0, acc1)));
+        return sum + sum_scalar(p + i, n - i);
+    }
+
+    QS_TARGET_AVX2 inline float sum_avx2(float const* p, std::size_t n) noexcept
+    {
+        __m256      acc0 = _mm256_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        std::size_t i    = 0;
+        for(; i + 32 <= n; i += 32)
+        {
+            acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(p + i));
+            acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(p + i + 8));
+            acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(p + i + 16));
+            acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(p + i + 24));
+        }
+        for(; i + 8 <= n; i += 8)
+            acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(p + i));
+        float sum = hsum_ps_avx2(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+        for(; i < n; ++i)
+            sum += p[i];
+        return sum;
+    }
+
+    QS_TARGET_AVX2 inline float dot_avx2(float const* a, float const* b, std::size_t n) noexcept
+    {
+        __m256      acc0 = _mm256_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        std::size_t i    = 0;
+        for(; i + 32 <= n; i += 32)
+        {
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16)));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24)));
+        }
+        for(; i + 8 <= n; i += 8)
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        float dot = hsum_ps_avx2(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+        for(; i < n; ++i)
+            dot += a[i] * b[i];
+        return dot;
+    }
+
+    // `vpmuldq` multiplies the even lanes into 64-bit products, the odd ones are shifted down first.
+    QS_TARGET_AVX2 inline std::int64_t dot_avx2(std::int32_t const* a, std::int32_t const* b, std::size_t n) noexcept
+    {
+        __m256i     acc0 = _mm256_setzero_si256(), acc1 = acc0;
+        std::size_t i    = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const x = avx2_ops<std::int32_t>::load(a + i);
+            __m256i const y = avx2_ops<std::int32_t>::load(b + i);
+            acc0            = _mm256_add_epi64(acc0, _mm256_mul_epi32(x, y));
+            acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+        }
+        return hsum_epi64_avx2(_mm256_add_epi64(acc0, acc1)) + dot_scalar(a + i, b + i, n - i);
+    }
+
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX-512, same shapes, tails are masked loads of a neutral value.
+    // ---------------------------------------------------------------------------------------------------------
+
+    template<class T>
+    QS_TARGET_AVX512 std::pair<T, T> minmax_avx512(T const* p, std::size_t n) noexcept
+    {
+        using ops                   = avx512_ops<T>;
+        constexpr std::size_t lanes = ops::lanes;
+        auto const            first = ops::set1(p[0]);
+        auto                  lo0 = first, lo1 = first, hi0 = first, hi1 = first;
+        std::size_t           i   = 0;
+        for(; i + 2 * lanes <= n; i += 2 * lanes)
+        {
+            auto const x0 = ops::load(p + i);
+            auto const x1 = ops::load(p + i + lanes);
+            lo0           = ops::min(lo0, x0);
+            lo1           = ops::min(lo1, x1);
+            hi0           = ops::max(hi0, x0);
+            hi1           = ops::max(hi1, x1);
+        }
+        for(; i < n; i += lanes)
+        {
+            auto const x = ops::load(p + i, n - i < lanes ? ops::tail(n - i) : typename ops::mask(~0ull), first);
+            lo0          = ops::min(lo0, x);
+            hi0          = ops::max(hi0, x);
+        }
+
+        T los[lanes], his[lanes];
+        ops::store(los, ops::min(lo0, lo1));
+        ops::store(his, ops::max(hi0, hi1));
+        std::pair<T, T> const l = minmax_scalar(los, lanes), h = minmax_scalar(his, lanes);
+        return {l.first, h.second};
+    }
+
+    QS_TARGET_AVX512 inline std::uint64_t sum_avx512(std::uint8_t const* p, std::size_t n) noexcept
+    {
+        __m512i const zero = _mm512_setzero_si512();
+        __m512i       acc  = zero;
+        std::size_t   i    = 0;
+        for(; i + 64 <= n; i += 64)
+            acc = _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_loadu_si512(p + i), zero));
+        if(i < n)
+        {
+            __mmask64 const m = _bzhi_u64(~0ull, static_cast<unsigned>(n - i));
+            acc               = _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_maskz_loadu_epi8(m, p + i), zero));
+        }
+        return static_cast<std::uint64_t>(_mm512_reduce_add_epi64(acc));
+    }
+
+    template<class T>
+    QS_TARGET_AVX512 sum_result_t<T> sum_avx512(T const* p, std::size_t n) noexcept
+    {
+        __m512i     acc0 = _mm512_setzero_si512(), acc1 = acc0;
+        std::size_t i    = 0;
+        for(; i < n; i += 16)
+        {
+            __mmask16 const m  = step_mask16(n - i);
+            __m512i const   x  = _mm512_maskz_loadu_epi32(m, p + i);
+            __m256i const   lo = _mm512_castsi512_si256(x), hi = _mm512_extracti64x4_epi64(x, 1);
+            if(std::is_signed<T>::value)
+            {
+                acc0 = _mm512_add_epi64(acc0, _mm512_cvtepi32_epi64(lo));
+                acc1 = _mm512_add_epi64(acc1, _mm512_cvtepi32_epi64(hi));
+            }
+            else
+            {
+                acc0 = _mm512_add_epi64(acc0, _mm512_cvtepu32_epi64(lo));
+                acc1 = _mm512_add_epi64(acc1, _mm512_cvtepu32_epi64(hi));
+            }
+        }
+        return static_cast<sum_result_t<T>>(_mm512_reduce_add_epi64(_mm512_add_epi64(acc0, acc1)));
+    }
+
+    QS_TARGET_AVX512 inline float sum_avx512(float const* p, std::size_t n) noexcept
+    {
+        __m512      acc0 = _mm512_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        std::size_t i    = 0;
+        for(; i + 64 <= n; i += 64)
+        {
+            acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(p + i));
+            acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(p + i + 16));
+            acc2 = _mm512_add_ps(acc2, _mm512_loadu_ps(p + i + 32));
+            acc3 = _mm512_add_ps(acc3, _mm512_loadu_ps(p + i + 48));
+        }
+        for(; i < n; i += 16)
+        {
+            __mmask16 const m = step_mask16(n - i);
+            acc0              = _mm512_add_ps(acc0, _mm512_maskz_loadu_ps(m, p + i));
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+    }
+
+    QS_TARGET_AVX512 inline float dot_avx512(float const* a, float const* b, std::size_t n) noexcept
+    {
+        __m512      acc0 = _mm512_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        std::size_t i    = 0;
+        for(; i + 64 <= n; i += 64)
+        {
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+            acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+            acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+        }
+        for(; i < n; i += 16)
+        {
+            __mmask16 const m = step_mask16(n - i);
+            acc0              = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), acc0);
+        }
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+    }
+
+    QS_TARGET_AVX512 inline std::int64_t dot_avx512(std::int32_t const* a, std::int32_t const* b,
+                                                    std::size_t n) noexcept
+    {
+        __m512i     acc0 = _mm512_setzero_si512(), acc1 = acc0;
+        std::size_t i    = 0;
+        for(; i < n; i += 16)
+        {
+            __mmask16 const m = step_mask16(n - i);
+            __m512i const   x = _mm512_maskz_loadu_epi32(m, a + i);
+            __m512i const   y = _mm512_maskz_loadu_epi32(m, b + i);
+            acc0              = _mm512_add_epi64(acc0, _mm512_mul_epi32(x, y));
+            acc1 = _mm512_add_epi64(acc1, _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32)));
+        }
+        return _mm512_reduce_add_epi64(_mm512_add_epi64(acc0, acc1));
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+
+
+    // Dispatchers, for the types with a kernel.
+
+    template<class T>
+    QS_INLINE std::pair<T, T> minmax_dispatch(T const* p, std::size_t n) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return minmax_avx512(p, n);
+            case simd_level::avx2: return minmax_avx2(p, n);
+            case simd_level::scalar: break;
+        }
+#endif
+        return minmax_scalar(p, n);
+    }
+
+    template<class T>
+    QS_INLINE sum_result_t<T> sum_dispatch(T const* p, std::size_t n) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return sum_avx512(p, n);
+            case simd_level::avx2: return sum_avx2(p, n);
+            case simd_level::scalar: break;
+        }
+#endif
+        return sum_scalar(p, n);
+    }
+
+    template<class T>
+    QS_INLINE sum_result_t<T> dot_dispatch(T const* a, T const* b, std::size_t n) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return dot_avx512(a, b, n);
+            case simd_level::avx2: return dot_avx2(a, b, n);
+            case simd_level::scalar: break;
+        }
+#endif
+        return dot_scalar(a, b, n);
+    }
+} // namespace intl
+
+
+/**
+ * Reductions over a span, vectorized with AVX-512/AVX2 when the CPU supports it (see `active_simd_level()`):
+ * `min_value`, `max_value`, `minmax_value`, `argmin` and `argmax` for `std::int32_t`, `std::uint32_t`,
+ * `std::uint8_t` and `float`; `sum` for the same types; `dot` for `std::int32_t` and `float`. Other types, and
+ * other targets, run plain loops shaped for the auto-vectorizer.
+ *
+ * Integers are summed in 64 bits (`std::int64_t` or `std::uint64_t`), so `sum` of 32-bit values does not overflow.
+ * Floating-point sums and dot products add in lanes, in an order that depends on the instruction set (and AVX-512
+ * fuses the multiply-adds): the result may differ from a serial loop in the last bits. The minimum and maximum of
+ * floats are unspecified when the span holds NaNs.
+ *
+ * `argmin` and `argmax` return the index of the first minimum or maximum, as `std::min_element` and
+ * `std::max_element` (not `std::minmax_element`, which returns the last maximum). The span must not be empty for
+ * all of these but `sum` and `dot`.
+ *
+ * Usage:
+ *      std::int64_t total = qs::sum(qs::make_span(counts));
+ *      float        score = qs::dot(qs::make_span(weights), qs::make_span(features));
+ *      std::size_t  best  = qs::argmax(qs::make_span(scores));
+ */
+template<class T, size_t E>
+QS_NODISCARD std::pair<remove_cv_t<T>, remove_cv_t<T>> minmax_value(span<T, E> s)
+    noexcept(is_nothrow_contract_violation)
+{
+    using value_type = remove_cv_t<T>;
+    QS_VERIFY(!s.empty(), "minmax_value: empty span");
+    if constexpr(std::is_void<intl::simd_ordered_lane_t<value_type>>::value)
+        return intl::minmax_scalar<value_type>(s.data(), s.size());
+    else
+        return intl::minmax_dispatch<value_type>(s.data(), s.size());
+}
+
+template<class T, size_t E>
+QS_NODISCARD remove_cv_t<T> min_value(span<T, E> s) noexcept(is_nothrow_contract_violation)
+{
+    return minmax_value(s).first;
+}
+
+template<class T, size_t E>
+QS_NODISCARD remove_cv_t<T> max_value(span<T, E> s) noexcept(is_nothrow_contract_violation)
+{
+    return minmax_value(s).second;
+}
+
+template<class T, size_t E>
+QS_NODISCARD std::size_t argmin(span<T, E> s) noexcept(is_nothrow_contract_violation)
+{
+    return static_cast<std::size_t>(find(s, min_value(s)) - s.begin());
+}
+
+template<class T, size_t E>
+QS_NODISCARD std::size_t argmax(span<T, E> s) noexcept(is_nothrow_contract_violation)
+{
+    return static_cast<std::size_t>(find(s, max_value(s)) - s.begin());
+}
+
+template<class T, size_t E>
+QS_NODISCARD intl::sum_result_t<remove_cv_t<T>> sum(span<T, E> s) noexcept
+{
+    using value_type = remove_cv_t<T>;
+    if constexpr(std::is_void<intl::simd_ordered_lane_t<value_type>>::value)
+        return intl::sum_scalar<value_type>(s.data(), s.size());
+    else
+        return intl::sum_dispatch<value_type>(s.data(), s.size());
+}
+
+template<class T, size_t E>
+QS_NODISCARD intl::sum_result_t<remove_cv_t<T>> dot(span<T, E> a, type_identity_t<span<remove_cv_t<T> const>> b)
+    noexcept(is_nothrow_contract_violation)
+{
+    using value_type = remove_cv_t<T>;
+    QS_VERIFY(a.size() == b.size(), "dot: span size mismatch");
+    if constexpr(std::is_same<value_type, std::int32_t>::value || std::is_same<value_type, float>::value)
+        return intl::dot_dispatch<value_type>(a.data(), b.data(), a.size());
+    else
+        return intl::dot_scalar<value_type>(a.data(), b.data(), a.size());
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_REDUCE_H
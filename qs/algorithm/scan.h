@@ -0,0 +1,336 @@
+#ifndef QS_ALGORITHM_SCAN_H
+#define QS_ALGORITHM_SCAN_H
+
+#include <qs/algorithm/reduce.h>
+#include <qs/algorithm/simd_ops.h>
+#include <qs/config.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Element type the prefix sum kernels run on: 32-bit integers add as unsigned (wrapping), `void` for no kernel.
+    template<class T>
+    using simd_scan_lane_t = conditional_t<std::is_same<T, float>::value, float,
+                                           conditional_t<std::is_integral<T>::value && sizeof(T) == 4 &&
+                                                             !std::is_same<T, bool>::value,
+                                                         std::uint32_t, void>>;
+
+    // Kernels on raw pointers, `out` may be `in`. They start from `acc`, write inclusive or exclusive sums and
+    // return the running total after the last element, which is where the next block of a blocked scan starts.
+
+    template<bool Exclusive, class T>
+    inline T scan_scalar(T const* in, T* out, std::size_t n, T acc) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            T const x    = in[i];
+            T const next = static_cast<T>(acc + x);
+            out[i]       = Exclusive ? acc : next;
+            acc          = next;
+        }
+        return acc;
+    }
+
+
+#if QS_HAS_X86_DISPATCH
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX2: each vector is scanned in registers (log2 of its lanes shift-and-add steps, the 128-bit halves
+    // joined last), then offset by the running total broadcast from the previous one. Exclusive sums are the
+    // inclusive ones moved up a lane, the previous total entering lane 0.
+    // ---------------------------------------------------------------------------------------------------------
+
+    QS_TARGET_AVX2 inline __m256i scan_epi32_avx2(__m256i x) noexcept
+    {
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        // [0, low half], its last element broadcast
+        __m256i const low = _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xFF);
+        return _mm256_add_epi32(x, low);
+    }
+
+    QS_TARGET_AVX2 inline __m256 scan_ps_avx2(__m256 x) noexcept
+    {
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+        __m256 const low = _mm256_permute_ps(_mm256_permute2f128_ps(x, x, 0x08), 0xFF);
+        return _mm256_add_ps(x, low);
+    }
+
+    template<bool Exclusive>
+    QS_TARGET_AVX2 std::uint32_t scan_avx2(std::uint32_t const* in, std::uint32_t* out, std::size_t n,
+                                           std::uint32_t acc) noexcept
+    {
+        __m256i const last  = _mm256_set1_epi32(7);
+        __m256i const up    = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+        __m256i       carry = _mm256_set1_epi32(static_cast<int>(acc));
+        std::size_t   i     = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+            __m256i const s = _mm256_add_epi32(scan_epi32_avx2(x), carry);
+            __m256i const r = Exclusive ? _mm256_blend_epi32(_mm256_permutevar8x32_epi32(s, up), carry, 0x01) : s;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+            carry = _mm256_permutevar8x32_epi32(s, last);
+        }
+        acc = static_cast<std::uint32_t>(_mm256_cvtsi256_si32(carry));
+        return scan_scalar<Exclusive>(in + i, out + i, n - i, acc);
+    }
+
+    template<bool Exclusive>
+    QS_TARGET_AVX2 float scan_avx2(float const* in, float* out, std::size_t n, float acc) noexcept
+    {
+        __m256i const last  = _mm256_set1_epi32(7);
+        __m256i const up    = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+        __m256        carry = _mm256_set1_ps(acc);
+        std::size_t   i     = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256 const s = _mm256_add_ps(scan_ps_avx2(_mm256_loadu_ps(in + i)), carry);
+            __m256 const r = Exclusive ? _mm256_blend_ps(_mm256_permutevar8x32_ps(s, up), carry, 0x01) : s;
+            _mm256_storeu_ps(out + i, r);
+            carry = _mm256_permutevar8x32_ps(s, last);
+        }
+        return scan_scalar<Exclusive>(in + i, out + i, n - i, _mm256_cvtss_f32(carry));
+    }
+
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX-512, same scheme: `valignd` against zero shifts whole vectors by `k` lanes, and against the carry
+    // gives the exclusive sums. Tails are masked, their zero lanes leave the total in the last lane.
+    // ---------------------------------------------------------------------------------------------------------
+
+    QS_TARGET_AVX512 inline __m512i scan_epi32_avx512(__m512i x) noexcept
+    {
+        __m512i const zero = _mm512_setzero_si512();
+        x                  = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 15));
+        x                  = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 14));
+        x                  = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 12));
+        return _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 8));
+    }
+
+    QS_TARGET_AVX512 inline __m512 scan_ps_avx512(__m512 x) noexcept
+    {
+        __m512i const zero = _mm512_setzero_si512();
+        x = _mm512_add_ps(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), zero, 15)));
+        x = _mm512_add_ps(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), zero, 14)));
+        x = _mm512_add_ps(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), zero, 12)));
+        return _mm512_add_ps(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), zero, 8)));
+    }
+
+    template<bool Exclusive>
+    QS_TARGET_AVX512 std::uint32_t scan_avx512(std::uint32_t const* in, std::uint32_t* out, std::size_t n,
+                                               std::uint32_t acc) noexcept
+    {
+        __m512i const last  = _mm512_set1_epi32(15);
+        __m512i       carry = _mm512_set1_epi32(static_cast<int>(acc));
+        for(std::size_t i = 0; i < n; i += 16)
+        {
+            __mmask16 const m = step_mask16(n - i);
+            __m512i const   s = _mm512_add_epi32(scan_epi32_avx512(_mm512_maskz_loadu_epi32(m, in + i)), carry);
+            _mm512_mask_storeu_epi32(out + i, m, Exclusive ? _mm512_alignr_epi32(s, carry, 15) : s);
+            carry = _mm512_permutexvar_epi32(last, s);
+        }
+        return static_cast<std::uint32_t>(_mm512_cvtsi512_si32(carry));
+    }
+
+    template<bool Exclusive>
+    QS_TARGET_AVX512 float scan_avx512(float const* in, float* out, std::size_t n, float acc) noexcept
+    {
+        __m512i const last  = _mm512_set1_epi32(15);
+        __m512        carry = _mm512_set1_ps(acc);
+        for(std::size_t i = 0; i < n; i += 16)
+        {
+            __mmask16 const m = step_mask16(n - i);
+            __m512 const    s = _mm512_add_ps(scan_ps_avx512(_mm512_maskz_loadu_ps(m, in + i)), carry);
+            __m512 const    r = Exclusive ? _mm512_castsi512_ps(_mm512_alignr_epi32(
+                                                _mm512_castps_si512(s), _mm512_castps_si512(carry), 15))
+                                          : s;
+            _mm512_mask_storeu_ps(out + i, m, r);
+            carry = _mm512_permutexvar_ps(last, s);
+        }
+        return _mm512_cvtss_f32(carry);
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+
+
+    template<bool Exclusive, class T>
+    QS_INLINE T scan_dispatch(T const* in, T* out, std::size_t n, T acc) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return scan_avx512<Exclusive>(in, out, n, acc);
+            case simd_level::avx2: return scan_avx2<Exclusive>(in, out, n, acc);
+            case simd_level::scalar: break;
+        }
+#endif
+        return scan_scalar<Exclusive>(in, out, n, acc);
+    }
+
+    template<bool Exclusive, class T>
+    QS_INLINE T scan_any(T const* in, T* out, std::size_t n, T acc) noexcept
+    {
+        using lane = simd_scan_lane_t<T>;
+        if constexpr(std::is_void<lane>::value)
+            return scan_scalar<Exclusive>(in, out, n, acc);
+        else
+            return static_cast<T>(scan_dispatch<Exclusive>(reinterpret_cast<lane const*>(in),
+                                                           reinterpret_cast<lane*>(out), n, static_cast<lane>(acc)));
+    }
+
+    // Total of `in[0, n)`, in the same arithmetic as the scan kernels.
+    template<class T>
+    QS_INLINE T scan_total(T const* in, std::size_t n) noexcept
+    {
+        using lane = simd_scan_lane_t<T>;
+        if constexpr(std::is_void<lane>::value)
+            return std::accumulate(in, in + n, T(), [](T a, T b) { return static_cast<T>(a + b); });
+        else
+            return static_cast<T>(static_cast<lane>(sum_dispatch(reinterpret_cast<lane const*>(in), n)));
+    }
+
+    // Smallest part worth a thread: below it, starting the thread costs more than the part's scan.
+    constexpr std::size_t parallel_scan_min_part = std::size_t(1) << 18;
+
+    // Two passes over parts of `[0, n)`, one per thread (part 0 on the calling thread): the totals of all parts
+    // but the last, then the scan of each part from the sum of the totals before it. Memory is read twice and
+    // written once, against once each for the serial scan, so this pays off only with spare memory bandwidth.
+    template<bool Exclusive, class T>
+    T parallel_scan(T const* in, T* out, std::size_t n, T acc, unsigned threads)
+    {
+        std::size_t const max_parts = n / parallel_scan_min_part;
+        if(max_parts <= 1 || threads == 1)
+            return scan_any<Exclusive>(in, out, n, acc);
+        if(threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t const parts = std::min<std::size_t>(threads, max_parts);
+        if(parts <= 1)
+            return scan_any<Exclusive>(in, out, n, acc);
+
+        // whole cache lines per part
+        std::size_t const part      = ((n + parts - 1) / parts + 15) / 16 * 16;
+        auto const        run_parts = [parts](auto const& f) {
+            std::vector<std::thread> workers;
+            workers.reserve(parts - 1);
+            for(std::size_t t = 1; t < parts; ++t)
+                workers.emplace_back([&f, t] { f(t); });
+            f(std::size_t(0));
+            for(auto& w: workers)
+                w.join();
+        };
+        auto const part_size = [&](std::size_t t) { return std::min(n, (t + 1) * part) - std::min(n, t * part); };
+
+        std::vector<T> starts(parts);
+        run_parts([&](std::size_t t) {
+            if(t + 1 < parts)
+                starts[t + 1] = scan_total(in + t * part, part_size(t));
+        });
+        starts[0] = acc;
+        for(std::size_t t = 1; t < parts; ++t)
+            starts[t] = static_cast<T>(starts[t] + starts[t - 1]);
+        T total = acc;
+        run_parts([&](std::size_t t) {
+            T const end = scan_any<Exclusive>(in + t * part, out + t * part, part_size(t), starts[t]);
+            if(t + 1 == parts)
+                total = end;
+        });
+        return total;
+    }
+} // namespace intl
+
+
+/**
+ * Prefix sums over spans, `out[i] = in[0] + ... + in[i]`, `out` may be `in`. Vectorized with AVX-512/AVX2 when
+ * the CPU supports it (see `active_simd_level()`) for 32-bit integers, which wrap on overflow, and `float`, whose
+ * vector kernels add in a tree order within each vector: results may differ from a serial loop in the last bits.
+ * Other types, and other targets, run a plain loop.
+ *
+ * The overloads taking `threads` split spans of millions of elements among up to that many threads (0 for one
+ * per hardware thread) in two passes, totals then scans, and run the serial kernel on smaller ones. Float sums
+ * then also depend on the split.
+ *
+ * Usage:
+ *      qs::inclusive_scan(qs::make_span(counts), qs::make_span(offsets));
+ *      qs::inclusive_scan(qs::make_span(histogram));   // in place: the histogram becomes a CDF
+ *      qs::inclusive_scan(qs::make_span(big), 0);      // all hardware threads
+ */
+template<class T>
+void inclusive_scan(type_identity_t<span<T const>> in, span<T> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(in.size() == out.size(), "inclusive_scan: span size mismatch");
+    intl::scan_any<false>(in.data(), out.data(), out.size(), T());
+}
+
+template<class T>
+void inclusive_scan(type_identity_t<span<T const>> in, span<T> out, unsigned threads)
+{
+    QS_VERIFY(in.size() == out.size(), "inclusive_scan: span size mismatch");
+    intl::parallel_scan<false>(in.data(), out.data(), out.size(), T(), threads);
+}
+
+template<class T>
+void inclusive_scan(span<T> s) noexcept
+{
+    inclusive_scan<T>(s, s);
+}
+
+template<class T>
+void inclusive_scan(span<T> s, unsigned threads)
+{
+    inclusive_scan<T>(s, s, threads);
+}
+
+/**
+ * Same, exclusive: `out[i] = init + in[0] + ... + in[i - 1]`, so `out[0] == init`, the offsets of the elements
+ * whose sizes are `in`.
+ *
+ * Usage:
+ *      qs::exclusive_scan(qs::make_span(bucket_sizes), qs::make_span(bucket_begins));
+ */
+template<class T>
+void exclusive_scan(type_identity_t<span<T const>> in, span<T> out, type_identity_t<T> init = T()) noexcept(
+    is_nothrow_contract_violation)
+{
+    QS_VERIFY(in.size() == out.size(), "exclusive_scan: span size mismatch");
+    intl::scan_any<true>(in.data(), out.data(), out.size(), init);
+}
+
+template<class T>
+void exclusive_scan(type_identity_t<span<T const>> in, span<T> out, type_identity_t<T> init, unsigned threads)
+{
+    QS_VERIFY(in.size() == out.size(), "exclusive_scan: span size mismatch");
+    intl::parallel_scan<true>(in.data(), out.data(), out.size(), init, threads);
+}
+
+template<class T>
+void exclusive_scan(span<T> s, type_identity_t<T> init = T()) noexcept
+{
+    exclusive_scan<T>(s, s, init);
+}
+
+template<class T>
+void exclusive_scan(span<T> s, type_identity_t<T> init, unsigned threads)
+{
+    exclusive_scan<T>(s, s, init, threads);
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_SCAN_H
@@ -0,0 +1,255 @@
+#ifndef QS_ALGORITHM_SIMD_OPS_H
+#define QS_ALGORITHM_SIMD_OPS_H
+
+#include <qs/config.h>
+#include <qs/memory.h>
+#include <qs/utils/cpu_features.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Element type a kernel runs on for `T`: equality only needs the bits, so every 1-byte type searches as
+    // `std::uint8_t` and every 4-byte integer as `std::uint32_t`, `void` when no kernel applies.
+    template<class T>
+    using simd_equality_lane_t = conditional_t<
+        std::is_same<T, float>::value, float,
+        conditional_t<(std::is_integral<T>::value || std::is_same<T, byte>::value) && sizeof(T) == 1, std::uint8_t,
+                      conditional_t<std::is_integral<T>::value && sizeof(T) == 4, std::uint32_t, void>>>;
+
+    // Ordering depends on the signedness, the kernels cover exactly these types.
+    template<class T>
+    using simd_ordered_lane_t =
+        conditional_t<std::is_same<T, std::int32_t>::value || std::is_same<T, std::uint32_t>::value ||
+                          std::is_same<T, std::uint8_t>::value || std::is_same<T, float>::value,
+                      T, void>;
+
+
+#if QS_HAS_X86_DISPATCH
+    // Per-type operations of the generic kernels: `eq` and `lt` give all-ones lanes, reinterpreted as integers for
+    // floats.
+
+    template<class T>
+    struct avx2_ops;
+
+    template<>
+    struct avx2_ops<std::uint8_t>
+    {
+        using value_type                   = std::uint8_t;
+        using vector                       = __m256i;
+        static constexpr std::size_t lanes = 32;
+
+        QS_TARGET_AVX2 static vector load(value_type const* p) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+        }
+        QS_TARGET_AVX2 static void store(value_type* p, vector v) noexcept
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+        QS_TARGET_AVX2 static vector set1(value_type x) noexcept
+        {
+            return _mm256_set1_epi8(static_cast<char>(x));
+        }
+        QS_TARGET_AVX2 static __m256i       eq(vector a, vector b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+        QS_TARGET_AVX2 static std::uint32_t bits(__m256i m) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(m));
+        }
+        QS_TARGET_AVX2 static vector min(vector a, vector b) noexcept { return _mm256_min_epu8(a, b); }
+        QS_TARGET_AVX2 static vector max(vector a, vector b) noexcept { return _mm256_max_epu8(a, b); }
+    };
+
+    template<>
+    struct avx2_ops<std::uint32_t>
+    {
+        using value_type                   = std::uint32_t;
+        using vector                       = __m256i;
+        static constexpr std::size_t lanes = 8;
+
+        QS_TARGET_AVX2 static vector load(value_type const* p) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+        }
+        QS_TARGET_AVX2 static void store(value_type* p, vector v) noexcept
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+        QS_TARGET_AVX2 static vector set1(value_type x) noexcept
+        {
+            return _mm256_set1_epi32(static_cast<int>(x));
+        }
+        QS_TARGET_AVX2 static __m256i       eq(vector a, vector b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+        QS_TARGET_AVX2 static std::uint32_t bits(__m256i m) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+        }
+        QS_TARGET_AVX2 static vector min(vector a, vector b) noexcept { return _mm256_min_epu32(a, b); }
+        QS_TARGET_AVX2 static vector max(vector a, vector b) noexcept { return _mm256_max_epu32(a, b); }
+        QS_TARGET_AVX2 static __m256i lt(vector a, vector b) noexcept
+        {
+            __m256i const sign = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::min());
+            return _mm256_cmpgt_epi32(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+        }
+    };
+
+    template<>
+    struct avx2_ops<std::int32_t> : avx2_ops<std::uint32_t>
+    {
+        using value_type = std::int32_t;
+
+        QS_TARGET_AVX2 static vector load(value_type const* p) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+        }
+        QS_TARGET_AVX2 static void store(value_type* p, vector v) noexcept
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+        QS_TARGET_AVX2 static vector set1(value_type x) noexcept { return _mm256_set1_epi32(x); }
+        QS_TARGET_AVX2 static vector  min(vector a, vector b) noexcept { return _mm256_min_epi32(a, b); }
+        QS_TARGET_AVX2 static vector  max(vector a, vector b) noexcept { return _mm256_max_epi32(a, b); }
+        QS_TARGET_AVX2 static __m256i lt(vector a, vector b) noexcept { return _mm256_cmpgt_epi32(b, a); }
+    };
+
+    template<>
+    struct avx2_ops<float>
+    {
+        using value_type                   = float;
+        using vector                       = __m256;
+        static constexpr std::size_t lanes = 8;
+
+        QS_TARGET_AVX2 static vector  load(value_type const* p) noexcept { return _mm256_loadu_ps(p); }
+        QS_TARGET_AVX2 static void    store(value_type* p, vector v) noexcept { _mm256_storeu_ps(p, v); }
+        QS_TARGET_AVX2 static vector  set1(value_type x) noexcept { return _mm256_set1_ps(x); }
+        QS_TARGET_AVX2 static __m256i eq(vector a, vector b) noexcept
+        {
+            return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+        }
+        QS_TARGET_AVX2 static std::uint32_t bits(__m256i m) noexcept
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+        }
+        QS_TARGET_AVX2 static vector  min(vector a, vector b) noexcept { return _mm256_min_ps(a, b); }
+        QS_TARGET_AVX2 static vector  max(vector a, vector b) noexcept { return _mm256_max_ps(a, b); }
+        QS_TARGET_AVX2 static __m256i lt(vector a, vector b) noexcept
+        {
+            return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+        }
+    };
+
+
+    // The lanes of a 16-element step with `remaining` elements left: all of them but on the last step.
+    QS_TARGET_AVX512 inline __mmask16 step_mask16(std::size_t remaining) noexcept
+    {
+        return remaining < 16 ? static_cast<__mmask16>(_bzhi_u32(0xFFFF, static_cast<unsigned>(remaining)))
+                              : __mmask16(0xFFFF);
+    }
+
+    // Same with AVX-512, `eq` gives a bit mask. Tails use masked loads, `fill` being what masked-off lanes read.
+
+    template<class T>
+    struct avx512_ops;
+
+    template<>
+    struct avx512_ops<std::uint8_t>
+    {
+        using value_type                   = std::uint8_t;
+        using vector                       = __m512i;
+        using mask                         = __mmask64;
+        static constexpr std::size_t lanes = 64;
+
+        QS_TARGET_AVX512 static vector load(value_type const* p) noexcept { return _mm512_loadu_si512(p); }
+        QS_TARGET_AVX512 static void   store(value_type* p, vector v) noexcept { _mm512_storeu_si512(p, v); }
+        QS_TARGET_AVX512 static vector load(value_type const* p, mask m, vector fill) noexcept
+        {
+            return _mm512_mask_loadu_epi8(fill, m, p);
+        }
+        QS_TARGET_AVX512 static mask tail(std::size_t n) noexcept
+        {
+            return _bzhi_u64(~0ull, static_cast<unsigned>(n));
+        }
+        QS_TARGET_AVX512 static vector set1(value_type x) noexcept { return _mm512_set1_epi8(static_cast<char>(x)); }
+        QS_TARGET_AVX512 static mask   eq(vector a, vector b) noexcept { return _mm512_cmpeq_epi8_mask(a, b); }
+        QS_TARGET_AVX512 static vector min(vector a, vector b) noexcept { return _mm512_min_epu8(a, b); }
+        QS_TARGET_AVX512 static vector max(vector a, vector b) noexcept { return _mm512_max_epu8(a, b); }
+    };
+
+    template<>
+    struct avx512_ops<std::uint32_t>
+    {
+        using value_type                   = std::uint32_t;
+        using vector                       = __m512i;
+        using mask                         = __mmask16;
+        static constexpr std::size_t lanes = 16;
+
+        QS_TARGET_AVX512 static vector load(value_type const* p) noexcept { return _mm512_loadu_si512(p); }
+        QS_TARGET_AVX512 static void   store(value_type* p, vector v) noexcept { _mm512_storeu_si512(p, v); }
+        QS_TARGET_AVX512 static vector load(value_type const* p, mask m, vector fill) noexcept
+        {
+            return _mm512_mask_loadu_epi32(fill, m, p);
+        }
+        QS_TARGET_AVX512 static mask tail(std::size_t n) noexcept
+        {
+            return static_cast<mask>(_bzhi_u32(0xFFFFu, static_cast<unsigned>(n)));
+        }
+        QS_TARGET_AVX512 static vector set1(value_type x) noexcept { return _mm512_set1_epi32(static_cast<int>(x)); }
+        QS_TARGET_AVX512 static mask   eq(vector a, vector b) noexcept { return _mm512_cmpeq_epi32_mask(a, b); }
+        QS_TARGET_AVX512 static vector min(vector a, vector b) noexcept { return _mm512_min_epu32(a, b); }
+        QS_TARGET_AVX512 static vector max(vector a, vector b) noexcept { return _mm512_max_epu32(a, b); }
+        QS_TARGET_AVX512 static mask   lt(vector a, vector b) noexcept { return _mm512_cmplt_epu32_mask(a, b); }
+    };
+
+    template<>
+    struct avx512_ops<std::int32_t> : avx512_ops<std::uint32_t>
+    {
+        using value_type = std::int32_t;
+
+        QS_TARGET_AVX512 static vector load(value_type const* p) noexcept { return _mm512_loadu_si512(p); }
+        QS_TARGET_AVX512 static void   store(value_type* p, vector v) noexcept { _mm512_storeu_si512(p, v); }
+        QS_TARGET_AVX512 static vector load(value_type const* p, mask m, vector fill) noexcept
+        {
+            return _mm512_mask_loadu_epi32(fill, m, p);
+        }
+        QS_TARGET_AVX512 static vector set1(value_type x) noexcept { return _mm512_set1_epi32(x); }
+        QS_TARGET_AVX512 static vector min(vector a, vector b) noexcept { return _mm512_min_epi32(a, b); }
+        QS_TARGET_AVX512 static vector max(vector a, vector b) noexcept { return _mm512_max_epi32(a, b); }
+        QS_TARGET_AVX512 static mask   lt(vector a, vector b) noexcept { return _mm512_cmplt_epi32_mask(a, b); }
+    };
+
+    template<>
+    struct avx512_ops<float>
+    {
+        using value_type                   = float;
+        using vector                       = __m512;
+        using mask                         = __mmask16;
+        static constexpr std::size_t lanes = 16;
+
+        QS_TARGET_AVX512 static vector load(value_type const* p) noexcept { return _mm512_loadu_ps(p); }
+        QS_TARGET_AVX512 static void   store(value_type* p, vector v) noexcept { _mm512_storeu_ps(p, v); }
+        QS_TARGET_AVX512 static vector load(value_type const* p, mask m, vector fill) noexcept
+        {
+            return _mm512_mask_loadu_ps(fill, m, p);
+        }
+        QS_TARGET_AVX512 static mask tail(std::size_t n) noexcept
+        {
+            return static_cast<mask>(_bzhi_u32(0xFFFFu, static_cast<unsigned>(n)));
+        }
+        QS_TARGET_AVX512 static vector set1(value_type x) noexcept { return _mm512_set1_ps(x); }
+        QS_TARGET_AVX512 static mask   eq(vector a, vector b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+        QS_TARGET_AVX512 static vector min(vector a, vector b) noexcept { return _mm512_min_ps(a, b); }
+        QS_TARGET_AVX512 static vector max(vector a, vector b) noexcept { return _mm512_max_ps(a, b); }
+        QS_TARGET_AVX512 static mask   lt(vector a, vector b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    };
+#endif // QS_HAS_X86_DISPATCH
+} // namespace intl
+
+QS_NAMESPACE_END
+
+#endif // QS_ALGORITHM_SIMD_OPS_H
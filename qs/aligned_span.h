@@ -0,0 +1,168 @@
+#ifndef QS_ALIGNED_SPAN_H
+#define QS_ALIGNED_SPAN_H
+
+#include <qs/config.h>
+#include <qs/memory.h>
+#include <qs/span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+
+template<class T, size_t Align, size_t Extent = dynamic_extent>
+class aligned_span;
+
+
+/**
+ * Span whose first element is aligned to `Align` bytes, recorded in the type: the alignment is checked once on
+ * construction and every access goes through `assume_aligned`, so that vectorized loops over the elements use
+ * aligned loads without a peeling prologue. Converts implicitly to `span` (and to weaker alignments).
+ *
+ * `for_each_block` visits the elements by aligned blocks of `block_size` (`Align` bytes for the usual element
+ * sizes), then `tail()` holds the rest: a fixed trip count per block is what lets the compiler vectorize
+ * reductions even at -O2, and independent accumulators per lane make floating-point sums vectorizable without
+ * reassociating them.
+ *
+ *      float acc[qs::aligned_span<float const, 64>::block_size] = {};
+ *      s.for_each_block([&](auto block) {
+ *          for(std::size_t l = 0; l < block.size(); ++l)
+ *              acc[l] += block[l];
+ *      });
+ */
+template<class T, size_t Align, size_t Extent>
+class aligned_span
+{
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "aligned_span<T, Align>: Align must be a power of two");
+    static_assert(Align >= alignof(T), "aligned_span<T, Align>: Align below the alignment of T");
+
+public:
+    using element_type     = T;
+    using value_type       = remove_cv_t<T>;
+    using size_type        = size_t;
+    using difference_type  = ptrdiff_t;
+    using pointer          = element_type*;
+    using reference        = element_type&;
+    using iterator         = pointer;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    static constexpr size_t alignment = Align;
+    static constexpr size_t extent    = Extent;
+    // Elements between two aligned addresses.
+    static constexpr size_t block_size = Align / std::gcd(Align, sizeof(T));
+
+    constexpr aligned_span() noexcept = default;
+
+    // Requires `data` aligned to `Align` bytes.
+    aligned_span(pointer data, size_type count) noexcept(is_nothrow_contract_violation)
+        : span_(data, count)
+    {
+        QS_VERIFY(is_aligned(data, Align), "aligned_span: data not aligned to Align bytes");
+    }
+
+    template<class U, size_t E, enable_if_t<intl::is_span_convertible<U, element_type, E, Extent>::value, int> = 0>
+    explicit aligned_span(span<U, E> s) noexcept(is_nothrow_contract_violation)
+        : aligned_span(s.data(), s.size())
+    {}
+
+    // From a span of stronger (or equal) alignment.
+    template<class U, size_t A, size_t E,
+             enable_if_t<(A >= Align) && intl::is_span_convertible<U, element_type, E, Extent>::value, int> = 0>
+    aligned_span(aligned_span<U, A, E> const& other) noexcept(is_nothrow_contract_violation)
+        : span_(other.data(), other.size())
+    {}
+
+    template<class U, size_t E, enable_if_t<intl::is_span_convertible<T, U, Extent, E>::value, int> = 0>
+    QS_CONSTEXPR20 operator span<U, E>() const noexcept
+    {
+        return span<U, E>(data(), size());
+    }
+
+    constexpr size_type    size() const noexcept { return span_.size(); }
+    constexpr size_type    size_bytes() const noexcept { return span_.size_bytes(); }
+    constexpr bool         empty() const noexcept { return span_.empty(); }
+    QS_CONSTEXPR20 pointer data() const noexcept { return assume_aligned<Align>(span_.data()); }
+
+    QS_CONSTEXPR20 reference operator[](size_type index) const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(index < size(), "aligned_span::operator[](index): index out of range"), data()[index];
+    }
+    QS_CONSTEXPR20 reference front() const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(!empty(), "aligned_span::front() called on empty span"), data()[0];
+    }
+    QS_CONSTEXPR20 reference back() const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(!empty(), "aligned_span::back() called on empty span"), data()[size() - 1];
+    }
+
+    QS_CONSTEXPR20 iterator         begin() const noexcept { return data(); }
+    QS_CONSTEXPR20 iterator         end() const noexcept { return data() + size(); }
+    QS_CONSTEXPR20 reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    QS_CONSTEXPR20 reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+    // The first elements keep the alignment, other subspans are plain spans.
+    template<size_t Count>
+    aligned_span<T, Align, Count> first() const noexcept(is_nothrow_contract_violation)
+    {
+        return aligned_span<T, Align, Count>(span_.template first<Count>());
+    }
+    aligned_span<T, Align> first(size_type count) const noexcept(is_nothrow_contract_violation)
+    {
+        return aligned_span<T, Align>(span_.first(count));
+    }
+    QS_CONSTEXPR20 span<T> subspan(size_type offset, size_type count = dynamic_extent) const
+        noexcept(is_nothrow_contract_violation)
+    {
+        return span<T>(data(), size()).subspan(offset, count);
+    }
+
+    // Calls `f(span<T, block_size>)` on each whole block, every block starting on an `Align` boundary.
+    template<class F>
+    QS_ALWAYS_INLINE void for_each_block(F&& f) const
+    {
+        pointer const   p      = data();
+        size_type const blocks = size() / block_size;
+        for(size_type i = 0; i < blocks; ++i)
+            f(span<T, block_size>(p + i * block_size, block_size));
+    }
+
+    // The elements after the last whole block, fewer than `block_size`.
+    QS_CONSTEXPR20 span<T> tail() const noexcept
+    {
+        return span<T>(data() + size() / block_size * block_size, size() % block_size);
+    }
+
+private:
+    span<T, Extent> span_;
+};
+
+
+/**
+ * Splits `s` into a head of fewer than `Align / sizeof(T)` elements and an aligned remainder, the usual peel
+ * before an aligned kernel. Everything goes to the head when no element of `s` is aligned (possible only for
+ * elements misaligned to their own size).
+ *
+ *      auto [head, body] = qs::split_aligned<64>(qs::make_span(values));
+ */
+template<size_t Align, class T, size_t E>
+std::pair<span<T>, aligned_span<T, Align>> split_aligned(span<T, E> s) noexcept
+{
+    size_t const misalignment = reinterpret_cast<std::uintptr_t>(s.data()) & (Align - 1);
+    size_t const padding      = misalignment == 0 ? 0 : Align - misalignment;
+    if(padding % sizeof(T) != 0 || padding / sizeof(T) >= s.size())
+        return {span<T>(s), aligned_span<T, Align>()};
+    size_t const head = padding / sizeof(T);
+    return {span<T>(s.data(), head), aligned_span<T, Align>(s.data() + head, s.size() - head)};
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_ALIGNED_SPAN_H
@@ -0,0 +1,78 @@
+#ifndef QS_BIT_H
+#define QS_BIT_H
+
+#include <qs/config.h>
+
+#include <climits>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+// C++14 subset of <bit> for unsigned integers, `constexpr` and lowered to single instructions on GCC/Clang.
+
+template<class T>
+QS_ALWAYS_INLINE constexpr int countr_zero(T x) noexcept
+{
+    static_assert(std::is_unsigned<T>::value, "countr_zero: unsigned integers only");
+    constexpr int digits = sizeof(T) * CHAR_BIT;
+    if(x == 0)
+        return digits;
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+    if(sizeof(T) <= sizeof(unsigned))
+        return __builtin_ctz(static_cast<unsigned>(x));
+    else if(sizeof(T) <= sizeof(unsigned long long))
+        return __builtin_ctzll(static_cast<unsigned long long>(x));
+#endif
+    int n = 0;
+    for(; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+}
+
+template<class T>
+QS_ALWAYS_INLINE constexpr int countl_zero(T x) noexcept
+{
+    static_assert(std::is_unsigned<T>::value, "countl_zero: unsigned integers only");
+    constexpr int digits = sizeof(T) * CHAR_BIT;
+    if(x == 0)
+        return digits;
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+    if(sizeof(T) <= sizeof(unsigned))
+        return __builtin_clz(static_cast<unsigned>(x)) - static_cast<int>((sizeof(unsigned) - sizeof(T)) * CHAR_BIT);
+    else if(sizeof(T) <= sizeof(unsigned long long))
+        return __builtin_clzll(static_cast<unsigned long long>(x)) -
+               static_cast<int>((sizeof(unsigned long long) - sizeof(T)) * CHAR_BIT);
+#endif
+    int n = 0;
+    for(T mask = T(1) << (digits - 1); (x & mask) == 0; mask >>= 1)
+        ++n;
+    return n;
+}
+
+template<class T>
+QS_ALWAYS_INLINE constexpr int popcount(T x) noexcept
+{
+    static_assert(std::is_unsigned<T>::value, "popcount: unsigned integers only");
+#if QS_GCC_VERSION || QS_CLANG_VERSION
+    if(sizeof(T) <= sizeof(unsigned))
+        return __builtin_popcount(static_cast<unsigned>(x));
+    else if(sizeof(T) <= sizeof(unsigned long long))
+        return __builtin_popcountll(static_cast<unsigned long long>(x));
+#endif
+    int n = 0;
+    for(; x != 0; x &= x - 1)
+        ++n;
+    return n;
+}
+
+// Number of bits needed to represent `x`, 0 for 0.
+template<class T>
+QS_ALWAYS_INLINE constexpr int bit_width(T x) noexcept
+{
+    return static_cast<int>(sizeof(T) * CHAR_BIT) - countl_zero(x);
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_BIT_H
@@ -0,0 +1,257 @@
+#ifndef QS_CHUNKS_H
+#define QS_CHUNKS_H
+
+#include <qs/config.h>
+#include <qs/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+
+QS_NAMESPACE_BEGIN
+
+
+namespace intl
+{
+    // Random-access iterator over the pieces of a chunk view: a copy of the (small) view and a piece index, so
+    // that iterators never dangle on the view they came from.
+    template<class View>
+    class chunk_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = typename View::value_type;
+        using difference_type   = ptrdiff_t;
+        using pointer           = void;
+        using reference         = value_type;
+
+        constexpr chunk_iterator() noexcept = default;
+        constexpr chunk_iterator(View const& view, size_t index) noexcept
+            : view_(view),
+              index_(index)
+        {}
+
+        constexpr value_type operator*() const noexcept(is_nothrow_contract_violation) { return view_[index_]; }
+        constexpr value_type operator[](difference_type n) const noexcept(is_nothrow_contract_violation)
+        {
+            return view_[index_ + static_cast<size_t>(n)];
+        }
+
+        constexpr chunk_iterator& operator++() noexcept { return ++index_, *this; }
+        constexpr chunk_iterator& operator--() noexcept { return --index_, *this; }
+        constexpr chunk_iterator  operator++(int) noexcept { return chunk_iterator(view_, index_++); }
+        constexpr chunk_iterator  operator--(int) noexcept { return chunk_iterator(view_, index_--); }
+        constexpr chunk_iterator& operator+=(difference_type n) noexcept
+        {
+            return index_ += static_cast<size_t>(n), *this;
+        }
+        constexpr chunk_iterator& operator-=(difference_type n) noexcept
+        {
+            return index_ -= static_cast<size_t>(n), *this;
+        }
+
+        friend constexpr chunk_iterator operator+(chunk_iterator it, difference_type n) noexcept { return it += n; }
+        friend constexpr chunk_iterator operator+(difference_type n, chunk_iterator it) noexcept { return it += n; }
+        friend constexpr chunk_iterator operator-(chunk_iterator it, difference_type n) noexcept { return it -= n; }
+        friend constexpr difference_type operator-(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return static_cast<difference_type>(a.index_ - b.index_);
+        }
+
+        friend constexpr bool operator==(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ == b.index_;
+        }
+        friend constexpr bool operator!=(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ != b.index_;
+        }
+        friend constexpr bool operator<(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ < b.index_;
+        }
+        friend constexpr bool operator>(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ > b.index_;
+        }
+        friend constexpr bool operator<=(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ <= b.index_;
+        }
+        friend constexpr bool operator>=(chunk_iterator const& a, chunk_iterator const& b) noexcept
+        {
+            return a.index_ >= b.index_;
+        }
+
+    private:
+        View   view_{};
+        size_t index_ = 0;
+    };
+} // namespace intl
+
+
+/**
+ * The whole chunks of `N` consecutive elements of a span, as `span<T, N>`: the extent is a constant, so loops over
+ * a chunk unroll (and vectorize) fully. The fewer than `N` remaining elements are in `tail()`.
+ *
+ *      for(qs::span<float const, 8> c: qs::chunks<8>(values))
+ *          for(std::size_t i = 0; i < c.size(); ++i)
+ *              acc[i] += c[i];
+ *      for(float x: qs::chunks<8>(values).tail())
+ *          ...
+ */
+template<class T, size_t N>
+class static_chunk_view
+{
+    static_assert(N != 0 && N != dynamic_extent, "static_chunk_view<T, N>: N must be a positive constant");
+
+public:
+    using value_type = span<T, N>;
+    using size_type  = size_t;
+    using iterator   = intl::chunk_iterator<static_chunk_view>;
+
+    constexpr static_chunk_view() noexcept = default;
+    constexpr explicit static_chunk_view(span<T> s) noexcept
+        : data_(s.data()),
+          chunks_(s.size() / N),
+          tail_size_(s.size() % N)
+    {}
+
+    // Number of whole chunks.
+    constexpr size_type size() const noexcept { return chunks_; }
+    constexpr bool      empty() const noexcept { return chunks_ == 0; }
+
+    constexpr value_type operator[](size_type i) const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(i < chunks_, "static_chunk_view::operator[](i): index out of range"),
+               value_type(data_ + i * N, N);
+    }
+
+    constexpr iterator begin() const noexcept { return iterator(*this, 0); }
+    constexpr iterator end() const noexcept { return iterator(*this, chunks_); }
+
+    // The elements after the last whole chunk.
+    constexpr span<T> tail() const noexcept { return span<T>(data_ + chunks_ * N, tail_size_); }
+
+private:
+    T*        data_      = nullptr;
+    size_type chunks_    = 0;
+    size_type tail_size_ = 0;
+};
+
+
+/**
+ * Consecutive chunks of `n` elements of a span, the last one shorter when `n` does not divide the size.
+ *
+ *      for(qs::span<int> batch: qs::chunks(qs::make_span(items), 64))
+ *          process(batch);
+ */
+template<class T>
+class chunk_view
+{
+public:
+    using value_type = span<T>;
+    using size_type  = size_t;
+    using iterator   = intl::chunk_iterator<chunk_view>;
+
+    constexpr chunk_view() noexcept = default;
+    // Requires `n > 0`.
+    constexpr chunk_view(span<T> s, size_type n) noexcept(is_nothrow_contract_violation)
+        : data_(s.data()),
+          size_(s.size()),
+          chunk_size_(n)
+    {
+        QS_VERIFY(n != 0, "chunks(span, n): zero chunk size");
+    }
+
+    // Number of chunks, `ceil(elements / n)`, without the overflow of `elements + n - 1` for huge `n`.
+    constexpr size_type size() const noexcept { return size_ / chunk_size_ + (size_ % chunk_size_ != 0 ? 1 : 0); }
+    constexpr bool      empty() const noexcept { return size_ == 0; }
+
+    constexpr value_type operator[](size_type i) const noexcept(is_nothrow_contract_violation)
+    {
+        QS_VERIFY(i < size(), "chunk_view::operator[](i): index out of range");
+        size_type const offset = i * chunk_size_;
+        return value_type(data_ + offset, std::min(chunk_size_, size_ - offset));
+    }
+
+    constexpr iterator begin() const noexcept { return iterator(*this, 0); }
+    constexpr iterator end() const noexcept { return iterator(*this, size()); }
+
+private:
+    T*        data_       = nullptr;
+    size_type size_       = 0;
+    size_type chunk_size_ = 1;
+};
+
+
+/**
+ * A span cut into exactly `parts` consecutive pieces whose sizes differ by at most one (the first
+ * `size % parts` pieces get the extra element), some empty when there are more parts than elements. Piece `i` is
+ * computed in O(1), so that each worker of a pool can take its own.
+ *
+ *      auto const parts = qs::split_even(qs::make_span(items), threads);
+ *      pool.run([&](std::size_t thread) { process(parts[thread]); });
+ */
+template<class T>
+class even_split_view
+{
+public:
+    using value_type = span<T>;
+    using size_type  = size_t;
+    using iterator   = intl::chunk_iterator<even_split_view>;
+
+    constexpr even_split_view() noexcept = default;
+    // Requires `parts > 0`.
+    constexpr even_split_view(span<T> s, size_type parts) noexcept(is_nothrow_contract_violation)
+        : data_(s.data()),
+          parts_(parts),
+          base_(parts == 0 ? 0 : s.size() / parts),
+          extra_(parts == 0 ? 0 : s.size() % parts)
+    {
+        QS_VERIFY(parts != 0, "split_even(span, parts): zero parts");
+    }
+
+    constexpr size_type size() const noexcept { return parts_; }
+    constexpr bool      empty() const noexcept { return parts_ == 0; }
+
+    constexpr value_type operator[](size_type i) const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(i < parts_, "even_split_view::operator[](i): index out of range"),
+               value_type(data_ + i * base_ + std::min(i, extra_), base_ + (i < extra_ ? 1 : 0));
+    }
+
+    constexpr iterator begin() const noexcept { return iterator(*this, 0); }
+    constexpr iterator end() const noexcept { return iterator(*this, parts_); }
+
+private:
+    T*        data_  = nullptr;
+    size_type parts_ = 0;
+    size_type base_  = 0;
+    size_type extra_ = 0;
+};
+
+
+template<size_t N, class T, size_t E>
+constexpr static_chunk_view<T, N> chunks(span<T, E> s) noexcept
+{
+    return static_chunk_view<T, N>(s);
+}
+
+template<class T, size_t E>
+constexpr chunk_view<T> chunks(span<T, E> s, size_t n) noexcept(is_nothrow_contract_violation)
+{
+    return chunk_view<T>(s, n);
+}
+
+template<class T, size_t E>
+constexpr even_split_view<T> split_even(span<T, E> s, size_t parts) noexcept(is_nothrow_contract_violation)
+{
+    return even_split_view<T>(s, parts);
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CHUNKS_H
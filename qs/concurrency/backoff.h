@@ -0,0 +1,62 @@
+#ifndef QS_CONCURRENCY_BACKOFF_H
+#define QS_CONCURRENCY_BACKOFF_H
+
+#include <qs/config.h>
+
+#include <cstdint>
+#include <thread>
+
+#if QS_MSVC_VERSION
+#include <intrin.h>
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+// Hints the CPU that the caller is busy-waiting (x86 `pause`, ARM `yield`), reduces power and lets the
+// sibling hyper-thread run. It is a no-op on architectures without such an instruction.
+QS_ALWAYS_INLINE void cpu_relax() noexcept
+{
+#if QS_MSVC_VERSION && (QS_X86_64 || QS_X86)
+    _mm_pause();
+#elif QS_MSVC_VERSION && (QS_ARM64 || QS_ARM)
+    __yield();
+#elif (QS_GCC_VERSION || QS_CLANG_VERSION) && (QS_X86_64 || QS_X86)
+    __builtin_ia32_pause();
+#elif (QS_GCC_VERSION || QS_CLANG_VERSION) && (QS_ARM64 || QS_ARM)
+    asm volatile("yield" ::: "memory");
+#elif QS_GCC_VERSION || QS_CLANG_VERSION
+    asm volatile("" ::: "memory");
+#endif
+}
+
+// Exponential backoff for spin loops: doubles the number of `cpu_relax()` per round up to `SpinLimit`,
+// after which it yields the time slice to the OS scheduler.
+template<std::uint32_t SpinLimit = 64>
+class exponential_backoff
+{
+public:
+    void pause() noexcept
+    {
+        if(spins_ <= SpinLimit)
+        {
+            for(std::uint32_t i = 0; i < spins_; ++i)
+                cpu_relax();
+            spins_ <<= 1;
+        }
+        else
+            std::this_thread::yield();
+    }
+
+    // True once the backoff has gone past the spinning phase.
+    bool saturated() const noexcept { return spins_ > SpinLimit; }
+
+    void reset() noexcept { spins_ = 1; }
+
+private:
+    std::uint32_t spins_ = 1;
+};
+
+QS_NAMESPACE_END
+
+#endif // QS_CONCURRENCY_BACKOFF_H
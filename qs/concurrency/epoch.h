@@ -0,0 +1,385 @@
+#ifndef QS_CONCURRENCY_EPOCH_H
+#define QS_CONCURRENCY_EPOCH_H
+
+#include <qs/concurrency/cache_aligned.h>
+#include <qs/config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * Epoch-based memory reclamation (EBR), following the scheme of K. Fraser, "Practical lock-freedom" (2004).
+ *
+ * A thread registers once with an `epoch_domain` and receives an `epoch_handle`. Every access to shared nodes
+ * of a lock-free structure happens inside an `epoch_guard` (obtained with `handle.pin()`); nodes that were
+ * unlinked are handed to `handle.retire(ptr, deleter)` instead of being freed. A node retired at global epoch
+ * `e` is reclaimed once the global epoch reaches `e + 2`, since by then every thread that could still hold a
+ * reference has unpinned. Retired nodes are buffered in per-handle bags and reclaimed in batches, so the
+ * per-operation cost is a relaxed store and a fence on pin plus a vector push on retire.
+ *
+ * Usage:
+ *      qs::epoch_domain domain;
+ *      auto handle = domain.register_thread();     // once per thread
+ *      {
+ *          auto guard = handle.pin();
+ *          node* n = head.load(std::memory_order_acquire);
+ *          ... unlink n ...
+ *          handle.retire(n);
+ *      }
+ */
+
+class epoch_domain;
+class epoch_handle;
+class epoch_guard;
+
+
+namespace intl
+{
+    struct epoch_retired
+    {
+        void* ptr;
+        void (*deleter)(void*);
+
+        void reclaim() const { deleter(ptr); }
+    };
+
+    struct epoch_bag
+    {
+        std::uint64_t              epoch = 0;
+        std::vector<epoch_retired> items;
+
+        std::size_t reclaim() noexcept
+        {
+            std::size_t const n = items.size();
+            for(auto const& r: items)
+                r.reclaim();
+            items.clear();
+            return n;
+        }
+    };
+
+    // Per-thread record, the local epoch stores (epoch << 1) | active
+    struct epoch_record
+    {
+        std::atomic<std::uint64_t> local_epoch{0};
+        std::atomic<bool>          in_use{false};
+    };
+
+    template<class T, class Deleter>
+    void epoch_deleter_thunk(void* p)
+    {
+        Deleter{}(static_cast<T*>(p));
+    }
+} // namespace intl
+
+
+class epoch_domain
+{
+public:
+    static constexpr std::size_t default_max_threads       = 128;
+    static constexpr std::size_t default_collect_threshold = 64;
+
+    explicit epoch_domain(std::size_t max_threads       = default_max_threads,
+                          std::size_t collect_threshold = default_collect_threshold)
+        : records_(new cache_aligned<intl::epoch_record>[max_threads]),
+          max_threads_(max_threads),
+          collect_threshold_(collect_threshold == 0 ? 1 : collect_threshold)
+    {}
+
+    epoch_domain(epoch_domain const&)            = delete;
+    epoch_domain& operator=(epoch_domain const&) = delete;
+
+    ~epoch_domain()
+    {
+        QS_ASSERT(active_handles_.load(std::memory_order_acquire) == 0,
+                  "epoch_domain destroyed while threads are still registered");
+        for(auto& bag: orphans_)
+            bag.reclaim();
+    }
+
+    // Registers the calling thread. Throws std::length_error if all `max_threads` slots are taken.
+    epoch_handle register_thread();
+
+    // Attempts to advance the global epoch; fails if some pinned thread has not observed the current one.
+    bool try_advance() noexcept
+    {
+        std::uint64_t const epoch = global_epoch_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::size_t const hwm = high_water_mark_.load(std::memory_order_acquire);
+        for(std::size_t i = 0; i < hwm; ++i)
+        {
+            auto const& rec = records_[i];
+            if(!rec.in_use.load(std::memory_order_acquire))
+                continue;
+            std::uint64_t const local = rec.local_epoch.load(std::memory_order_acquire);
+            if((local & 1u) && (local >> 1) != epoch)
+                return false;
+        }
+
+        std::uint64_t expected = epoch;
+        global_epoch_.compare_exchange_strong(expected, epoch + 1, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed);
+        return true;
+    }
+
+    std::uint64_t epoch() const noexcept { return global_epoch_.load(std::memory_order_acquire); }
+    std::size_t   max_threads() const noexcept { return max_threads_; }
+    std::size_t   collect_threshold() const noexcept { return collect_threshold_; }
+
+    // Reclaims retired objects left behind by unregistered threads, returns the number reclaimed.
+    std::size_t collect_orphans()
+    {
+        if(orphan_bags_.load(std::memory_order_relaxed) == 0)
+            return 0;
+
+        std::uint64_t const epoch = this->epoch();
+        std::size_t         n     = 0;
+
+        std::lock_guard<std::mutex> lock(orphans_mutex_);
+        for(auto it = orphans_.begin(); it != orphans_.end();)
+        {
+            if(epoch >= it->epoch + 2)
+            {
+                n += it->reclaim();
+                it = orphans_.erase(it);
+                orphan_bags_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            else
+                ++it;
+        }
+        return n;
+    }
+
+private:
+    friend class epoch_handle;
+    friend class epoch_guard;
+
+    alignas(QS_CACHELINE_SIZE) std::atomic<std::uint64_t> global_epoch_{0};
+    alignas(QS_CACHELINE_SIZE) std::atomic<std::size_t> high_water_mark_{0};
+    std::atomic<std::size_t> active_handles_{0};
+
+    std::unique_ptr<cache_aligned<intl::epoch_record>[]> records_;
+    std::size_t const                                    max_threads_;
+    std::size_t const                                    collect_threshold_;
+
+    std::mutex                   orphans_mutex_;
+    std::vector<intl::epoch_bag> orphans_;
+    std::atomic<std::size_t>     orphan_bags_{0};
+
+    intl::epoch_record* acquire_record()
+    {
+        for(std::size_t i = 0; i < max_threads_; ++i)
+        {
+            bool expected = false;
+            if(records_[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            {
+                std::size_t hwm = high_water_mark_.load(std::memory_order_relaxed);
+                while(hwm < i + 1 &&
+                      !high_water_mark_.compare_exchange_weak(hwm, i + 1, std::memory_order_acq_rel))
+                {}
+                active_handles_.fetch_add(1, std::memory_order_relaxed);
+                return &records_[i];
+            }
+        }
+        throw std::length_error("qs::epoch_domain: too many registered threads");
+    }
+
+    void release_record(intl::epoch_record* rec, intl::epoch_bag* bags, std::size_t n_bags)
+    {
+        rec->local_epoch.store(0, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(orphans_mutex_);
+            for(std::size_t i = 0; i < n_bags; ++i)
+                if(!bags[i].items.empty())
+                {
+                    orphans_.push_back(std::move(bags[i]));
+                    orphan_bags_.fetch_add(1, std::memory_order_relaxed);
+                }
+        }
+        rec->in_use.store(false, std::memory_order_release);
+        active_handles_.fetch_sub(1, std::memory_order_release);
+    }
+};
+
+
+// RAII critical section, shared nodes read while the guard is alive are not reclaimed.
+class epoch_guard
+{
+public:
+    epoch_guard(epoch_guard&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {}
+
+    epoch_guard(epoch_guard const&)            = delete;
+    epoch_guard& operator=(epoch_guard const&) = delete;
+    epoch_guard& operator=(epoch_guard&&)      = delete;
+
+    inline ~epoch_guard();
+
+private:
+    friend class epoch_handle;
+
+    explicit epoch_guard(epoch_handle* handle) noexcept
+        : handle_(handle)
+    {}
+
+    epoch_handle* handle_;
+};
+
+
+// Per-thread participant of an `epoch_domain`, not thread-safe: owned and used by a single thread.
+class epoch_handle
+{
+public:
+    static constexpr std::size_t bag_count = 3;
+
+    epoch_handle(epoch_handle&& other) noexcept
+        : domain_(std::exchange(other.domain_, nullptr)),
+          record_(std::exchange(other.record_, nullptr)),
+          pin_depth_(std::exchange(other.pin_depth_, 0)),
+          pending_(std::exchange(other.pending_, 0))
+    {
+        for(std::size_t i = 0; i < bag_count; ++i)
+            bags_[i] = std::move(other.bags_[i]);
+    }
+
+    epoch_handle(epoch_handle const&)            = delete;
+    epoch_handle& operator=(epoch_handle const&) = delete;
+    epoch_handle& operator=(epoch_handle&&)      = delete;
+
+    ~epoch_handle()
+    {
+        if(domain_ == nullptr)
+            return;
+        QS_ASSERT(pin_depth_ == 0, "epoch_handle destroyed while pinned");
+        flush();
+        domain_->release_record(record_, bags_, bag_count);
+    }
+
+    // Enters a critical section, nested pins are allowed and only the outermost one publishes the epoch.
+    QS_NODISCARD epoch_guard pin() noexcept
+    {
+        if(pin_depth_++ == 0)
+        {
+            std::uint64_t epoch = domain_->global_epoch_.load(std::memory_order_relaxed);
+            while(true)
+            {
+                record_->local_epoch.store((epoch << 1) | 1u, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::uint64_t const current = domain_->global_epoch_.load(std::memory_order_relaxed);
+                if(QS_LIKELY(current == epoch))
+                    break;
+                epoch = current;
+            }
+        }
+        return epoch_guard(this);
+    }
+
+    bool is_pinned() const noexcept { return pin_depth_ > 0; }
+
+    // Defers `deleter(ptr)` until no thread can hold a reference obtained before the call.
+    void retire(void* ptr, void (*deleter)(void*))
+    {
+        std::uint64_t const epoch = domain_->global_epoch_.load(std::memory_order_acquire);
+        intl::epoch_bag&    bag   = bags_[epoch % bag_count];
+        if(bag.epoch != epoch)
+        {
+            // the bag holds objects retired at epoch - 3 or earlier, all of them are safe to free
+            pending_ -= bag.reclaim();
+            bag.epoch = epoch;
+            bag.items.reserve(domain_->collect_threshold_);
+        }
+        bag.items.push_back(intl::epoch_retired{ptr, deleter});
+
+        if(++pending_ % domain_->collect_threshold_ == 0)
+            collect();
+    }
+
+    // Typed form, `Deleter` is a stateless class; function pointers go to the overload above.
+    template<class T, class Deleter = std::default_delete<T>, enable_if_t<std::is_empty<Deleter>::value, int> = 0>
+    void retire(T* ptr, Deleter = Deleter{})
+    {
+        static_assert(std::is_default_constructible<Deleter>::value,
+                      "epoch_handle::retire: Deleter must be a stateless, default-constructible type");
+        retire(static_cast<void*>(ptr), &intl::epoch_deleter_thunk<T, Deleter>);
+    }
+
+    // Tries to advance the global epoch and reclaims all bags that became safe, returns the number reclaimed.
+    std::size_t collect()
+    {
+        // a pinned caller only blocks the advance if it is lagging behind, which pin() never leaves it
+        domain_->try_advance();
+
+        std::uint64_t const epoch = domain_->epoch();
+        std::size_t         n     = 0;
+        for(auto& bag: bags_)
+            if(!bag.items.empty() && epoch >= bag.epoch + 2)
+                n += bag.reclaim();
+        pending_ -= n;
+        return n + domain_->collect_orphans();
+    }
+
+    // Drives the global epoch forward until every object retired by this handle has been reclaimed.
+    // Must not be called while pinned, returns the number of objects reclaimed.
+    std::size_t flush()
+    {
+        QS_ASSERT(!is_pinned(), "epoch_handle::flush() called inside a critical section");
+        std::size_t n = 0;
+        for(std::size_t attempt = 0; pending_ > 0 && attempt < 2 * bag_count; ++attempt)
+            n += collect();
+        return n;
+    }
+
+    std::size_t   pending() const noexcept { return pending_; }
+    epoch_domain& domain() const noexcept { return *domain_; }
+
+private:
+    friend class epoch_domain;
+    friend class epoch_guard;
+
+    epoch_handle(epoch_domain* domain, intl::epoch_record* record) noexcept
+        : domain_(domain),
+          record_(record)
+    {}
+
+    void unpin() noexcept
+    {
+        QS_ASSERT(pin_depth_ > 0, "epoch_handle::unpin() without matching pin()");
+        if(--pin_depth_ == 0)
+            record_->local_epoch.store(record_->local_epoch.load(std::memory_order_relaxed) & ~std::uint64_t(1),
+                                       std::memory_order_release);
+    }
+
+    epoch_domain*       domain_;
+    intl::epoch_record* record_;
+    std::size_t         pin_depth_ = 0;
+    std::size_t         pending_   = 0;
+    intl::epoch_bag     bags_[bag_count];
+};
+
+
+inline epoch_guard::~epoch_guard()
+{
+    if(handle_ != nullptr)
+        handle_->unpin();
+}
+
+inline epoch_handle epoch_domain::register_thread()
+{
+    return epoch_handle(this, acquire_record());
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CONCURRENCY_EPOCH_H
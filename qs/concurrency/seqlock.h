@@ -0,0 +1,141 @@
+#ifndef QS_CONCURRENCY_SEQLOCK_H
+#define QS_CONCURRENCY_SEQLOCK_H
+
+#include <qs/concurrency/backoff.h>
+#include <qs/concurrency/cache_aligned.h>
+#include <qs/config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Fences of the seqlock protocol (H. Boehm, "Can seqlocks get along with programming language memory models?").
+    // Thread fences, since only they order against other threads; on x86 (TSO) acquire and release fences emit no
+    // instruction and only restrain the compiler, ARM (and anything weaker) gets the dmb barriers.
+    QS_ALWAYS_INLINE void seqlock_read_fence() noexcept { std::atomic_thread_fence(std::memory_order_acquire); }
+
+    QS_ALWAYS_INLINE void seqlock_write_fence() noexcept { std::atomic_thread_fence(std::memory_order_release); }
+} // namespace intl
+
+/**
+ * Sequence lock for read-mostly snapshots of a trivially copyable `T`, with a single writer.
+ *
+ * The version counter lives on its own cache line so that polling readers do not share a line with the
+ * payload being rewritten. Readers never write shared memory: `try_load` is wait-free (a single attempt that
+ * fails only when it raced a writer) and `load` retries until it observes a stable version. The payload is
+ * stored as relaxed atomic words, so concurrent reads of a torn value are not data races; torn copies are
+ * detected through the version and discarded.
+ *
+ * Writers must be externally serialized (one writer thread, or a lock around `store`/`update`).
+ */
+template<class T>
+class seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "qs::seqlock<T> requires a trivially copyable T");
+
+    using word_type = std::uintptr_t;
+
+    static constexpr std::size_t word_count = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+    static_assert(std::atomic<word_type>::is_always_lock_free, "qs::seqlock<T> requires lock-free word atomics");
+
+public:
+    using value_type    = T;
+    using sequence_type = std::uint64_t;
+
+    seqlock() noexcept
+        : seqlock(T{})
+    {}
+
+    explicit seqlock(T const& value) noexcept
+        : seq_(0)
+    {
+        write_words(value);
+    }
+
+    seqlock(seqlock const&)            = delete;
+    seqlock& operator=(seqlock const&) = delete;
+
+    // Single attempt to read a consistent snapshot, returns false if a write was in progress or raced.
+    bool try_load(T& out) const noexcept
+    {
+        sequence_type const before = seq_.load(std::memory_order_acquire);
+        if(before & 1u)
+            return false;
+        read_words(out);
+        intl::seqlock_read_fence();
+        return seq_.load(std::memory_order_relaxed) == before;
+    }
+
+    // Reads a consistent snapshot, retrying only while writes race the read.
+    T load() const noexcept
+    {
+        T out;
+        while(!try_load(out))
+            cpu_relax();
+        return out;
+    }
+
+    void store(T const& value) noexcept
+    {
+        sequence_type const seq = begin_write();
+        write_words(value);
+        end_write(seq);
+    }
+
+    // Read-modify-write of the snapshot: `fn(T&)` is applied to a private copy that is then published.
+    template<class Fn>
+    void update(Fn&& fn)
+    {
+        T value;
+        read_words(value);
+        fn(value);
+        store(value);
+    }
+
+    // Current version, even when no write is in progress, and incremented by two per write.
+    sequence_type version() const noexcept { return seq_.load(std::memory_order_acquire); }
+
+private:
+    cache_aligned<std::atomic<sequence_type>>         seq_;
+    alignas(QS_CACHELINE_SIZE) std::atomic<word_type> data_[word_count];
+
+    sequence_type begin_write() noexcept
+    {
+        sequence_type const seq = seq_.load(std::memory_order_relaxed);
+        QS_ASSERT((seq & 1u) == 0, "qs::seqlock: concurrent writers detected");
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        intl::seqlock_write_fence();
+        return seq;
+    }
+
+    void end_write(sequence_type seq) noexcept { seq_.store(seq + 2, std::memory_order_release); }
+
+    void read_words(T& out) const noexcept
+    {
+        word_type buffer[word_count];
+        for(std::size_t i = 0; i < word_count; ++i)
+            buffer[i] = data_[i].load(std::memory_order_relaxed);
+        std::memcpy(static_cast<void*>(std::addressof(out)), buffer, sizeof(T));
+    }
+
+    void write_words(T const& value) noexcept
+    {
+        word_type buffer[word_count] = {};
+        std::memcpy(buffer, static_cast<void const*>(std::addressof(value)), sizeof(T));
+        for(std::size_t i = 0; i < word_count; ++i)
+            data_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+};
+
+QS_NAMESPACE_END
+
+#endif // QS_CONCURRENCY_SEQLOCK_H
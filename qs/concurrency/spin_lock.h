@@ -0,0 +1,169 @@
+#ifndef QS_CONCURRENCY_SPIN_LOCK_H
+#define QS_CONCURRENCY_SPIN_LOCK_H
+
+#include <qs/concurrency/backoff.h>
+#include <qs/concurrency/cache_aligned.h>
+#include <qs/config.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Local to this header, undefined at its end.
+#ifdef QS_INTL_HAS_FUTEX
+#error "QS_INTL_HAS_FUTEX is internal to qs/concurrency/spin_lock.h and must not be defined elsewhere"
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define QS_INTL_HAS_FUTEX 1
+#else
+#define QS_INTL_HAS_FUTEX 0
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * Test-and-test-and-set spin lock, for critical sections of a few dozen cycles where parking a thread costs
+ * far more than the protected work. Waiters spin on a plain load (the line stays shared in their caches) with
+ * exponential `cpu_relax()` backoff, and only retry the exchange once the lock looks free.
+ * Meets the Lockable requirements, so it works with `std::lock_guard`/`std::unique_lock`.
+ */
+class spin_lock
+{
+public:
+    spin_lock() noexcept = default;
+
+    spin_lock(spin_lock const&)            = delete;
+    spin_lock& operator=(spin_lock const&) = delete;
+
+    void lock() noexcept
+    {
+        exponential_backoff<> backoff;
+        while(locked_.exchange(true, std::memory_order_acquire))
+        {
+            while(locked_.load(std::memory_order_relaxed))
+                backoff.pause();
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+    bool is_locked() const noexcept { return locked_.load(std::memory_order_relaxed); }
+
+private:
+    cache_aligned<std::atomic<bool>> locked_{false};
+};
+
+
+namespace intl
+{
+    // Parks the calling thread while `*addr == expected` (futex/atomic::wait), may return spuriously.
+    QS_INLINE void atomic_wait(std::atomic<std::uint32_t>& addr, std::uint32_t expected) noexcept
+    {
+#if QS_INTL_HAS_FUTEX
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word size mismatch");
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&addr), FUTEX_WAIT_PRIVATE, expected, nullptr,
+                  nullptr, 0);
+#elif defined(__cpp_lib_atomic_wait)
+        addr.wait(expected, std::memory_order_relaxed);
+#else
+        intl::ignore_unused(addr, expected);
+        std::this_thread::yield();
+#endif
+    }
+
+    QS_INLINE void atomic_notify_one(std::atomic<std::uint32_t>& addr) noexcept
+    {
+#if QS_INTL_HAS_FUTEX
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&addr), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(__cpp_lib_atomic_wait)
+        addr.notify_one();
+#else
+        intl::ignore_unused(addr);
+#endif
+    }
+} // namespace intl
+
+
+/**
+ * Hybrid mutex: spins for a bounded number of backoff rounds and then parks the thread on a futex
+ * (or `std::atomic::wait` where futexes are not available). The state machine is the three-state mutex of
+ * U. Drepper, "Futexes Are Tricky": 0 unlocked, 1 locked, 2 locked with (possible) sleepers, so an
+ * uncontended unlock never enters the kernel.
+ */
+template<std::uint32_t SpinRounds = 8>
+class basic_hybrid_mutex
+{
+    enum : std::uint32_t
+    {
+        unlocked  = 0,
+        locked    = 1,
+        contended = 2
+    };
+
+public:
+    basic_hybrid_mutex() noexcept = default;
+
+    basic_hybrid_mutex(basic_hybrid_mutex const&)            = delete;
+    basic_hybrid_mutex& operator=(basic_hybrid_mutex const&) = delete;
+
+    void lock() noexcept
+    {
+        std::uint32_t expected = unlocked;
+        if(QS_LIKELY(state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                                    std::memory_order_relaxed)))
+            return;
+        lock_slow();
+    }
+
+    bool try_lock() noexcept
+    {
+        std::uint32_t expected = unlocked;
+        return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        if(QS_UNLIKELY(state_.exchange(unlocked, std::memory_order_release) == contended))
+            intl::atomic_notify_one(state_);
+    }
+
+private:
+    cache_aligned<std::atomic<std::uint32_t>> state_{unlocked};
+
+    QS_NOINLINE void lock_slow() noexcept
+    {
+        exponential_backoff<> backoff;
+        for(std::uint32_t round = 0; round < SpinRounds; ++round)
+        {
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if(s == unlocked &&
+               state_.compare_exchange_weak(s, locked, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            if(s == contended)
+                break; // somebody is already sleeping, spinning further only steals the line
+            backoff.pause();
+        }
+
+        // from here on the lock is acquired as `contended`, since other threads may be parked
+        while(state_.exchange(contended, std::memory_order_acquire) != unlocked)
+            intl::atomic_wait(state_, contended);
+    }
+};
+
+using hybrid_mutex = basic_hybrid_mutex<>;
+
+QS_NAMESPACE_END
+
+#undef QS_INTL_HAS_FUTEX
+
+#endif // QS_CONCURRENCY_SPIN_LOCK_H
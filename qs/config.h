@@ -360,6 +360,15 @@
 #define QS_UNLIKELY(x) (x)
 #endif
 
+// Read prefetch hint into all cache levels, a no-op where the compiler has no builtin.
+#ifdef QS_PREFETCH
+// Use the provided definition.
+#elif QS_GCC_VERSION || QS_CLANG_VERSION
+#define QS_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define QS_PREFETCH(addr) static_cast<void>(addr)
+#endif
+
 #ifdef QS_MAYBE_UNUSED
 // Use the provided definition.
 #elif QS_HAS_CPP17_ATTRIBUTE(maybe_unused)
@@ -1,6 +1,7 @@
 #ifndef QS_CONTAINERS_FENWICKTREE_H_
 #define QS_CONTAINERS_FENWICKTREE_H_
 
+#include <qs/algorithm/scan.h>
 #include <qs/config.h>
 
 #include <vector>
@@ -53,6 +54,11 @@ private:
     QS_CONSTEXPR14 size_type recommend_size(size_type) const;
 
     QS_CONSTEXPR14 void build_prefix_tree(size_type = 0, size_type = std::numeric_limits<size_type>::max());
+
+    // Builds the whole tree from the values in `tree_[1, n]`.
+    QS_CONSTEXPR14 void build_tree();
+    QS_CONSTEXPR14 void build_tree(std::false_type);
+    QS_CONSTEXPR14 void build_tree(std::true_type);
 };
 
 
@@ -75,7 +81,8 @@ template<class T, class Allocator>
 QS_CONSTEXPR14 FenwickTree<T, Allocator>::FenwickTree(size_type n, value_type const& x, allocator_type const& a)
     : tree_(n + 1, x, a)
 {
-    build_prefix_tree();
+    tree_[0] = value_type();
+    build_tree();
 }
 
 template<class T, class Allocator>
@@ -83,13 +90,8 @@ template<class InputIterator>
 QS_CONSTEXPR14 FenwickTree<T, Allocator>::FenwickTree(InputIterator first, InputIterator last, allocator_type const& a)
     : tree_(1, a)
 {
-    size_type const n = std::distance(first, last);
-    tree_.resize(n + 1);
-    //tree_.insert(tree_.end(), first, last);
-    size_t i = 0;
-    while(first != last)
-        update(i++, *first++);
-    build_prefix_tree();
+    tree_.insert(tree_.end(), first, last);
+    build_tree();
 }
 
 template<class T, class Allocator>
@@ -174,6 +176,33 @@ QS_CONSTEXPR14 void FenwickTree<T, Allocator>::build_prefix_tree(size_type first
     }
 }
 
+template<class T, class Allocator>
+QS_CONSTEXPR14 void FenwickTree<T, Allocator>::build_tree()
+{
+    using fast_path = std::integral_constant<bool, std::is_integral<value_type>::value &&
+                                                       !std::is_void<intl::simd_scan_lane_t<value_type>>::value>;
+    build_tree(fast_path());
+}
+
+template<class T, class Allocator>
+QS_CONSTEXPR14 void FenwickTree<T, Allocator>::build_tree(std::false_type)
+{
+    build_prefix_tree();
+}
+
+// Node `i` holds the sum over `(i - lowbit(i), i]`, a difference of two prefix sums: one vectorized scan and an
+// independent subtraction per node, where the generic build chains each node's addition through its parent.
+// Done in unsigned arithmetic since prefix sums may overflow where the nodes do not.
+template<class T, class Allocator>
+QS_CONSTEXPR14 void FenwickTree<T, Allocator>::build_tree(std::true_type)
+{
+    using unsigned_type = typename std::make_unsigned<value_type>::type;
+    inclusive_scan(span<value_type>(tree_.data() + 1, size()));
+    for(size_type i = size(); i > 0; --i)
+        tree_[i] = static_cast<value_type>(static_cast<unsigned_type>(tree_[i]) -
+                                           static_cast<unsigned_type>(tree_[i & (i - 1)]));
+}
+
 
 #if defined(__cpp_deduction_guides)
 
@@ -0,0 +1,818 @@
+#ifndef QS_CONTAINERS_FLAT_HASH_MAP_H_
+#define QS_CONTAINERS_FLAT_HASH_MAP_H_
+
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/traits/iterator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if QS_X86_64
+#include <emmintrin.h>
+#elif QS_ARM64
+#include <arm_neon.h>
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+template<class Key, class T, class Hash, class KeyEqual>
+class flat_hash_map;
+
+namespace intl
+{
+    // Control bytes, one per slot: a full slot holds the low 7 bits of its hash (`h2`), so its sign bit is clear.
+    using hash_ctrl_t = std::int8_t;
+
+    QS_INLINE_VAR constexpr hash_ctrl_t hash_ctrl_empty    = -128;
+    QS_INLINE_VAR constexpr hash_ctrl_t hash_ctrl_deleted  = -2;
+    QS_INLINE_VAR constexpr hash_ctrl_t hash_ctrl_sentinel = -1; // past the last slot, stops iteration
+
+    QS_INLINE_VAR constexpr std::size_t hash_group_width = 16;
+
+    // Slots matched in a group, `Shift` giving the bits per slot in `bits` as a power of two.
+    template<class Bits, int Shift>
+    struct hash_group_mask
+    {
+        Bits bits;
+
+        explicit operator bool() const noexcept { return bits != 0; }
+        std::size_t lowest() const noexcept { return static_cast<std::size_t>(countr_zero(bits)) >> Shift; }
+        void        clear_lowest() noexcept { bits &= bits - 1; }
+    };
+
+#if QS_X86_64
+    // One SSE2 comparison per probe, its movemask giving a bit per slot.
+    struct hash_group
+    {
+        using mask = hash_group_mask<std::uint32_t, 0>;
+
+        __m128i ctrl;
+
+        explicit hash_group(hash_ctrl_t const* p) noexcept
+            : ctrl(_mm_load_si128(reinterpret_cast<__m128i const*>(p)))
+        {}
+
+        mask match(hash_ctrl_t h2) const noexcept { return bits(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)); }
+        mask match_empty() const noexcept { return match(hash_ctrl_empty); }
+        mask match_empty_or_deleted() const noexcept
+        {
+            return bits(_mm_cmpgt_epi8(_mm_set1_epi8(hash_ctrl_sentinel), ctrl));
+        }
+
+    private:
+        static mask bits(__m128i v) noexcept { return {static_cast<std::uint32_t>(_mm_movemask_epi8(v))}; }
+    };
+#elif QS_ARM64
+    // NEON has no movemask: narrowing the comparison by 4 bits per lane packs it into 64 bits, a nibble per slot.
+    struct hash_group
+    {
+        using mask = hash_group_mask<std::uint64_t, 2>;
+
+        int8x16_t ctrl;
+
+        explicit hash_group(hash_ctrl_t const* p) noexcept
+            : ctrl(vld1q_s8(p))
+        {}
+
+        mask match(hash_ctrl_t h2) const noexcept { return bits(vceqq_s8(ctrl, vdupq_n_s8(h2))); }
+        mask match_empty() const noexcept { return match(hash_ctrl_empty); }
+        mask match_empty_or_deleted() const noexcept { return bits(vcltq_s8(ctrl, vdupq_n_s8(hash_ctrl_sentinel))); }
+
+    private:
+        static mask bits(uint8x16_t v) noexcept
+        {
+            uint8x8_t const nibbles = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+            return {vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888u};
+        }
+    };
+#else
+    // Portable fallback, a loop over the 16 bytes that compilers vectorize where they can.
+    struct hash_group
+    {
+        using mask = hash_group_mask<std::uint32_t, 0>;
+
+        hash_ctrl_t ctrl[hash_group_width];
+
+        explicit hash_group(hash_ctrl_t const* p) noexcept { std::memcpy(ctrl, p, sizeof(ctrl)); }
+
+        mask match(hash_ctrl_t h2) const noexcept
+        {
+            std::uint32_t m = 0;
+            for(std::size_t i = 0; i < hash_group_width; ++i)
+                m |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+            return {m};
+        }
+        mask match_empty() const noexcept { return match(hash_ctrl_empty); }
+        mask match_empty_or_deleted() const noexcept
+        {
+            std::uint32_t m = 0;
+            for(std::size_t i = 0; i < hash_group_width; ++i)
+                m |= static_cast<std::uint32_t>(ctrl[i] < hash_ctrl_sentinel) << i;
+            return {m};
+        }
+    };
+#endif
+
+    // Control bytes of the tables without slots: a sentinel, so iteration ends at once. Never probed nor written.
+    QS_INLINE hash_ctrl_t* empty_hash_ctrl() noexcept
+    {
+        alignas(hash_group_width) static hash_ctrl_t ctrl[hash_group_width] = {hash_ctrl_sentinel};
+        return ctrl;
+    }
+
+    // Folded 64x64 -> 128-bit product with the golden ratio: every input bit reaches the low 7 bits (`h2`) and the
+    // group index, which `std::hash` of integers, the identity, leaves to chance. No seed, so a map's layout and
+    // iteration order are the same from run to run.
+    QS_ALWAYS_INLINE constexpr std::uint64_t hash_mix(std::uint64_t h) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using uint128_t = unsigned __int128;
+        uint128_t const p             = static_cast<uint128_t>(h) * 0x9e3779b97f4a7c15u;
+        return static_cast<std::uint64_t>(p) ^ static_cast<std::uint64_t>(p >> 64);
+#else
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdu;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53u;
+        return h ^ (h >> 33);
+#endif
+    }
+
+    // Hashes declaring `is_avalanching` are used as they are, without `hash_mix`.
+    template<class Hash, class = void>
+    struct is_avalanching_hash : std::false_type
+    {};
+    template<class Hash>
+    struct is_avalanching_hash<Hash, void_t<typename Hash::is_avalanching>> : std::true_type
+    {};
+
+    template<class Hash, class KeyEqual, class = void>
+    struct is_transparent_hash : std::false_type
+    {};
+    template<class Hash, class KeyEqual>
+    struct is_transparent_hash<Hash, KeyEqual, void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>>
+        : std::true_type
+    {};
+
+
+    // Entry of a `flat_hash_map` slot, as Abseil's `map_slot_type`: constructed and handed out as `value`, whose
+    // key is const, and moved out of as `mutable_value` when a rehash relocates it. The two pairs are layout
+    // compatible, a common initial sequence of the union as long as both are standard layout; otherwise the rehash
+    // copies the key.
+    template<class Key, class T>
+    union hash_map_slot
+    {
+        using value_type         = std::pair<Key const, T>;
+        using mutable_value_type = std::pair<Key, T>;
+
+        static constexpr bool mutable_keys =
+            std::is_standard_layout<value_type>::value && std::is_standard_layout<mutable_value_type>::value;
+
+        hash_map_slot() noexcept {}
+        ~hash_map_slot() noexcept {}
+
+        value_type         value;
+        mutable_value_type mutable_value;
+    };
+
+    template<class Slot, bool Const>
+    class flat_hash_map_iterator
+    {
+        template<class, bool>
+        friend class flat_hash_map_iterator;
+        template<class, class, class, class>
+        friend class QS_NAMESPACE::flat_hash_map;
+
+        using slot_pointer = conditional_t<Const, Slot const*, Slot*>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename Slot::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = conditional_t<Const, value_type const*, value_type*>;
+        using reference         = conditional_t<Const, value_type const&, value_type&>;
+
+        flat_hash_map_iterator() = default;
+
+        template<bool C = Const, enable_if_t<C, int> = 0>
+        flat_hash_map_iterator(flat_hash_map_iterator<Slot, false> const& other) noexcept
+            : ctrl_(other.ctrl_),
+              slot_(other.slot_)
+        {}
+
+        reference operator*() const noexcept { return slot_->value; }
+        pointer   operator->() const noexcept { return std::addressof(slot_->value); }
+
+        flat_hash_map_iterator& operator++() noexcept
+        {
+            ++ctrl_;
+            ++slot_;
+            skip_free();
+            return *this;
+        }
+        flat_hash_map_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(flat_hash_map_iterator const& l, flat_hash_map_iterator const& r) noexcept
+        {
+            return l.ctrl_ == r.ctrl_;
+        }
+        friend bool operator!=(flat_hash_map_iterator const& l, flat_hash_map_iterator const& r) noexcept
+        {
+            return l.ctrl_ != r.ctrl_;
+        }
+
+    private:
+        hash_ctrl_t const* ctrl_ = nullptr;
+        slot_pointer       slot_ = nullptr;
+
+        flat_hash_map_iterator(hash_ctrl_t const* ctrl, slot_pointer slot) noexcept
+            : ctrl_(ctrl),
+              slot_(slot)
+        {}
+
+        // Empty and deleted slots sort below the sentinel that ends the table.
+        void skip_free() noexcept
+        {
+            while(*ctrl_ < hash_ctrl_sentinel)
+            {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+    };
+} // namespace intl
+
+
+// Transparent string hash, for `flat_hash_map<std::string, T, qs::string_hash, std::equal_to<>>` looked up with
+// `std::string_view` and string literals without building a `std::string`.
+struct string_hash
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>()(s); }
+};
+
+
+/**
+ * Open-addressing hash map in the Swiss-table layout: one byte of control per slot, holding 7 bits of the hash of
+ * its key, with the entries in a flat array beside them. A lookup compares 16 control bytes at once (SSE2 on
+ * x86-64, NEON on AArch64, a portable loop elsewhere) and only compares the keys of slots whose 7 bits match, so
+ * a miss rarely touches an entry and a hit usually touches one. No node allocations, no pointer chase.
+ *
+ * Groups of 16 slots are probed quadratically from the group picked by the rest of the hash, the table growing
+ * at 7/8 load. Hashes are post-mixed (see `intl::hash_mix`) unless `Hash` declares `is_avalanching`; with no
+ * seed, the layout is deterministic. `reserve(n)` sizes the table once for `n` entries, after which inserting up
+ * to `n` never rehashes. Erasure leaves a tombstone only in groups that filled up since the last rehash; a table
+ * filled with tombstones is rebuilt in place rather than grown.
+ *
+ * Unlike `std::unordered_map`, any insertion may invalidate iterators and references (rehash moves the entries).
+ * Lookups are heterogeneous when both `Hash` and `KeyEqual` are transparent, see `string_hash`. Moving entries
+ * is assumed not to throw.
+ *
+ * Usage:
+ *      qs::flat_hash_map<std::string, book_state, qs::string_hash, std::equal_to<>> books;
+ *      books.reserve(symbol_count);
+ *      if(auto it = books.find(std::string_view(msg.symbol)); it != books.end())
+ *          it->second.apply(msg);
+ */
+template<class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_map
+{
+    using ctrl_t    = intl::hash_ctrl_t;
+    using group     = intl::hash_group;
+    using slot_type = intl::hash_map_slot<Key, T>;
+
+public:
+    using key_type        = Key;
+    using mapped_type     = T;
+    using value_type      = std::pair<Key const, T>;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator        = intl::flat_hash_map_iterator<slot_type, false>;
+    using const_iterator  = intl::flat_hash_map_iterator<slot_type, true>;
+
+    flat_hash_map() = default;
+    explicit flat_hash_map(size_type n, hasher const& hash = hasher(), key_equal const& eq = key_equal())
+        : hash_(hash),
+          eq_(eq)
+    {
+        reserve(n);
+    }
+
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    flat_hash_map(InputIterator first, InputIterator last, size_type n = 0, hasher const& hash = hasher(),
+                  key_equal const& eq = key_equal())
+        : flat_hash_map(n, hash, eq)
+    {
+        insert(first, last);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> il, size_type n = 0, hasher const& hash = hasher(),
+                  key_equal const& eq = key_equal())
+        : flat_hash_map(il.begin(), il.end(), n, hash, eq)
+    {}
+
+    flat_hash_map(flat_hash_map const& other);
+    flat_hash_map(flat_hash_map&& other) noexcept
+        : ctrl_(std::exchange(other.ctrl_, intl::empty_hash_ctrl())),
+          slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          growth_left_(std::exchange(other.growth_left_, 0)),
+          hash_(other.hash_),
+          eq_(other.eq_)
+    {}
+
+    flat_hash_map& operator=(flat_hash_map const& other)
+    {
+        if(this != &other)
+            flat_hash_map(other).swap(*this);
+        return *this;
+    }
+    flat_hash_map& operator=(flat_hash_map&& other) noexcept
+    {
+        flat_hash_map(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~flat_hash_map() { release(); }
+
+    // Iterators, in slot order
+    iterator       begin() noexcept { return skipped(iterator(ctrl_, slots_)); }
+    const_iterator begin() const noexcept { return skipped(const_iterator(ctrl_, slots_)); }
+    iterator       end() noexcept { return at_index(capacity_); }
+    const_iterator end() const noexcept { return at_index(capacity_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+    QS_NODISCARD bool      empty() const noexcept { return size_ == 0; }
+    QS_NODISCARD size_type size() const noexcept { return size_; }
+    QS_NODISCARD size_type capacity() const noexcept { return capacity_; }
+    QS_NODISCARD float     load_factor() const noexcept
+    {
+        return capacity_ == 0 ? 0.f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    // Makes room for `n` entries in all: at most one rehash, none if there already is. Never shrinks the table: one
+    // short of room for tombstones is rebuilt at its capacity.
+    void reserve(size_type n)
+    {
+        if(n > size_ + growth_left_)
+            resize(std::max(capacity_, capacity_for(n)));
+    }
+
+    hasher    hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+    // Element access
+    mapped_type& operator[](key_type const& k) { return try_emplace(k).first->second; }
+    mapped_type& operator[](key_type&& k) { return try_emplace(std::move(k)).first->second; }
+
+    mapped_type&       at(key_type const& k) { return slots_[checked_index(k)].value.second; }
+    mapped_type const& at(key_type const& k) const { return slots_[checked_index(k)].value.second; }
+
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    mapped_type& at(K const& k)
+    {
+        return slots_[checked_index(k)].value.second;
+    }
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    mapped_type const& at(K const& k) const
+    {
+        return slots_[checked_index(k)].value.second;
+    }
+
+    // Modifiers
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type const& k, Args&&... args)
+    {
+        return try_emplace_(k, std::forward<Args>(args)...);
+    }
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args)
+    {
+        return try_emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+    // Heterogeneous: the key is built from `k` only when it is inserted.
+    template<class K, class... Args, class H = Hash,
+             enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value &&
+                             !std::is_convertible<K&&, const_iterator>::value,
+                         int> = 0>
+    std::pair<iterator, bool> try_emplace(K&& k, Args&&... args)
+    {
+        return try_emplace_(std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(value_type const& v) { return try_emplace_(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v)
+    {
+        return try_emplace_(v.first, std::move(v.second));
+    }
+
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    void insert(InputIterator first, InputIterator last)
+    {
+        using category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr(std::is_base_of<std::forward_iterator_tag, category>::value)
+            reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+        for(; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+    template<class Range>
+    void insert_range(Range&& range)
+    {
+        using std::begin;
+        using std::end;
+        insert(begin(range), end(range));
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type const& k, M&& m)
+    {
+        auto res = try_emplace(k, std::forward<M>(m));
+        if(!res.second)
+            res.first->second = std::forward<M>(m);
+        return res;
+    }
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& m)
+    {
+        auto res = try_emplace(std::move(k), std::forward<M>(m));
+        if(!res.second)
+            res.first->second = std::forward<M>(m);
+        return res;
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+    iterator erase(const_iterator pos)
+    {
+        QS_VERIFY(pos != cend(), "flat_hash_map::erase of end()");
+        auto const i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+        erase_at(i);
+        return skipped(at_index(i + 1));
+    }
+
+    size_type erase(key_type const& k) { return erase_(k); }
+
+    template<class K, class H = Hash,
+             enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value &&
+                             !std::is_convertible<K const&, const_iterator>::value,
+                         int> = 0>
+    size_type erase(K const& k)
+    {
+        return erase_(k);
+    }
+
+    // Destroys the entries, keeping the table.
+    void clear() noexcept
+    {
+        if(capacity_ == 0)
+            return;
+        destroy_entries();
+        reset_ctrl();
+        size_        = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+    void swap(flat_hash_map& other) noexcept
+    {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+    friend void swap(flat_hash_map& l, flat_hash_map& r) noexcept { l.swap(r); }
+
+    // Lookup, heterogeneous with a transparent `Hash` and `KeyEqual`
+    iterator       find(key_type const& k) { return at_index(find_index(k)); }
+    const_iterator find(key_type const& k) const { return at_index(find_index(k)); }
+    bool           contains(key_type const& k) const { return find_index(k) != capacity_; }
+    size_type      count(key_type const& k) const { return contains(k) ? 1 : 0; }
+
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    iterator find(K const& k)
+    {
+        return at_index(find_index(k));
+    }
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    const_iterator find(K const& k) const
+    {
+        return at_index(find_index(k));
+    }
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    bool contains(K const& k) const
+    {
+        return find_index(k) != capacity_;
+    }
+    template<class K, class H = Hash, enable_if_t<intl::is_transparent_hash<H, KeyEqual>::value, int> = 0>
+    size_type count(K const& k) const
+    {
+        return contains(k) ? 1 : 0;
+    }
+
+private:
+    ctrl_t*     ctrl_        = intl::empty_hash_ctrl(); // `capacity_ + 1` bytes, the last one a sentinel
+    slot_type*  slots_       = nullptr;
+    size_type   capacity_    = 0; // 0 or 16 times a power of two
+    size_type   size_        = 0;
+    size_type   growth_left_ = 0; // inserts into empty slots before the table is full
+    hasher      hash_;
+    key_equal   eq_;
+
+    static constexpr size_type block_align =
+        alignof(slot_type) > intl::hash_group_width ? alignof(slot_type) : intl::hash_group_width;
+
+    static constexpr size_type max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+    // Largest power of two whose `block_size` fits in a `size_type`: one control byte, one slot and the padding.
+    static constexpr size_type max_capacity =
+        size_type(1) << (bit_width((SIZE_MAX - alignof(slot_type)) / (sizeof(slot_type) + 1)) - 1);
+
+    static size_type capacity_for(size_type n)
+    {
+        if(n > max_load(max_capacity))
+            throw std::length_error("flat_hash_map: too many elements");
+        size_type capacity = intl::hash_group_width;
+        while(max_load(capacity) < n)
+            capacity *= 2;
+        return capacity;
+    }
+
+    static size_type slots_offset(size_type capacity) noexcept
+    {
+        return (capacity + 1 + alignof(slot_type) - 1) / alignof(slot_type) * alignof(slot_type);
+    }
+    static size_type block_size(size_type capacity) noexcept
+    {
+        return slots_offset(capacity) + capacity * sizeof(slot_type);
+    }
+
+    iterator       at_index(size_type i) noexcept { return {ctrl_ + i, slots_ + i}; }
+    const_iterator at_index(size_type i) const noexcept { return {ctrl_ + i, slots_ + i}; }
+
+    template<class It>
+    static It skipped(It it) noexcept
+    {
+        it.skip_free();
+        return it;
+    }
+
+    template<class K>
+    std::size_t hash(K const& k) const
+    {
+        auto const h = static_cast<std::uint64_t>(hash_(k));
+        if constexpr(intl::is_avalanching_hash<Hash>::value)
+            return static_cast<std::size_t>(h);
+        else
+            return static_cast<std::size_t>(intl::hash_mix(h));
+    }
+
+    static ctrl_t h2(std::size_t h) noexcept { return static_cast<ctrl_t>(h & 0x7f); }
+
+    // Index of the first group probed for the hash `h`.
+    size_type first_group(std::size_t h) const noexcept { return (h >> 7) & (capacity_ / intl::hash_group_width - 1); }
+
+    // Triangular steps over the groups, which visit each of a power-of-two count once.
+    size_type next_group(size_type g, size_type& step) const noexcept
+    {
+        return (g + ++step) & (capacity_ / intl::hash_group_width - 1);
+    }
+
+    // Slot of the key equivalent to `k`, `capacity_` when there is none.
+    template<class K>
+    size_type find_index(K const& k) const
+    {
+        if(capacity_ == 0)
+            return 0;
+        return find_index(k, hash(k));
+    }
+
+    template<class K>
+    size_type find_index(K const& k, std::size_t h) const
+    {
+        size_type step = 0;
+        for(size_type g = first_group(h);; g = next_group(g, step))
+        {
+            size_type const base = g * intl::hash_group_width;
+            group const     grp(ctrl_ + base);
+            for(auto m = grp.match(h2(h)); m; m.clear_lowest())
+            {
+                size_type const i = base + m.lowest();
+                if(QS_LIKELY(eq_(slots_[i].value.first, k)))
+                    return i;
+            }
+            if(QS_LIKELY(grp.match_empty()))
+                return capacity_;
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of `h`; the table has one.
+    size_type find_free(std::size_t h) const noexcept
+    {
+        size_type step = 0;
+        for(size_type g = first_group(h);; g = next_group(g, step))
+        {
+            size_type const base = g * intl::hash_group_width;
+            if(auto const m = group(ctrl_ + base).match_empty_or_deleted())
+                return base + m.lowest();
+        }
+    }
+
+    template<class K>
+    size_type checked_index(K const& k) const
+    {
+        size_type const i = find_index(k);
+        if(i == capacity_)
+            throw std::out_of_range("flat_hash_map::at");
+        return i;
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace_(K&& k, Args&&... args);
+
+    template<class K>
+    size_type erase_(K const& k)
+    {
+        size_type const i = find_index(k);
+        if(i == capacity_)
+            return 0;
+        erase_at(i);
+        return 1;
+    }
+
+    // A probe stops at the first group with an empty slot, so the slot can become empty again if its group still
+    // has one: no key was then placed past this group. Otherwise it is a tombstone, until the next rehash.
+    void erase_at(size_type i) noexcept
+    {
+        slots_[i].value.~value_type();
+        --size_;
+        size_type const base = i / intl::hash_group_width * intl::hash_group_width;
+        if(group(ctrl_ + base).match_empty())
+        {
+            ctrl_[i] = intl::hash_ctrl_empty;
+            ++growth_left_;
+        }
+        else
+            ctrl_[i] = intl::hash_ctrl_deleted;
+    }
+
+    void reset_ctrl() noexcept
+    {
+        std::memset(ctrl_, static_cast<unsigned char>(intl::hash_ctrl_empty), capacity_);
+        ctrl_[capacity_] = intl::hash_ctrl_sentinel;
+    }
+
+    void destroy_entries() noexcept
+    {
+        if constexpr(!std::is_trivially_destructible<value_type>::value)
+            for(size_type i = 0; i < capacity_; ++i)
+                if(ctrl_[i] >= 0)
+                    slots_[i].value.~value_type();
+    }
+
+    void release() noexcept
+    {
+        if(capacity_ == 0)
+            return;
+        destroy_entries();
+        ::operator delete(static_cast<void*>(ctrl_), std::align_val_t(block_align));
+    }
+
+    void resize(size_type capacity);
+    void rehash_and_grow();
+};
+
+
+template<class Key, class T, class Hash, class KeyEqual>
+flat_hash_map<Key, T, Hash, KeyEqual>::flat_hash_map(flat_hash_map const& other)
+    : flat_hash_map(0, other.hash_, other.eq_)
+{
+    reserve(other.size_);
+    for(auto const& v: other)
+    {
+        std::size_t const h = hash(v.first);
+        size_type const   i = find_free(h);
+        ::new(static_cast<void*>(std::addressof(slots_[i].value))) value_type(v);
+        ctrl_[i] = h2(h);
+        ++size_;
+        --growth_left_;
+    }
+}
+
+// Allocates the new table before touching the old one, then moves each entry to the first free slot of its probe
+// sequence: no key comparisons, the keys being distinct.
+template<class Key, class T, class Hash, class KeyEqual>
+void flat_hash_map<Key, T, Hash, KeyEqual>::resize(size_type capacity)
+{
+    if(capacity > max_capacity)
+        throw std::length_error("flat_hash_map: too many elements");
+    void* const block = ::operator new(block_size(capacity), std::align_val_t(block_align));
+
+    ctrl_t* const    old_ctrl     = ctrl_;
+    slot_type* const old_slots    = slots_;
+    size_type const  old_capacity = capacity_;
+
+    ctrl_     = static_cast<ctrl_t*>(block);
+    slots_    = reinterpret_cast<slot_type*>(static_cast<unsigned char*>(block) + slots_offset(capacity));
+    capacity_ = capacity;
+    reset_ctrl();
+    std::uninitialized_default_construct_n(slots_, capacity); // no-op, begins the lifetime of the empty unions
+
+    for(size_type j = 0; j < old_capacity; ++j)
+    {
+        if(old_ctrl[j] < 0)
+            continue;
+        std::size_t const h = hash(old_slots[j].value.first);
+        size_type const   i = find_free(h);
+        void* const       p = std::addressof(slots_[i].value);
+        // The source is destroyed right after, so its key may be moved from, as through a node handle.
+        if constexpr(slot_type::mutable_keys)
+            ::new(p) value_type(std::move(old_slots[j].mutable_value));
+        else
+            ::new(p) value_type(std::move(old_slots[j].value));
+        ctrl_[i] = h2(h);
+        old_slots[j].value.~value_type();
+    }
+    growth_left_ = max_load(capacity) - size_;
+
+    if(old_capacity != 0)
+        ::operator delete(static_cast<void*>(old_ctrl), std::align_val_t(block_align));
+}
+
+// Out of empty slots: the first table, a rebuild in place when tombstones hold at least half of the load, else
+// twice the capacity.
+template<class Key, class T, class Hash, class KeyEqual>
+void flat_hash_map<Key, T, Hash, KeyEqual>::rehash_and_grow()
+{
+    if(capacity_ == 0)
+        resize(intl::hash_group_width);
+    else if(size_ <= max_load(capacity_) / 2)
+        resize(capacity_);
+    else
+        resize(capacity_ * 2);
+}
+
+template<class Key, class T, class Hash, class KeyEqual>
+template<class K, class... Args>
+std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual>::iterator, bool>
+flat_hash_map<Key, T, Hash, KeyEqual>::try_emplace_(K&& k, Args&&... args)
+{
+    std::size_t const h = hash(k);
+    if(capacity_ != 0)
+    {
+        size_type const found = find_index(k, h);
+        if(found != capacity_)
+            return {at_index(found), false};
+    }
+
+    size_type i = capacity_ == 0 ? 0 : find_free(h);
+    if(capacity_ == 0 || (growth_left_ == 0 && ctrl_[i] == intl::hash_ctrl_empty))
+    {
+        rehash_and_grow();
+        i = find_free(h);
+    }
+
+    ::new(static_cast<void*>(std::addressof(slots_[i].value)))
+        value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    growth_left_ -= ctrl_[i] == intl::hash_ctrl_empty ? 1 : 0;
+    ctrl_[i] = h2(h);
+    ++size_;
+    return {at_index(i), true};
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CONTAINERS_FLAT_HASH_MAP_H_
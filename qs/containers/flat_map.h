@@ -0,0 +1,514 @@
+#ifndef QS_CONTAINERS_FLAT_MAP_H_
+#define QS_CONTAINERS_FLAT_MAP_H_
+
+#include <qs/algorithm/lower_bound.h>
+#include <qs/config.h>
+#include <qs/containers/inplace_vector.h>
+#include <qs/exception_guard.h>
+#include <qs/span.h>
+#include <qs/traits/iterator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    template<class Compare, class = void>
+    struct is_transparent_compare : std::false_type
+    {};
+    template<class Compare>
+    struct is_transparent_compare<Compare, void_t<typename Compare::is_transparent>> : std::true_type
+    {};
+
+    // Whether `Container` stores its elements contiguously behind `data()`, which `std::vector<bool>` does not.
+    template<class Container, class = void>
+    struct has_contiguous_data : std::false_type
+    {};
+    template<class Container>
+    struct has_contiguous_data<Container, void_t<decltype(std::declval<Container&>().data())>>
+        : std::is_same<decltype(std::declval<Container&>().data()), typename Container::value_type*>
+    {};
+
+    // Position of the first key not less than `k` in sorted contiguous `keys`, with the branchless search.
+    template<class Keys, class K, class Compare>
+    QS_INLINE std::size_t flat_lower_index(Keys const& keys, K const& k, Compare const& comp)
+    {
+        span<typename Keys::value_type const> const s(keys.data(), keys.size());
+        return static_cast<std::size_t>(QS_NAMESPACE::lower_bound(s, k, comp) - s.begin());
+    }
+
+    // Staging buffer of the bulk inserts: on the heap by default, in place for in-place storage, which could not
+    // take in more new keys than its capacity anyway.
+    template<class Container, class V>
+    struct flat_batch
+    {
+        using type                     = std::vector<V>;
+        static constexpr bool in_place = false;
+    };
+    template<class T, std::size_t N, class V>
+    struct flat_batch<inplace_vector<T, N>, V>
+    {
+        using type                     = inplace_vector<V, N>;
+        static constexpr bool in_place = true;
+    };
+
+    template<class Keys, class K, class Compare>
+    QS_INLINE std::size_t flat_upper_index(Keys const& keys, K const& k, Compare const& comp)
+    {
+        using key_type = typename Keys::value_type;
+        return flat_lower_index(keys, k, [&comp](key_type const& e, K const& x) { return !comp(x, e); });
+    }
+
+    // Iterator over the parallel key and value arrays of a `flat_map`, dereferencing to a pair of references.
+    // `Mapped` is const qualified for the const_iterator.
+    template<class Key, class Mapped>
+    class flat_map_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::pair<Key, remove_cv_t<Mapped>>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::pair<Key const&, Mapped&>;
+
+        // `it->second` through a temporary pair of references
+        struct pointer
+        {
+            reference ref;
+
+            QS_CONSTEXPR14 reference const* operator->() const noexcept { return &ref; }
+        };
+
+        QS_CONSTEXPR11 flat_map_iterator() noexcept = default;
+        QS_CONSTEXPR11 flat_map_iterator(Key const* key, Mapped* value) noexcept
+            : key_(key),
+              value_(value)
+        {}
+
+        // iterator to const_iterator
+        template<class M, enable_if_t<std::is_same<M const, Mapped>::value && !std::is_same<M, Mapped>::value, int> = 0>
+        QS_CONSTEXPR11 flat_map_iterator(flat_map_iterator<Key, M> const& other) noexcept
+            : key_(other.key()),
+              value_(other.value())
+        {}
+
+        QS_CONSTEXPR11 Key const* key() const noexcept { return key_; }
+        QS_CONSTEXPR11 Mapped*    value() const noexcept { return value_; }
+
+        QS_CONSTEXPR11 reference operator*() const noexcept { return {*key_, *value_}; }
+        QS_CONSTEXPR11 pointer   operator->() const noexcept { return {**this}; }
+        QS_CONSTEXPR11 reference operator[](difference_type n) const noexcept { return {key_[n], value_[n]}; }
+
+        QS_CONSTEXPR14 flat_map_iterator& operator++() noexcept { return *this += 1; }
+        QS_CONSTEXPR14 flat_map_iterator& operator--() noexcept { return *this -= 1; }
+        QS_CONSTEXPR14 flat_map_iterator  operator++(int) noexcept { return std::exchange(*this, *this + 1); }
+        QS_CONSTEXPR14 flat_map_iterator  operator--(int) noexcept { return std::exchange(*this, *this - 1); }
+
+        QS_CONSTEXPR14 flat_map_iterator& operator+=(difference_type n) noexcept
+        {
+            key_ += n;
+            value_ += n;
+            return *this;
+        }
+        QS_CONSTEXPR14 flat_map_iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+        friend QS_CONSTEXPR14 flat_map_iterator operator+(flat_map_iterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+        friend QS_CONSTEXPR14 flat_map_iterator operator+(difference_type n, flat_map_iterator it) noexcept
+        {
+            return it += n;
+        }
+        friend QS_CONSTEXPR14 flat_map_iterator operator-(flat_map_iterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+        friend QS_CONSTEXPR11 difference_type operator-(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ - r.key_;
+        }
+
+        friend QS_CONSTEXPR11 bool operator==(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ == r.key_;
+        }
+        friend QS_CONSTEXPR11 bool operator!=(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ != r.key_;
+        }
+        friend QS_CONSTEXPR11 bool operator<(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ < r.key_;
+        }
+        friend QS_CONSTEXPR11 bool operator>(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ > r.key_;
+        }
+        friend QS_CONSTEXPR11 bool operator<=(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ <= r.key_;
+        }
+        friend QS_CONSTEXPR11 bool operator>=(flat_map_iterator const& l, flat_map_iterator const& r) noexcept
+        {
+            return l.key_ >= r.key_;
+        }
+
+    private:
+        Key const* key_   = nullptr;
+        Mapped*    value_ = nullptr;
+    };
+} // namespace intl
+
+
+/**
+ * Sorted associative container over two contiguous arrays, keys in one and mapped values in the other, as
+ * C++23 `std::flat_map`. Lookups run the branchless `qs::lower_bound` over the keys alone, so a search touches
+ * only key cache lines and mispredicts nothing; iteration is a linear scan. Single inserts and erases shift the
+ * tail like `std::vector` does, while `insert_range` sorts the batch and merges it in one pass, O(n + m log m).
+ * With `inplace_vector` storage the batch is staged in place too, sorted by insertion as it is read.
+ *
+ * Keys are unique; on duplicate keys, inserts keep the element already in the map (or the first of the batch).
+ * Iterators are invalidated by any insertion or erasure. `KeyContainer` and `MappedContainer` are contiguous
+ * sequences (`std::vector`, `inplace_vector`); see `inplace_flat_map` for maps that fit in a fixed capacity.
+ * `std::vector<bool>` is not contiguous, so `bool` keys or values need another container, or a byte type
+ * such as `std::uint8_t`.
+ *
+ * Usage:
+ *      qs::flat_map<std::int64_t, std::uint32_t> levels; // price -> quantity
+ *      levels.insert_range(snapshot);                    // pairs in any order
+ *      if(auto it = levels.find(price); it != levels.end())
+ *          it->second += quantity;
+ */
+template<class Key, class T, class Compare = std::less<Key>, class KeyContainer = std::vector<Key>,
+         class MappedContainer = std::vector<T>>
+class flat_map
+{
+    static_assert(intl::has_contiguous_data<KeyContainer>::value && intl::has_contiguous_data<MappedContainer>::value,
+                  "flat_map: containers must be contiguous with data(), std::vector<bool> is not (store flags as "
+                  "std::uint8_t, or use inplace_vector<bool, N>)");
+
+public:
+    using key_type              = Key;
+    using mapped_type           = T;
+    using value_type            = std::pair<key_type, mapped_type>;
+    using key_compare           = Compare;
+    using reference             = std::pair<key_type const&, mapped_type&>;
+    using const_reference       = std::pair<key_type const&, mapped_type const&>;
+    using size_type             = std::size_t;
+    using difference_type       = std::ptrdiff_t;
+    using iterator              = intl::flat_map_iterator<key_type, mapped_type>;
+    using const_iterator        = intl::flat_map_iterator<key_type, mapped_type const>;
+    using key_container_type    = KeyContainer;
+    using mapped_container_type = MappedContainer;
+
+    flat_map() = default;
+    explicit flat_map(key_compare const& comp)
+        : comp_(comp)
+    {}
+
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    flat_map(InputIterator first, InputIterator last, key_compare const& comp = key_compare())
+        : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> il, key_compare const& comp = key_compare())
+        : flat_map(il.begin(), il.end(), comp)
+    {}
+
+    // Iterators
+    iterator       begin() noexcept { return at_index(0); }
+    const_iterator begin() const noexcept { return at_index(0); }
+    iterator       end() noexcept { return at_index(size()); }
+    const_iterator end() const noexcept { return at_index(size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+    QS_NODISCARD bool      empty() const noexcept { return keys_.empty(); }
+    QS_NODISCARD size_type size() const noexcept { return keys_.size(); }
+
+    void reserve(size_type n)
+    {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+
+    // Underlying arrays, sorted by key
+    key_container_type const&    keys() const noexcept { return keys_; }
+    mapped_container_type const& values() const noexcept { return values_; }
+    key_compare                  key_comp() const { return comp_; }
+
+    // Element access
+    mapped_type& operator[](key_type const& k) { return try_emplace(k).first->second; }
+    mapped_type& operator[](key_type&& k) { return try_emplace(std::move(k)).first->second; }
+
+    mapped_type&       at(key_type const& k) { return values_[checked_index(k)]; }
+    mapped_type const& at(key_type const& k) const { return values_[checked_index(k)]; }
+
+    // Modifiers
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type const& k, Args&&... args)
+    {
+        return try_emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args)
+    {
+        return try_emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(value_type const& v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v) { return try_emplace(std::move(v.first), std::move(v.second)); }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type const& k, M&& m)
+    {
+        auto res = try_emplace(k, std::forward<M>(m));
+        if(!res.second)
+            res.first->second = std::forward<M>(m);
+        return res;
+    }
+
+    // Bulk insertion: sorts the batch then merges it with the map in one pass.
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    void insert(InputIterator first, InputIterator last);
+
+    void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+    template<class Range>
+    void insert_range(Range&& range)
+    {
+        using std::begin;
+        using std::end;
+        insert(begin(range), end(range));
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+    iterator erase(const_iterator pos)
+    {
+        QS_VERIFY(cbegin() <= pos && pos < cend(), "flat_map::erase position out of bounds");
+        auto const i = static_cast<size_type>(pos - cbegin());
+        keys_.erase(keys_.begin() + static_cast<difference_type>(i));
+        values_.erase(values_.begin() + static_cast<difference_type>(i));
+        return at_index(i);
+    }
+
+    size_type erase(key_type const& k)
+    {
+        auto const it = find(k);
+        if(it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    void clear() noexcept
+    {
+        keys_.clear();
+        values_.clear();
+    }
+
+    // Lookup, heterogeneous with a transparent `Compare`
+    iterator       find(key_type const& k) { return at_index(find_index(k)); }
+    const_iterator find(key_type const& k) const { return at_index(find_index(k)); }
+    bool           contains(key_type const& k) const { return find_index(k) != size(); }
+    size_type      count(key_type const& k) const { return contains(k) ? 1 : 0; }
+
+    iterator       lower_bound(key_type const& k) { return at_index(intl::flat_lower_index(keys_, k, comp_)); }
+    const_iterator lower_bound(key_type const& k) const { return at_index(intl::flat_lower_index(keys_, k, comp_)); }
+    iterator       upper_bound(key_type const& k) { return at_index(intl::flat_upper_index(keys_, k, comp_)); }
+    const_iterator upper_bound(key_type const& k) const { return at_index(intl::flat_upper_index(keys_, k, comp_)); }
+
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    iterator find(K const& k)
+    {
+        return at_index(find_index(k));
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator find(K const& k) const
+    {
+        return at_index(find_index(k));
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    bool contains(K const& k) const
+    {
+        return find_index(k) != size();
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    size_type count(K const& k) const
+    {
+        return contains(k) ? 1 : 0;
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    iterator lower_bound(K const& k)
+    {
+        return at_index(intl::flat_lower_index(keys_, k, comp_));
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator lower_bound(K const& k) const
+    {
+        return at_index(intl::flat_lower_index(keys_, k, comp_));
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    iterator upper_bound(K const& k)
+    {
+        return at_index(intl::flat_upper_index(keys_, k, comp_));
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator upper_bound(K const& k) const
+    {
+        return at_index(intl::flat_upper_index(keys_, k, comp_));
+    }
+
+private:
+    key_container_type    keys_;
+    mapped_container_type values_;
+    key_compare           comp_;
+
+    iterator       at_index(size_type i) noexcept { return {keys_.data() + i, values_.data() + i}; }
+    const_iterator at_index(size_type i) const noexcept { return {keys_.data() + i, values_.data() + i}; }
+
+    // Index of the key equivalent to `k`, `size()` when there is none.
+    template<class K>
+    size_type find_index(K const& k) const
+    {
+        size_type const i = intl::flat_lower_index(keys_, k, comp_);
+        return i < size() && !comp_(k, keys_[i]) ? i : size();
+    }
+
+    size_type checked_index(key_type const& k) const
+    {
+        size_type const i = find_index(k);
+        if(i == size())
+            throw std::out_of_range("flat_map::at");
+        return i;
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace_(K&& k, Args&&... args);
+
+    template<class Batch>
+    void merge_(Batch& batch);
+};
+
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class K, class... Args>
+auto flat_map<Key, T, Compare, KeyContainer, MappedContainer>::try_emplace_(K&& k, Args&&... args)
+    -> std::pair<iterator, bool>
+{
+    size_type const i = intl::flat_lower_index(keys_, k, comp_);
+    if(i < size() && !comp_(k, keys_[i]))
+        return {at_index(i), false};
+
+    auto const pos = static_cast<difference_type>(i);
+    keys_.insert(keys_.begin() + pos, std::forward<K>(k));
+    auto guard = make_exception_guard([&] { keys_.erase(keys_.begin() + pos); });
+    values_.emplace(values_.begin() + pos, std::forward<Args>(args)...);
+    guard.complete();
+    return {at_index(i), true};
+}
+
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int>>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::insert(InputIterator first, InputIterator last)
+{
+    using batch_traits = intl::flat_batch<key_container_type, value_type>;
+    auto const by_key  = [this](value_type const& l, value_type const& r) { return comp_(l.first, r.first); };
+    typename batch_traits::type batch;
+    if constexpr(batch_traits::in_place)
+    {
+        // A few keys at most: sorted by insertion, skipping the ones already staged or in the map. A batch with
+        // more new keys than the capacity throws `std::bad_alloc` before the map is touched.
+        for(; first != last; ++first)
+        {
+            value_type v(*first);
+            auto const pos = std::lower_bound(batch.begin(), batch.end(), v, by_key);
+            if((pos == batch.end() || comp_(v.first, pos->first)) && find_index(v.first) == size())
+                batch.insert(pos, std::move(v));
+        }
+    }
+    else
+    {
+        batch.assign(first, last);
+        std::stable_sort(batch.begin(), batch.end(), by_key);
+        batch.erase(std::unique(batch.begin(), batch.end(),
+                                [this](value_type const& l, value_type const& r) { return !comp_(l.first, r.first); }),
+                    batch.end());
+
+        // Drops the keys already in the map, leaving the exact size to reserve before anything is moved.
+        auto      out = batch.begin();
+        size_type i   = 0;
+        for(auto& v: batch)
+        {
+            while(i < size() && comp_(keys_[i], v.first))
+                ++i;
+            if(i < size() && !comp_(v.first, keys_[i]))
+                continue;
+            if(&*out != &v)
+                *out = std::move(v);
+            ++out;
+        }
+        batch.erase(out, batch.end());
+    }
+    merge_(batch);
+}
+
+// Merges the sorted batch of new keys into fresh arrays. The map's elements are copied when their moves could throw,
+// so until the final assignments a throw leaves the map as it was; those assignments move element by element for
+// in-place storage, where only elements with non-throwing moves keep that guarantee.
+template<class Key, class T, class Compare, class KeyContainer, class MappedContainer>
+template<class Batch>
+void flat_map<Key, T, Compare, KeyContainer, MappedContainer>::merge_(Batch& batch)
+{
+    if(batch.empty())
+        return;
+
+    key_container_type    keys;
+    mapped_container_type values;
+    keys.reserve(size() + batch.size());
+    values.reserve(size() + batch.size());
+    size_type i = 0;
+    auto      b = batch.begin();
+    while(i < size() || b != batch.end())
+    {
+        if(b != batch.end() && (i == size() || comp_(b->first, keys_[i])))
+        {
+            keys.emplace_back(std::move(b->first));
+            values.emplace_back(std::move(b->second));
+            ++b;
+        }
+        else
+        {
+            keys.emplace_back(std::move_if_noexcept(keys_[i]));
+            values.emplace_back(std::move_if_noexcept(values_[i]));
+            ++i;
+        }
+    }
+    keys_   = std::move(keys);
+    values_ = std::move(values);
+}
+
+
+// `flat_map` stored in place, for tiny maps: no allocation, bulk inserts included; inserts past `N` elements throw
+// `std::bad_alloc`.
+template<class Key, class T, std::size_t N, class Compare = std::less<Key>>
+using inplace_flat_map = flat_map<Key, T, Compare, inplace_vector<Key, N>, inplace_vector<T, N>>;
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CONTAINERS_FLAT_MAP_H_
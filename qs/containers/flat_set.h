@@ -0,0 +1,250 @@
+#ifndef QS_CONTAINERS_FLAT_SET_H_
+#define QS_CONTAINERS_FLAT_SET_H_
+
+#include <qs/config.h>
+#include <qs/containers/flat_map.h>
+#include <qs/containers/inplace_vector.h>
+#include <qs/exception_guard.h>
+#include <qs/traits/iterator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * Sorted set over one contiguous array, as C++23 `std::flat_set`, with the lookups of `flat_map`: the branchless
+ * `qs::lower_bound`, heterogeneous with a transparent `Compare`. `insert_range` sorts the batch, appends its new
+ * keys and merges them in place, O(n + m log m) instead of m shifting inserts. With `inplace_vector` storage the
+ * batch is staged and merged in place, without allocating. Elements are read-only through the iterators.
+ * `KeyContainer` is contiguous, which `std::vector<bool>` is not: use `inplace_flat_set<bool, 2>` for a set of
+ * `bool`.
+ *
+ * Usage:
+ *      qs::flat_set<std::uint64_t> ids(batch.begin(), batch.end());
+ *      if(ids.contains(id))
+ *          ...
+ */
+template<class Key, class Compare = std::less<Key>, class KeyContainer = std::vector<Key>>
+class flat_set
+{
+    static_assert(intl::has_contiguous_data<KeyContainer>::value,
+                  "flat_set: KeyContainer must be contiguous with data(), std::vector<bool> is not (use "
+                  "inplace_flat_set<bool, 2>)");
+
+public:
+    using key_type        = Key;
+    using value_type      = Key;
+    using key_compare     = Compare;
+    using value_compare   = Compare;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator        = value_type const*;
+    using const_iterator  = value_type const*;
+    using container_type  = KeyContainer;
+
+    flat_set() = default;
+    explicit flat_set(key_compare const& comp)
+        : comp_(comp)
+    {}
+
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    flat_set(InputIterator first, InputIterator last, key_compare const& comp = key_compare())
+        : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    flat_set(std::initializer_list<value_type> il, key_compare const& comp = key_compare())
+        : flat_set(il.begin(), il.end(), comp)
+    {}
+
+    // Iterators
+    const_iterator begin() const noexcept { return keys_.data(); }
+    const_iterator end() const noexcept { return keys_.data() + keys_.size(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+    QS_NODISCARD bool      empty() const noexcept { return keys_.empty(); }
+    QS_NODISCARD size_type size() const noexcept { return keys_.size(); }
+    void                   reserve(size_type n) { keys_.reserve(n); }
+
+    // Underlying array, sorted
+    container_type const& keys() const noexcept { return keys_; }
+    key_compare           key_comp() const { return comp_; }
+
+    // Modifiers
+    std::pair<iterator, bool> insert(value_type const& k) { return insert_(k); }
+    std::pair<iterator, bool> insert(value_type&& k) { return insert_(std::move(k)); }
+
+    // Bulk insertion: sorts the batch, then appends its new keys and merges them in place.
+    template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
+    void insert(InputIterator first, InputIterator last);
+
+    void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+    template<class Range>
+    void insert_range(Range&& range)
+    {
+        using std::begin;
+        using std::end;
+        insert(begin(range), end(range));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        QS_VERIFY(cbegin() <= pos && pos < cend(), "flat_set::erase position out of bounds");
+        auto const i = pos - cbegin();
+        keys_.erase(keys_.begin() + i);
+        return begin() + i;
+    }
+
+    size_type erase(key_type const& k)
+    {
+        size_type const i = find_index(k);
+        if(i == size())
+            return 0;
+        erase(begin() + i);
+        return 1;
+    }
+
+    void clear() noexcept { keys_.clear(); }
+
+    // Lookup, heterogeneous with a transparent `Compare`
+    const_iterator find(key_type const& k) const { return begin() + find_index(k); }
+    bool           contains(key_type const& k) const { return find_index(k) != size(); }
+    size_type      count(key_type const& k) const { return contains(k) ? 1 : 0; }
+    const_iterator lower_bound(key_type const& k) const { return begin() + intl::flat_lower_index(keys_, k, comp_); }
+    const_iterator upper_bound(key_type const& k) const { return begin() + intl::flat_upper_index(keys_, k, comp_); }
+
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator find(K const& k) const
+    {
+        return begin() + find_index(k);
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    bool contains(K const& k) const
+    {
+        return find_index(k) != size();
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    size_type count(K const& k) const
+    {
+        return contains(k) ? 1 : 0;
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator lower_bound(K const& k) const
+    {
+        return begin() + intl::flat_lower_index(keys_, k, comp_);
+    }
+    template<class K, class C = Compare, enable_if_t<intl::is_transparent_compare<C>::value, int> = 0>
+    const_iterator upper_bound(K const& k) const
+    {
+        return begin() + intl::flat_upper_index(keys_, k, comp_);
+    }
+
+private:
+    container_type keys_;
+    key_compare    comp_;
+
+    // Index of the key equivalent to `k`, `size()` when there is none.
+    template<class K>
+    size_type find_index(K const& k) const
+    {
+        size_type const i = intl::flat_lower_index(keys_, k, comp_);
+        return i < size() && !comp_(k, keys_[i]) ? i : size();
+    }
+
+    template<class K>
+    std::pair<iterator, bool> insert_(K&& k)
+    {
+        size_type const i = intl::flat_lower_index(keys_, k, comp_);
+        if(i < size() && !comp_(k, keys_[i]))
+            return {begin() + i, false};
+        keys_.insert(keys_.begin() + static_cast<difference_type>(i), std::forward<K>(k));
+        return {begin() + i, true};
+    }
+};
+
+
+template<class Key, class Compare, class KeyContainer>
+template<class InputIterator, enable_if_t<is_input_iterator_tagged<InputIterator>::value, int>>
+void flat_set<Key, Compare, KeyContainer>::insert(InputIterator first, InputIterator last)
+{
+    using batch_traits = intl::flat_batch<container_type, key_type>;
+    typename batch_traits::type batch;
+    if constexpr(batch_traits::in_place)
+    {
+        // A few keys at most: sorted by insertion, skipping the ones already staged or in the set. A batch with
+        // more new keys than the capacity throws `std::bad_alloc` before the set is touched.
+        for(; first != last; ++first)
+        {
+            key_type   k(*first);
+            auto const pos = std::lower_bound(batch.begin(), batch.end(), k, comp_);
+            if((pos == batch.end() || comp_(k, *pos)) && find_index(k) == size())
+                batch.insert(pos, std::move(k));
+        }
+        if(batch.empty())
+            return;
+
+        // `std::inplace_merge` asks for a temporary buffer, the merge goes to fresh storage instead.
+        container_type keys;
+        keys.reserve(size() + batch.size());
+        std::merge(std::make_move_iterator(keys_.begin()), std::make_move_iterator(keys_.end()),
+                   std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()),
+                   std::back_inserter(keys), comp_);
+        keys_ = std::move(keys);
+    }
+    else
+    {
+        batch.assign(first, last);
+        std::sort(batch.begin(), batch.end(), comp_);
+        auto const equivalent = [this](key_type const& l, key_type const& r) { return !comp_(l, r); };
+        batch.erase(std::unique(batch.begin(), batch.end(), equivalent), batch.end());
+
+        // Drops the keys already in the set, so the merge below has no duplicates to remove.
+        auto      out = batch.begin();
+        size_type i   = 0;
+        for(auto& k: batch)
+        {
+            while(i < size() && comp_(keys_[i], k))
+                ++i;
+            if(i < size() && !comp_(k, keys_[i]))
+                continue;
+            if(&*out != &k)
+                *out = std::move(k);
+            ++out;
+        }
+        batch.erase(out, batch.end());
+        if(batch.empty())
+            return;
+
+        auto const old_size = static_cast<difference_type>(size());
+        keys_.reserve(size() + batch.size());
+        auto guard = make_exception_guard([&] { keys_.erase(keys_.begin() + old_size, keys_.end()); });
+        for(auto& k: batch)
+            keys_.emplace_back(std::move(k));
+        std::inplace_merge(keys_.begin(), keys_.begin() + old_size, keys_.end(), comp_);
+        guard.complete();
+    }
+}
+
+
+// `flat_set` stored in place, for tiny sets: no allocation, bulk inserts included; inserts past `N` elements throw
+// `std::bad_alloc`.
+template<class Key, std::size_t N, class Compare = std::less<Key>>
+using inplace_flat_set = flat_set<Key, Compare, inplace_vector<Key, N>>;
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CONTAINERS_FLAT_SET_H_
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <new>
@@ -270,7 +271,7 @@ struct inplace_vector_base<T, Capacity, false>
         : inplace_vector_base()
     {
         // auto guard = make_exception_guard([&]{ this->clear_(); });
-        this->construct_back_range_(other.data_(), other.end_, other.size_());
+        this->construct_back_range_(other.data_(), other.data_(other.size_()), other.size_());
         // guard.complete();
     }
 
@@ -280,7 +281,7 @@ struct inplace_vector_base<T, Capacity, false>
         if(this != std::addressof(rhs))
         {
             auto guard = make_exception_guard([&] { this->clear_(); });
-            this->assign_range_(rhs.data_(), rhs.end_, rhs.size_());
+            this->assign_range_(rhs.data_(), rhs.data_(rhs.size_()), rhs.size_());
             guard.complete();
         }
         return *this;
@@ -323,7 +324,7 @@ struct inplace_vector_base<T, Capacity, false>
     QS_CONSTEXPR20 void construct_back_single_(Args&&... args)
     {
         construction_transaction<pointer> tx(this->end_, 1);
-        construct_at(this->end_, std::forward<Args>(args)...);
+        qs::construct_at(this->end_, std::forward<Args>(args)...);
         tx.commit();
     }
 
@@ -331,14 +332,14 @@ struct inplace_vector_base<T, Capacity, false>
     {
         construction_transaction<pointer> tx(this->end_, n);
         for(pointer pos = this->end_; pos != tx.new_end; ++pos, tx.commit())
-            construct_at(pos);
+            qs::construct_at(pos);
     }
 
     QS_CONSTEXPR20 void construct_back_n_(size_type n, const_reference x)
     {
         construction_transaction<pointer> tx(this->end_, n);
         for(pointer pos = this->end_; pos != tx.new_end; ++pos, tx.commit())
-            construct_at(pos, x);
+            qs::construct_at(pos, x);
     }
 
     template<class Iterator, class Sentinel>
@@ -349,7 +350,7 @@ struct inplace_vector_base<T, Capacity, false>
 
         construction_transaction<pointer> tx(this->end_, n);
         for(pointer pos = this->end_; first != last; ++pos, ++first, tx.commit())
-            construct_at(pos, *first);
+            qs::construct_at(pos, *first);
 
         guard.complete();
     }
@@ -388,14 +389,14 @@ struct inplace_vector_base<T, Capacity, false>
         {
             construction_transaction<pointer> tx(this->end_, m);
             for(pointer i = from_mid, pos = old_last; i < from_end; ++i, ++pos, tx.commit())
-                construct_at(pos, std::move(*i));
+                qs::construct_at(pos, std::move(*i));
         }
         std::move_backward(from_start, from_mid, old_last);
     }
 
     QS_CONSTEXPR20 void destroy_back_(pointer new_end) noexcept
     {
-        reverse_destroy(new_end, this->end_);
+        qs::reverse_destroy(new_end, this->end_);
         this->end_ = new_end;
     }
 
@@ -404,8 +405,8 @@ struct inplace_vector_base<T, Capacity, false>
     struct alignas(value_type) inner_element_t
     {
         byte                         elem_[sizeof(value_type)];
-        QS_CONSTEXPR14 pointer       recast() { return launder(reinterpret_cast<pointer>(elem_)); }
-        QS_CONSTEXPR14 const_pointer recast() const { return launder(reinterpret_cast<const_pointer>(elem_)); }
+        QS_CONSTEXPR14 pointer       recast() { return qs::launder(reinterpret_cast<pointer>(elem_)); }
+        QS_CONSTEXPR14 const_pointer recast() const { return qs::launder(reinterpret_cast<const_pointer>(elem_)); }
     };
     static_assert(sizeof(inner_element_t) == sizeof(value_type) && alignof(inner_element_t) == alignof(value_type),
                   "inner_element_t is not the same size/alignment as value_type");
@@ -432,6 +433,18 @@ struct inplace_vector_base<T, Capacity, true>
     QS_CONSTEXPR14 inplace_vector_base()
         : end_(data_()) {};
 
+    // `end_` points into the own buffer, so the copies rebase it instead of copying it
+    QS_CONSTEXPR14 inplace_vector_base(inplace_vector_base const& other) noexcept
+        : end_(std::copy(other.data_(), other.data_(other.size_()), data_()))
+    {}
+
+    QS_CONSTEXPR14 inplace_vector_base& operator=(inplace_vector_base const& rhs) noexcept
+    {
+        if(this != std::addressof(rhs))
+            end_ = std::copy(rhs.data_(), rhs.data_(rhs.size_()), data_());
+        return *this;
+    }
+
     QS_CONSTEXPR20 ~inplace_vector_base() noexcept { clear_(); }
 
     QS_CONSTEXPR14 pointer       data_(size_type n = 0) noexcept { return buffer_ + n; }
@@ -445,20 +458,24 @@ struct inplace_vector_base<T, Capacity, true>
         *(this->end_++) = value_type{std::forward<Args>(args)...};
     }
 
-    QS_CONSTEXPR20 void construct_back_n_(size_type n) { assign_n_(n, value_type{}); }
+    QS_CONSTEXPR20 void construct_back_n_(size_type n) { construct_back_n_(n, value_type{}); }
 
-    QS_CONSTEXPR20 void construct_back_n_(size_type n, const_reference x) { assign_n_(n, x); }
+    QS_CONSTEXPR20 void construct_back_n_(size_type n, const_reference x)
+    {
+        this->end_ = std::fill_n(this->end_, n, x);
+    }
 
     template<class Iterator, class Sentinel>
-    QS_CONSTEXPR20 void construct_back_range_(Iterator first, Sentinel last, size_type n)
+    QS_CONSTEXPR20 void construct_back_range_(Iterator first, Sentinel last, size_type)
     {
-        assign_range_(first, last, n);
+        this->end_ = std::copy(first, last, this->end_);
     }
 
     QS_CONSTEXPR20 void move_range_(pointer from_start, pointer from_end, pointer to)
     {
         auto const n = static_cast<size_t>(from_end - from_start);
         std::memmove(to, from_start, n * sizeof(value_type));
+        this->end_ = std::max(this->end_, to + n);
     }
 
     QS_CONSTEXPR20 void assign_n_(size_type n, const_reference x)
@@ -470,7 +487,7 @@ struct inplace_vector_base<T, Capacity, true>
     template<class Iterator, class Sentinel>
     QS_CONSTEXPR20 void assign_range_(Iterator first, Sentinel last, size_type)
     {
-        this->end_ = std::copy(first, last, this->end_);
+        this->end_ = std::copy(first, last, this->data_());
     }
 
     QS_CONSTEXPR20 void destroy_back_(pointer new_end) noexcept { this->end_ = new_end; }
@@ -532,7 +549,8 @@ public:
 
     // Constructor for initializing from a range of iterators
     template<class InputIterator,
-             enable_it_t<is_std_iterator_exact<InputIterator, std::input_iterator_tag, value_type>::value, int> = 0>
+             enable_if_t<is_input_iterator_tagged<InputIterator>::value &&
+                             !is_forward_iterator_tagged<InputIterator>::value, int> = 0>
     QS_CONSTEXPR11 inplace_vector(InputIterator first, InputIterator last)
         : inplace_vector()
     {
@@ -545,7 +563,7 @@ public:
     }
 
     template<class ForwardIterator,
-             enable_it_t<is_std_iterator<ForwardIterator, std::forward_iterator_tag, value_type>::value, int> = 0>
+             enable_if_t<is_forward_iterator_tagged<ForwardIterator>::value, int> = 0>
     QS_CONSTEXPR11 inplace_vector(ForwardIterator first, ForwardIterator last)
         : inplace_vector()
     {
@@ -569,7 +587,8 @@ public:
     // Assign functions for various scenarios
 
     template<class InputIterator,
-             enable_it_t<is_std_iterator_exact<InputIterator, std::input_iterator_tag, value_type>::value, int> = 0>
+             enable_if_t<is_input_iterator_tagged<InputIterator>::value &&
+                             !is_forward_iterator_tagged<InputIterator>::value, int> = 0>
     QS_CONSTEXPR11 void assign(InputIterator first, InputIterator last)
     {
         clear();
@@ -578,7 +597,7 @@ public:
     }
 
     template<class ForwardIterator,
-             enable_it_t<is_std_iterator<ForwardIterator, std::forward_iterator_tag, value_type>::value, int> = 0>
+             enable_if_t<is_forward_iterator_tagged<ForwardIterator>::value, int> = 0>
     QS_CONSTEXPR11 void assign(ForwardIterator first, ForwardIterator last)
     {
         auto const new_size = static_cast<size_type>(std::distance(first, last));
@@ -593,7 +612,7 @@ public:
             else
             {
                 pointer new_end = std::copy(first, last, base::data_());
-                base::destruct_back_(new_end);
+                base::destroy_back_(new_end);
             }
         }
         else
@@ -685,25 +704,38 @@ public:
     QS_CONSTEXPR14 const_pointer data() const noexcept { return base::data_(); };
 
     // Modifiers
-    QS_CONSTEXPR11 void push_back(value_type const& x);
-    QS_CONSTEXPR11 void push_back(value_type&& x);
+    QS_CONSTEXPR11 void push_back(value_type const& x) { emplace_back(x); }
+    QS_CONSTEXPR11 void push_back(value_type&& x) { emplace_back(std::move(x)); }
 
     // new in inplace_vector, does not throw, does nothing if the vector is full
-    QS_CONSTEXPR11 void try_push_back(value_type const& x);
-    QS_CONSTEXPR11 void try_push_back(value_type&& x);
+    QS_CONSTEXPR11 void try_push_back(value_type const& x) { try_emplace_back(x); }
+    QS_CONSTEXPR11 void try_push_back(value_type&& x) { try_emplace_back(std::move(x)); }
 
-    QS_CONSTEXPR11 void unchecked_push_back(value_type const& x);
-    QS_CONSTEXPR11 void unchecked_push_back(value_type&& x);
+    QS_CONSTEXPR11 void unchecked_push_back(value_type const& x) { unchecked_emplace_back(x); }
+    QS_CONSTEXPR11 void unchecked_push_back(value_type&& x) { unchecked_emplace_back(std::move(x)); }
 
     template<class... Args>
-    QS_CONSTEXPR17 reference emplace_back(Args&&... args);
+    QS_CONSTEXPR17 reference emplace_back(Args&&... args)
+    {
+        if(size() == capacity())
+            throw_bad_alloc_();
+        return *unchecked_emplace_back(std::forward<Args>(args)...);
+    }
 
     // new in inplace_vector, does not throw, instead returns a pointer to the inserted element
     template<class... Args>
-    QS_CONSTEXPR17 pointer try_emplace_back(Args&&... args);
+    QS_CONSTEXPR17 pointer try_emplace_back(Args&&... args)
+    {
+        return size() == capacity() ? nullptr : unchecked_emplace_back(std::forward<Args>(args)...);
+    }
 
     template<class... Args>
-    QS_CONSTEXPR17 pointer unchecked_emplace_back(Args&&... args);
+    QS_CONSTEXPR17 pointer unchecked_emplace_back(Args&&... args)
+    {
+        QS_VERIFY(size() < capacity(), "inplace_vector::unchecked_emplace_back called on a full vector");
+        base::construct_back_single_(std::forward<Args>(args)...);
+        return base::end_ - 1;
+    }
 
     QS_CONSTEXPR11 void pop_back()
     {
@@ -712,20 +744,47 @@ public:
     }
 
     template<class... Args>
-    QS_CONSTEXPR17 iterator emplace(const_iterator position, Args&&... args);
+    QS_CONSTEXPR17 iterator emplace(const_iterator position, Args&&... args)
+    {
+        QS_VERIFY(cbegin() <= position && position <= cend(), "inplace_vector::emplace position out of bounds");
+        if(size() == capacity())
+            throw_bad_alloc_();
+        pointer const pos = base::data_() + (position - cbegin());
+        if(pos == base::end_)
+            base::construct_back_single_(std::forward<Args>(args)...);
+        else
+        {
+            value_type tmp(std::forward<Args>(args)...); // `args` may refer to an element about to move
+            base::move_range_(pos, base::end_, pos + 1);
+            *pos = std::move(tmp);
+        }
+        return wrap_iter(pos);
+    }
 
-    QS_CONSTEXPR11 iterator insert(const_iterator position, value_type const& x);
-    QS_CONSTEXPR11 iterator insert(const_iterator position, value_type&& x);
+    QS_CONSTEXPR11 iterator insert(const_iterator position, value_type const& x) { return emplace(position, x); }
+    QS_CONSTEXPR11 iterator insert(const_iterator position, value_type&& x) { return emplace(position, std::move(x)); }
     QS_CONSTEXPR11 iterator insert(const_iterator position, size_type n, value_type const& x);
 
     template<class InputIterator,
-             enable_it_t<is_std_iterator<InputIterator, std::input_iterator_tag, value_type>::value, int> = 0>
+             enable_if_t<is_input_iterator_tagged<InputIterator>::value, int> = 0>
     QS_CONSTEXPR11 iterator insert(const_iterator position, InputIterator first, InputIterator last);
 
     QS_CONSTEXPR11 iterator insert(const_iterator position, std::initializer_list<value_type> il);
 
-    QS_CONSTEXPR11 iterator erase(const_iterator position);
-    QS_CONSTEXPR11 iterator erase(const_iterator first, const_iterator last);
+    QS_CONSTEXPR11 iterator erase(const_iterator position)
+    {
+        QS_VERIFY(cbegin() <= position && position < cend(), "inplace_vector::erase position out of bounds");
+        return erase(position, position + 1);
+    }
+
+    QS_CONSTEXPR11 iterator erase(const_iterator first, const_iterator last)
+    {
+        QS_VERIFY(cbegin() <= first && first <= last && last <= cend(), "inplace_vector::erase invalid range");
+        pointer const pos = base::data_() + (first - cbegin());
+        if(first != last)
+            base::destroy_back_(std::move(pos + (last - first), base::end_, pos));
+        return wrap_iter(pos);
+    }
 
     QS_CONSTEXPR11 void clear() noexcept { base::clear_(); }
 
@@ -0,0 +1,236 @@
+#ifndef QS_CONTAINERS_STATIC_SEARCH_TREE_H_
+#define QS_CONTAINERS_STATIC_SEARCH_TREE_H_
+
+#include <qs/algorithm/simd_ops.h>
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Implicit B-tree ("S-tree") of `count` 64-byte nodes of `B` keys, stored breadth-first: node `k` has its
+    // `B + 1` children at `k * (B + 1) + 1 ...`, so nothing but the keys is stored. A search returns the slot
+    // `k * B + i` of the first key not less than `x` in the in-order sequence, `count * B` when there is none.
+    QS_INLINE_VAR constexpr std::size_t stree_node_bytes = 64;
+
+    QS_ALWAYS_INLINE constexpr std::size_t stree_child(std::size_t k, std::size_t i, std::size_t b) noexcept
+    {
+        return k * (b + 1) + i + 1;
+    }
+
+    // Keys of a node counted with branch-free comparisons, which compilers vectorize where no kernel applies.
+    template<class Node, class T, class Compare>
+    inline std::size_t stree_search_scalar(Node const* nodes, std::size_t count, T const& x, Compare const& comp)
+    {
+        constexpr std::size_t b    = std::extent<decltype(Node::keys)>::value;
+        std::size_t           slot = count * b;
+        std::size_t           k    = 0;
+        while(k < count)
+        {
+            std::size_t i = 0;
+            for(std::size_t j = 0; j < b; ++j)
+                i += comp(nodes[k].keys[j], x) ? 1 : 0;
+            slot = i < b ? k * b + i : slot;
+            k    = stree_child(k, i, b);
+        }
+        return slot;
+    }
+
+    // The kernels cover `std::less` on 4-byte keys, 16 of them to a node.
+    template<class T, class Compare>
+    using stree_simd_lane_t = conditional_t<
+        sizeof(T) == 4 && (std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::less<T>>::value),
+        simd_ordered_lane_t<T>, void>;
+
+
+#if QS_HAS_X86_DISPATCH
+    // AVX2: a node is two vectors, the rank is the popcount of their joined comparison masks.
+    template<class T>
+    QS_TARGET_AVX2 std::size_t stree_search_avx2(T const* keys, std::size_t count, T x) noexcept
+    {
+        using ops        = avx2_ops<T>;
+        auto const  v    = ops::set1(x);
+        std::size_t slot = count * 16;
+        std::size_t k    = 0;
+        while(k < count)
+        {
+            std::uint32_t const lo = ops::bits(ops::lt(ops::load(keys + k * 16), v));
+            std::uint32_t const hi = ops::bits(ops::lt(ops::load(keys + k * 16 + 8), v));
+            std::size_t const   i  = static_cast<std::size_t>(popcount(lo | hi << 8));
+            slot                   = i < 16 ? k * 16 + i : slot;
+            k                      = stree_child(k, i, 16);
+        }
+        return slot;
+    }
+
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    // AVX-512: a node is one vector, the comparison gives the mask to count directly.
+    template<class T>
+    QS_TARGET_AVX512 std::size_t stree_search_avx512(T const* keys, std::size_t count, T x) noexcept
+    {
+        using ops        = avx512_ops<T>;
+        auto const  v    = ops::set1(x);
+        std::size_t slot = count * 16;
+        std::size_t k    = 0;
+        while(k < count)
+        {
+            std::size_t const i = static_cast<std::size_t>(popcount(ops::lt(ops::load(keys + k * 16), v)));
+            slot                = i < 16 ? k * 16 + i : slot;
+            k                   = stree_child(k, i, 16);
+        }
+        return slot;
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+
+
+    template<class Node, class T>
+    QS_INLINE std::size_t stree_search_dispatch(Node const* nodes, std::size_t count, T x) noexcept
+    {
+        static_assert(sizeof(Node) == 16 * sizeof(T), "stree_search_dispatch: the kernels take 16 keys per node");
+#if QS_HAS_X86_DISPATCH
+        T const* const keys = reinterpret_cast<T const*>(nodes);
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return stree_search_avx512(keys, count, x);
+            case simd_level::avx2: return stree_search_avx2(keys, count, x);
+            case simd_level::scalar: break;
+        }
+#endif
+        return stree_search_scalar(nodes, count, x, std::less<>());
+    }
+} // namespace intl
+
+
+/**
+ * Read-only sorted set laid out for `lower_bound`: the keys are rearranged into an implicit B-tree of
+ * cache-line nodes, so a lookup loads one line per level (log17(n) of them for 4-byte keys) where a binary search
+ * loads one per halving. Within a node the rank of the searched key is counted without branches, with one
+ * AVX-512 or two AVX2 comparisons for `std::int32_t`, `std::uint32_t` and `float` keys under `std::less` (see
+ * `active_simd_level()`), with a plain loop otherwise.
+ *
+ * Built once from a sorted span, at most 2^32 - 1 keys; lookups return positions into that span. Float keys must
+ * not be NaN. The tree holds a copy of the keys padded to whole nodes, plus 4 bytes of position per key.
+ *
+ * Usage:
+ *      qs::static_search_tree<std::int32_t> const levels(qs::make_span(sorted_prices));
+ *      std::size_t i = levels.lower_bound(price); // first i with sorted_prices[i] >= price, or levels.size()
+ */
+template<class T, class Compare = std::less<>>
+class static_search_tree
+{
+public:
+    using value_type  = T;
+    using key_compare = Compare;
+    using size_type   = std::size_t;
+
+    // Keys per node, a node filling a cache line.
+    static constexpr size_type node_keys =
+        intl::stree_node_bytes / sizeof(T) < 2 ? 2 : intl::stree_node_bytes / sizeof(T);
+
+    static_search_tree() = default;
+    explicit static_search_tree(span<T const> sorted, Compare const& comp = Compare());
+
+    QS_NODISCARD size_type size() const noexcept { return size_; }
+    QS_NODISCARD bool      empty() const noexcept { return size_ == 0; }
+
+    // Position in the sorted input of the first key not less than `x`, `size()` when there is none.
+    QS_NODISCARD size_type lower_bound(T const& x) const;
+
+    QS_NODISCARD bool contains(T const& x) const;
+
+private:
+    struct alignas(intl::stree_node_bytes) node
+    {
+        T keys[node_keys];
+    };
+
+    std::vector<node>          nodes_;
+    std::vector<std::uint32_t> positions_; // by slot, `size_` for the padding
+    size_type                  size_ = 0;
+    Compare                    comp_;
+
+    void      build(span<T const> sorted, size_type k, size_type& next);
+    size_type find_slot(T const& x) const;
+};
+
+
+template<class T, class Compare>
+static_search_tree<T, Compare>::static_search_tree(span<T const> sorted, Compare const& comp)
+    : nodes_((sorted.size() + node_keys - 1) / node_keys),
+      positions_(nodes_.size() * node_keys),
+      size_(sorted.size()),
+      comp_(comp)
+{
+    QS_VERIFY(sorted.size() < std::numeric_limits<std::uint32_t>::max(), "static_search_tree: too many keys");
+    size_type next = 0;
+    build(sorted, 0, next);
+}
+
+// In-order walk over the slots, handing out the sorted keys then the padding (copies of the largest key, which
+// keep every node sorted and are never the first key not less than a searched one).
+template<class T, class Compare>
+void static_search_tree<T, Compare>::build(span<T const> sorted, size_type k, size_type& next)
+{
+    if(k >= nodes_.size())
+        return;
+    for(size_type i = 0; i < node_keys; ++i)
+    {
+        build(sorted, intl::stree_child(k, i, node_keys), next);
+        size_type const slot = k * node_keys + i;
+        if(next < sorted.size())
+        {
+            nodes_[k].keys[i] = sorted[next];
+            positions_[slot]  = static_cast<std::uint32_t>(next++);
+        }
+        else
+        {
+            nodes_[k].keys[i] = sorted.back();
+            positions_[slot]  = static_cast<std::uint32_t>(size_);
+        }
+    }
+    build(sorted, intl::stree_child(k, node_keys, node_keys), next);
+}
+
+template<class T, class Compare>
+typename static_search_tree<T, Compare>::size_type static_search_tree<T, Compare>::find_slot(T const& x) const
+{
+    using lane = intl::stree_simd_lane_t<T, Compare>;
+    if constexpr(std::is_void<lane>::value)
+        return intl::stree_search_scalar(nodes_.data(), nodes_.size(), x, comp_);
+    else
+        return intl::stree_search_dispatch(nodes_.data(), nodes_.size(), x);
+}
+
+template<class T, class Compare>
+typename static_search_tree<T, Compare>::size_type static_search_tree<T, Compare>::lower_bound(T const& x) const
+{
+    size_type const slot = find_slot(x);
+    return slot < positions_.size() ? positions_[slot] : size_;
+}
+
+template<class T, class Compare>
+bool static_search_tree<T, Compare>::contains(T const& x) const
+{
+    size_type const slot = find_slot(x);
+    return slot < positions_.size() && !comp_(x, nodes_[slot / node_keys].keys[slot % node_keys]);
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_CONTAINERS_STATIC_SEARCH_TREE_H_
@@ -0,0 +1,180 @@
+#ifndef QS_MATH_BINOMIAL_H
+#define QS_MATH_BINOMIAL_H
+
+#include <qs/config.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * Batch inversion (Montgomery's trick): `out[i] = 1 / a[i]` for all `i` with one modular inverse and 3(n - 1)
+ * multiplications, from the prefix products of `a`. `Mod` is a `mod_int<p>` with `p` prime; the `a[i]` must be
+ * nonzero and `out` must not overlap `a`.
+ *
+ * Usage:
+ *      qs::batch_inverse(qs::make_span(denominators), qs::make_span(inverses));
+ */
+template<class Mod>
+QS_CONSTEXPR14 void batch_inverse(type_identity_t<span<Mod const>> a,
+                                  span<Mod> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size(), "batch_inverse: size mismatch");
+    if(a.empty())
+        return;
+    Mod prefix(1);
+    for(std::size_t i = 0; i < a.size(); ++i)
+    {
+        out[i] = prefix; // a[0] * ... * a[i - 1]
+        prefix *= a[i];
+    }
+    Mod inv = prefix.pow(Mod::mod() - 2); // Fermat, 1 / (a[0] * ... * a[n - 1])
+    for(std::size_t i = a.size(); i-- > 0;)
+    {
+        out[i] *= inv;
+        inv *= a[i];
+    }
+}
+
+
+/**
+ * Factorials and inverse factorials modulo a prime, answering `C(n, k) mod p` in O(1) for `n` in the table and
+ * with Lucas's theorem (one O(1) lookup per base-`p` digit) above it, when the table covers `[0, p)`.
+ * Building costs O(n) multiplications and a single modular inverse: the inverse factorials are the batch inversion
+ * of `batch_inverse` specialized to prefix products, `1/(n-1)!` being inverted once and the others following from
+ * `1/(i-1)! = i/i!`. Digits of Lucas's theorem past a smaller table cost O(k) and one inverse.
+ * `Mod` is a `mod_int<p>` with `p` prime. The table never extends past `p - 1`, where factorials vanish.
+ *
+ * With a static size `N` the table lives inline and can be built at compile time:
+ *      constexpr qs::binomial_table<qs::mod_int<1000003>, 64> small;
+ *      static_assert(small(10, 3) == 120);
+ * With the default dynamic size, it is sized at runtime:
+ *      qs::binomial_table<qs::mod_int<998244353>> table(1'000'000);
+ *      auto c = table(n, k);
+ */
+template<class Mod, std::size_t N = dynamic_extent>
+class binomial_table
+{
+    static constexpr bool          is_dynamic = N == dynamic_extent;
+    static constexpr std::uint64_t p          = Mod::mod();
+
+    static_assert(is_dynamic || (N >= 1 && N <= p), "binomial_table: static size must be in [1, p]");
+
+    using storage_type = std::conditional_t<is_dynamic, std::vector<Mod>, std::array<Mod, is_dynamic ? 1 : N>>;
+
+public:
+    using value_type = Mod;
+
+    // Table of `n!` for `n < N`.
+    template<std::size_t E = N, std::enable_if_t<E != dynamic_extent, int> = 0>
+    constexpr binomial_table() noexcept
+    {
+        build();
+    }
+
+    // Table of `n!` for `n <= max_n`, capped at `p - 1`.
+    template<std::size_t E = N, std::enable_if_t<E == dynamic_extent, int> = 0>
+    explicit binomial_table(std::uint64_t max_n)
+        : fact_(static_cast<std::size_t>(std::min(max_n, p - 1) + 1)),
+          inv_fact_(fact_.size())
+    {
+        build();
+    }
+
+    // Number of entries: factorials are tabulated for `n < size()`.
+    constexpr std::size_t size() const noexcept { return fact_.size(); }
+
+    constexpr Mod factorial(std::size_t n) const noexcept
+    {
+        QS_ASSERT(n < size(), "binomial_table: n out of the table");
+        return fact_[n];
+    }
+
+    constexpr Mod inverse_factorial(std::size_t n) const noexcept
+    {
+        QS_ASSERT(n < size(), "binomial_table: n out of the table");
+        return inv_fact_[n];
+    }
+
+    // `1/n`, for `1 <= n < size()`.
+    constexpr Mod inverse(std::size_t n) const noexcept
+    {
+        QS_ASSERT(n >= 1 && n < size(), "binomial_table: n out of the table");
+        return inv_fact_[n] * fact_[n - 1];
+    }
+
+    // `C(n, k) mod p`, 0 for `k > n`. Arguments of `size()` or more go through Lucas's theorem, in O(1) per base-`p`
+    // digit when the table covers `[0, p)`.
+    QS_ALWAYS_INLINE constexpr Mod operator()(std::uint64_t n, std::uint64_t k) const noexcept
+    {
+        if(QS_UNLIKELY(k > n))
+            return Mod(0);
+        if(QS_LIKELY(n < size()))
+            return small(static_cast<std::size_t>(n), static_cast<std::size_t>(k));
+        return lucas(n, k);
+    }
+
+    constexpr Mod binomial(std::uint64_t n, std::uint64_t k) const noexcept { return (*this)(n, k); }
+
+private:
+    storage_type fact_{};
+    storage_type inv_fact_{};
+
+    constexpr void build() noexcept
+    {
+        std::size_t const n = size();
+        fact_[0]            = Mod(1);
+        for(std::size_t i = 1; i < n; ++i)
+            fact_[i] = fact_[i - 1] * Mod(i);
+        inv_fact_[n - 1] = fact_[n - 1].pow(p - 2); // Fermat, p is prime
+        for(std::size_t i = n - 1; i > 0; --i)
+            inv_fact_[i - 1] = inv_fact_[i] * Mod(i);
+    }
+
+    constexpr Mod small(std::size_t n, std::size_t k) const noexcept
+    {
+        return fact_[n] * inv_fact_[k] * inv_fact_[n - k];
+    }
+
+    // `C(n, k)` for `k <= n < p` past the table: `n (n - 1) ... (n - k + 1) / k!`, over the smaller of `k`, `n - k`.
+    static constexpr Mod direct(std::uint64_t n, std::uint64_t k) noexcept
+    {
+        k = std::min(k, n - k);
+        Mod num(1);
+        Mod den(1);
+        for(std::uint64_t i = 0; i < k; ++i)
+        {
+            num *= Mod(n - i);
+            den *= Mod(i + 1);
+        }
+        return num * den.pow(p - 2);
+    }
+
+    // Lucas: C(n, k) is the product of the binomials of the base-p digits of n and k. Digits are below `p`, so in
+    // the table whenever it covers `[0, p)`; the others are computed directly rather than read past the table.
+    QS_NOINLINE constexpr Mod lucas(std::uint64_t n, std::uint64_t k) const noexcept
+    {
+        Mod r(1);
+        for(; k != 0; n /= p, k /= p)
+        {
+            std::size_t const nd = static_cast<std::size_t>(n % p);
+            std::size_t const kd = static_cast<std::size_t>(k % p);
+            if(kd > nd)
+                return Mod(0);
+            r *= QS_LIKELY(nd < size()) ? small(nd, kd) : direct(nd, kd);
+        }
+        return r;
+    }
+};
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_BINOMIAL_H
@@ -0,0 +1,279 @@
+#ifndef QS_MATH_CRT_H
+#define QS_MATH_CRT_H
+
+#include <qs/config.h>
+#include <qs/math/gcd.h>
+#include <qs/math/mod_arithmetic.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+// `x = remainder (mod modulus)`.
+struct congruence
+{
+    std::uint64_t remainder = 0;
+    std::uint64_t modulus   = 1;
+
+    friend constexpr bool operator==(congruence const& a, congruence const& b) noexcept
+    {
+        return a.remainder == b.remainder && a.modulus == b.modulus;
+    }
+    friend constexpr bool operator!=(congruence const& a, congruence const& b) noexcept { return !(a == b); }
+};
+
+namespace intl
+{
+    // `a^-1 mod m` from the Bezout coefficients, for coprime `a` and `m`.
+    constexpr std::uint32_t crt_inverse(std::uint32_t a, std::uint32_t m) noexcept
+    {
+        std::int64_t const x = std::get<0>(extended_gcd(std::int64_t(a), std::int64_t(m)).second) % m;
+        return static_cast<std::uint32_t>(x < 0 ? x + m : x);
+    }
+
+    // `a * b mod m` for 64-bit operands.
+    constexpr std::uint64_t mul_mod_u64(std::uint64_t a, std::uint64_t b, std::uint64_t m) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<std::uint64_t>(static_cast<uint128_t>(a) * b % m);
+#else
+        std::uint64_t r = 0;
+        for(a %= m; b != 0; b >>= 1, a = a >= m - a ? a - (m - a) : a + a)
+        {
+            if(b & 1)
+                r = r >= m - a ? r - (m - a) : r + a;
+        }
+        return r;
+#endif
+    }
+
+    // Splits `lcm(a, b)` into coprime factors `a' | a` and `b' | b`: every prime power goes to the operand
+    // holding its highest power.
+    inline std::pair<std::uint32_t, std::uint32_t> coprime_split(std::uint32_t a, std::uint32_t b) noexcept
+    {
+        b /= gcd(a, b);
+        for(std::uint32_t g = gcd(a, b); g != 1; g = gcd(a, b))
+        {
+            a /= g;
+            b *= g;
+        }
+        return {a, b};
+    }
+} // namespace intl
+
+/**
+ * Combines two congruences into their intersection, for any moduli (not necessarily coprime). The result has
+ * the modulus `lcm(a.modulus, b.modulus)`, which must fit in 64 bits; no value when the congruences contradict
+ * each other. Remainders may be unreduced, moduli must be below 2^63 (the Bezout coefficients are signed).
+ *
+ *      constexpr auto x = qs::crt({2, 4}, {4, 6}); // x == 10 (mod 12)
+ */
+constexpr std::optional<congruence> crt(congruence a, congruence b) noexcept
+{
+    std::uint64_t const r1 = a.remainder % a.modulus, m1 = a.modulus;
+    std::uint64_t const r2 = b.remainder % b.modulus, m2 = b.modulus;
+    auto const          bezout = extended_gcd(static_cast<std::int64_t>(m1), static_cast<std::int64_t>(m2));
+    auto const          g      = static_cast<std::uint64_t>(bezout.first);
+    if(r1 % g != r2 % g)
+        return std::nullopt;
+
+    // x = r1 + m1 k with m1 k = r2 - r1 (mod m2), so k = (r2 - r1) / g * (m1 / g)^-1 (mod m2 / g)
+    std::uint64_t const m2g  = m2 / g;
+    std::uint64_t const r1m2 = r1 % m2;
+    std::uint64_t const diff = (r2 >= r1m2 ? r2 - r1m2 : r2 + (m2 - r1m2)) / g;
+    std::int64_t const  x    = std::get<0>(bezout.second) % static_cast<std::int64_t>(m2g);
+    std::uint64_t const inv  = static_cast<std::uint64_t>(x < 0 ? x + static_cast<std::int64_t>(m2g) : x);
+    return congruence{r1 + m1 * intl::mul_mod_u64(diff, inv, m2g), m1 * m2g};
+}
+
+// Intersection of all the `congruences`, `x = 0 (mod 1)` for none.
+constexpr std::optional<congruence> crt(span<congruence const> congruences) noexcept
+{
+    congruence result{};
+    for(congruence const& c: congruences)
+    {
+        auto const r = crt(result, c);
+        if(!r)
+            return std::nullopt;
+        result = *r;
+    }
+    return result;
+}
+
+namespace intl
+{
+    // Multiplication by a constant `w < q` with Shoup's precomputed quotient `floor(w * 2^32 / q)`: the
+    // product's quotient is estimated from the high half of one 32-bit product, off by at most one.
+    struct shoup_constant
+    {
+        std::uint32_t value    = 0;
+        std::uint32_t quotient = 0;
+
+        constexpr shoup_constant() noexcept = default;
+        constexpr shoup_constant(std::uint32_t w, std::uint32_t q) noexcept
+            : value(w),
+              quotient(static_cast<std::uint32_t>((static_cast<std::uint64_t>(w) << 32) / q))
+        {}
+
+        // `a * w mod q` plus 0 or `q`, for any 32-bit `a`.
+        QS_ALWAYS_INLINE constexpr std::uint64_t mul_lazy(std::uint32_t a, std::uint32_t q) const noexcept
+        {
+            std::uint64_t const estimate = (static_cast<std::uint64_t>(a) * quotient) >> 32;
+            return static_cast<std::uint64_t>(a) * value - estimate * q;
+        }
+
+        QS_ALWAYS_INLINE constexpr std::uint32_t mul(std::uint32_t a, std::uint32_t q) const noexcept
+        {
+            std::uint64_t const r = mul_lazy(a, q);
+            return static_cast<std::uint32_t>(r >= q ? r - q : r);
+        }
+    };
+} // namespace intl
+
+/**
+ * Garner's mixed-radix reconstruction for a fixed set of 32-bit moduli, reconstructing many elements from their
+ * residues. Every inverse and every constant quotient is computed once in the constructor: per element, each
+ * pair of moduli costs one multiplication by a Shoup constant and each modulus one Barrett reduction, with no
+ * division. Elements go by blocks, one modulus at a time, so that the independent elements of a block overlap
+ * the multiplication latencies instead of waiting on the serial digit chain of a single element.
+ *
+ * Moduli that are not pairwise coprime are first split into coprime factors, each prime power taken from the
+ * modulus holding its highest power; reconstruction then assumes consistent residues (use `crt` to check them).
+ * Values are reconstructed in `[0, modulus())` modulo 2^64: exact when the lcm of the moduli fits in 64 bits
+ * (see `exact()`), the low 64 bits of the value otherwise.
+ *
+ * Usage:
+ *      std::uint32_t const moduli[] = {998244353, 1000000007, 1000000009};
+ *      qs::crt_basis const basis(qs::make_span(moduli));
+ *      basis.reconstruct(qs::make_span(residues), qs::make_span(values)); // 3 residues per value
+ */
+class crt_basis
+{
+public:
+    // Requires non-zero moduli, at least one.
+    explicit crt_basis(span<std::uint32_t const> moduli)
+        : size_(moduli.size())
+    {
+        QS_ASSERT(!moduli.empty(), "crt_basis: no moduli");
+        std::vector<std::uint32_t> factors;
+        for(std::size_t j = 0; j < moduli.size(); ++j)
+        {
+            QS_ASSERT(moduli[j] != 0, "crt_basis: zero modulus");
+            std::uint32_t m = moduli[j];
+            for(std::size_t i = 0; i < factors.size() && m != 1; ++i)
+                std::tie(factors[i], m) = intl::coprime_split(factors[i], m);
+            factors.push_back(m);
+        }
+
+        std::uint64_t weight = 1;
+        for(std::size_t j = 0; j < factors.size(); ++j)
+        {
+            std::uint32_t const q = factors[j];
+            if(q == 1)
+                continue; // fully covered by other moduli
+            barrett_reduction const red(q);
+            std::uint32_t           prefix = 1; // product of the previous factors mod q
+            for(factor const& f: factors_)
+            {
+                prefixes_.emplace_back(prefix, q);
+                prefix = red.mul(prefix, red.reduce(f.reduction.modulus()));
+            }
+            factors_.push_back({red, static_cast<std::uint32_t>(j), {intl::crt_inverse(prefix, q), q}, weight});
+            exact_ = exact_ && intl::umulh64(weight, q) == 0;
+            weight *= q;
+        }
+        modulus_ = weight;
+    }
+
+    // Number of residues per element, the number of moduli given to the constructor.
+    std::size_t size() const noexcept { return size_; }
+
+    // The lcm of the moduli, modulo 2^64.
+    std::uint64_t modulus() const noexcept { return modulus_; }
+
+    // Whether the lcm of the moduli fits in 64 bits, so that reconstructed values are exact.
+    bool exact() const noexcept { return exact_; }
+
+    // Value from its `size()` residues, one per modulus in constructor order.
+    std::uint64_t reconstruct(span<std::uint32_t const> residues) const
+    {
+        std::uint64_t x = 0;
+        reconstruct(residues, span<std::uint64_t>(&x, 1));
+        return x;
+    }
+
+    // `out[i]` from `residues[i * size(), (i + 1) * size())`.
+    void reconstruct(span<std::uint32_t const> residues, span<std::uint64_t> out) const
+    {
+        QS_VERIFY(residues.size() == out.size() * size_, "crt_basis::reconstruct: expected size() residues per value");
+        std::uint32_t              inline_digits[max_inline_factors * block_size];
+        std::vector<std::uint32_t> buffer(factors_.size() > max_inline_factors ? factors_.size() * block_size : 0);
+        std::uint32_t* const       digits = buffer.empty() ? inline_digits : buffer.data();
+        for(std::size_t i = 0; i < out.size(); i += block_size)
+        {
+            std::size_t const n = std::min(block_size, out.size() - i);
+            reconstruct_block(residues.data() + i * size_, out.data() + i, n, digits);
+        }
+    }
+
+private:
+    static constexpr std::size_t max_inline_factors = 16;
+    static constexpr std::size_t block_size         = 64;
+
+    struct factor
+    {
+        barrett_reduction    reduction;
+        std::uint32_t        source;  // modulus whose residue is reduced by this factor
+        intl::shoup_constant inverse; // (product of the previous factors)^-1 mod this factor
+        std::uint64_t        weight;  // product of the previous factors mod 2^64
+    };
+
+    std::vector<factor>               factors_;
+    std::vector<intl::shoup_constant> prefixes_; // row j: (product of the factors before i) mod factor j, i < j
+    std::size_t                       size_;
+    std::uint64_t                     modulus_ = 1;
+    bool                              exact_   = true;
+
+    // Mixed-radix digits `v_j` with `x = sum_j v_j * weight_j`: `v_j = (r_j - sum_{i<j} v_i prefix_ij) / prefix_jj`
+    // modulo `q_j`. The sum is kept unreduced below `r_j + 2 j q_j`, and reduced once.
+    void reconstruct_block(std::uint32_t const* residues, std::uint64_t* out, std::size_t n,
+                           std::uint32_t* digits) const noexcept
+    {
+        std::uint64_t               acc[block_size];
+        intl::shoup_constant const* prefix = prefixes_.data();
+        std::fill(out, out + n, std::uint64_t(0));
+        for(std::size_t j = 0; j < factors_.size(); prefix += j, ++j)
+        {
+            factor const&       f    = factors_[j];
+            std::uint32_t const q    = f.reduction.modulus();
+            std::uint64_t const bias = 2 * static_cast<std::uint64_t>(j) * q;
+            for(std::size_t e = 0; e < n; ++e)
+                acc[e] = residues[e * size_ + f.source] + bias;
+            for(std::size_t i = 0; i < j; ++i)
+            {
+                std::uint32_t const* vi = digits + i * block_size;
+                for(std::size_t e = 0; e < n; ++e)
+                    acc[e] -= prefix[i].mul_lazy(vi[e], q);
+            }
+            std::uint32_t* const vj = digits + j * block_size;
+            for(std::size_t e = 0; e < n; ++e)
+            {
+                vj[e] = f.inverse.mul(f.reduction.reduce(acc[e]), q);
+                out[e] += vj[e] * f.weight;
+            }
+        }
+    }
+};
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_CRT_H
@@ -0,0 +1,408 @@
+#ifndef QS_MATH_GCD_H
+#define QS_MATH_GCD_H
+
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/math/mod_arithmetic.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    template<class T>
+    QS_ALWAYS_INLINE constexpr std::make_unsigned_t<T> unsigned_abs(T x) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        return x < 0 ? U(0) - static_cast<U>(x) : static_cast<U>(x);
+    }
+
+    // Stein's algorithm on unsigned values. Each step strips all trailing zeros at once with `ctz`, and the
+    // ordering of the two operands is done with min/abs (cmov) rather than a swap, which would mispredict on
+    // every other iteration. The `ctz` of the difference does not depend on the ordering, so it starts early.
+    template<class U>
+    QS_ALWAYS_INLINE constexpr U binary_gcd_unsigned(U a, U b) noexcept
+    {
+        if(a == 0)
+            return b;
+        if(b == 0)
+            return a;
+        int const shift = countr_zero(static_cast<U>(a | b));
+        a >>= countr_zero(a);
+        int bz = countr_zero(b);
+        for(;;)
+        {
+            b >>= bz;
+            U const diff = static_cast<U>(b - a);
+            bz           = countr_zero(diff);
+            if(diff == 0)
+                break;
+            U const lo = a < b ? a : b;
+            b          = a < b ? diff : static_cast<U>(a - b);
+            a          = lo;
+        }
+        return a << shift;
+    }
+} // namespace intl
+
+/**
+ * Greatest common divisor with the binary (Stein) algorithm, which replaces the 20-90 cycle integer division
+ * of each Euclidean step with a `ctz`, a shift and a subtraction. The result is always non-negative.
+ */
+template<class T, class U>
+QS_NODISCARD constexpr std::common_type_t<T, U> gcd(T a, U b) noexcept
+{
+    static_assert(std::is_integral<T>::value && std::is_integral<U>::value, "gcd: integral arguments only");
+    using common_t = std::common_type_t<T, U>;
+    using ucommon  = std::make_unsigned_t<common_t>;
+    return static_cast<common_t>(intl::binary_gcd_unsigned<ucommon>(intl::unsigned_abs(static_cast<common_t>(a)),
+                                                                     intl::unsigned_abs(static_cast<common_t>(b))));
+}
+
+namespace intl
+{
+    template<class U>
+    struct wider_unsigned
+    {};
+    template<>
+    struct wider_unsigned<unsigned char>
+    {
+        using type = unsigned short;
+    };
+    template<>
+    struct wider_unsigned<unsigned short>
+    {
+        using type = unsigned int;
+    };
+    template<>
+    struct wider_unsigned<unsigned int>
+    {
+        using type = unsigned long long;
+    };
+#if defined(__SIZEOF_INT128__)
+    template<>
+    struct wider_unsigned<unsigned long>
+    {
+        using type = uint128_t;
+    };
+    template<>
+    struct wider_unsigned<unsigned long long>
+    {
+        using type = uint128_t;
+    };
+#endif
+
+    template<class U, class = void>
+    struct has_wider_unsigned : std::false_type
+    {};
+    template<class U>
+    struct has_wider_unsigned<U, void_t<typename wider_unsigned<U>::type>>
+        : std::integral_constant<bool, (sizeof(typename wider_unsigned<U>::type) > sizeof(U))>
+    {};
+
+    // Inverse of an odd `y` modulo 2^bits, by Newton iteration (each step doubles the correct low bits).
+    template<class U>
+    QS_ALWAYS_INLINE constexpr U inverse_mod_pow2(U y) noexcept
+    {
+        U inv = y; // correct to 3 bits, since y * y == 1 (mod 8) for odd y
+        for(std::size_t bits = 3; bits < sizeof(U) * CHAR_BIT; bits *= 2)
+            inv *= U(2) - y * inv;
+        return inv;
+    }
+
+    // `c / 2^k (mod y)` for an odd `y` and `c` in [0, y). With a wider type available, all `k` halvings are done
+    // at once Montgomery style: adding `m*y`, with `m = -c/y mod 2^k`, clears the low `k` bits of `c` exactly.
+    // Otherwise one conditional add and shift per bit.
+    template<class U, bool Wide = has_wider_unsigned<U>::value>
+    struct div_pow2_mod
+    {
+        U y;
+        U neg_inv; // -y^-1 mod 2^bits
+
+        constexpr explicit div_pow2_mod(U odd) noexcept
+            : y(odd),
+              neg_inv(static_cast<U>(U(0) - inverse_mod_pow2(odd)))
+        {}
+
+        QS_ALWAYS_INLINE constexpr U operator()(U c, int k) const noexcept
+        {
+            using W       = typename wider_unsigned<U>::type;
+            U const  mask = static_cast<U>((W(1) << k) - 1);
+            U const  m    = static_cast<U>(c * neg_inv) & mask;
+            U const  r    = static_cast<U>((W(c) + W(m) * y) >> k);
+            return r >= y ? static_cast<U>(r - y) : r;
+        }
+    };
+
+    template<class U>
+    struct div_pow2_mod<U, false>
+    {
+        U y;
+
+        constexpr explicit div_pow2_mod(U odd) noexcept
+            : y(odd)
+        {}
+
+        QS_ALWAYS_INLINE constexpr U operator()(U c, int k) const noexcept
+        {
+            for(; k > 0; --k)
+                c = static_cast<U>((c + (y & (U(0) - (c & 1)))) >> 1);
+            return c;
+        }
+    };
+} // namespace intl
+
+/**
+ * Binary extended GCD: returns `{g, {x, y}}` with `a*x + b*y == g == gcd(a, b)`, in the same format as
+ * `extended_gcd(a, b)`, without any division. Only the coefficient of `a` is tracked, modulo the odd one of the
+ * two (halving modulo an odd number is a shift plus a conditional add), and the other one is recovered at the
+ * end by exact division, itself done as a multiplication by the inverse modulo 2^bits.
+ * Arguments must be above the minimum value of `T` (their magnitude has to be representable).
+ */
+template<class T>
+QS_NODISCARD constexpr std::pair<T, std::tuple<T, T>> binary_extended_gcd(T a, T b) noexcept
+{
+    static_assert(std::is_integral<T>::value && std::is_signed<T>::value,
+                  "binary_extended_gcd: signed integral arguments only (coefficients can be negative)");
+    using U = std::make_unsigned_t<T>;
+
+    T const sa = a < 0 ? T(-1) : T(1);
+    T const sb = b < 0 ? T(-1) : T(1);
+    U       x  = intl::unsigned_abs(a);
+    U       y  = intl::unsigned_abs(b);
+    if(x == 0)
+        return {static_cast<T>(y), std::make_tuple(T(0), sb)};
+    if(y == 0)
+        return {static_cast<T>(x), std::make_tuple(sa, T(0))};
+
+    int const shift = countr_zero(static_cast<U>(x | y));
+    x >>= shift;
+    y >>= shift;
+    bool const swapped = (y & 1) == 0; // the modulus of the tracked coefficient must be odd
+    if(swapped)
+    {
+        U const tmp = x;
+        x           = y;
+        y           = tmp;
+    }
+
+    // invariants: s*x == u and t*x == v (mod y), with s, t in [0, y)
+    U                u         = x, v = y;
+    U                s         = 1, t = 0;
+    intl::div_pow2_mod<U> const div_pow2(y);
+    while(u != 0)
+    {
+        int const ku = countr_zero(u);
+        int const kv = countr_zero(v);
+        u >>= ku;
+        v >>= kv;
+        s = div_pow2(s, ku);
+        t = div_pow2(t, kv);
+        if(u >= v)
+        {
+            u -= v;
+            s = s >= t ? s - t : s - t + y;
+        }
+        else
+        {
+            v -= u;
+            t = t >= s ? t - s : t - s + y;
+        }
+    }
+
+    // v == gcd and t*x == v (mod y): the cofactor (v - x*t) / y is exact, |.| <= x, so wrapping arithmetic is fine
+    T const cx = static_cast<T>(t);
+    T const cy = static_cast<T>(static_cast<U>(v - x * t) * intl::inverse_mod_pow2(y));
+    T const ca = swapped ? cy : cx;
+    T const cb = swapped ? cx : cy;
+    return {static_cast<T>(v << shift), std::make_tuple(T(sa * ca), T(sb * cb))};
+}
+
+
+namespace intl
+{
+    template<class U>
+    inline void gcd_scalar(U const* a, U const* b, U* out, std::size_t n) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            out[i] = binary_gcd_unsigned(a[i], b[i]);
+    }
+
+#if QS_HAS_X86_DISPATCH
+    // Lane-wise Stein: the vector units have no `ctz`, the lowest set bit `x & -x` is converted to floating
+    // point and its exponent read back. Lanes that finished (b == 0) are frozen with a blend/mask.
+
+    QS_TARGET_AVX2 inline __m256i ctz_epi32_avx2(__m256i x) noexcept
+    {
+        __m256i const low = _mm256_and_si256(x, _mm256_sub_epi32(_mm256_setzero_si256(), x));
+        __m256i const exp = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(low)), 23);
+        return _mm256_sub_epi32(_mm256_and_si256(exp, _mm256_set1_epi32(0xff)), _mm256_set1_epi32(127));
+    }
+
+    QS_TARGET_AVX2 inline __m256i gcd_epu32_avx2(__m256i a, __m256i b) noexcept
+    {
+        __m256i const zero  = _mm256_setzero_si256();
+        __m256i const shift = ctz_epi32_avx2(_mm256_or_si256(a, b));
+        // gcd(0, b) == gcd(b, b), so zero operands are replaced by the other one
+        a = _mm256_blendv_epi8(a, b, _mm256_cmpeq_epi32(a, zero));
+        b = _mm256_blendv_epi8(b, a, _mm256_cmpeq_epi32(b, zero));
+        a = _mm256_srlv_epi32(a, ctz_epi32_avx2(a));
+        b = _mm256_srlv_epi32(b, ctz_epi32_avx2(b));
+
+        __m256i active = _mm256_cmpeq_epi32(_mm256_cmpeq_epi32(b, zero), zero);
+        while(!_mm256_testz_si256(active, active))
+        {
+            __m256i const lo = _mm256_min_epu32(a, b);
+            __m256i const d  = _mm256_sub_epi32(_mm256_max_epu32(a, b), lo);
+            a                = _mm256_blendv_epi8(a, lo, active);
+            b                = _mm256_blendv_epi8(b, _mm256_srlv_epi32(d, ctz_epi32_avx2(d)), active);
+            active           = _mm256_cmpeq_epi32(_mm256_cmpeq_epi32(b, zero), zero);
+        }
+        // srlv/sllv produce 0 for counts >= 32, which covers gcd(0, 0)
+        return _mm256_sllv_epi32(a, shift);
+    }
+
+    QS_TARGET_AVX2 inline void gcd_avx2(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                        std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+            __m256i const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), gcd_epu32_avx2(va, vb));
+        }
+        gcd_scalar(a + i, b + i, out + i, n - i);
+    }
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    QS_TARGET_AVX512 inline __m512i ctz_epi32_avx512(__m512i x) noexcept
+    {
+        __m512i const low = _mm512_and_si512(x, _mm512_sub_epi32(_mm512_setzero_si512(), x));
+        __m512i const exp = _mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(low)), 23);
+        return _mm512_sub_epi32(_mm512_and_si512(exp, _mm512_set1_epi32(0xff)), _mm512_set1_epi32(127));
+    }
+
+    QS_TARGET_AVX512 inline __m512i ctz_epi64_avx512(__m512i x) noexcept
+    {
+        __m512i const low = _mm512_and_si512(x, _mm512_sub_epi64(_mm512_setzero_si512(), x));
+        __m512i const exp = _mm512_srli_epi64(_mm512_castpd_si512(_mm512_cvtepi64_pd(low)), 52);
+        return _mm512_sub_epi64(_mm512_and_si512(exp, _mm512_set1_epi64(0x7ff)), _mm512_set1_epi64(1023));
+    }
+
+    QS_TARGET_AVX512 inline __m512i gcd_epu32_avx512(__m512i a, __m512i b) noexcept
+    {
+        __m512i const shift = ctz_epi32_avx512(_mm512_or_si512(a, b));
+        a                   = _mm512_mask_mov_epi32(a, _mm512_testn_epi32_mask(a, a), b);
+        b                   = _mm512_mask_mov_epi32(b, _mm512_testn_epi32_mask(b, b), a);
+        a                   = _mm512_srlv_epi32(a, ctz_epi32_avx512(a));
+        b                   = _mm512_srlv_epi32(b, ctz_epi32_avx512(b));
+
+        for(__mmask16 active = _mm512_test_epi32_mask(b, b); active != 0; active = _mm512_test_epi32_mask(b, b))
+        {
+            __m512i const lo = _mm512_min_epu32(a, b);
+            __m512i const d  = _mm512_sub_epi32(_mm512_max_epu32(a, b), lo);
+            a                = _mm512_mask_mov_epi32(a, active, lo);
+            b                = _mm512_mask_srlv_epi32(b, active, d, ctz_epi32_avx512(d));
+        }
+        return _mm512_sllv_epi32(a, shift);
+    }
+
+    QS_TARGET_AVX512 inline __m512i gcd_epu64_avx512(__m512i a, __m512i b) noexcept
+    {
+        __m512i const shift = ctz_epi64_avx512(_mm512_or_si512(a, b));
+        a                   = _mm512_mask_mov_epi64(a, _mm512_testn_epi64_mask(a, a), b);
+        b                   = _mm512_mask_mov_epi64(b, _mm512_testn_epi64_mask(b, b), a);
+        a                   = _mm512_srlv_epi64(a, ctz_epi64_avx512(a));
+        b                   = _mm512_srlv_epi64(b, ctz_epi64_avx512(b));
+
+        for(__mmask8 active = _mm512_test_epi64_mask(b, b); active != 0; active = _mm512_test_epi64_mask(b, b))
+        {
+            __m512i const lo = _mm512_min_epu64(a, b);
+            __m512i const d  = _mm512_sub_epi64(_mm512_max_epu64(a, b), lo);
+            a                = _mm512_mask_mov_epi64(a, active, lo);
+            b                = _mm512_mask_srlv_epi64(b, active, d, ctz_epi64_avx512(d));
+        }
+        return _mm512_sllv_epi64(a, shift);
+    }
+
+    QS_TARGET_AVX512 inline void gcd_avx512(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                            std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for(; i + 16 <= n; i += 16)
+            _mm512_storeu_si512(out + i, gcd_epu32_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+        if(i < n)
+        {
+            __mmask16 const tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+            __m512i const   va   = _mm512_maskz_loadu_epi32(tail, a + i);
+            __m512i const   vb   = _mm512_maskz_loadu_epi32(tail, b + i);
+            _mm512_mask_storeu_epi32(out + i, tail, gcd_epu32_avx512(va, vb));
+        }
+    }
+
+    QS_TARGET_AVX512 inline void gcd_avx512(std::uint64_t const* a, std::uint64_t const* b, std::uint64_t* out,
+                                            std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+        for(; i + 8 <= n; i += 8)
+            _mm512_storeu_si512(out + i, gcd_epu64_avx512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+        if(i < n)
+        {
+            __mmask8 const tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+            __m512i const  va   = _mm512_maskz_loadu_epi64(tail, a + i);
+            __m512i const  vb   = _mm512_maskz_loadu_epi64(tail, b + i);
+            _mm512_mask_storeu_epi64(out + i, tail, gcd_epu64_avx512(va, vb));
+        }
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+} // namespace intl
+
+
+/**
+ * Element-wise `out[i] = gcd(a[i], b[i])`, `out` may alias an input. The lanes of a vector run Stein's
+ * algorithm in lockstep until the slowest one finishes (AVX-512: 16 x 32-bit or 8 x 64-bit, AVX2: 8 x 32-bit),
+ * other cases use the scalar binary GCD.
+ */
+QS_INLINE void gcd(span<std::uint32_t const> a, span<std::uint32_t const> b,
+                   span<std::uint32_t> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "gcd: span size mismatch");
+#if QS_HAS_X86_DISPATCH
+    switch(active_simd_level())
+    {
+        case simd_level::avx512: return intl::gcd_avx512(a.data(), b.data(), out.data(), out.size());
+        case simd_level::avx2: return intl::gcd_avx2(a.data(), b.data(), out.data(), out.size());
+        case simd_level::scalar: break;
+    }
+#endif
+    intl::gcd_scalar(a.data(), b.data(), out.data(), out.size());
+}
+
+QS_INLINE void gcd(span<std::uint64_t const> a, span<std::uint64_t const> b,
+                   span<std::uint64_t> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "gcd: span size mismatch");
+#if QS_HAS_X86_DISPATCH
+    if(active_simd_level() == simd_level::avx512)
+        return intl::gcd_avx512(a.data(), b.data(), out.data(), out.size());
+#endif
+    intl::gcd_scalar(a.data(), b.data(), out.data(), out.size());
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_GCD_H
@@ -2,6 +2,9 @@
 #define QS_EXTENDED_GCD_H_
 
 #include <qs/config.h>
+#include <qs/span.h>
+
+#include <cstddef>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -127,12 +130,68 @@ namespace intl
  * @param args The integers.
  * @return A pair containing the GCD and a tuple with the coefficients.
  */
-template<class... Ts>
+template<class... Ts, std::enable_if_t<std::conjunction<std::is_integral<Ts>...>::value, int> = 0>
 constexpr auto extended_gcd(Ts... args)
 {
     return intl::extended_gcd_impl(args...);
 }
 
+namespace intl
+{
+    // Euclid's loop of `extended_gcd_impl(a, b)` without the coefficients; returns the same (possibly negative) value.
+    template<class T>
+    inline constexpr T euclid_gcd(T a, T b) noexcept
+    {
+        while(b)
+        {
+            T const r = a % b;
+            a         = b;
+            b         = r;
+        }
+        return a;
+    }
+} // namespace intl
+
+/**
+ * @brief Computes the extended GCD of a runtime-length sequence of integers.
+ *
+ * @details Writes into `coefficients[i]` the Bézout coefficients \(x_i\) such that
+ * \(a_0 x_0 + a_1 x_1 + \ldots + a_{n-1} x_{n-1} = \gcd(a_0, \ldots, a_{n-1})\), and returns the GCD.
+ * The sequence is folded from the right: a first pass stores the suffix GCDs in `coefficients`, and a second pass
+ * replaces them with the coefficients while carrying the running product of the right-hand Bézout factors.
+ * That is O(n) two-integer GCDs and no allocation, against the O(n^2) tuple building of the variadic overload.
+ * Once a suffix GCD divides an element, its coefficient is zero and the running product stays unchanged, so
+ * coefficients do not grow with `n` in practice; as with the variadic overload, overflow is not checked.
+ *
+ * @param values The integers \(a_i\). An empty sequence has GCD 0.
+ * @param coefficients Output, of the same size as `values`. May not alias `values`.
+ * @return The GCD, with the sign convention of the two-integer `extended_gcd`.
+ */
+template<class T>
+constexpr std::enable_if_t<std::is_integral<T>::value, T> extended_gcd(type_identity_t<span<T const>> values,
+                                                                       span<T>                        coefficients)
+{
+    QS_ASSERT(values.size() == coefficients.size(), "extended_gcd: values and coefficients must have the same size");
+    std::size_t const n = values.size();
+    if(n == 0)
+        return T(0);
+
+    coefficients[n - 1] = values[n - 1];
+    for(std::size_t i = n - 1; i-- > 0;)
+        coefficients[i] = intl::euclid_gcd(values[i], coefficients[i + 1]);
+
+    T const g       = coefficients[0];
+    T       product = 1; // product of the right-hand factors of the pairs seen so far
+    for(std::size_t i = 0; i + 1 < n; ++i)
+    {
+        auto const xy   = intl::extended_gcd_impl(values[i], coefficients[i + 1]).second;
+        coefficients[i] = static_cast<T>(product * std::get<0>(xy));
+        product         = static_cast<T>(product * std::get<1>(xy));
+    }
+    coefficients[n - 1] = product;
+    return g;
+}
+
 
 namespace intl
 {
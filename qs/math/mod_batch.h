@@ -0,0 +1,435 @@
+#ifndef QS_MATH_MOD_BATCH_H
+#define QS_MATH_MOD_BATCH_H
+
+#include <qs/config.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    // Element-wise kernels on raw pointers. `Plain` residues are converted in and out of Montgomery form by the
+    // kernel itself, otherwise the data is already in Montgomery form (the representation of an odd `mod_int`).
+
+    template<bool Plain>
+    QS_INLINE std::uint32_t mont_mul_scalar(montgomery_reduction const& r, std::uint32_t a, std::uint32_t b) noexcept
+    {
+        std::uint32_t const t = r.mul(a, b);
+        return Plain ? r.mul(t, r.r2()) : t;
+    }
+
+    template<bool Plain>
+    QS_INLINE std::uint32_t mont_pow_scalar(montgomery_reduction const& r, std::uint32_t a, std::uint64_t e) noexcept
+    {
+        std::uint32_t const x = Plain ? r.mul(a, r.r2()) : a;
+        std::uint32_t const p = mod_ops<montgomery_reduction>::pow(r, x, e);
+        return Plain ? r.reduce(p) : p;
+    }
+
+    template<class Reduction>
+    inline void add_mod_scalar(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out, std::size_t n,
+                               Reduction const& r) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            out[i] = mod_ops<Reduction>::add(a[i], b[i], r.modulus());
+    }
+
+    template<class Reduction>
+    inline void mul_mod_scalar(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out, std::size_t n,
+                               Reduction const& r) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            out[i] = r.mul(a[i], b[i]);
+    }
+
+    template<class Reduction>
+    inline void pow_mod_scalar(std::uint32_t const* a, std::uint64_t e, std::uint32_t* out, std::size_t n,
+                               Reduction const& r) noexcept
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            out[i] = mod_ops<Reduction>::pow(r, a[i], e);
+    }
+
+
+#if QS_HAS_X86_DISPATCH
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX2, 8 lanes. Each 32x32->64 product is split in even/odd lanes (`vpmuludq` only reads the even ones).
+    // ---------------------------------------------------------------------------------------------------------
+
+    QS_TARGET_AVX2 inline __m256i sub_mod_avx2(__m256i a, __m256i b, __m256i m) noexcept
+    {
+        __m256i const d     = _mm256_sub_epi32(a, b);
+        __m256i const no_bw = _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a); // a >= b
+        return _mm256_add_epi32(d, _mm256_andnot_si256(no_bw, m));
+    }
+
+    // `a + b` as `a - (m - b)`, which cannot overflow for any modulus below 2^32.
+    QS_TARGET_AVX2 inline __m256i add_mod_avx2(__m256i a, __m256i b, __m256i m) noexcept
+    {
+        return sub_mod_avx2(a, _mm256_sub_epi32(m, b), m);
+    }
+
+    QS_TARGET_AVX2 inline __m256i mont_mul_avx2(__m256i a, __m256i b, __m256i m, __m256i inv) noexcept
+    {
+        __m256i const t_even = _mm256_mul_epu32(a, b);
+        __m256i const t_odd  = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i const t_lo   = _mm256_blend_epi32(t_even, _mm256_slli_epi64(t_odd, 32), 0xAA);
+        __m256i const t_hi   = _mm256_blend_epi32(_mm256_srli_epi64(t_even, 32), t_odd, 0xAA);
+
+        __m256i const q       = _mm256_mullo_epi32(t_lo, inv);
+        __m256i const qm_even = _mm256_mul_epu32(q, m);
+        __m256i const qm_odd  = _mm256_mul_epu32(_mm256_srli_epi64(q, 32), m);
+        __m256i const qm_hi   = _mm256_blend_epi32(_mm256_srli_epi64(qm_even, 32), qm_odd, 0xAA);
+        return sub_mod_avx2(t_hi, qm_hi, m);
+    }
+
+    QS_TARGET_AVX2 inline void add_mod_avx2(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                            std::size_t n, std::uint32_t mod) noexcept
+    {
+        __m256i const m = _mm256_set1_epi32(static_cast<int>(mod));
+        std::size_t   i = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+            __m256i const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), add_mod_avx2(va, vb, m));
+        }
+        for(; i < n; ++i)
+            out[i] = mod_ops<barrett_reduction>::add(a[i], b[i], mod);
+    }
+
+    template<bool Plain>
+    QS_TARGET_AVX2 void mul_mod_avx2(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                     std::size_t n, montgomery_reduction const& r) noexcept
+    {
+        __m256i const m   = _mm256_set1_epi32(static_cast<int>(r.modulus()));
+        __m256i const inv = _mm256_set1_epi32(static_cast<int>(r.modulus_inverse()));
+        __m256i const r2  = _mm256_set1_epi32(static_cast<int>(r.r2()));
+        std::size_t   i   = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+            __m256i const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+            __m256i const t  = mont_mul_avx2(va, vb, m, inv);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), Plain ? mont_mul_avx2(t, r2, m, inv) : t);
+        }
+        for(; i < n; ++i)
+            out[i] = mont_mul_scalar<Plain>(r, a[i], b[i]);
+    }
+
+    template<bool Plain>
+    QS_TARGET_AVX2 void pow_mod_avx2(std::uint32_t const* a, std::uint64_t e, std::uint32_t* out, std::size_t n,
+                                     montgomery_reduction const& r) noexcept
+    {
+        // four independent vectors per pass, the square-and-multiply chain of a single one is latency bound
+        constexpr std::size_t lanes = 4;
+
+        __m256i const m   = _mm256_set1_epi32(static_cast<int>(r.modulus()));
+        __m256i const inv = _mm256_set1_epi32(static_cast<int>(r.modulus_inverse()));
+        __m256i const r2  = _mm256_set1_epi32(static_cast<int>(r.r2()));
+        __m256i const one = _mm256_set1_epi32(static_cast<int>(r.to_rep(1)));
+        std::size_t   i   = 0;
+        for(; i + 8 * lanes <= n; i += 8 * lanes)
+        {
+            __m256i base[lanes], acc[lanes];
+            for(std::size_t k = 0; k < lanes; ++k)
+            {
+                base[k] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i + 8 * k));
+                if(Plain)
+                    base[k] = mont_mul_avx2(base[k], r2, m, inv);
+                acc[k] = one;
+            }
+            for(std::uint64_t x = e; x != 0; x >>= 1)
+            {
+                for(std::size_t k = 0; k < lanes; ++k)
+                {
+                    if(x & 1)
+                        acc[k] = mont_mul_avx2(acc[k], base[k], m, inv);
+                    base[k] = mont_mul_avx2(base[k], base[k], m, inv);
+                }
+            }
+            for(std::size_t k = 0; k < lanes; ++k)
+            {
+                if(Plain)
+                    acc[k] = mont_mul_avx2(acc[k], _mm256_set1_epi32(1), m, inv);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8 * k), acc[k]);
+            }
+        }
+        for(; i < n; ++i)
+            out[i] = mont_pow_scalar<Plain>(r, a[i], e);
+    }
+
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    // ---------------------------------------------------------------------------------------------------------
+    // AVX-512, 16 lanes. Same algorithm, borrows are handled with mask registers instead of blends.
+    // ---------------------------------------------------------------------------------------------------------
+
+    QS_TARGET_AVX512 inline __m512i sub_mod_avx512(__m512i a, __m512i b, __m512i m) noexcept
+    {
+        __m512i const   d      = _mm512_sub_epi32(a, b);
+        __mmask16 const borrow = _mm512_cmplt_epu32_mask(a, b);
+        return _mm512_mask_add_epi32(d, borrow, d, m);
+    }
+
+    QS_TARGET_AVX512 inline __m512i add_mod_avx512(__m512i a, __m512i b, __m512i m) noexcept
+    {
+        return sub_mod_avx512(a, _mm512_sub_epi32(m, b), m);
+    }
+
+    QS_TARGET_AVX512 inline __m512i mont_mul_avx512(__m512i a, __m512i b, __m512i m, __m512i inv) noexcept
+    {
+        __mmask16 const odd    = 0xAAAA;
+        __m512i const   t_even = _mm512_mul_epu32(a, b);
+        __m512i const   t_odd  = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+        __m512i const   t_lo   = _mm512_mask_blend_epi32(odd, t_even, _mm512_slli_epi64(t_odd, 32));
+        __m512i const   t_hi   = _mm512_mask_blend_epi32(odd, _mm512_srli_epi64(t_even, 32), t_odd);
+
+        __m512i const q       = _mm512_mullo_epi32(t_lo, inv);
+        __m512i const qm_even = _mm512_mul_epu32(q, m);
+        __m512i const qm_odd  = _mm512_mul_epu32(_mm512_srli_epi64(q, 32), m);
+        __m512i const qm_hi   = _mm512_mask_blend_epi32(odd, _mm512_srli_epi64(qm_even, 32), qm_odd);
+        return sub_mod_avx512(t_hi, qm_hi, m);
+    }
+
+    template<bool Plain>
+    QS_TARGET_AVX512 inline __m512i mont_mul_io_avx512(__m512i a, __m512i b, __m512i m, __m512i inv,
+                                                       __m512i r2) noexcept
+    {
+        __m512i const t = mont_mul_avx512(a, b, m, inv);
+        return Plain ? mont_mul_avx512(t, r2, m, inv) : t;
+    }
+
+    QS_TARGET_AVX512 inline void add_mod_avx512(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                                std::size_t n, std::uint32_t mod) noexcept
+    {
+        __m512i const m = _mm512_set1_epi32(static_cast<int>(mod));
+        std::size_t   i = 0;
+        for(; i + 16 <= n; i += 16)
+        {
+            __m512i const va = _mm512_loadu_si512(a + i);
+            __m512i const vb = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(out + i, add_mod_avx512(va, vb, m));
+        }
+        if(i < n)
+        {
+            __mmask16 const tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+            __m512i const   va   = _mm512_maskz_loadu_epi32(tail, a + i);
+            __m512i const   vb   = _mm512_maskz_loadu_epi32(tail, b + i);
+            _mm512_mask_storeu_epi32(out + i, tail, add_mod_avx512(va, vb, m));
+        }
+    }
+
+    template<bool Plain>
+    QS_TARGET_AVX512 void mul_mod_avx512(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                         std::size_t n, montgomery_reduction const& r) noexcept
+    {
+        __m512i const m   = _mm512_set1_epi32(static_cast<int>(r.modulus()));
+        __m512i const inv = _mm512_set1_epi32(static_cast<int>(r.modulus_inverse()));
+        __m512i const r2  = _mm512_set1_epi32(static_cast<int>(r.r2()));
+
+        std::size_t i = 0;
+        for(; i + 16 <= n; i += 16)
+        {
+            __m512i const va = _mm512_loadu_si512(a + i);
+            __m512i const vb = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(out + i, mont_mul_io_avx512<Plain>(va, vb, m, inv, r2));
+        }
+        if(i < n)
+        {
+            __mmask16 const tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+            __m512i const   va   = _mm512_maskz_loadu_epi32(tail, a + i);
+            __m512i const   vb   = _mm512_maskz_loadu_epi32(tail, b + i);
+            _mm512_mask_storeu_epi32(out + i, tail, mont_mul_io_avx512<Plain>(va, vb, m, inv, r2));
+        }
+    }
+
+    template<bool Plain>
+    QS_TARGET_AVX512 void pow_mod_avx512(std::uint32_t const* a, std::uint64_t e, std::uint32_t* out,
+                                         std::size_t n, montgomery_reduction const& r) noexcept
+    {
+        constexpr std::size_t lanes = 4;
+
+        __m512i const m   = _mm512_set1_epi32(static_cast<int>(r.modulus()));
+        __m512i const inv = _mm512_set1_epi32(static_cast<int>(r.modulus_inverse()));
+        __m512i const r2  = _mm512_set1_epi32(static_cast<int>(r.r2()));
+        __m512i const one = _mm512_set1_epi32(static_cast<int>(r.to_rep(1)));
+        std::size_t   i   = 0;
+        for(; i + 16 * lanes <= n; i += 16 * lanes)
+        {
+            __m512i base[lanes], acc[lanes];
+            for(std::size_t k = 0; k < lanes; ++k)
+            {
+                base[k] = _mm512_loadu_si512(a + i + 16 * k);
+                if(Plain)
+                    base[k] = mont_mul_avx512(base[k], r2, m, inv);
+                acc[k] = one;
+            }
+            for(std::uint64_t x = e; x != 0; x >>= 1)
+            {
+                for(std::size_t k = 0; k < lanes; ++k)
+                {
+                    if(x & 1)
+                        acc[k] = mont_mul_avx512(acc[k], base[k], m, inv);
+                    base[k] = mont_mul_avx512(base[k], base[k], m, inv);
+                }
+            }
+            for(std::size_t k = 0; k < lanes; ++k)
+            {
+                if(Plain)
+                    acc[k] = mont_mul_avx512(acc[k], _mm512_set1_epi32(1), m, inv);
+                _mm512_storeu_si512(out + i + 16 * k, acc[k]);
+            }
+        }
+        for(; i < n; ++i)
+            out[i] = mont_pow_scalar<Plain>(r, a[i], e);
+    }
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+
+
+    // Dispatchers, `Plain` as above. Montgomery kernels need an odd modulus, even ones stay on the scalar path.
+
+    QS_INLINE void add_mod_dispatch(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out,
+                                    std::size_t n, std::uint32_t mod) noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        switch(active_simd_level())
+        {
+            case simd_level::avx512: return add_mod_avx512(a, b, out, n, mod);
+            case simd_level::avx2: return add_mod_avx2(a, b, out, n, mod);
+            case simd_level::scalar: break;
+        }
+#endif
+        add_mod_scalar(a, b, out, n, barrett_reduction(mod));
+    }
+
+    template<bool Plain>
+    void mul_mod_dispatch(std::uint32_t const* a, std::uint32_t const* b, std::uint32_t* out, std::size_t n,
+                          std::uint32_t mod) noexcept
+    {
+        if(mod % 2 == 1)
+        {
+            montgomery_reduction const r(mod);
+#if QS_HAS_X86_DISPATCH
+            switch(active_simd_level())
+            {
+                case simd_level::avx512: return mul_mod_avx512<Plain>(a, b, out, n, r);
+                case simd_level::avx2: return mul_mod_avx2<Plain>(a, b, out, n, r);
+                case simd_level::scalar: break;
+            }
+#endif
+            if(!Plain)
+                return mul_mod_scalar(a, b, out, n, r);
+        }
+        mul_mod_scalar(a, b, out, n, barrett_reduction(mod));
+    }
+
+    template<bool Plain>
+    void pow_mod_dispatch(std::uint32_t const* a, std::uint64_t e, std::uint32_t* out, std::size_t n,
+                          std::uint32_t mod) noexcept
+    {
+        if(mod % 2 == 1)
+        {
+            montgomery_reduction const r(mod);
+#if QS_HAS_X86_DISPATCH
+            switch(active_simd_level())
+            {
+                case simd_level::avx512: return pow_mod_avx512<Plain>(a, e, out, n, r);
+                case simd_level::avx2: return pow_mod_avx2<Plain>(a, e, out, n, r);
+                case simd_level::scalar: break;
+            }
+#endif
+            if(!Plain)
+                return pow_mod_scalar(a, e, out, n, r);
+        }
+        pow_mod_scalar(a, e, out, n, barrett_reduction(mod));
+    }
+
+    template<std::uint32_t M>
+    QS_INLINE std::uint32_t const* mod_int_reps(span<mod_int<M> const> s) noexcept
+    {
+        // `mod_int` is a standard-layout wrapper of its representation, pointer-interconvertible with it
+        static_assert(sizeof(mod_int<M>) == sizeof(std::uint32_t) && std::is_standard_layout<mod_int<M>>::value,
+                      "mod_int must be layout compatible with std::uint32_t");
+        return reinterpret_cast<std::uint32_t const*>(s.data());
+    }
+
+    template<std::uint32_t M>
+    QS_INLINE std::uint32_t* mod_int_reps(span<mod_int<M>> s) noexcept
+    {
+        return reinterpret_cast<std::uint32_t*>(s.data());
+    }
+} // namespace intl
+
+
+/**
+ * Element-wise modular kernels over spans of residues, `out` may alias an input.
+ * Residues must already be reduced (`< modulus`). Odd moduli run Montgomery multiplication on AVX-512/AVX2
+ * when the CPU supports it (see `active_simd_level()`), everything else falls back to scalar code.
+ *
+ * Usage:
+ *      qs::dynamic_modulus mod(998244353);
+ *      qs::mul_mod(qs::make_span(a), qs::make_span(b), qs::make_span(out), mod);   // out[i] = a[i] * b[i] % m
+ *      qs::pow_mod(qs::make_span(x), mod.modulus() - 2, qs::make_span(inv), mod);  // batch Fermat inverse
+ */
+QS_INLINE void add_mod(span<std::uint32_t const> a, span<std::uint32_t const> b, span<std::uint32_t> out,
+                       dynamic_modulus const& mod) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "add_mod: span size mismatch");
+    intl::add_mod_dispatch(a.data(), b.data(), out.data(), out.size(), mod.modulus());
+}
+
+QS_INLINE void mul_mod(span<std::uint32_t const> a, span<std::uint32_t const> b, span<std::uint32_t> out,
+                       dynamic_modulus const& mod) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "mul_mod: span size mismatch");
+    intl::mul_mod_dispatch<true>(a.data(), b.data(), out.data(), out.size(), mod.modulus());
+}
+
+// out[i] = a[i]^e, the exponent is shared by every lane.
+QS_INLINE void pow_mod(span<std::uint32_t const> a, std::uint64_t e, span<std::uint32_t> out,
+                       dynamic_modulus const& mod) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size(), "pow_mod: span size mismatch");
+    intl::pow_mod_dispatch<true>(a.data(), e, out.data(), out.size(), mod.modulus());
+}
+
+// Overloads for `mod_int` (the modulus is deduced from `out`), odd moduli are kept in Montgomery form so they
+// skip the conversions.
+template<std::uint32_t M>
+void add_mod(type_identity_t<span<mod_int<M> const>> a, type_identity_t<span<mod_int<M> const>> b,
+             span<mod_int<M>> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "add_mod: span size mismatch");
+    intl::add_mod_dispatch(intl::mod_int_reps(a), intl::mod_int_reps(b), intl::mod_int_reps(out), out.size(), M);
+}
+
+template<std::uint32_t M>
+void mul_mod(type_identity_t<span<mod_int<M> const>> a, type_identity_t<span<mod_int<M> const>> b,
+             span<mod_int<M>> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size() && b.size() == out.size(), "mul_mod: span size mismatch");
+    intl::mul_mod_dispatch<M % 2 == 0>(intl::mod_int_reps(a), intl::mod_int_reps(b), intl::mod_int_reps(out),
+                                       out.size(), M);
+}
+
+template<std::uint32_t M>
+void pow_mod(type_identity_t<span<mod_int<M> const>> a, std::uint64_t e,
+             span<mod_int<M>> out) noexcept(is_nothrow_contract_violation)
+{
+    QS_VERIFY(a.size() == out.size(), "pow_mod: span size mismatch");
+    intl::pow_mod_dispatch<M % 2 == 0>(intl::mod_int_reps(a), e, intl::mod_int_reps(out), out.size(), M);
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_MOD_BATCH_H
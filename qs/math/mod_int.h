@@ -0,0 +1,375 @@
+#ifndef QS_MATH_MOD_INT_H
+#define QS_MATH_MOD_INT_H
+
+#include <qs/config.h>
+#include <qs/math/mod_arithmetic.h>
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128_t = unsigned __int128;
+#endif
+
+    // High 64 bits of the 128-bit product `a * b`.
+    QS_ALWAYS_INLINE constexpr std::uint64_t umulh64(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<std::uint64_t>((static_cast<uint128_t>(a) * b) >> 64);
+#else
+        std::uint64_t const a_lo = a & 0xffffffffu, a_hi = a >> 32;
+        std::uint64_t const b_lo = b & 0xffffffffu, b_hi = b >> 32;
+        std::uint64_t const lo_lo = a_lo * b_lo;
+        std::uint64_t const hi_lo = a_hi * b_lo;
+        std::uint64_t const lo_hi = a_lo * b_hi;
+        std::uint64_t const cross = (lo_lo >> 32) + (hi_lo & 0xffffffffu) + lo_hi;
+        return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+    }
+
+    // Inverse of an odd `m` modulo 2^32, by Newton iteration (each step doubles the correct low bits).
+    QS_ALWAYS_INLINE constexpr std::uint32_t inverse_mod_2_32(std::uint32_t m) noexcept
+    {
+        std::uint32_t inv = m; // correct to 3 bits, since m * m == 1 (mod 8) for odd m
+        for(int i = 0; i < 4; ++i)
+            inv *= 2u - m * inv;
+        return inv;
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint64_t inverse_mod_2_64(std::uint64_t m) noexcept
+    {
+        std::uint64_t inv = m;
+        for(int i = 0; i < 5; ++i)
+            inv *= 2u - m * inv;
+        return inv;
+    }
+
+    // Modular inverse of `a` (already reduced) modulo `m` with the extended Euclidean algorithm.
+    template<class UInt>
+    constexpr UInt inverse_mod(UInt a, UInt m) noexcept
+    {
+        static_assert(std::is_unsigned<UInt>::value && sizeof(UInt) <= 4, "inverse_mod: 32-bit residues only");
+        auto const r = extended_gcd(static_cast<std::int64_t>(a), static_cast<std::int64_t>(m));
+        QS_ASSERT(r.first == 1, "modular inverse: value is not coprime with the modulus");
+        std::int64_t const x = std::get<0>(r.second) % static_cast<std::int64_t>(m);
+        return static_cast<UInt>(x < 0 ? x + static_cast<std::int64_t>(m) : x);
+    }
+} // namespace intl
+
+
+/**
+ * Montgomery reduction for an odd modulus `m < 2^32`. Residues are kept in Montgomery form `a * 2^32 mod m`,
+ * so that a product is reduced with two multiplications and a subtraction instead of a division.
+ */
+class montgomery_reduction
+{
+public:
+    using value_type = std::uint32_t;
+
+    // Requires an odd `m`.
+    constexpr explicit montgomery_reduction(std::uint32_t m) noexcept
+        : m_(m),
+          inv_(intl::inverse_mod_2_32(m)),
+          r2_(static_cast<std::uint32_t>((std::uint64_t(0) - m) % m))
+    {}
+
+    constexpr std::uint32_t modulus() const noexcept { return m_; }
+    constexpr std::uint32_t modulus_inverse() const noexcept { return inv_; } // m^-1 mod 2^32
+    constexpr std::uint32_t r2() const noexcept { return r2_; }               // 2^64 mod m
+
+    // Returns `t * 2^-32 mod m` for any `t < m * 2^32`.
+    QS_ALWAYS_INLINE constexpr std::uint32_t reduce(std::uint64_t t) const noexcept
+    {
+        // the low halves of `t` and `q * m` are equal by construction of `q`, only the high halves are subtracted
+        std::uint32_t const q  = static_cast<std::uint32_t>(t) * inv_;
+        std::uint32_t const hi = static_cast<std::uint32_t>(t >> 32);
+        std::uint32_t const qm = static_cast<std::uint32_t>((static_cast<std::uint64_t>(q) * m_) >> 32);
+        return hi >= qm ? hi - qm : hi - qm + m_;
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint32_t mul(std::uint32_t a, std::uint32_t b) const noexcept
+    {
+        return reduce(static_cast<std::uint64_t>(a) * b);
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint32_t to_rep(std::uint64_t x) const noexcept { return mul(x % m_, r2_); }
+    QS_ALWAYS_INLINE constexpr std::uint32_t from_rep(std::uint32_t a) const noexcept { return reduce(a); }
+
+private:
+    std::uint32_t m_;
+    std::uint32_t inv_;
+    std::uint32_t r2_;
+};
+
+/**
+ * Montgomery reduction for an odd 64-bit modulus, with `R = 2^64`. Products are split in halves with `umulh64`,
+ * so it does not need a 128-bit integer type.
+ */
+class montgomery_reduction64
+{
+public:
+    using value_type = std::uint64_t;
+
+    // Requires an odd `m`.
+    constexpr explicit montgomery_reduction64(std::uint64_t m) noexcept
+        : m_(m),
+          inv_(intl::inverse_mod_2_64(m)),
+          one_((std::uint64_t(0) - m) % m),
+          r2_(compute_r2(m, one_))
+    {}
+
+    constexpr std::uint64_t modulus() const noexcept { return m_; }
+    constexpr std::uint64_t one() const noexcept { return one_; } // 2^64 mod m, 1 in Montgomery form
+    constexpr std::uint64_t r2() const noexcept { return r2_; }   // 2^128 mod m
+
+    // Returns `(hi * 2^64 + lo) * 2^-64 mod m` for any `hi < m`.
+    QS_ALWAYS_INLINE constexpr std::uint64_t reduce(std::uint64_t hi, std::uint64_t lo) const noexcept
+    {
+        std::uint64_t const q  = lo * inv_;
+        std::uint64_t const qm = intl::umulh64(q, m_);
+        return hi >= qm ? hi - qm : hi - qm + m_;
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint64_t mul(std::uint64_t a, std::uint64_t b) const noexcept
+    {
+        return reduce(intl::umulh64(a, b), a * b);
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint64_t to_rep(std::uint64_t x) const noexcept { return mul(x % m_, r2_); }
+    QS_ALWAYS_INLINE constexpr std::uint64_t from_rep(std::uint64_t a) const noexcept { return reduce(0, a); }
+
+private:
+    std::uint64_t m_;
+    std::uint64_t inv_;
+    std::uint64_t one_;
+    std::uint64_t r2_;
+
+    static constexpr std::uint64_t compute_r2(std::uint64_t m, std::uint64_t r) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<std::uint64_t>(static_cast<intl::uint128_t>(r) * r % m);
+#else
+        // 2^128 = 2^64 * 2^64: 64 modular doublings of 2^64 mod m
+        for(int i = 0; i < 64; ++i)
+            r = r >= m - r ? r - (m - r) : r + r;
+        return r;
+#endif
+    }
+};
+
+/**
+ * Barrett reduction for any modulus `1 <= m < 2^32`, residues are kept as plain values. The quotient of
+ * `t / m` is estimated with a multiplication by the precomputed `ceil(2^64 / m)`, off by at most one.
+ */
+class barrett_reduction
+{
+public:
+    using value_type = std::uint32_t;
+
+    // Requires a non-zero `m`.
+    constexpr explicit barrett_reduction(std::uint32_t m) noexcept
+        : m_(m),
+          im_(static_cast<std::uint64_t>(-1) / m + 1)
+    {}
+
+    constexpr std::uint32_t modulus() const noexcept { return m_; }
+
+    // Returns `t mod m` for any `t <= 2^64 - m`, which covers every product of two 32-bit values: the estimated
+    // quotient `t * ceil(2^64 / m) / 2^64` is then at most one above the true one.
+    QS_ALWAYS_INLINE constexpr std::uint32_t reduce(std::uint64_t t) const noexcept
+    {
+        if(m_ == 1)
+            return 0;
+        std::uint64_t const q = intl::umulh64(t, im_);
+        std::uint64_t const y = q * m_;
+        return static_cast<std::uint32_t>(t - y + (t < y ? m_ : 0));
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint32_t mul(std::uint32_t a, std::uint32_t b) const noexcept
+    {
+        return reduce(static_cast<std::uint64_t>(a) * b);
+    }
+
+    QS_ALWAYS_INLINE constexpr std::uint32_t to_rep(std::uint64_t x) const noexcept { return x % m_; }
+    QS_ALWAYS_INLINE constexpr std::uint32_t from_rep(std::uint32_t a) const noexcept { return a; }
+
+private:
+    std::uint32_t m_;
+    std::uint64_t im_; // ceil(2^64 / m), wraps to 0 for m == 1
+};
+
+
+namespace intl
+{
+    // Addition, subtraction and exponentiation shared by every reduction, on residues in representation form.
+    // The conditional corrections are masks rather than branches, which would mispredict on random residues.
+    template<class Reduction>
+    struct mod_ops
+    {
+        QS_ALWAYS_INLINE static constexpr std::uint32_t add(std::uint32_t a, std::uint32_t b, std::uint32_t m) noexcept
+        {
+            std::uint64_t const s = static_cast<std::uint64_t>(a) + b;
+            return static_cast<std::uint32_t>(s - (m & (0u - static_cast<std::uint32_t>(s >= m))));
+        }
+
+        QS_ALWAYS_INLINE static constexpr std::uint32_t sub(std::uint32_t a, std::uint32_t b, std::uint32_t m) noexcept
+        {
+            return a - b + (m & (0u - static_cast<std::uint32_t>(a < b)));
+        }
+
+        static constexpr std::uint32_t pow(Reduction const& r, std::uint32_t base, std::uint64_t e) noexcept
+        {
+            std::uint32_t result = r.to_rep(1);
+            while(e != 0)
+            {
+                if(e & 1)
+                    result = r.mul(result, base);
+                base = r.mul(base, base);
+                e >>= 1;
+            }
+            return result;
+        }
+    };
+
+    template<std::uint32_t M>
+    using mod_int_reduction = std::conditional_t<M % 2 == 1, montgomery_reduction, barrett_reduction>;
+} // namespace intl
+
+
+/**
+ * Integer modulo the compile-time constant `M` (`1 <= M < 2^32`). Odd moduli use Montgomery form, even ones
+ * Barrett reduction, so no operation issues a hardware division once the value is constructed.
+ * Every operation is `constexpr`.
+ *
+ * Usage:
+ *      using mint = qs::mod_int<998244353>;
+ *      mint x = mint(3).pow(100) * mint(5).inverse();
+ *      std::uint32_t v = x.value();
+ */
+template<std::uint32_t M>
+class mod_int
+{
+    static_assert(M >= 1, "mod_int: the modulus must be non-zero");
+
+    using reduction_type = intl::mod_int_reduction<M>;
+    using ops            = intl::mod_ops<reduction_type>;
+
+    static constexpr reduction_type reduction_{M};
+
+public:
+    constexpr mod_int() noexcept = default;
+
+    template<class Int, std::enable_if_t<std::is_integral<Int>::value, int> = 0>
+    constexpr mod_int(Int x) noexcept
+        : rep_(reduction_.to_rep(normalize(x)))
+    {}
+
+    static constexpr std::uint32_t mod() noexcept { return M; }
+
+    constexpr std::uint32_t value() const noexcept { return reduction_.from_rep(rep_); }
+    constexpr explicit operator std::uint32_t() const noexcept { return value(); }
+
+    constexpr mod_int pow(std::uint64_t e) const noexcept { return from_rep(ops::pow(reduction_, rep_, e)); }
+
+    // Requires `gcd(value(), M) == 1`.
+    constexpr mod_int inverse() const noexcept { return mod_int(intl::inverse_mod(value(), M)); }
+
+    constexpr mod_int& operator+=(mod_int const& o) noexcept { return rep_ = ops::add(rep_, o.rep_, M), *this; }
+    constexpr mod_int& operator-=(mod_int const& o) noexcept { return rep_ = ops::sub(rep_, o.rep_, M), *this; }
+    constexpr mod_int& operator*=(mod_int const& o) noexcept { return rep_ = reduction_.mul(rep_, o.rep_), *this; }
+    constexpr mod_int& operator/=(mod_int const& o) noexcept { return *this *= o.inverse(); }
+
+    constexpr mod_int operator+() const noexcept { return *this; }
+    constexpr mod_int operator-() const noexcept { return from_rep(ops::sub(0, rep_, M)); }
+
+    friend constexpr mod_int operator+(mod_int l, mod_int const& r) noexcept { return l += r; }
+    friend constexpr mod_int operator-(mod_int l, mod_int const& r) noexcept { return l -= r; }
+    friend constexpr mod_int operator*(mod_int l, mod_int const& r) noexcept { return l *= r; }
+    friend constexpr mod_int operator/(mod_int l, mod_int const& r) noexcept { return l /= r; }
+
+    // the representation is canonical (fully reduced), so it can be compared directly
+    friend constexpr bool operator==(mod_int const& l, mod_int const& r) noexcept { return l.rep_ == r.rep_; }
+    friend constexpr bool operator!=(mod_int const& l, mod_int const& r) noexcept { return l.rep_ != r.rep_; }
+
+private:
+    std::uint32_t rep_ = 0;
+
+    static constexpr mod_int from_rep(std::uint32_t rep) noexcept
+    {
+        mod_int r;
+        r.rep_ = rep;
+        return r;
+    }
+
+    template<class Int>
+    static constexpr std::uint64_t normalize(Int x) noexcept
+    {
+        if constexpr(std::is_signed<Int>::value)
+        {
+            std::int64_t const v = static_cast<std::int64_t>(x) % static_cast<std::int64_t>(M);
+            return static_cast<std::uint64_t>(v < 0 ? v + M : v);
+        }
+        else
+            return static_cast<std::uint64_t>(x);
+    }
+};
+
+
+/**
+ * Modulus fixed at runtime (`1 <= m < 2^32`), operating on plain `std::uint32_t` residues in `[0, m)`.
+ * Products are reduced with Barrett reduction, which needs no representation change, so values can flow in
+ * and out of other code (hash tables, spans of residues) without conversions.
+ *
+ * Usage:
+ *      qs::dynamic_modulus mod(read_modulus());
+ *      std::uint32_t h = 0;
+ *      for(auto c: data)
+ *          h = mod.add(mod.mul(h, base), c);
+ */
+class dynamic_modulus
+{
+public:
+    constexpr explicit dynamic_modulus(std::uint32_t m) noexcept
+        : reduction_(m)
+    {}
+
+    constexpr std::uint32_t modulus() const noexcept { return reduction_.modulus(); }
+
+    // Reduces any 64-bit value without a division: Barrett covers `x <= 2^64 - m`, and above that `x - m`
+    // has the same residue.
+    constexpr std::uint32_t reduce(std::uint64_t x) const noexcept
+    {
+        std::uint64_t const m = modulus();
+        return reduction_.reduce(x - (x > 0 - m ? m : 0));
+    }
+
+    constexpr std::uint32_t add(std::uint32_t a, std::uint32_t b) const noexcept { return ops::add(a, b, modulus()); }
+    constexpr std::uint32_t sub(std::uint32_t a, std::uint32_t b) const noexcept { return ops::sub(a, b, modulus()); }
+    constexpr std::uint32_t mul(std::uint32_t a, std::uint32_t b) const noexcept { return reduction_.mul(a, b); }
+    constexpr std::uint32_t neg(std::uint32_t a) const noexcept { return ops::sub(0, a, modulus()); }
+
+    constexpr std::uint32_t pow(std::uint32_t a, std::uint64_t e) const noexcept
+    {
+        return ops::pow(reduction_, a, e);
+    }
+
+    // Requires `gcd(a, m) == 1`.
+    constexpr std::uint32_t inverse(std::uint32_t a) const noexcept { return intl::inverse_mod(a, modulus()); }
+
+    constexpr barrett_reduction const& reduction() const noexcept { return reduction_; }
+
+private:
+    using ops = intl::mod_ops<barrett_reduction>;
+
+    barrett_reduction reduction_;
+};
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_MOD_INT_H
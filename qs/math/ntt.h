@@ -0,0 +1,957 @@
+#ifndef QS_MATH_NTT_H
+#define QS_MATH_NTT_H
+
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/math/crt.h>
+#include <qs/math/mod_arithmetic.h>
+#include <qs/math/mod_batch.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+#include <qs/utils/cpu_features.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    QS_ALWAYS_INLINE constexpr std::uint32_t pow_mod_u32(std::uint64_t base, std::uint64_t e, std::uint32_t m) noexcept
+    {
+        std::uint64_t r = 1 % m;
+        for(base %= m; e != 0; e >>= 1, base = base * base % m)
+        {
+            if(e & 1)
+                r = r * base % m;
+        }
+        return static_cast<std::uint32_t>(r);
+    }
+
+    // Smallest generator of the multiplicative group of the prime `p`: `g` is a generator iff
+    // `g^((p-1)/q) != 1` for every prime factor `q` of `p - 1`.
+    constexpr std::uint32_t primitive_root(std::uint32_t p) noexcept
+    {
+        if(p == 2)
+            return 1;
+        std::uint32_t factors[32] = {};
+        int           count       = 0;
+        std::uint32_t rest        = p - 1;
+        for(std::uint32_t q = 2; q <= rest / q; ++q)
+        {
+            if(rest % q == 0)
+            {
+                factors[count++] = q;
+                while(rest % q == 0)
+                    rest /= q;
+            }
+        }
+        if(rest > 1)
+            factors[count++] = rest;
+
+        for(std::uint32_t g = 2;; ++g)
+        {
+            bool generator = true;
+            for(int i = 0; i < count && generator; ++i)
+                generator = pow_mod_u32(g, (p - 1) / factors[i], p) != 1;
+            if(generator)
+                return g;
+        }
+    }
+
+    // Sub-transforms of at most this many elements (a power of 4, 64 KiB of 32-bit residues) are finished
+    // depth-first, so their remaining levels run out of L2 instead of streaming the whole array per level.
+    QS_INLINE_VAR constexpr std::size_t ntt_block_size = std::size_t(1) << 14;
+
+#if QS_HAS_X86_DISPATCH
+    // Butterfly levels on Montgomery representations, `m` (a quarter or a half of `len`) a multiple of the lane
+    // count. Same data flow as the scalar members of `ntt` below.
+
+    QS_TARGET_AVX2 inline void ntt_forward_radix2_avx2(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                       std::uint32_t const* roots, std::uint32_t mod,
+                                                       std::uint32_t inv) noexcept
+    {
+        __m256i const        m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const        vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        std::size_t const    half = len / 2;
+        std::uint32_t const* w    = roots + half;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < half; j += 8)
+            {
+                __m256i const u  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j));
+                __m256i const v  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + half));
+                __m256i const wj = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), add_mod_avx2(u, v, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + half),
+                                    mont_mul_avx2(sub_mod_avx2(u, v, m), wj, m, vinv));
+            }
+        }
+    }
+
+    QS_TARGET_AVX2 inline void ntt_forward_radix4_avx2(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                       std::uint32_t const* roots, std::uint32_t mod,
+                                                       std::uint32_t inv) noexcept
+    {
+        __m256i const        m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const        vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        std::size_t const    q    = len / 4;
+        std::uint32_t const* w4   = roots + 2 * q;
+        std::uint32_t const* w2   = roots + q;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < q; j += 8)
+            {
+                __m256i const a0  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j));
+                __m256i const a1  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + q));
+                __m256i const a2  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + 2 * q));
+                __m256i const a3  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + 3 * q));
+                __m256i const w4a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w4 + j));
+                __m256i const w4b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w4 + j + q));
+                __m256i const w2a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w2 + j));
+                __m256i const b0  = add_mod_avx2(a0, a2, m);
+                __m256i const b1  = add_mod_avx2(a1, a3, m);
+                __m256i const b2  = mont_mul_avx2(sub_mod_avx2(a0, a2, m), w4a, m, vinv);
+                __m256i const b3  = mont_mul_avx2(sub_mod_avx2(a1, a3, m), w4b, m, vinv);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), add_mod_avx2(b0, b1, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + q),
+                                    mont_mul_avx2(sub_mod_avx2(b0, b1, m), w2a, m, vinv));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + 2 * q), add_mod_avx2(b2, b3, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + 3 * q),
+                                    mont_mul_avx2(sub_mod_avx2(b2, b3, m), w2a, m, vinv));
+            }
+        }
+    }
+
+    QS_TARGET_AVX2 inline void ntt_inverse_radix2_avx2(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                       std::uint32_t const* roots, std::uint32_t mod,
+                                                       std::uint32_t inv) noexcept
+    {
+        __m256i const        m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const        vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        std::size_t const    half = len / 2;
+        std::uint32_t const* w    = roots + half;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < half; j += 8)
+            {
+                __m256i const wj = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w + j));
+                __m256i const u  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j));
+                __m256i const v  = mont_mul_avx2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + half)),
+                                                 wj, m, vinv);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), add_mod_avx2(u, v, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + half), sub_mod_avx2(u, v, m));
+            }
+        }
+    }
+
+    QS_TARGET_AVX2 inline void ntt_inverse_radix4_avx2(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                       std::uint32_t const* roots, std::uint32_t mod,
+                                                       std::uint32_t inv) noexcept
+    {
+        __m256i const        m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const        vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        std::size_t const    q    = len / 4;
+        std::uint32_t const* w4   = roots + 2 * q;
+        std::uint32_t const* w2   = roots + q;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < q; j += 8)
+            {
+                __m256i const w2a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w2 + j));
+                __m256i const w4a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w4 + j));
+                __m256i const w4b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w4 + j + q));
+                __m256i const x0  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j));
+                __m256i const x2  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + 2 * q));
+                __m256i const c1  = mont_mul_avx2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + q)),
+                                                  w2a, m, vinv);
+                __m256i const c3  = mont_mul_avx2(
+                    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x + j + 3 * q)), w2a, m, vinv);
+                __m256i const b0 = add_mod_avx2(x0, c1, m);
+                __m256i const b1 = sub_mod_avx2(x0, c1, m);
+                __m256i const b2 = mont_mul_avx2(add_mod_avx2(x2, c3, m), w4a, m, vinv);
+                __m256i const b3 = mont_mul_avx2(sub_mod_avx2(x2, c3, m), w4b, m, vinv);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), add_mod_avx2(b0, b2, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + 2 * q), sub_mod_avx2(b0, b2, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + q), add_mod_avx2(b1, b3, m));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + 3 * q), sub_mod_avx2(b1, b3, m));
+            }
+        }
+    }
+
+    QS_TARGET_AVX2 inline void ntt_scale_avx2(std::uint32_t* a, std::size_t n, std::uint32_t factor, std::uint32_t mod,
+                                              std::uint32_t inv) noexcept
+    {
+        __m256i const m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        __m256i const f    = _mm256_set1_epi32(static_cast<int>(factor));
+        for(std::size_t i = 0; i < n; i += 8)
+        {
+            __m256i const x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), mont_mul_avx2(x, f, m, vinv));
+        }
+    }
+
+    // The two smallest radix-4 levels (sizes 16 and 4) fused, on two 16-element blocks per pass: a transpose of
+    // 128-bit lanes gathers the same quarter of both blocks in one vector (level 16), and a 4x4 transpose inside
+    // the lanes gathers the same element of every group of four (level 4).
+    QS_TARGET_AVX2 inline void transpose_lanes_avx2(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3) noexcept
+    {
+        __m256i const t0 = _mm256_unpacklo_epi32(v0, v1), t1 = _mm256_unpackhi_epi32(v0, v1);
+        __m256i const t2 = _mm256_unpacklo_epi32(v2, v3), t3 = _mm256_unpackhi_epi32(v2, v3);
+        v0               = _mm256_unpacklo_epi64(t0, t2);
+        v1               = _mm256_unpackhi_epi64(t0, t2);
+        v2               = _mm256_unpacklo_epi64(t1, t3);
+        v3               = _mm256_unpackhi_epi64(t1, t3);
+    }
+
+    QS_TARGET_AVX2 inline void load_quarters_avx2(std::uint32_t const* p, __m256i (&z)[4]) noexcept
+    {
+        __m256i const y0 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+        __m256i const y1 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 8));
+        __m256i const y2 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 16));
+        __m256i const y3 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 24));
+        z[0]             = _mm256_permute2x128_si256(y0, y2, 0x20);
+        z[1]             = _mm256_permute2x128_si256(y0, y2, 0x31);
+        z[2]             = _mm256_permute2x128_si256(y1, y3, 0x20);
+        z[3]             = _mm256_permute2x128_si256(y1, y3, 0x31);
+    }
+
+    QS_TARGET_AVX2 inline void store_quarters_avx2(std::uint32_t* p, __m256i const (&z)[4]) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_permute2x128_si256(z[0], z[1], 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 8), _mm256_permute2x128_si256(z[2], z[3], 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 16), _mm256_permute2x128_si256(z[0], z[1], 0x31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 24), _mm256_permute2x128_si256(z[2], z[3], 0x31));
+    }
+
+    QS_TARGET_AVX2 inline __m256i broadcast4_avx2(std::uint32_t const* p) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)));
+    }
+
+    QS_TARGET_AVX2 inline void ntt_forward_last16_avx2(std::uint32_t* a, std::size_t n, std::uint32_t const* roots,
+                                                       std::uint32_t mod, std::uint32_t inv) noexcept
+    {
+        __m256i const m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        __m256i const w2   = broadcast4_avx2(roots + 4);
+        __m256i const w4a  = broadcast4_avx2(roots + 8);
+        __m256i const w4b  = broadcast4_avx2(roots + 12);
+        __m256i const i4   = _mm256_set1_epi32(static_cast<int>(roots[3])); // w^1 at size 4
+        for(std::size_t s = 0; s < n; s += 32)
+        {
+            __m256i z[4];
+            load_quarters_avx2(a + s, z);
+            for(int level = 0; level < 2; ++level)
+            {
+                __m256i const b0 = add_mod_avx2(z[0], z[2], m);
+                __m256i const b1 = add_mod_avx2(z[1], z[3], m);
+                __m256i       b2 = sub_mod_avx2(z[0], z[2], m);
+                __m256i       b3 = sub_mod_avx2(z[1], z[3], m);
+                if(level == 0)
+                {
+                    b2 = mont_mul_avx2(b2, w4a, m, vinv);
+                    b3 = mont_mul_avx2(b3, w4b, m, vinv);
+                    z[1] = mont_mul_avx2(sub_mod_avx2(b0, b1, m), w2, m, vinv);
+                    z[3] = mont_mul_avx2(sub_mod_avx2(b2, b3, m), w2, m, vinv);
+                }
+                else // size 4: every twiddle is 1 but w^1
+                {
+                    b3   = mont_mul_avx2(b3, i4, m, vinv);
+                    z[1] = sub_mod_avx2(b0, b1, m);
+                    z[3] = sub_mod_avx2(b2, b3, m);
+                }
+                z[0] = add_mod_avx2(b0, b1, m);
+                z[2] = add_mod_avx2(b2, b3, m);
+                transpose_lanes_avx2(z[0], z[1], z[2], z[3]);
+            }
+            store_quarters_avx2(a + s, z);
+        }
+    }
+
+    QS_TARGET_AVX2 inline void ntt_inverse_first16_avx2(std::uint32_t* a, std::size_t n, std::uint32_t const* roots,
+                                                        std::uint32_t mod, std::uint32_t inv) noexcept
+    {
+        __m256i const m    = _mm256_set1_epi32(static_cast<int>(mod));
+        __m256i const vinv = _mm256_set1_epi32(static_cast<int>(inv));
+        __m256i const w2   = broadcast4_avx2(roots + 4);
+        __m256i const w4a  = broadcast4_avx2(roots + 8);
+        __m256i const w4b  = broadcast4_avx2(roots + 12);
+        __m256i const i4   = _mm256_set1_epi32(static_cast<int>(roots[3]));
+        for(std::size_t s = 0; s < n; s += 32)
+        {
+            __m256i z[4];
+            load_quarters_avx2(a + s, z);
+            for(int level = 0; level < 2; ++level)
+            {
+                transpose_lanes_avx2(z[0], z[1], z[2], z[3]);
+                __m256i c1 = z[1], c3 = z[3], b2, b3;
+                if(level == 1)
+                {
+                    c1 = mont_mul_avx2(c1, w2, m, vinv);
+                    c3 = mont_mul_avx2(c3, w2, m, vinv);
+                }
+                __m256i const b0 = add_mod_avx2(z[0], c1, m);
+                __m256i const b1 = sub_mod_avx2(z[0], c1, m);
+                if(level == 1)
+                {
+                    b2 = mont_mul_avx2(add_mod_avx2(z[2], c3, m), w4a, m, vinv);
+                    b3 = mont_mul_avx2(sub_mod_avx2(z[2], c3, m), w4b, m, vinv);
+                }
+                else
+                {
+                    b2 = add_mod_avx2(z[2], c3, m);
+                    b3 = mont_mul_avx2(sub_mod_avx2(z[2], c3, m), i4, m, vinv);
+                }
+                z[0] = add_mod_avx2(b0, b2, m);
+                z[2] = sub_mod_avx2(b0, b2, m);
+                z[1] = add_mod_avx2(b1, b3, m);
+                z[3] = sub_mod_avx2(b1, b3, m);
+            }
+            store_quarters_avx2(a + s, z);
+        }
+    }
+
+    QS_SIMD_DIAGNOSTICS_BEGIN
+
+    QS_TARGET_AVX512 inline void ntt_forward_radix2_avx512(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                           std::uint32_t const* roots, std::uint32_t mod,
+                                                           std::uint32_t inv) noexcept
+    {
+        __m512i const        m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const        vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        std::size_t const    half = len / 2;
+        std::uint32_t const* w    = roots + half;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < half; j += 16)
+            {
+                __m512i const u = _mm512_loadu_si512(x + j);
+                __m512i const v = _mm512_loadu_si512(x + j + half);
+                _mm512_storeu_si512(x + j, add_mod_avx512(u, v, m));
+                _mm512_storeu_si512(x + j + half,
+                                    mont_mul_avx512(sub_mod_avx512(u, v, m), _mm512_loadu_si512(w + j), m, vinv));
+            }
+        }
+    }
+
+    QS_TARGET_AVX512 inline void ntt_forward_radix4_avx512(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                           std::uint32_t const* roots, std::uint32_t mod,
+                                                           std::uint32_t inv) noexcept
+    {
+        __m512i const        m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const        vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        std::size_t const    q    = len / 4;
+        std::uint32_t const* w4   = roots + 2 * q;
+        std::uint32_t const* w2   = roots + q;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < q; j += 16)
+            {
+                __m512i const a0  = _mm512_loadu_si512(x + j);
+                __m512i const a1  = _mm512_loadu_si512(x + j + q);
+                __m512i const a2  = _mm512_loadu_si512(x + j + 2 * q);
+                __m512i const a3  = _mm512_loadu_si512(x + j + 3 * q);
+                __m512i const w2a = _mm512_loadu_si512(w2 + j);
+                __m512i const b0  = add_mod_avx512(a0, a2, m);
+                __m512i const b1  = add_mod_avx512(a1, a3, m);
+                __m512i const b2  = mont_mul_avx512(sub_mod_avx512(a0, a2, m), _mm512_loadu_si512(w4 + j), m, vinv);
+                __m512i const b3 =
+                    mont_mul_avx512(sub_mod_avx512(a1, a3, m), _mm512_loadu_si512(w4 + j + q), m, vinv);
+                _mm512_storeu_si512(x + j, add_mod_avx512(b0, b1, m));
+                _mm512_storeu_si512(x + j + q, mont_mul_avx512(sub_mod_avx512(b0, b1, m), w2a, m, vinv));
+                _mm512_storeu_si512(x + j + 2 * q, add_mod_avx512(b2, b3, m));
+                _mm512_storeu_si512(x + j + 3 * q, mont_mul_avx512(sub_mod_avx512(b2, b3, m), w2a, m, vinv));
+            }
+        }
+    }
+
+    QS_TARGET_AVX512 inline void ntt_inverse_radix2_avx512(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                           std::uint32_t const* roots, std::uint32_t mod,
+                                                           std::uint32_t inv) noexcept
+    {
+        __m512i const        m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const        vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        std::size_t const    half = len / 2;
+        std::uint32_t const* w    = roots + half;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < half; j += 16)
+            {
+                __m512i const u = _mm512_loadu_si512(x + j);
+                __m512i const v = mont_mul_avx512(_mm512_loadu_si512(x + j + half), _mm512_loadu_si512(w + j), m, vinv);
+                _mm512_storeu_si512(x + j, add_mod_avx512(u, v, m));
+                _mm512_storeu_si512(x + j + half, sub_mod_avx512(u, v, m));
+            }
+        }
+    }
+
+    QS_TARGET_AVX512 inline void ntt_inverse_radix4_avx512(std::uint32_t* a, std::size_t n, std::size_t len,
+                                                           std::uint32_t const* roots, std::uint32_t mod,
+                                                           std::uint32_t inv) noexcept
+    {
+        __m512i const        m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const        vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        std::size_t const    q    = len / 4;
+        std::uint32_t const* w4   = roots + 2 * q;
+        std::uint32_t const* w2   = roots + q;
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            std::uint32_t* const x = a + s;
+            for(std::size_t j = 0; j < q; j += 16)
+            {
+                __m512i const w2a = _mm512_loadu_si512(w2 + j);
+                __m512i const x0  = _mm512_loadu_si512(x + j);
+                __m512i const x2  = _mm512_loadu_si512(x + j + 2 * q);
+                __m512i const c1  = mont_mul_avx512(_mm512_loadu_si512(x + j + q), w2a, m, vinv);
+                __m512i const c3  = mont_mul_avx512(_mm512_loadu_si512(x + j + 3 * q), w2a, m, vinv);
+                __m512i const b0  = add_mod_avx512(x0, c1, m);
+                __m512i const b1  = sub_mod_avx512(x0, c1, m);
+                __m512i const b2  = mont_mul_avx512(add_mod_avx512(x2, c3, m), _mm512_loadu_si512(w4 + j), m, vinv);
+                __m512i const b3 =
+                    mont_mul_avx512(sub_mod_avx512(x2, c3, m), _mm512_loadu_si512(w4 + j + q), m, vinv);
+                _mm512_storeu_si512(x + j, add_mod_avx512(b0, b2, m));
+                _mm512_storeu_si512(x + j + 2 * q, sub_mod_avx512(b0, b2, m));
+                _mm512_storeu_si512(x + j + q, add_mod_avx512(b1, b3, m));
+                _mm512_storeu_si512(x + j + 3 * q, sub_mod_avx512(b1, b3, m));
+            }
+        }
+    }
+
+    QS_TARGET_AVX512 inline void ntt_scale_avx512(std::uint32_t* a, std::size_t n, std::uint32_t factor,
+                                                  std::uint32_t mod, std::uint32_t inv) noexcept
+    {
+        __m512i const m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        __m512i const f    = _mm512_set1_epi32(static_cast<int>(factor));
+        for(std::size_t i = 0; i < n; i += 16)
+            _mm512_storeu_si512(a + i, mont_mul_avx512(_mm512_loadu_si512(a + i), f, m, vinv));
+    }
+
+    // Same fusion on four 16-element blocks per pass, the 128-bit lane transpose now spans four vectors.
+    QS_TARGET_AVX512 inline void transpose_quarters_avx512(__m512i (&z)[4]) noexcept
+    {
+        __m512i const u0 = _mm512_shuffle_i32x4(z[0], z[1], 0x44), u1 = _mm512_shuffle_i32x4(z[0], z[1], 0xEE);
+        __m512i const u2 = _mm512_shuffle_i32x4(z[2], z[3], 0x44), u3 = _mm512_shuffle_i32x4(z[2], z[3], 0xEE);
+        z[0]             = _mm512_shuffle_i32x4(u0, u2, 0x88);
+        z[1]             = _mm512_shuffle_i32x4(u0, u2, 0xDD);
+        z[2]             = _mm512_shuffle_i32x4(u1, u3, 0x88);
+        z[3]             = _mm512_shuffle_i32x4(u1, u3, 0xDD);
+    }
+
+    QS_TARGET_AVX512 inline void transpose_lanes_avx512(__m512i (&z)[4]) noexcept
+    {
+        __m512i const t0 = _mm512_unpacklo_epi32(z[0], z[1]), t1 = _mm512_unpackhi_epi32(z[0], z[1]);
+        __m512i const t2 = _mm512_unpacklo_epi32(z[2], z[3]), t3 = _mm512_unpackhi_epi32(z[2], z[3]);
+        z[0]             = _mm512_unpacklo_epi64(t0, t2);
+        z[1]             = _mm512_unpackhi_epi64(t0, t2);
+        z[2]             = _mm512_unpacklo_epi64(t1, t3);
+        z[3]             = _mm512_unpackhi_epi64(t1, t3);
+    }
+
+    QS_TARGET_AVX512 inline __m512i broadcast4_avx512(std::uint32_t const* p) noexcept
+    {
+        // zero-masking form, the unmasked one trips the same GCC false positive as above
+        return _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<__m128i const*>(p)));
+    }
+
+    QS_TARGET_AVX512 inline void ntt_forward_last16_avx512(std::uint32_t* a, std::size_t n,
+                                                           std::uint32_t const* roots, std::uint32_t mod,
+                                                           std::uint32_t inv) noexcept
+    {
+        __m512i const m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        __m512i const w2   = broadcast4_avx512(roots + 4);
+        __m512i const w4a  = broadcast4_avx512(roots + 8);
+        __m512i const w4b  = broadcast4_avx512(roots + 12);
+        __m512i const i4   = _mm512_set1_epi32(static_cast<int>(roots[3]));
+        for(std::size_t s = 0; s < n; s += 64)
+        {
+            __m512i z[4];
+            for(int k = 0; k < 4; ++k)
+                z[k] = _mm512_loadu_si512(a + s + 16 * k);
+            transpose_quarters_avx512(z);
+            for(int level = 0; level < 2; ++level)
+            {
+                __m512i const b0 = add_mod_avx512(z[0], z[2], m);
+                __m512i const b1 = add_mod_avx512(z[1], z[3], m);
+                __m512i       b2 = sub_mod_avx512(z[0], z[2], m);
+                __m512i       b3 = sub_mod_avx512(z[1], z[3], m);
+                if(level == 0)
+                {
+                    b2   = mont_mul_avx512(b2, w4a, m, vinv);
+                    b3   = mont_mul_avx512(b3, w4b, m, vinv);
+                    z[1] = mont_mul_avx512(sub_mod_avx512(b0, b1, m), w2, m, vinv);
+                    z[3] = mont_mul_avx512(sub_mod_avx512(b2, b3, m), w2, m, vinv);
+                }
+                else
+                {
+                    b3   = mont_mul_avx512(b3, i4, m, vinv);
+                    z[1] = sub_mod_avx512(b0, b1, m);
+                    z[3] = sub_mod_avx512(b2, b3, m);
+                }
+                z[0] = add_mod_avx512(b0, b1, m);
+                z[2] = add_mod_avx512(b2, b3, m);
+                transpose_lanes_avx512(z);
+            }
+            transpose_quarters_avx512(z);
+            for(int k = 0; k < 4; ++k)
+                _mm512_storeu_si512(a + s + 16 * k, z[k]);
+        }
+    }
+
+    QS_TARGET_AVX512 inline void ntt_inverse_first16_avx512(std::uint32_t* a, std::size_t n,
+                                                            std::uint32_t const* roots, std::uint32_t mod,
+                                                            std::uint32_t inv) noexcept
+    {
+        __m512i const m    = _mm512_set1_epi32(static_cast<int>(mod));
+        __m512i const vinv = _mm512_set1_epi32(static_cast<int>(inv));
+        __m512i const w2   = broadcast4_avx512(roots + 4);
+        __m512i const w4a  = broadcast4_avx512(roots + 8);
+        __m512i const w4b  = broadcast4_avx512(roots + 12);
+        __m512i const i4   = _mm512_set1_epi32(static_cast<int>(roots[3]));
+        for(std::size_t s = 0; s < n; s += 64)
+        {
+            __m512i z[4];
+            for(int k = 0; k < 4; ++k)
+                z[k] = _mm512_loadu_si512(a + s + 16 * k);
+            transpose_quarters_avx512(z);
+            for(int level = 0; level < 2; ++level)
+            {
+                transpose_lanes_avx512(z);
+                __m512i c1 = z[1], c3 = z[3], b2, b3;
+                if(level == 1)
+                {
+                    c1 = mont_mul_avx512(c1, w2, m, vinv);
+                    c3 = mont_mul_avx512(c3, w2, m, vinv);
+                }
+                __m512i const b0 = add_mod_avx512(z[0], c1, m);
+                __m512i const b1 = sub_mod_avx512(z[0], c1, m);
+                if(level == 1)
+                {
+                    b2 = mont_mul_avx512(add_mod_avx512(z[2], c3, m), w4a, m, vinv);
+                    b3 = mont_mul_avx512(sub_mod_avx512(z[2], c3, m), w4b, m, vinv);
+                }
+                else
+                {
+                    b2 = add_mod_avx512(z[2], c3, m);
+                    b3 = mont_mul_avx512(sub_mod_avx512(z[2], c3, m), i4, m, vinv);
+                }
+                z[0] = add_mod_avx512(b0, b2, m);
+                z[2] = sub_mod_avx512(b0, b2, m);
+                z[1] = add_mod_avx512(b1, b3, m);
+                z[3] = sub_mod_avx512(b1, b3, m);
+            }
+            transpose_quarters_avx512(z);
+            for(int k = 0; k < 4; ++k)
+                _mm512_storeu_si512(a + s + 16 * k, z[k]);
+        }
+    }
+
+    QS_SIMD_DIAGNOSTICS_END
+#endif // QS_HAS_X86_DISPATCH
+} // namespace intl
+
+
+/**
+ * Number-theoretic transform modulo the NTT-friendly prime `M` (`M - 1` divisible by a large power of two),
+ * with twiddle factors precomputed for every power-of-two size up to `max_size`.
+ *
+ * `forward` is a decimation-in-frequency transform taking natural order to bit-reversed order, and `inverse`
+ * the matching decimation-in-time transform taking it back, so convolutions never permute the data. Both work
+ * in place, two levels at a time (radix 4, with one radix-2 level for odd powers of two), and switch from
+ * level-by-level passes to finishing each 2^14-element block once a sub-transform fits in cache.
+ * Levels run on AVX-512/AVX2 Montgomery kernels when available (see `active_simd_level()`), with the two
+ * smallest levels fused through in-register transposes.
+ *
+ * Usage:
+ *      qs::ntt<998244353> plan(1 << 20);
+ *      plan.forward(a);          // a, b: spans of mod_int<998244353>, same power-of-two size
+ *      plan.forward(b);
+ *      for(std::size_t i = 0; i < a.size(); ++i)
+ *          a[i] *= b[i];
+ *      plan.inverse(a);          // a holds the cyclic convolution
+ */
+template<std::uint32_t M>
+class ntt
+{
+public:
+    using value_type = mod_int<M>;
+
+    static constexpr int           max_log_size = countr_zero(M - 1);
+    static constexpr std::uint32_t root         = intl::primitive_root(M);
+
+    static_assert(M % 2 == 1 && max_log_size >= 2, "ntt: the modulus must be a prime with 4 | M - 1");
+
+    // Requires `max_size` to be a power of two dividing `M - 1`.
+    explicit ntt(std::size_t max_size)
+        : roots_(std::max<std::size_t>(max_size, 2)),
+          inverse_roots_(roots_.size())
+    {
+        QS_VERIFY(popcount(max_size) == 1 && countr_zero(max_size) <= max_log_size,
+                  "ntt: max_size must be a power of two dividing M - 1");
+        // roots_[h + k] = w^k for the primitive (2h)-th root of unity w, k < h
+        for(std::size_t h = 1; h < roots_.size(); h *= 2)
+        {
+            value_type const w     = value_type(root).pow((M - 1) / (2 * h));
+            value_type const w_inv = w.pow(2 * h - 1);
+            value_type       x(1), y(1);
+            for(std::size_t k = 0; k < h; ++k, x *= w, y *= w_inv)
+            {
+                roots_[h + k]         = x;
+                inverse_roots_[h + k] = y;
+            }
+        }
+    }
+
+    std::size_t max_size() const noexcept { return roots_.size(); }
+
+    // Natural order to bit-reversed order. `a.size()` must be a power of two, at most `max_size()`.
+    void forward(span<value_type> a) const noexcept(is_nothrow_contract_violation)
+    {
+        std::size_t const n     = check_size(a.size());
+        value_type* const p     = a.data();
+        simd_level const  level = active_simd_level();
+        std::size_t       len   = n;
+        if(countr_zero(n) % 2 == 1)
+        {
+            forward_radix2(p, n, len, level);
+            len /= 2;
+        }
+        for(; len > intl::ntt_block_size; len /= 4)
+            forward_radix4(p, n, len, level);
+        for(std::size_t b = 0; b < n; b += len)
+        {
+            std::size_t l = len;
+            for(; l > 16; l /= 4)
+                forward_radix4(p + b, len, l, level);
+            if(l == 16 && forward_last16(p + b, len, level))
+                continue;
+            for(; l >= 4; l /= 4)
+                forward_radix4(p + b, len, l, level);
+        }
+    }
+
+    // Bit-reversed order to natural order, divided by `a.size()`: `inverse(forward(a)) == a`.
+    void inverse(span<value_type> a) const noexcept(is_nothrow_contract_violation)
+    {
+        std::size_t const n     = check_size(a.size());
+        value_type* const p     = a.data();
+        simd_level const  level = active_simd_level();
+        std::size_t const top   = countr_zero(n) % 2 == 1 ? n / 2 : n; // largest radix-4 level
+        std::size_t const block = std::min(top, intl::ntt_block_size);
+        for(std::size_t b = 0; b < n; b += block)
+        {
+            std::size_t l = 4;
+            if(block >= 16 && inverse_first16(p + b, block, level))
+                l = 64;
+            for(; l <= block; l *= 4)
+                inverse_radix4(p + b, block, l, level);
+        }
+        for(std::size_t l = block * 4; l <= top; l *= 4)
+            inverse_radix4(p, n, l, level);
+        if(top != n)
+            inverse_radix2(p, n, n, level);
+        scale(p, n, value_type(n).inverse(), level);
+    }
+
+    // Cyclic convolution in place: `a` receives `a * b`, `b` is left transformed. Same power-of-two sizes.
+    void convolve(span<value_type> a, span<value_type> b) const noexcept(is_nothrow_contract_violation)
+    {
+        QS_VERIFY(a.size() == b.size(), "ntt: convolution operands must have the same size");
+        forward(a);
+        forward(b);
+        mul_mod<M>(a, b, a);
+        inverse(a);
+    }
+
+private:
+    static constexpr montgomery_reduction montgomery_{M};
+
+    std::vector<value_type> roots_;
+    std::vector<value_type> inverse_roots_;
+
+    std::size_t check_size(std::size_t n) const noexcept(is_nothrow_contract_violation)
+    {
+        QS_VERIFY(n != 0 && popcount(n) == 1 && n <= max_size(), "ntt: size must be a power of two <= max_size()");
+        return n;
+    }
+
+    // One level of butterflies `(u, v) -> (u + v, (u - v) w^j)` on every block of `len` elements.
+    void forward_radix2(value_type* a, std::size_t n, std::size_t len, simd_level level) const noexcept
+    {
+        std::size_t const       half = len / 2;
+        value_type const* const w    = roots_.data() + half;
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && half % 16 == 0)
+            return intl::ntt_forward_radix2_avx512(reps(a), n, len, reps(roots_.data()), M,
+                                                   montgomery_.modulus_inverse());
+        if(level != simd_level::scalar && half % 8 == 0)
+            return intl::ntt_forward_radix2_avx2(reps(a), n, len, reps(roots_.data()), M,
+                                                 montgomery_.modulus_inverse());
+#endif
+        intl::ignore_unused(level);
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            for(std::size_t j = 0; j < half; ++j)
+            {
+                value_type const u = a[s + j], v = a[s + j + half];
+                a[s + j]           = u + v;
+                a[s + j + half]    = (u - v) * w[j];
+            }
+        }
+    }
+
+    // Two levels at once (sizes `len` then `len / 2`), four multiplications per four elements.
+    void forward_radix4(value_type* a, std::size_t n, std::size_t len, simd_level level) const noexcept
+    {
+        std::size_t const       m  = len / 4;
+        value_type const* const w4 = roots_.data() + 2 * m;
+        value_type const* const w2 = roots_.data() + m;
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && m % 16 == 0)
+            return intl::ntt_forward_radix4_avx512(reps(a), n, len, reps(roots_.data()), M,
+                                                   montgomery_.modulus_inverse());
+        if(level != simd_level::scalar && m % 8 == 0)
+            return intl::ntt_forward_radix4_avx2(reps(a), n, len, reps(roots_.data()), M,
+                                                 montgomery_.modulus_inverse());
+#endif
+        intl::ignore_unused(level);
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            value_type* const x = a + s;
+            for(std::size_t j = 0; j < m; ++j)
+            {
+                value_type const a0 = x[j], a1 = x[j + m], a2 = x[j + 2 * m], a3 = x[j + 3 * m];
+                value_type const b0 = a0 + a2, b1 = a1 + a3;
+                value_type const b2 = (a0 - a2) * w4[j], b3 = (a1 - a3) * w4[j + m];
+                x[j]                = b0 + b1;
+                x[j + m]            = (b0 - b1) * w2[j];
+                x[j + 2 * m]        = b2 + b3;
+                x[j + 3 * m]        = (b2 - b3) * w2[j];
+            }
+        }
+    }
+
+    // Inverse of `forward_radix2` up to a factor 2: `(p, q) -> (p + q w^-j, p - q w^-j)`.
+    void inverse_radix2(value_type* a, std::size_t n, std::size_t len, simd_level level) const noexcept
+    {
+        std::size_t const       half = len / 2;
+        value_type const* const w    = inverse_roots_.data() + half;
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && half % 16 == 0)
+            return intl::ntt_inverse_radix2_avx512(reps(a), n, len, reps(inverse_roots_.data()), M,
+                                                   montgomery_.modulus_inverse());
+        if(level != simd_level::scalar && half % 8 == 0)
+            return intl::ntt_inverse_radix2_avx2(reps(a), n, len, reps(inverse_roots_.data()), M,
+                                                 montgomery_.modulus_inverse());
+#endif
+        intl::ignore_unused(level);
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            for(std::size_t j = 0; j < half; ++j)
+            {
+                value_type const u = a[s + j], v = a[s + j + half] * w[j];
+                a[s + j]           = u + v;
+                a[s + j + half]    = u - v;
+            }
+        }
+    }
+
+    // Inverse of `forward_radix4` up to a factor 4: levels `len / 2` then `len`.
+    void inverse_radix4(value_type* a, std::size_t n, std::size_t len, simd_level level) const noexcept
+    {
+        std::size_t const       m  = len / 4;
+        value_type const* const w4 = inverse_roots_.data() + 2 * m;
+        value_type const* const w2 = inverse_roots_.data() + m;
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && m % 16 == 0)
+            return intl::ntt_inverse_radix4_avx512(reps(a), n, len, reps(inverse_roots_.data()), M,
+                                                   montgomery_.modulus_inverse());
+        if(level != simd_level::scalar && m % 8 == 0)
+            return intl::ntt_inverse_radix4_avx2(reps(a), n, len, reps(inverse_roots_.data()), M,
+                                                 montgomery_.modulus_inverse());
+#endif
+        intl::ignore_unused(level);
+        for(std::size_t s = 0; s < n; s += len)
+        {
+            value_type* const x = a + s;
+            for(std::size_t j = 0; j < m; ++j)
+            {
+                value_type const c1 = x[j + m] * w2[j], c3 = x[j + 3 * m] * w2[j];
+                value_type const b0 = x[j] + c1, b1 = x[j] - c1;
+                value_type const b2 = (x[j + 2 * m] + c3) * w4[j], b3 = (x[j + 2 * m] - c3) * w4[j + m];
+                x[j]                = b0 + b2;
+                x[j + 2 * m]        = b0 - b2;
+                x[j + m]            = b1 + b3;
+                x[j + 3 * m]        = b1 - b3;
+            }
+        }
+    }
+
+    // Sizes 16 and 4 of the forward transform on `n` elements, false when no fused kernel applies.
+    bool forward_last16(value_type* a, std::size_t n, simd_level level) const noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && n % 64 == 0)
+            return intl::ntt_forward_last16_avx512(reps(a), n, reps(roots_.data()), M, montgomery_.modulus_inverse()),
+                   true;
+        if(level != simd_level::scalar && n % 32 == 0)
+            return intl::ntt_forward_last16_avx2(reps(a), n, reps(roots_.data()), M, montgomery_.modulus_inverse()),
+                   true;
+#endif
+        intl::ignore_unused(a, n, level);
+        return false;
+    }
+
+    // Sizes 4 and 16 of the inverse transform on `n` elements, false when no fused kernel applies.
+    bool inverse_first16(value_type* a, std::size_t n, simd_level level) const noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && n % 64 == 0)
+            return intl::ntt_inverse_first16_avx512(reps(a), n, reps(inverse_roots_.data()), M,
+                                                    montgomery_.modulus_inverse()),
+                   true;
+        if(level != simd_level::scalar && n % 32 == 0)
+            return intl::ntt_inverse_first16_avx2(reps(a), n, reps(inverse_roots_.data()), M,
+                                                  montgomery_.modulus_inverse()),
+                   true;
+#endif
+        intl::ignore_unused(a, n, level);
+        return false;
+    }
+
+    void scale(value_type* a, std::size_t n, value_type factor, simd_level level) const noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        if(level == simd_level::avx512 && n % 16 == 0)
+            return intl::ntt_scale_avx512(reps(a), n, *reps(&factor), M, montgomery_.modulus_inverse());
+        if(level != simd_level::scalar && n % 8 == 0)
+            return intl::ntt_scale_avx2(reps(a), n, *reps(&factor), M, montgomery_.modulus_inverse());
+#endif
+        intl::ignore_unused(level);
+        for(std::size_t i = 0; i < n; ++i)
+            a[i] *= factor;
+    }
+
+    // `mod_int` is layout compatible with its Montgomery representation, see `intl::mod_int_reps`
+    static std::uint32_t* reps(value_type* p) noexcept { return reinterpret_cast<std::uint32_t*>(p); }
+    static std::uint32_t const* reps(value_type const* p) noexcept { return reinterpret_cast<std::uint32_t const*>(p); }
+};
+
+
+/**
+ * Linear convolution `out[k] = sum a[i] * b[k - i]` modulo `M`, zero-padded to the next power of two.
+ * `out.size()` must be at least `a.size() + b.size() - 1` (extra elements are zeroed), and that result size at
+ * most `2^ntt<M>::max_log_size`.
+ */
+template<std::uint32_t M>
+void convolve(type_identity_t<span<mod_int<M> const>> a, type_identity_t<span<mod_int<M> const>> b,
+              span<mod_int<M>> out)
+{
+    if(a.empty() || b.empty())
+    {
+        std::fill(out.begin(), out.end(), mod_int<M>(0));
+        return;
+    }
+    std::size_t const result_size = a.size() + b.size() - 1;
+    QS_VERIFY(result_size <= (std::size_t(1) << ntt<M>::max_log_size), "convolve: result too long for the modulus");
+    QS_VERIFY(out.size() >= result_size, "convolve: output too small");
+    std::size_t n = 1;
+    while(n < result_size)
+        n *= 2;
+
+    std::vector<mod_int<M>> fa(n), fb(n);
+    std::copy(a.begin(), a.end(), fa.begin());
+    std::copy(b.begin(), b.end(), fb.begin());
+    ntt<M>(n).convolve(make_span(fa), make_span(fb));
+    std::copy(fa.begin(), fa.begin() + static_cast<std::ptrdiff_t>(result_size), out.begin());
+    std::fill(out.begin() + static_cast<std::ptrdiff_t>(result_size), out.end(), mod_int<M>(0));
+}
+
+
+namespace intl
+{
+    // Three NTT primes supporting transforms of 2^24 points, with a product of about 2^85.6.
+    QS_INLINE_VAR constexpr std::uint32_t ntt_crt_m1 = 469762049; // 7 * 2^26 + 1
+    QS_INLINE_VAR constexpr std::uint32_t ntt_crt_m2 = 167772161; // 5 * 2^25 + 1
+    QS_INLINE_VAR constexpr std::uint32_t ntt_crt_m3 = 754974721; // 45 * 2^24 + 1
+
+    template<std::uint32_t M>
+    void convolve_residues(span<std::uint32_t const> a, span<std::uint32_t const> b, std::size_t n,
+                           std::vector<mod_int<M>>& out)
+    {
+        std::vector<mod_int<M>> fb(n);
+        out.assign(n, mod_int<M>(0));
+        for(std::size_t i = 0; i < a.size(); ++i)
+            out[i] = mod_int<M>(a[i]);
+        for(std::size_t i = 0; i < b.size(); ++i)
+            fb[i] = mod_int<M>(b[i]);
+        ntt<M>(n).convolve(make_span(out), make_span(fb));
+    }
+} // namespace intl
+
+/**
+ * Exact linear convolution of non-negative 32-bit sequences: convolutions modulo three NTT primes are combined
+ * with Garner's form of the Chinese remainder theorem, whose constants come from `extended_gcd`. Results are
+ * the true sums reduced modulo 2^64 (exact whenever they fit in 64 bits) as long as every true sum is below
+ * the product of the primes, about 2^85, which holds e.g. for `min(a.size(), b.size()) * max(a) * max(b)`
+ * below that bound. The result size `a.size() + b.size() - 1` is limited to 2^24.
+ */
+inline void convolve_exact(span<std::uint32_t const> a, span<std::uint32_t const> b, span<std::uint64_t> out)
+{
+    using intl::ntt_crt_m1;
+    using intl::ntt_crt_m2;
+    using intl::ntt_crt_m3;
+    using mint2 = mod_int<ntt_crt_m2>;
+    using mint3 = mod_int<ntt_crt_m3>;
+
+    if(a.empty() || b.empty())
+    {
+        std::fill(out.begin(), out.end(), std::uint64_t(0));
+        return;
+    }
+    std::size_t const result_size = a.size() + b.size() - 1;
+    QS_VERIFY(result_size <= (std::size_t(1) << 24), "convolve_exact: result longer than 2^24");
+    QS_VERIFY(out.size() >= result_size, "convolve_exact: output too small");
+    std::size_t n = 1;
+    while(n < result_size)
+        n *= 2;
+
+    std::vector<mod_int<ntt_crt_m1>> r1;
+    std::vector<mint2>               r2;
+    std::vector<mint3>               r3;
+    intl::convolve_residues<ntt_crt_m1>(a, b, n, r1);
+    intl::convolve_residues<ntt_crt_m2>(a, b, n, r2);
+    intl::convolve_residues<ntt_crt_m3>(a, b, n, r3);
+
+    // x = x1 + m1 * k2 + m1 * m2 * k3, with every digit reduced modulo the next prime
+    constexpr std::uint64_t m1m2   = std::uint64_t(ntt_crt_m1) * ntt_crt_m2;
+    mint2 const             inv12  = intl::crt_inverse(ntt_crt_m1 % ntt_crt_m2, ntt_crt_m2);
+    mint3 const             inv123 = intl::crt_inverse(static_cast<std::uint32_t>(m1m2 % ntt_crt_m3), ntt_crt_m3);
+    for(std::size_t i = 0; i < result_size; ++i)
+    {
+        std::uint32_t const x1 = r1[i].value();
+        std::uint32_t const k2 = ((r2[i] - mint2(x1)) * inv12).value();
+        std::uint64_t const x2 = x1 + std::uint64_t(ntt_crt_m1) * k2; // x mod m1 m2, below 2^64
+        std::uint32_t const k3 = ((r3[i] - mint3(x2)) * inv123).value();
+        out[i]                 = x2 + m1m2 * k3; // wraps modulo 2^64
+    }
+    std::fill(out.begin() + static_cast<std::ptrdiff_t>(result_size), out.end(), std::uint64_t(0));
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_NTT_H
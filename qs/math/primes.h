@@ -0,0 +1,424 @@
+#ifndef QS_MATH_PRIMES_H
+#define QS_MATH_PRIMES_H
+
+#include <qs/bit.h>
+#include <qs/config.h>
+#include <qs/math/mod_int.h>
+#include <qs/span.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace intl
+{
+    template<class Reduction>
+    constexpr typename Reduction::value_type pow_rep(Reduction const& r, typename Reduction::value_type base,
+                                                     typename Reduction::value_type e) noexcept
+    {
+        auto x = r.to_rep(1);
+        for(; e != 0; e >>= 1, base = r.mul(base, base))
+        {
+            if(e & 1)
+                x = r.mul(x, base);
+        }
+        return x;
+    }
+
+    // Strong probable prime test of the odd `n = r.modulus()` to base `a`, in Montgomery form throughout
+    // (`reduce` returns fully reduced values, so representations compare directly).
+    template<class Reduction>
+    constexpr bool is_strong_probable_prime(Reduction const& r, typename Reduction::value_type a) noexcept
+    {
+        using U           = typename Reduction::value_type;
+        U const n         = r.modulus();
+        int const s       = countr_zero(static_cast<U>(n - 1));
+        U const   one     = r.to_rep(1);
+        U const   neg_one = r.to_rep(n - 1);
+        U         x       = pow_rep(r, r.to_rep(a), static_cast<U>((n - 1) >> s));
+        if(x == one || x == neg_one)
+            return true;
+        for(int i = 1; i < s; ++i)
+        {
+            x = r.mul(x, x);
+            if(x == neg_one)
+                return true;
+        }
+        return false;
+    }
+
+    // Integer square root, `floor(sqrt(n))`.
+    inline std::uint64_t isqrt(std::uint64_t n) noexcept
+    {
+        auto r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+        while(r > 0 && (r > 0xffffffffu || r * r > n))
+            --r;
+        while(r < 0xffffffffu && (r + 1) * (r + 1) <= n)
+            ++r;
+        return r;
+    }
+} // namespace intl
+
+/**
+ * Deterministic Miller-Rabin primality test for all 64-bit integers, after trial division by the primes up to 37.
+ * Below 2^32 the bases {2, 7, 61} are enough and run on the 32-bit `montgomery_reduction`, above they are
+ * Sinclair's seven bases on `montgomery_reduction64`, a few hundred modular multiplications in the worst case.
+ */
+constexpr bool is_prime(std::uint64_t n) noexcept
+{
+    constexpr std::uint32_t small[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    for(std::uint32_t p: small)
+    {
+        if(n % p == 0)
+            return n == p;
+    }
+    if(n < 41 * 41)
+        return n > 1;
+
+    if(n < (std::uint64_t(1) << 32))
+    {
+        montgomery_reduction const r(static_cast<std::uint32_t>(n));
+        for(std::uint32_t a: {2u, 7u, 61u})
+        {
+            if(!intl::is_strong_probable_prime(r, a))
+                return false;
+        }
+        return true;
+    }
+    montgomery_reduction64 const r(n);
+    for(std::uint64_t a: {2ull, 325ull, 9375ull, 28178ull, 450775ull, 9780504ull, 1795265022ull})
+    {
+        if(!intl::is_strong_probable_prime(r, a)) // all bases are below `n`
+            return false;
+    }
+    return true;
+}
+
+namespace intl
+{
+    // The sieve stores one byte per 30 integers, one bit per residue coprime with 30 (the 2-3-5 wheel).
+    QS_INLINE_VAR constexpr std::uint8_t wheel30_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+    QS_INLINE_VAR constexpr std::uint8_t wheel30_gaps[8]     = {6, 4, 2, 4, 2, 4, 6, 2};
+
+    // Bytes per segment, so that the segment stays in the L1 data cache while it is crossed off.
+    QS_INLINE_VAR constexpr std::size_t sieve_segment_bytes = 32 * 1024;
+
+    // 7 * 11 * 13 * 17 bytes: the pattern left by these primes repeats with this period and is copied into each
+    // segment instead of being crossed off.
+    QS_INLINE_VAR constexpr std::size_t presieve_period = 17017;
+
+    // Bit of each residue modulo 30, 8 for the residues sharing a factor with 30.
+    constexpr std::array<std::uint8_t, 30> make_wheel30_bits() noexcept
+    {
+        std::array<std::uint8_t, 30> bits{};
+        for(auto& b: bits)
+            b = 8;
+        for(std::uint8_t i = 0; i < 8; ++i)
+            bits[wheel30_residues[i]] = i;
+        return bits;
+    }
+    QS_INLINE_VAR constexpr std::array<std::uint8_t, 30> wheel30_bits = make_wheel30_bits();
+
+    // Crossing off the multiples `p * q` of a prime `p = 30 a + R[i]`, with `q` walking the wheel from `R[j]`:
+    // the multiple sits at bit `bit(R[i] R[j] mod 30)` and the next one `a * gap[j] + carry` bytes further.
+    struct wheel30_step
+    {
+        std::uint8_t mask;  // clears the bit of the multiple
+        std::uint8_t carry; // `(R[i] R[j] mod 30 + R[i] gap[j]) / 30`
+    };
+
+    constexpr std::array<wheel30_step, 64> make_wheel30_steps() noexcept
+    {
+        std::array<wheel30_step, 64> steps{};
+        for(int i = 0; i < 8; ++i)
+        {
+            for(int j = 0; j < 8; ++j)
+            {
+                int const rem         = wheel30_residues[i] * wheel30_residues[j] % 30;
+                steps[i * 8 + j].mask = static_cast<std::uint8_t>(~(1u << wheel30_bits[rem]));
+                steps[i * 8 + j].carry =
+                    static_cast<std::uint8_t>((rem + wheel30_residues[i] * wheel30_gaps[j]) / 30);
+            }
+        }
+        return steps;
+    }
+    QS_INLINE_VAR constexpr std::array<wheel30_step, 64> wheel30_steps = make_wheel30_steps();
+
+    inline std::vector<std::uint8_t> const& presieve_pattern()
+    {
+        static std::vector<std::uint8_t> const pattern = [] {
+            std::vector<std::uint8_t> bytes(presieve_period, 0xFF);
+            for(std::uint32_t p: {7u, 11u, 13u, 17u})
+            {
+                for(std::uint64_t m = p; m < 30 * presieve_period; m += 2 * p)
+                {
+                    if(wheel30_bits[m % 30] != 8)
+                        bytes[m / 30] &= static_cast<std::uint8_t>(~(1u << wheel30_bits[m % 30]));
+                }
+            }
+            return bytes;
+        }();
+        return pattern;
+    }
+
+    struct sieving_prime
+    {
+        std::uint32_t div30; // p / 30
+        std::uint32_t wheel; // 8 * bit(p mod 30) + bit(q mod 30) of the next multiple p * q
+        std::uint64_t next;  // byte of the next multiple
+    };
+
+    // Sieves `[lo, hi)` one segment at a time, crossing off the multiples of `primes` (all the primes from 19 to
+    // `sqrt(hi)`, the smaller ones are handled by the wheel and the presieve pattern).
+    class sieve_segments
+    {
+    public:
+        sieve_segments(span<std::uint32_t const> primes, std::uint64_t lo, std::uint64_t hi)
+            : lo_(lo),
+              hi_(hi),
+              first_(lo / 30),
+              last_((hi + 29) / 30),
+              begin_(first_)
+        {
+            primes_.reserve(primes.size());
+            for(std::uint32_t p: primes)
+            {
+                // first multiple `p * q >= max(p^2, lo)` with `q` on the wheel, smaller ones have a smaller factor
+                std::uint64_t q = std::max<std::uint64_t>(p, (lo + p - 1) / p);
+                while(wheel30_bits[q % 30] == 8)
+                    ++q;
+                primes_.push_back({p / 30, static_cast<std::uint32_t>(8 * wheel30_bits[p % 30] + wheel30_bits[q % 30]),
+                                   p * q / 30});
+            }
+        }
+
+        // Sieves the next segment, false past the end of the range.
+        bool next()
+        {
+            if(begin_ >= last_)
+                return false;
+            size_ = static_cast<std::size_t>(std::min<std::uint64_t>(sieve_segment_bytes, last_ - begin_));
+            presieve();
+            cross_off();
+            clip();
+            begin_ += size_;
+            return true;
+        }
+
+        // Calls `f(p)` for the primes of the last sieved segment, in increasing order.
+        template<class F>
+        void for_each(F&& f) const
+        {
+            std::uint64_t const base = begin_ - size_;
+            for(std::size_t i = 0; i < size_; i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, bytes_.data() + i, sizeof(word));
+                for(; word != 0; word &= word - 1)
+                {
+                    int const bit = countr_zero(word);
+                    f((base + i + std::size_t(bit / 8)) * 30 + wheel30_residues[bit % 8]);
+                }
+            }
+        }
+
+        // Number of primes in the last sieved segment.
+        std::uint64_t count() const noexcept
+        {
+            std::uint64_t n = 0;
+            for(std::size_t i = 0; i < size_; i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, bytes_.data() + i, sizeof(word));
+                n += static_cast<std::uint64_t>(popcount(word));
+            }
+            return n;
+        }
+
+    private:
+        std::vector<sieving_prime> primes_;
+        std::vector<std::uint8_t>  bytes_ = std::vector<std::uint8_t>(sieve_segment_bytes + 8);
+        std::uint64_t              lo_, hi_;
+        std::uint64_t              first_, last_; // bytes covering the range
+        std::uint64_t              begin_;        // first byte of the segment
+        std::size_t                size_ = 0;
+
+        void presieve() noexcept
+        {
+            auto const& pattern = presieve_pattern();
+            std::size_t offset  = static_cast<std::size_t>(begin_ % presieve_period);
+            for(std::size_t i = 0; i < size_;)
+            {
+                std::size_t const n = std::min(size_ - i, presieve_period - offset);
+                std::memcpy(bytes_.data() + i, pattern.data() + offset, n);
+                i += n;
+                offset = 0;
+            }
+            std::memset(bytes_.data() + size_, 0, 8); // whole words in `for_each` and `count`
+            if(begin_ == 0)
+                bytes_[0] = (bytes_[0] | 0x1E) & 0xFE; // 7, 11, 13 and 17 are prime, 1 is not
+        }
+
+        void cross_off() noexcept
+        {
+            std::uint64_t const end   = begin_ + size_;
+            std::uint8_t* const bytes = bytes_.data();
+            for(auto& sp: primes_)
+            {
+                if(sp.next >= end)
+                    continue;
+                std::size_t  i     = static_cast<std::size_t>(sp.next - begin_);
+                std::uint32_t const pc = sp.wheel & ~7u;
+                std::uint32_t       qc = sp.wheel & 7u;
+                for(; i < size_; qc = (qc + 1) & 7)
+                {
+                    wheel30_step const step = wheel30_steps[pc + qc];
+                    bytes[i] &= step.mask;
+                    i += sp.div30 * wheel30_gaps[qc] + step.carry;
+                }
+                sp.next  = begin_ + i;
+                sp.wheel = pc | qc;
+            }
+        }
+
+        // Clears the bits of the first and last bytes outside `[lo, hi)`.
+        void clip() noexcept
+        {
+            for(int b = 0; b < 8; ++b)
+            {
+                auto const clear = static_cast<std::uint8_t>(~(1u << b));
+                if(begin_ == first_ && first_ * 30 + wheel30_residues[b] < lo_)
+                    bytes_[0] &= clear;
+                if(begin_ + size_ == last_ && (last_ - 1) * 30 + wheel30_residues[b] >= hi_)
+                    bytes_[size_ - 1] &= clear;
+            }
+        }
+    };
+
+    // The primes from 19 to `sqrt(hi - 1)`, sieved by the same segmented sieve.
+    inline std::vector<std::uint32_t> sieving_primes(std::uint64_t hi)
+    {
+        std::vector<std::uint32_t> primes;
+        std::uint64_t const        limit = hi > 1 ? isqrt(hi - 1) + 1 : 0;
+        if(limit > 19)
+        {
+            sieve_segments segments(make_span(sieving_primes(limit)), 19, limit);
+            while(segments.next())
+                segments.for_each([&primes](std::uint64_t p) { primes.push_back(static_cast<std::uint32_t>(p)); });
+        }
+        return primes;
+    }
+
+    // Splits `[lo, hi)` on segment boundaries and runs `f(index, lo, hi)` for each part, part 0 on the calling thread.
+    template<class F>
+    void for_each_part(std::uint64_t lo, std::uint64_t hi, unsigned threads, F&& f)
+    {
+        if(threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        std::uint64_t const first = lo / 30, last = (hi + 29) / 30;
+        std::uint64_t       part  = (last - first + threads - 1) / threads;
+        part                      = (part + sieve_segment_bytes - 1) / sieve_segment_bytes * sieve_segment_bytes;
+
+        std::vector<std::thread> workers;
+        for(unsigned t = 1; t < threads && first + t * part < last; ++t)
+        {
+            std::uint64_t const b = (first + t * part) * 30;
+            std::uint64_t const e = std::min(hi, (first + (t + 1) * part) * 30);
+            workers.emplace_back([&f, t, b, e] { f(t, b, e); });
+        }
+        f(0u, lo, std::min(hi, (first + part) * 30));
+        for(auto& w: workers)
+            w.join();
+    }
+} // namespace intl
+
+/**
+ * Calls `f(p)` for every prime `p` in `[lo, hi)` in increasing order, with a segmented sieve of Eratosthenes:
+ * segments of 32 KiB (the L1 data cache) hold 30 integers per byte on the 2-3-5 wheel, start from a copy of the
+ * pattern of 7, 11, 13 and 17, and are crossed off by the primes up to `sqrt(hi)`. Memory is O(sqrt(hi)).
+ * Requires `hi <= 2^63`.
+ */
+template<class F>
+void for_each_prime(std::uint64_t lo, std::uint64_t hi, F&& f)
+{
+    QS_ASSERT(hi <= (std::uint64_t(1) << 63), "for_each_prime: range past 2^63");
+    for(std::uint64_t p: {2u, 3u, 5u})
+    {
+        if(p >= lo && p < hi)
+            f(p);
+    }
+    if(lo >= hi)
+        return;
+    auto const           primes = intl::sieving_primes(hi);
+    intl::sieve_segments segments(make_span(primes), lo, hi);
+    while(segments.next())
+        segments.for_each(f);
+}
+
+/**
+ * Number of primes in `[lo, hi)`. The range is split among `threads` threads (0 for one per hardware thread),
+ * each sieving its own segments with a private copy of the sieving state.
+ */
+inline std::uint64_t count_primes(std::uint64_t lo, std::uint64_t hi, unsigned threads = 1)
+{
+    QS_ASSERT(hi <= (std::uint64_t(1) << 63), "count_primes: range past 2^63");
+    std::uint64_t count = 0;
+    for(std::uint64_t p: {2u, 3u, 5u})
+        count += p >= lo && p < hi;
+    if(lo >= hi)
+        return count;
+
+    auto const                 primes = intl::sieving_primes(hi);
+    std::vector<std::uint64_t> counts(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads);
+    auto const                 sieve_part = [&](unsigned t, std::uint64_t b, std::uint64_t e) {
+        intl::sieve_segments segments(make_span(primes), b, e);
+        while(segments.next())
+            counts[t] += segments.count();
+    };
+    intl::for_each_part(lo, hi, static_cast<unsigned>(counts.size()), sieve_part);
+    for(std::uint64_t c: counts)
+        count += c;
+    return count;
+}
+
+/**
+ * The primes in `[lo, hi)` in increasing order, as `T` (which must hold `hi - 1`), sieved by `threads` threads
+ * as in `count_primes`.
+ */
+template<class T = std::uint64_t>
+std::vector<T> generate_primes(std::uint64_t lo, std::uint64_t hi, unsigned threads = 1)
+{
+    QS_ASSERT(hi <= (std::uint64_t(1) << 63), "generate_primes: range past 2^63");
+    std::vector<T> result;
+    for(std::uint64_t p: {2u, 3u, 5u})
+    {
+        if(p >= lo && p < hi)
+            result.push_back(static_cast<T>(p));
+    }
+    if(lo >= hi)
+        return result;
+
+    auto const                  primes = intl::sieving_primes(hi);
+    std::vector<std::vector<T>> parts(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads);
+    auto const                  sieve_part = [&](unsigned t, std::uint64_t b, std::uint64_t e) {
+        intl::sieve_segments segments(make_span(primes), b, e);
+        while(segments.next())
+            segments.for_each([&part = parts[t]](std::uint64_t p) { part.push_back(static_cast<T>(p)); });
+    };
+    intl::for_each_part(lo, hi, static_cast<unsigned>(parts.size()), sieve_part);
+    for(auto const& part: parts)
+        result.insert(result.end(), part.begin(), part.end());
+    return result;
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MATH_PRIMES_H
@@ -0,0 +1,687 @@
+#ifndef QS_MDSPAN_H
+#define QS_MDSPAN_H
+
+#include <qs/config.h>
+#include <qs/span.h>
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+
+template<class IndexType, size_t... Extents>
+class extents;
+
+
+namespace intl
+{
+    template<size_t... Extents>
+    QS_INLINE_VAR constexpr size_t count_dynamic_extents = (size_t(0) + ... + size_t(Extents == dynamic_extent));
+
+    // Position of each dynamic extent among the stored ones.
+    template<size_t... Extents>
+    constexpr std::array<size_t, sizeof...(Extents)> dynamic_extent_indices() noexcept
+    {
+        std::array<size_t, sizeof...(Extents)> result{};
+        size_t const                           static_extents[] = {Extents..., 0};
+        for(size_t r = 0, count = 0; r < sizeof...(Extents); ++r)
+        {
+            result[r] = count;
+            count += static_extents[r] == dynamic_extent;
+        }
+        return result;
+    }
+
+    template<size_t>
+    QS_INLINE_VAR constexpr size_t always_dynamic = dynamic_extent;
+
+    template<class IndexType, class Ranks>
+    struct make_dextents;
+    template<class IndexType, size_t... R>
+    struct make_dextents<IndexType, std::index_sequence<R...>>
+    {
+        using type = extents<IndexType, always_dynamic<R>...>;
+    };
+
+    template<class IndexType, class... Indices>
+    using are_convertible_indices = conjunction<std::is_convertible<Indices, IndexType>...>;
+
+    // `0 <= i < extent`, negative indices wrapping around to large unsigned ones.
+    template<class IndexType>
+    QS_ALWAYS_INLINE constexpr bool index_in_range(IndexType i, IndexType extent) noexcept
+    {
+        using U = std::make_unsigned_t<IndexType>;
+        return static_cast<U>(i) < static_cast<U>(extent);
+    }
+
+    // Product of the extents `[first, last)`.
+    template<class Extents>
+    constexpr typename Extents::index_type extents_product(Extents const& e, size_t first, size_t last) noexcept
+    {
+        typename Extents::index_type product = 1;
+        for(size_t r = first; r < last; ++r)
+            product *= e.extent(r);
+        return product;
+    }
+} // namespace intl
+
+
+/**
+ * Shape of a multidimensional index space: `rank()` extents, each fixed at compile time or given at run time
+ * (`dynamic_extent`). Only the dynamic extents are stored, static ones fold into the index arithmetic.
+ *
+ *      qs::extents<int, 3, qs::dynamic_extent> e(5); // 3 x 5
+ */
+template<class IndexType, size_t... Extents>
+class extents
+{
+    static_assert(std::is_integral<IndexType>::value && !std::is_same<IndexType, bool>::value,
+                  "extents<IndexType, ...>: IndexType must be an integer type");
+
+public:
+    using index_type = IndexType;
+    using size_type  = std::make_unsigned_t<index_type>;
+    using rank_type  = size_t;
+
+    static constexpr rank_type rank() noexcept { return sizeof...(Extents); }
+    static constexpr rank_type rank_dynamic() noexcept { return intl::count_dynamic_extents<Extents...>; }
+    static constexpr size_t    static_extent(rank_type r) noexcept { return static_extents_[r]; }
+
+    constexpr index_type extent(rank_type r) const noexcept
+    {
+        return static_extents_[r] == dynamic_extent ? dynamic_[dynamic_indices_[r]]
+                                                    : static_cast<index_type>(static_extents_[r]);
+    }
+
+    constexpr extents() noexcept = default;
+
+    // Either the `rank_dynamic()` dynamic extents, or all the `rank()` extents (static ones must match).
+    template<class... OtherIndices,
+             enable_if_t<sizeof...(OtherIndices) != 0 &&
+                             (sizeof...(OtherIndices) == rank_dynamic() || sizeof...(OtherIndices) == rank()) &&
+                             intl::are_convertible_indices<index_type, OtherIndices...>::value,
+                         int> = 0>
+    constexpr explicit extents(OtherIndices... exts) noexcept(is_nothrow_contract_violation)
+        : extents(std::array<index_type, sizeof...(OtherIndices)>{{static_cast<index_type>(exts)...}})
+    {}
+
+    template<class OtherIndex, size_t N,
+             enable_if_t<(N == rank_dynamic() || N == rank()) &&
+                             std::is_convertible<OtherIndex const&, index_type>::value,
+                         int> = 0>
+    constexpr explicit extents(std::array<OtherIndex, N> const& exts) noexcept(is_nothrow_contract_violation)
+    {
+        for(rank_type r = 0; r < N; ++r)
+        {
+            auto const e = static_cast<index_type>(exts[r]);
+            if constexpr(N == rank_dynamic())
+                dynamic_[r] = e;
+            else if(static_extents_[r] == dynamic_extent)
+                dynamic_[dynamic_indices_[r]] = e;
+            else
+                QS_VERIFY(e == static_cast<index_type>(static_extents_[r]), "extents: static extent mismatch");
+        }
+    }
+
+    // From extents of the same rank, static extents must match.
+    template<class OtherIndex, size_t... OtherExtents,
+             enable_if_t<sizeof...(OtherExtents) == sizeof...(Extents) &&
+                             ((Extents == dynamic_extent || OtherExtents == dynamic_extent ||
+                               Extents == OtherExtents) && ...),
+                         int> = 0>
+    constexpr extents(extents<OtherIndex, OtherExtents...> const& other) noexcept(is_nothrow_contract_violation)
+    {
+        for(rank_type r = 0; r < rank(); ++r)
+        {
+            auto const e = static_cast<index_type>(other.extent(r));
+            if(static_extents_[r] == dynamic_extent)
+                dynamic_[dynamic_indices_[r]] = e;
+            else
+                QS_VERIFY(e == static_cast<index_type>(static_extents_[r]), "extents: static extent mismatch");
+        }
+    }
+
+    friend constexpr bool operator==(extents const& a, extents const& b) noexcept { return a.dynamic_ == b.dynamic_; }
+    friend constexpr bool operator!=(extents const& a, extents const& b) noexcept { return !(a == b); }
+
+private:
+    static constexpr std::array<size_t, sizeof...(Extents)> static_extents_{{Extents...}};
+    static constexpr std::array<size_t, sizeof...(Extents)> dynamic_indices_ =
+        intl::dynamic_extent_indices<Extents...>();
+
+    std::array<index_type, intl::count_dynamic_extents<Extents...>> dynamic_{};
+};
+
+// Extents all given at run time.
+template<class IndexType, size_t Rank>
+using dextents = typename intl::make_dextents<IndexType, std::make_index_sequence<Rank>>::type;
+
+
+// Row-major layout, the last index contiguous (C arrays).
+struct layout_right
+{
+    template<class Extents>
+    class mapping;
+};
+
+// Column-major layout, the first index contiguous (Fortran arrays).
+struct layout_left
+{
+    template<class Extents>
+    class mapping;
+};
+
+// Arbitrary non-negative stride per dimension (sub-matrices, transposed views).
+struct layout_stride
+{
+    template<class Extents>
+    class mapping;
+};
+
+
+template<class Extents>
+class layout_right::mapping
+{
+public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_right;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(extents_type const& e) noexcept
+        : extents_(e)
+    {}
+
+    constexpr extents_type const& extents() const noexcept { return extents_; }
+
+    constexpr index_type required_span_size() const noexcept
+    {
+        return intl::extents_product(extents_, 0, extents_type::rank());
+    }
+
+    // `((i0 * e1 + i1) * e2 + i2) ...`, one multiply-add per index past the first.
+    template<class... Indices, enable_if_t<sizeof...(Indices) == extents_type::rank() &&
+                                               intl::are_convertible_indices<index_type, Indices...>::value,
+                                           int> = 0>
+    QS_ALWAYS_INLINE constexpr index_type operator()(Indices... indices) const noexcept
+    {
+        index_type offset = 0;
+        rank_type  r      = 0;
+        ((offset = offset * extents_.extent(r++) + static_cast<index_type>(indices)), ...);
+        return offset;
+    }
+
+    constexpr index_type stride(rank_type r) const noexcept
+    {
+        return intl::extents_product(extents_, r + 1, extents_type::rank());
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return true; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_exhaustive() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    friend constexpr bool operator==(mapping const& a, mapping const& b) noexcept { return a.extents_ == b.extents_; }
+    friend constexpr bool operator!=(mapping const& a, mapping const& b) noexcept { return !(a == b); }
+
+private:
+    extents_type extents_{};
+};
+
+
+template<class Extents>
+class layout_left::mapping
+{
+public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_left;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(extents_type const& e) noexcept
+        : extents_(e)
+    {}
+
+    constexpr extents_type const& extents() const noexcept { return extents_; }
+
+    constexpr index_type required_span_size() const noexcept
+    {
+        return intl::extents_product(extents_, 0, extents_type::rank());
+    }
+
+    // `i0 + i1 * e0 + i2 * e0 * e1 ...`, the running strides are loop invariants.
+    template<class... Indices, enable_if_t<sizeof...(Indices) == extents_type::rank() &&
+                                               intl::are_convertible_indices<index_type, Indices...>::value,
+                                           int> = 0>
+    QS_ALWAYS_INLINE constexpr index_type operator()(Indices... indices) const noexcept
+    {
+        index_type offset = 0, stride = 1;
+        rank_type  r = 0;
+        ((offset += static_cast<index_type>(indices) * stride, stride *= extents_.extent(r++)), ...);
+        return offset;
+    }
+
+    constexpr index_type stride(rank_type r) const noexcept { return intl::extents_product(extents_, 0, r); }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return true; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_exhaustive() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    friend constexpr bool operator==(mapping const& a, mapping const& b) noexcept { return a.extents_ == b.extents_; }
+    friend constexpr bool operator!=(mapping const& a, mapping const& b) noexcept { return !(a == b); }
+
+private:
+    extents_type extents_{};
+};
+
+
+template<class Extents>
+class layout_stride::mapping
+{
+public:
+    using extents_type = Extents;
+    using index_type   = typename extents_type::index_type;
+    using size_type    = typename extents_type::size_type;
+    using rank_type    = typename extents_type::rank_type;
+    using layout_type  = layout_stride;
+
+    // Row-major strides.
+    constexpr mapping() noexcept
+        : mapping(layout_right::mapping<extents_type>())
+    {}
+
+    // Requires strides mapping distinct indices to distinct offsets.
+    template<class OtherIndex, enable_if_t<std::is_convertible<OtherIndex const&, index_type>::value, int> = 0>
+    constexpr mapping(extents_type const& e, std::array<OtherIndex, extents_type::rank()> const& strides) noexcept
+        : extents_(e)
+    {
+        for(rank_type r = 0; r < extents_type::rank(); ++r)
+            strides_[r] = static_cast<index_type>(strides[r]);
+    }
+
+    // From any other strided mapping of the same extents, e.g. `layout_right` or `layout_left`.
+    template<class Mapping, enable_if_t<std::is_same<typename Mapping::extents_type, extents_type>::value &&
+                                            !std::is_same<Mapping, mapping>::value,
+                                        int> = 0>
+    constexpr mapping(Mapping const& other) noexcept
+        : extents_(other.extents())
+    {
+        for(rank_type r = 0; r < extents_type::rank(); ++r)
+            strides_[r] = other.stride(r);
+    }
+
+    constexpr extents_type const&                               extents() const noexcept { return extents_; }
+    constexpr std::array<index_type, extents_type::rank()> const& strides() const noexcept { return strides_; }
+
+    // One past the largest offset, 0 for an empty index space.
+    constexpr index_type required_span_size() const noexcept
+    {
+        index_type size = 1;
+        for(rank_type r = 0; r < extents_type::rank(); ++r)
+        {
+            if(extents_.extent(r) == 0)
+                return 0;
+            size += (extents_.extent(r) - 1) * strides_[r];
+        }
+        return size;
+    }
+
+    // `i0 * s0 + i1 * s1 + ...`
+    template<class... Indices, enable_if_t<sizeof...(Indices) == extents_type::rank() &&
+                                               intl::are_convertible_indices<index_type, Indices...>::value,
+                                           int> = 0>
+    QS_ALWAYS_INLINE constexpr index_type operator()(Indices... indices) const noexcept
+    {
+        index_type offset = 0;
+        rank_type  r      = 0;
+        ((offset += static_cast<index_type>(indices) * strides_[r++]), ...);
+        return offset;
+    }
+
+    constexpr index_type stride(rank_type r) const noexcept { return strides_[r]; }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return false; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+    static constexpr bool is_unique() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    // Unique offsets all below the number of indices leave no gap.
+    constexpr bool is_exhaustive() const noexcept
+    {
+        return required_span_size() == intl::extents_product(extents_, 0, extents_type::rank());
+    }
+
+    friend constexpr bool operator==(mapping const& a, mapping const& b) noexcept
+    {
+        return a.extents_ == b.extents_ && a.strides_ == b.strides_;
+    }
+    friend constexpr bool operator!=(mapping const& a, mapping const& b) noexcept { return !(a == b); }
+
+private:
+    extents_type                                   extents_{};
+    std::array<index_type, extents_type::rank()> strides_{};
+};
+
+
+/**
+ * Non-owning multidimensional view over a contiguous buffer: `operator()(i, j, ...)` maps the indices through the
+ * layout to an offset from `data_handle()`. With `layout_right` or `layout_left` an access is one multiply-add per
+ * index past the first, static extents folding into immediates; the view is a pointer plus the dynamic extents.
+ *
+ * Usage:
+ *      std::vector<float> buffer(rows * cols);
+ *      qs::mdspan m(buffer.data(), rows, cols); // mdspan<float, dextents<size_t, 2>>
+ *      m(i, j) = 1;
+ *
+ *      qs::mdspan<float, qs::extents<int, 4, 4>, qs::layout_left> fixed(buffer.data());
+ */
+template<class T, class Extents, class LayoutPolicy = layout_right>
+class mdspan
+{
+public:
+    using extents_type     = Extents;
+    using layout_type      = LayoutPolicy;
+    using mapping_type     = typename layout_type::template mapping<extents_type>;
+    using element_type     = T;
+    using value_type       = remove_cv_t<T>;
+    using index_type       = typename extents_type::index_type;
+    using size_type        = typename extents_type::size_type;
+    using rank_type        = typename extents_type::rank_type;
+    using data_handle_type = element_type*;
+    using reference        = element_type&;
+
+    static constexpr rank_type rank() noexcept { return extents_type::rank(); }
+    static constexpr rank_type rank_dynamic() noexcept { return extents_type::rank_dynamic(); }
+    static constexpr size_t    static_extent(rank_type r) noexcept { return extents_type::static_extent(r); }
+
+    constexpr index_type extent(rank_type r) const noexcept { return mapping_.extents().extent(r); }
+
+    constexpr mdspan() noexcept = default;
+
+    template<class... OtherIndices,
+             enable_if_t<(sizeof...(OtherIndices) == rank_dynamic() || sizeof...(OtherIndices) == rank()) &&
+                             intl::are_convertible_indices<index_type, OtherIndices...>::value,
+                         int> = 0>
+    constexpr explicit mdspan(data_handle_type data, OtherIndices... exts) noexcept(is_nothrow_contract_violation)
+        : data_(data),
+          mapping_(extents_type(static_cast<index_type>(exts)...))
+    {}
+
+    template<class OtherIndex, size_t N,
+             enable_if_t<(N == rank_dynamic() || N == rank()) &&
+                             std::is_convertible<OtherIndex const&, index_type>::value,
+                         int> = 0>
+    constexpr mdspan(data_handle_type                  data,
+                     std::array<OtherIndex, N> const& exts) noexcept(is_nothrow_contract_violation)
+        : data_(data),
+          mapping_(extents_type(exts))
+    {}
+
+    constexpr mdspan(data_handle_type data, extents_type const& e) noexcept
+        : data_(data),
+          mapping_(e)
+    {}
+
+    constexpr mdspan(data_handle_type data, mapping_type const& m) noexcept
+        : data_(data),
+          mapping_(m)
+    {}
+
+    // Adding const to the elements.
+    template<class U, enable_if_t<intl::is_span_convertible<U, element_type>::value, int> = 0>
+    constexpr mdspan(mdspan<U, extents_type, layout_type> const& other) noexcept
+        : data_(other.data_handle()),
+          mapping_(other.mapping())
+    {}
+
+    template<class... Indices, enable_if_t<sizeof...(Indices) == rank() &&
+                                               intl::are_convertible_indices<index_type, Indices...>::value,
+                                           int> = 0>
+    QS_ALWAYS_INLINE constexpr reference operator()(Indices... indices) const noexcept(is_nothrow_contract_violation)
+    {
+        QS_ASSERT(in_bounds(static_cast<index_type>(indices)...), "mdspan::operator(): index out of range");
+        return data_[mapping_(static_cast<index_type>(indices)...)];
+    }
+
+    // Number of elements, the product of the extents.
+    constexpr size_type size() const noexcept
+    {
+        return static_cast<size_type>(intl::extents_product(mapping_.extents(), 0, rank()));
+    }
+    constexpr bool empty() const noexcept { return size() == 0; }
+
+    constexpr data_handle_type    data_handle() const noexcept { return data_; }
+    constexpr mapping_type const& mapping() const noexcept { return mapping_; }
+    constexpr extents_type const& extents() const noexcept { return mapping_.extents(); }
+    constexpr index_type          stride(rank_type r) const noexcept { return mapping_.stride(r); }
+
+    static constexpr bool is_always_unique() noexcept { return mapping_type::is_always_unique(); }
+    static constexpr bool is_always_exhaustive() noexcept { return mapping_type::is_always_exhaustive(); }
+    static constexpr bool is_always_strided() noexcept { return mapping_type::is_always_strided(); }
+    constexpr bool        is_unique() const noexcept { return mapping_.is_unique(); }
+    constexpr bool        is_exhaustive() const noexcept { return mapping_.is_exhaustive(); }
+    constexpr bool        is_strided() const noexcept { return mapping_.is_strided(); }
+
+private:
+    data_handle_type data_ = nullptr;
+    mapping_type     mapping_{};
+
+    template<class... Indices>
+    constexpr bool in_bounds(Indices... indices) const noexcept
+    {
+        rank_type r = 0;
+        return (true && ... && intl::index_in_range(indices, extent(r++)));
+    }
+};
+
+template<class T, class... Integrals,
+         enable_if_t<sizeof...(Integrals) != 0 && conjunction<std::is_convertible<Integrals, size_t>...>::value,
+                     int> = 0>
+explicit mdspan(T*, Integrals...) -> mdspan<T, dextents<size_t, sizeof...(Integrals)>>;
+
+template<class T, class IndexType, size_t... Extents>
+mdspan(T*, extents<IndexType, Extents...> const&) -> mdspan<T, extents<IndexType, Extents...>>;
+
+template<class T, class Mapping>
+mdspan(T*, Mapping const&) -> mdspan<T, typename Mapping::extents_type, typename Mapping::layout_type>;
+
+
+/**
+ * Non-owning view of `size()` elements spaced `stride()` elements apart: a column of a row-major matrix, every
+ * other element of an array, or (negative stride) an array backwards. Random-access iterable, element `i` is
+ * `data()[i * stride()]`.
+ *
+ *      qs::strided_span<float> column(matrix + j, rows, cols); // column j of a rows x cols row-major matrix
+ */
+template<class T>
+class strided_span
+{
+public:
+    using element_type    = T;
+    using value_type      = remove_cv_t<T>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer         = element_type*;
+    using reference       = element_type&;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = remove_cv_t<T>;
+        using difference_type   = ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        constexpr iterator() noexcept = default;
+
+        constexpr reference operator*() const noexcept { return data_[index_ * stride_]; }
+        constexpr pointer   operator->() const noexcept { return data_ + index_ * stride_; }
+        constexpr reference operator[](difference_type n) const noexcept { return data_[(index_ + n) * stride_]; }
+
+        constexpr iterator& operator++() noexcept { return ++index_, *this; }
+        constexpr iterator& operator--() noexcept { return --index_, *this; }
+        constexpr iterator  operator++(int) noexcept { return iterator(data_, stride_, index_++); }
+        constexpr iterator  operator--(int) noexcept { return iterator(data_, stride_, index_--); }
+        constexpr iterator& operator+=(difference_type n) noexcept { return index_ += n, *this; }
+        constexpr iterator& operator-=(difference_type n) noexcept { return index_ -= n, *this; }
+
+        friend constexpr iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+        friend constexpr iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+        friend constexpr iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+        friend constexpr difference_type operator-(iterator const& a, iterator const& b) noexcept
+        {
+            return a.index_ - b.index_;
+        }
+
+        friend constexpr bool operator==(iterator const& a, iterator const& b) noexcept { return a.index_ == b.index_; }
+        friend constexpr bool operator!=(iterator const& a, iterator const& b) noexcept { return a.index_ != b.index_; }
+        friend constexpr bool operator<(iterator const& a, iterator const& b) noexcept { return a.index_ < b.index_; }
+        friend constexpr bool operator>(iterator const& a, iterator const& b) noexcept { return a.index_ > b.index_; }
+        friend constexpr bool operator<=(iterator const& a, iterator const& b) noexcept { return a.index_ <= b.index_; }
+        friend constexpr bool operator>=(iterator const& a, iterator const& b) noexcept { return a.index_ >= b.index_; }
+
+    private:
+        friend class strided_span;
+
+        // Offsets are computed from the first element so that no pointer ever leaves the viewed elements.
+        constexpr iterator(pointer data, difference_type stride, difference_type index) noexcept
+            : data_(data),
+              stride_(stride),
+              index_(index)
+        {}
+
+        pointer         data_   = nullptr;
+        difference_type stride_ = 0;
+        difference_type index_  = 0;
+    };
+    using const_iterator   = iterator; // the view is shallow-const, like `span`
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    constexpr strided_span() noexcept = default;
+    constexpr strided_span(pointer data, size_type size, difference_type stride = 1) noexcept
+        : data_(data),
+          size_(size),
+          stride_(stride)
+    {}
+
+    template<class U, size_t Extent, enable_if_t<intl::is_span_convertible<U, element_type>::value, int> = 0>
+    constexpr strided_span(span<U, Extent> s) noexcept
+        : data_(s.data()),
+          size_(s.size()),
+          stride_(1)
+    {}
+
+    template<class U, enable_if_t<intl::is_span_convertible<U, element_type>::value, int> = 0>
+    constexpr strided_span(strided_span<U> const& other) noexcept
+        : data_(other.data()),
+          size_(other.size()),
+          stride_(other.stride())
+    {}
+
+    constexpr size_type       size() const noexcept { return size_; }
+    constexpr difference_type stride() const noexcept { return stride_; }
+    constexpr bool            empty() const noexcept { return size_ == 0; }
+    constexpr pointer         data() const noexcept { return data_; }
+
+    constexpr reference operator[](size_type index) const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(index < size_, "strided_span::operator[](index): index out of range"),
+               data_[static_cast<difference_type>(index) * stride_];
+    }
+    constexpr reference front() const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(!empty(), "strided_span::front() called on empty span"), data_[0];
+    }
+    constexpr reference back() const noexcept(is_nothrow_contract_violation)
+    {
+        return QS_VERIFY(!empty(), "strided_span::back() called on empty span"),
+               data_[static_cast<difference_type>(size_ - 1) * stride_];
+    }
+
+    constexpr iterator         begin() const noexcept { return iterator(data_, stride_, 0); }
+    constexpr iterator         end() const noexcept
+    {
+        return iterator(data_, stride_, static_cast<difference_type>(size_));
+    }
+    constexpr reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    constexpr reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+    constexpr strided_span subspan(size_type offset, size_type count = dynamic_extent) const
+        noexcept(is_nothrow_contract_violation)
+    {
+        QS_VERIFY(offset <= size_, "strided_span::subspan(offset, count): offset out of range");
+        QS_VERIFY(count == dynamic_extent || count <= size_ - offset,
+                  "strided_span::subspan(offset, count): count out of range");
+        return strided_span(data_ + static_cast<difference_type>(offset) * stride_,
+                            count == dynamic_extent ? size_ - offset : count, stride_);
+    }
+
+    // Every `step`-th element, starting with the first.
+    constexpr strided_span every(size_type step) const noexcept(is_nothrow_contract_violation)
+    {
+        QS_VERIFY(step != 0, "strided_span::every(step): zero step");
+        // `ceil(size() / step)` without the overflow of `size() + step - 1`; a single element keeps the stride,
+        // whose product with a huge step would overflow
+        size_type const count = size_ / step + (size_ % step != 0 ? 1 : 0);
+        return strided_span(data_, count, count > 1 ? stride_ * static_cast<difference_type>(step) : stride_);
+    }
+
+    // The same elements, last to first.
+    constexpr strided_span reversed() const noexcept
+    {
+        return empty() ? *this
+                       : strided_span(data_ + static_cast<difference_type>(size_ - 1) * stride_, size_, -stride_);
+    }
+
+private:
+    pointer         data_   = nullptr;
+    size_type       size_   = 0;
+    difference_type stride_ = 0;
+};
+
+template<class U, size_t Extent>
+strided_span(span<U, Extent>) -> strided_span<U>;
+
+
+// Row `i` of a matrix view, contiguous with `layout_right`.
+template<class T, class Extents, class LayoutPolicy>
+constexpr strided_span<T> row(mdspan<T, Extents, LayoutPolicy> const& m,
+                              typename Extents::index_type     i) noexcept(is_nothrow_contract_violation)
+{
+    static_assert(Extents::rank() == 2, "row(mdspan, i): rank-2 mdspan expected");
+    QS_VERIFY(intl::index_in_range(i, m.extent(0)), "row(mdspan, i): index out of range");
+    return strided_span<T>(m.data_handle() + m.mapping()(i, 0), static_cast<size_t>(m.extent(1)),
+                           static_cast<ptrdiff_t>(m.stride(1)));
+}
+
+// Column `j` of a matrix view, contiguous with `layout_left`.
+template<class T, class Extents, class LayoutPolicy>
+constexpr strided_span<T> column(mdspan<T, Extents, LayoutPolicy> const& m,
+                                 typename Extents::index_type     j) noexcept(is_nothrow_contract_violation)
+{
+    static_assert(Extents::rank() == 2, "column(mdspan, j): rank-2 mdspan expected");
+    QS_VERIFY(intl::index_in_range(j, m.extent(1)), "column(mdspan, j): index out of range");
+    return strided_span<T>(m.data_handle() + m.mapping()(0, j), static_cast<size_t>(m.extent(0)),
+                           static_cast<ptrdiff_t>(m.stride(0)));
+}
+
+
+QS_NAMESPACE_END
+
+#endif // QS_MDSPAN_H
@@ -3,6 +3,9 @@
 
 #include <qs/config.h>
 
+#include <cstdint>
+#include <memory>
+
 QS_NAMESPACE_BEGIN
 
 
@@ -27,6 +30,27 @@ QS_INLINE QS_CONSTEXPR17 T* launder(T* p) noexcept
 #endif
 }
 
+// Whether `p` is a multiple of `alignment` bytes, a power of two.
+QS_INLINE bool is_aligned(void const volatile* p, size_t alignment) noexcept
+{
+    return (reinterpret_cast<std::uintptr_t>(p) & (alignment - 1)) == 0;
+}
+
+// `p`, with its alignment to `N` bytes made known to the optimizer: vectorized loops over it drop their peeling
+// prologue and use aligned accesses. Undefined behavior when `p` is not aligned (check with `is_aligned`).
+template<size_t N, class T>
+QS_NODISCARD QS_ALWAYS_INLINE QS_CONSTEXPR20 T* assume_aligned(T* p) noexcept
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "assume_aligned<N>(p): N must be a power of two");
+#if defined(__cpp_lib_assume_aligned)
+    return std::assume_aligned<N>(p);
+#elif QS_HAS_BUILTIN(__builtin_assume_aligned) || QS_GCC_VERSION >= 407
+    return static_cast<T*>(__builtin_assume_aligned(p, N));
+#else
+    return p;
+#endif
+}
+
 // Note: maybe replace decltype check with meta::test::placement_new<T, Args...> in the future
 template<class T, class... Args, class = decltype(::new(std::declval<void*>()) T(std::declval<Args>()...))>
 QS_CONSTEXPR20 T* construct_at(T* location, Args&&... args)
@@ -47,7 +71,7 @@ template<class ForwardIterator>
 QS_CONSTEXPR20 ForwardIterator destroy(ForwardIterator first, ForwardIterator last) noexcept
 {
     while(first != last)
-        destroy_at(std::addressof(*(first++)));
+        qs::destroy_at(std::addressof(*(first++)));
     return first;
 }
 
@@ -55,7 +79,7 @@ template<class BidirectionalIterator>
 QS_CONSTEXPR20 BidirectionalIterator reverse_destroy(BidirectionalIterator first, BidirectionalIterator last) noexcept
 {
     while(last != first)
-        destroy_at(std::addressof(*(--last)));
+        qs::destroy_at(std::addressof(*(--last)));
     return last;
 }
 
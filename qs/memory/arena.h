@@ -0,0 +1,320 @@
+#ifndef QS_MEMORY_ARENA_H
+#define QS_MEMORY_ARENA_H
+
+#include <qs/config.h>
+#include <qs/memory.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+/**
+ * Monotonic (bump) allocator over a chain of blocks. Allocation is a pointer bump, deallocation is a no-op
+ * except for the most recent allocation which is rolled back, and all memory is reclaimed at once with
+ * `reset()`. Blocks are kept across `reset()`/`rewind()` and reused by later cycles, so a steady-state
+ * request loop stops touching the system allocator after the first few iterations.
+ *
+ * The first block can be a caller-provided buffer (see `inline_arena<N>` for one living on the stack),
+ * further blocks grow geometrically from `block_size`.
+ *
+ * Usage:
+ *      qs::inline_arena<4096> arena;
+ *      for(auto& request: requests)
+ *      {
+ *          qs::arena::scoped_rewind scope(arena);
+ *          std::vector<int, qs::arena_allocator<int>> v{qs::arena_allocator<int>(arena)};
+ *          ...
+ *      }
+ */
+class arena
+{
+    struct block_header
+    {
+        block_header* next;
+        char*         end;
+        bool          owned;
+    };
+
+public:
+    static constexpr std::size_t default_block_size = 64 * 1024;
+    static constexpr std::size_t max_block_size     = std::size_t(64) << 20;
+
+    // Position in the arena, everything allocated after it is released by `rewind(marker)`.
+    struct marker
+    {
+        block_header* block;
+        char*         ptr;
+    };
+
+    class scoped_rewind;
+
+    explicit arena(std::size_t block_size = default_block_size) noexcept
+        : next_block_size_(std::max<std::size_t>(block_size, 2 * sizeof(block_header)))
+    {}
+
+    // Uses `buffer` as the first block, it must outlive the arena (or the next `release()`).
+    arena(void* buffer, std::size_t size, std::size_t block_size = default_block_size) noexcept
+        : arena(block_size)
+    {
+        if(buffer != nullptr && size > sizeof(block_header) + alignof(block_header))
+        {
+            void*       p     = buffer;
+            std::size_t space = size;
+            if(std::align(alignof(block_header), sizeof(block_header), p, space) != nullptr)
+            {
+                head_ = ::new(p) block_header{nullptr, static_cast<char*>(p) + space, false};
+                enter(head_);
+            }
+        }
+    }
+
+    arena(arena const&)            = delete;
+    arena& operator=(arena const&) = delete;
+
+    ~arena() { release(); }
+
+    QS_NODISCARD void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t))
+    {
+        QS_ASSERT(align != 0 && (align & (align - 1)) == 0, "arena::allocate: alignment must be a power of two");
+        char* p = align_up(ptr_, align);
+        // the padding alone can overshoot the block, `end_ - p` would then wrap
+        if(QS_UNLIKELY(p == nullptr || p > end_ || bytes > static_cast<std::size_t>(end_ - p)))
+            p = allocate_slow(bytes, align);
+        last_ = p;
+        ptr_  = p + bytes;
+        return p;
+    }
+
+    // Only the most recent allocation is given back, anything else waits for `reset()`/`rewind()`.
+    void deallocate(void* p, std::size_t bytes) noexcept
+    {
+        if(p != nullptr && p == last_ && static_cast<char*>(p) + bytes == ptr_)
+        {
+            ptr_  = static_cast<char*>(p);
+            last_ = nullptr;
+        }
+    }
+
+    template<class T, class... Args>
+    QS_NODISCARD T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena::create: the arena never runs destructors, T must be trivially destructible");
+        return qs::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+    }
+
+    QS_NODISCARD marker mark() const noexcept { return marker{current_, ptr_}; }
+
+    // O(1) rollback to a marker taken earlier from this arena, blocks are kept for reuse.
+    void rewind(marker m) noexcept
+    {
+        if(m.block == nullptr)
+            return reset();
+        current_ = m.block;
+        ptr_     = m.ptr;
+        end_     = m.block->end;
+        last_    = nullptr;
+    }
+
+    // O(1) release of every allocation, blocks are kept for reuse.
+    void reset() noexcept
+    {
+        if(head_ != nullptr)
+            enter(head_);
+        last_ = nullptr;
+    }
+
+    // Returns every owned block to the system.
+    void release() noexcept
+    {
+        block_header* blk = head_;
+        head_             = nullptr;
+        while(blk != nullptr)
+        {
+            block_header* next = blk->next;
+            if(blk->owned)
+                ::operator delete(static_cast<void*>(blk));
+            else
+                head_ = blk; // the caller-provided buffer is always the head
+            blk = next;
+        }
+        if(head_ != nullptr)
+        {
+            head_->next = nullptr;
+            enter(head_);
+        }
+        else
+        {
+            current_ = nullptr;
+            ptr_ = end_ = nullptr;
+        }
+        last_ = nullptr;
+    }
+
+    // Bytes still available in the current block.
+    std::size_t available() const noexcept { return static_cast<std::size_t>(end_ - ptr_); }
+
+    std::size_t block_count() const noexcept
+    {
+        std::size_t n = 0;
+        for(block_header* blk = head_; blk != nullptr; blk = blk->next)
+            ++n;
+        return n;
+    }
+
+private:
+    block_header* head_            = nullptr;
+    block_header* current_         = nullptr;
+    char*         ptr_             = nullptr;
+    char*         end_             = nullptr;
+    char*         last_            = nullptr;
+    std::size_t   next_block_size_;
+
+    static char* align_up(char* p, std::size_t align) noexcept
+    {
+        auto const addr = reinterpret_cast<std::uintptr_t>(p);
+        return p == nullptr ? nullptr : p + ((align - (addr & (align - 1))) & (align - 1));
+    }
+
+    static char* data_of(block_header* blk) noexcept { return reinterpret_cast<char*>(blk + 1); }
+
+    void enter(block_header* blk) noexcept
+    {
+        current_ = blk;
+        ptr_     = data_of(blk);
+        end_     = blk->end;
+    }
+
+    QS_NOINLINE char* allocate_slow(std::size_t bytes, std::size_t align)
+    {
+        // no block could hold it, and `needed` below would wrap
+        if(bytes > SIZE_MAX - sizeof(block_header) - align)
+            throw std::bad_alloc();
+
+        // reuse the following blocks kept from previous cycles when the request fits
+        while(current_ != nullptr && current_->next != nullptr)
+        {
+            enter(current_->next);
+            char* p = align_up(ptr_, align);
+            if(p <= end_ && bytes <= static_cast<std::size_t>(end_ - p))
+                return p;
+        }
+
+        std::size_t const needed = sizeof(block_header) + bytes + align;
+        std::size_t const size   = std::max(next_block_size_, needed);
+        next_block_size_         = std::min(2 * next_block_size_, max_block_size);
+
+        void* mem = ::operator new(size);
+        auto* blk = ::new(mem) block_header{nullptr, static_cast<char*>(mem) + size, true};
+        if(current_ == nullptr)
+            head_ = blk;
+        else
+            current_->next = blk;
+        enter(blk);
+        return align_up(ptr_, align);
+    }
+};
+
+// RAII rewind marker: everything allocated during the scope is released on exit.
+class arena::scoped_rewind
+{
+public:
+    explicit scoped_rewind(arena& a) noexcept
+        : arena_(a),
+          marker_(a.mark())
+    {}
+
+    scoped_rewind(scoped_rewind const&)            = delete;
+    scoped_rewind& operator=(scoped_rewind const&) = delete;
+
+    ~scoped_rewind() { arena_.rewind(marker_); }
+
+private:
+    arena& arena_;
+    marker marker_;
+};
+
+
+namespace intl
+{
+    template<std::size_t N>
+    struct inline_arena_storage
+    {
+        alignas(std::max_align_t) byte buffer_[N];
+    };
+} // namespace intl
+
+// Arena whose first block is an `N`-byte buffer embedded in the object (e.g. on the stack).
+template<std::size_t N>
+class inline_arena : private intl::inline_arena_storage<N>, public arena
+{
+public:
+    explicit inline_arena(std::size_t block_size = default_block_size) noexcept
+        : arena(this->buffer_, N, block_size)
+    {}
+};
+
+
+// Standard allocator adaptor over an `arena`, e.g. `FenwickTree<int, arena_allocator<int>>`.
+template<class T>
+class arena_allocator
+{
+public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    template<class U>
+    struct rebind
+    {
+        using other = arena_allocator<U>;
+    };
+
+    arena_allocator(arena& a) noexcept
+        : arena_(&a)
+    {}
+
+    template<class U>
+    arena_allocator(arena_allocator<U> const& other) noexcept
+        : arena_(other.resource())
+    {}
+
+    QS_NODISCARD T* allocate(std::size_t n)
+    {
+        if(n > static_cast<std::size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept { arena_->deallocate(p, n * sizeof(T)); }
+
+    arena* resource() const noexcept { return arena_; }
+
+private:
+    arena* arena_;
+};
+
+template<class T, class U>
+bool operator==(arena_allocator<T> const& lhs, arena_allocator<U> const& rhs) noexcept
+{
+    return lhs.resource() == rhs.resource();
+}
+
+template<class T, class U>
+bool operator!=(arena_allocator<T> const& lhs, arena_allocator<U> const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MEMORY_ARENA_H
@@ -0,0 +1,302 @@
+#ifndef QS_MEMORY_HUGE_PAGE_ALLOCATOR_H
+#define QS_MEMORY_HUGE_PAGE_ALLOCATOR_H
+
+#include <qs/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// Local to this header, undefined at its end.
+#ifdef QS_INTL_HAS_LINUX_MMAP
+#error "QS_INTL_HAS_LINUX_MMAP is internal to qs/memory/huge_page_allocator.h and must not be defined elsewhere"
+#endif
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define QS_INTL_HAS_LINUX_MMAP 1
+#else
+#define QS_INTL_HAS_LINUX_MMAP 0
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+enum class page_size
+{
+    standard = 0, // 4K (or whatever the base page size is)
+    huge_2m  = 1,
+    huge_1g  = 2
+};
+
+enum class numa_policy
+{
+    none       = 0, // first-touch default of the OS
+    bind       = 1, // allocate strictly on the nodes of `node_mask`
+    interleave = 2, // round-robin the pages over the nodes of `node_mask`
+    preferred  = 3  // prefer the first node of `node_mask`, fall back to others under pressure
+};
+
+struct huge_page_options
+{
+    page_size     pages     = page_size::huge_2m;
+    numa_policy   policy    = numa_policy::none;
+    std::uint64_t node_mask = 0; // bit i selects NUMA node i
+
+    // Requests below this size are served by `::operator new`, a dedicated mapping would waste a huge page.
+    std::size_t min_mapping_bytes = std::size_t(1) << 20;
+
+    friend bool operator==(huge_page_options const& l, huge_page_options const& r) noexcept
+    {
+        return l.pages == r.pages && l.policy == r.policy && l.node_mask == r.node_mask &&
+               l.min_mapping_bytes == r.min_mapping_bytes;
+    }
+    friend bool operator!=(huge_page_options const& l, huge_page_options const& r) noexcept { return !(l == r); }
+};
+
+// Result of `map_pages`, `pages` is the page size actually obtained after fallbacks.
+struct page_mapping
+{
+    void*       ptr          = nullptr;
+    std::size_t size         = 0;
+    page_size   pages        = page_size::standard;
+    bool        numa_applied = false;
+};
+
+
+namespace intl
+{
+    QS_INLINE_VAR constexpr std::size_t huge_2m_bytes     = std::size_t(2) << 20;
+    QS_INLINE_VAR constexpr std::size_t huge_1g_bytes     = std::size_t(1) << 30;
+    QS_INLINE_VAR constexpr std::size_t max_mapping_bytes = SIZE_MAX - huge_1g_bytes;
+
+    QS_ALWAYS_INLINE constexpr std::size_t round_up_pow2(std::size_t n, std::size_t align) noexcept
+    {
+        return (n + align - 1) & ~(align - 1);
+    }
+
+    // Length of a mapping of `pages` pages. Every fallback of a huge page request keeps the 2M granularity, so
+    // the length of a mapping only depends on whether it got 1G hugetlb pages. Callers keep `bytes` at most
+    // `max_mapping_bytes`, the rounding would wrap past it.
+    QS_INLINE std::size_t mapping_size(std::size_t bytes, page_size pages) noexcept
+    {
+        switch(pages)
+        {
+            case page_size::huge_1g: return round_up_pow2(bytes, huge_1g_bytes);
+            case page_size::huge_2m: return round_up_pow2(bytes, huge_2m_bytes);
+            case page_size::standard: break;
+        }
+        return round_up_pow2(bytes, 4096);
+    }
+
+#if QS_INTL_HAS_LINUX_MMAP
+    // Explicit hugetlbfs pages, only succeeds when the administrator reserved pages (vm.nr_hugepages).
+    QS_INLINE void* mmap_hugetlb(std::size_t bytes, unsigned log2_page) noexcept
+    {
+        int const flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | static_cast<int>(log2_page << MAP_HUGE_SHIFT);
+        void*     p     = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    // Regular anonymous mapping aligned to `align`, so that transparent huge pages can back it entirely.
+    QS_INLINE void* mmap_aligned(std::size_t bytes, std::size_t align) noexcept
+    {
+        if(bytes > SIZE_MAX - align)
+            return nullptr;
+        std::size_t const padded = bytes + align;
+        void*             raw    = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(raw == MAP_FAILED)
+            return nullptr;
+
+        auto const base    = reinterpret_cast<std::uintptr_t>(raw);
+        auto const aligned = round_up_pow2(base, align);
+        if(aligned > base)
+            ::munmap(raw, aligned - base);
+        std::size_t const tail = (base + padded) - (aligned + bytes);
+        if(tail > 0)
+            ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    QS_INLINE bool apply_numa_policy(void* p, std::size_t bytes, huge_page_options const& opts) noexcept
+    {
+        if(opts.policy == numa_policy::none || opts.node_mask == 0)
+            return false;
+
+        int mode = MPOL_DEFAULT;
+        switch(opts.policy)
+        {
+            case numa_policy::bind: mode = MPOL_BIND; break;
+            case numa_policy::interleave: mode = MPOL_INTERLEAVE; break;
+            case numa_policy::preferred: mode = MPOL_PREFERRED; break;
+            case numa_policy::none: break;
+        }
+        unsigned long const mask = static_cast<unsigned long>(opts.node_mask);
+        // maxnode is the number of bits in the mask, + 1 for the kernel's off-by-one convention
+        return ::syscall(SYS_mbind, p, bytes, mode, &mask, sizeof(mask) * 8 + 1, 0) == 0;
+    }
+
+    // Unmaps what `map_pages(bytes, {requested})` returned when the page size obtained was not kept. Only a 1G
+    // hugetlb mapping is longer than the 2M-granular fallbacks, and the kernel refuses to split a hugetlb
+    // mapping off a page boundary (EINVAL), so a failed unmap at the shorter length identifies it.
+    QS_INLINE void unmap_allocation(void* p, std::size_t bytes, page_size requested) noexcept
+    {
+        page_size const fallback = requested == page_size::huge_1g ? page_size::huge_2m : requested;
+        if(::munmap(p, mapping_size(bytes, fallback)) != 0 && requested == page_size::huge_1g)
+            ::munmap(p, mapping_size(bytes, page_size::huge_1g));
+    }
+#endif
+} // namespace intl
+
+
+/**
+ * Maps `bytes` of zero-filled memory backed by the requested page size, degrading gracefully:
+ * 1G hugetlb -> 2M hugetlb -> 2M-aligned mapping with `madvise(MADV_HUGEPAGE)` (transparent huge pages)
+ * -> standard pages. The length is rounded to the page size obtained, except that the fallbacks of a huge page
+ * request keep 2M granularity. A `page_size::standard` request is marked `MADV_NOHUGEPAGE`, so it stays on
+ * base pages even when transparent huge pages are enabled system-wide. The NUMA policy is applied with `mbind`
+ * before the memory is touched, so the first fault already lands on the requested node(s); failure to apply it
+ * is reported, not fatal.
+ * Returns a null mapping on failure, including sizes too large to round up to the page size.
+ * Non-Linux targets fall back to aligned `::operator new`.
+ */
+QS_INLINE page_mapping map_pages(std::size_t bytes, huge_page_options const& opts = {}) noexcept
+{
+    page_mapping m;
+    if(bytes == 0 || bytes > intl::max_mapping_bytes)
+        return m;
+
+    std::size_t const size =
+        intl::mapping_size(bytes, opts.pages == page_size::standard ? page_size::standard : page_size::huge_2m);
+
+#if QS_INTL_HAS_LINUX_MMAP
+    if(opts.pages == page_size::huge_1g)
+    {
+        std::size_t const size_1g = intl::mapping_size(bytes, page_size::huge_1g);
+        if(void* p = intl::mmap_hugetlb(size_1g, 30))
+            m = page_mapping{p, size_1g, page_size::huge_1g, false};
+    }
+    if(m.ptr == nullptr && opts.pages != page_size::standard)
+    {
+        if(void* p = intl::mmap_hugetlb(size, 21))
+            m = page_mapping{p, size, page_size::huge_2m, false};
+        else if(void* q = intl::mmap_aligned(size, intl::huge_2m_bytes))
+        {
+            bool const thp = ::madvise(q, size, MADV_HUGEPAGE) == 0;
+            m              = page_mapping{q, size, thp ? page_size::huge_2m : page_size::standard, false};
+        }
+    }
+    if(m.ptr == nullptr)
+    {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED)
+            return page_mapping{};
+        if(opts.pages == page_size::standard)
+            (void)::madvise(p, size, MADV_NOHUGEPAGE);
+        m = page_mapping{p, size, page_size::standard, false};
+    }
+    m.numa_applied = intl::apply_numa_policy(m.ptr, m.size, opts);
+#else
+    m.ptr = ::operator new(size, std::align_val_t(intl::huge_2m_bytes), std::nothrow);
+    if(m.ptr == nullptr)
+        return page_mapping{};
+    std::memset(m.ptr, 0, size);
+    m.size = size;
+#endif
+    return m;
+}
+
+QS_INLINE void unmap_pages(page_mapping const& m) noexcept
+{
+    if(m.ptr == nullptr)
+        return;
+#if QS_INTL_HAS_LINUX_MMAP
+    ::munmap(m.ptr, m.size);
+#else
+    ::operator delete(m.ptr, std::align_val_t(intl::huge_2m_bytes));
+#endif
+}
+
+
+/**
+ * Standard allocator backing large allocations with huge pages and an optional NUMA placement, e.g.
+ * `FenwickTree<int, huge_page_allocator<int>>`. Allocations smaller than `min_mapping_bytes` go through
+ * `::operator new`, so small containers do not burn a whole huge page each.
+ */
+template<class T>
+class huge_page_allocator
+{
+public:
+    using value_type      = T;
+    using is_always_equal = std::false_type;
+
+    template<class U>
+    struct rebind
+    {
+        using other = huge_page_allocator<U>;
+    };
+
+    huge_page_allocator() noexcept = default;
+
+    explicit huge_page_allocator(huge_page_options const& opts) noexcept
+        : opts_(opts)
+    {}
+
+    template<class U>
+    huge_page_allocator(huge_page_allocator<U> const& other) noexcept
+        : opts_(other.options())
+    {}
+
+    QS_NODISCARD T* allocate(std::size_t n)
+    {
+        if(n > static_cast<std::size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        std::size_t const bytes = n * sizeof(T);
+        if(bytes < opts_.min_mapping_bytes)
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+
+        page_mapping const m = map_pages(bytes, opts_);
+        if(m.ptr == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(m.ptr);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        std::size_t const bytes = n * sizeof(T);
+        if(bytes < opts_.min_mapping_bytes)
+            return ::operator delete(static_cast<void*>(p), std::align_val_t(alignof(T)));
+#if QS_INTL_HAS_LINUX_MMAP
+        intl::unmap_allocation(p, bytes, opts_.pages);
+#else
+        unmap_pages(page_mapping{p, bytes, page_size::standard, false});
+#endif
+    }
+
+    huge_page_options const& options() const noexcept { return opts_; }
+
+private:
+    huge_page_options opts_;
+};
+
+template<class T, class U>
+bool operator==(huge_page_allocator<T> const& lhs, huge_page_allocator<U> const& rhs) noexcept
+{
+    return lhs.options() == rhs.options();
+}
+
+template<class T, class U>
+bool operator!=(huge_page_allocator<T> const& lhs, huge_page_allocator<U> const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+QS_NAMESPACE_END
+
+#undef QS_INTL_HAS_LINUX_MMAP
+
+#endif // QS_MEMORY_HUGE_PAGE_ALLOCATOR_H
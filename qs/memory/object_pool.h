@@ -0,0 +1,482 @@
+#ifndef QS_MEMORY_OBJECT_POOL_H
+#define QS_MEMORY_OBJECT_POOL_H
+
+#include <qs/concurrency/spin_lock.h>
+#include <qs/config.h>
+#include <qs/exception_guard.h>
+#include <qs/memory.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+QS_INLINE_VAR constexpr std::size_t default_slab_size = 4096;
+
+
+/**
+ * Fixed-size block allocator over page-sized slabs. Free blocks form an intrusive singly linked list (the
+ * link is stored inside the free block itself), so allocation and deallocation are a pointer pop/push.
+ * Fresh slabs are carved lazily with a bump pointer, and slabs are only returned to the system on
+ * `release()` or destruction. Not thread-safe, see `concurrent_object_pool` for a shared variant.
+ */
+class slab_allocator
+{
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct slab_header
+    {
+        slab_header* next;
+    };
+
+public:
+    explicit slab_allocator(std::size_t block_size, std::size_t block_align = alignof(std::max_align_t),
+                            std::size_t slab_size = default_slab_size)
+        : block_align_(std::max(block_align, alignof(free_block))),
+          block_size_(round_up(std::max(block_size, sizeof(free_block)), block_align_)),
+          slab_size_(std::max(slab_size, round_up(sizeof(slab_header), block_align_) + block_size_))
+    {
+        QS_VERIFY((block_align & (block_align - 1)) == 0, "slab_allocator: alignment must be a power of two");
+    }
+
+    slab_allocator(slab_allocator const&)            = delete;
+    slab_allocator& operator=(slab_allocator const&) = delete;
+
+    slab_allocator(slab_allocator&& other) noexcept
+        : block_align_(other.block_align_),
+          block_size_(other.block_size_),
+          slab_size_(other.slab_size_),
+          free_list_(std::exchange(other.free_list_, nullptr)),
+          slabs_(std::exchange(other.slabs_, nullptr)),
+          bump_(std::exchange(other.bump_, nullptr)),
+          bump_end_(std::exchange(other.bump_end_, nullptr)),
+          slab_count_(std::exchange(other.slab_count_, 0))
+    {}
+
+    ~slab_allocator() { release(); }
+
+    QS_NODISCARD void* allocate()
+    {
+        if(QS_LIKELY(free_list_ != nullptr))
+            return std::exchange(free_list_, free_list_->next);
+        if(QS_UNLIKELY(bump_ == bump_end_))
+            add_slab(allocate_slab());
+        return std::exchange(bump_, bump_ + block_size_);
+    }
+
+    // Whether `try_allocate()` would succeed.
+    bool can_allocate() const noexcept { return free_list_ != nullptr || bump_ != bump_end_; }
+
+    // A free block without growing, `nullptr` when a new slab is needed.
+    QS_NODISCARD void* try_allocate() noexcept
+    {
+        if(QS_LIKELY(free_list_ != nullptr))
+            return std::exchange(free_list_, free_list_->next);
+        if(QS_UNLIKELY(bump_ == bump_end_))
+            return nullptr;
+        return std::exchange(bump_, bump_ + block_size_);
+    }
+
+    void deallocate(void* p) noexcept
+    {
+        QS_ASSERT(p != nullptr, "slab_allocator::deallocate(nullptr)");
+        free_list_ = ::new(p) free_block{free_list_};
+    }
+
+    // Returns every slab to the system, all outstanding blocks become invalid.
+    void release() noexcept
+    {
+        while(slabs_ != nullptr)
+        {
+            slab_header* next = slabs_->next;
+            free_slab(static_cast<void*>(slabs_));
+            slabs_ = next;
+        }
+        free_list_  = nullptr;
+        bump_       = nullptr;
+        bump_end_   = nullptr;
+        slab_count_ = 0;
+    }
+
+    // Growth in two steps, for callers that lock around the allocator: `allocate_slab()` only calls the system
+    // allocator and touches no state, so it can run outside the lock; `add_slab()` hands the slab over. Blocks
+    // not yet carved from the current slab move to the free list, so adding a slab early wastes nothing.
+    QS_NODISCARD void* allocate_slab() const
+    {
+        return ::operator new(slab_size_, std::align_val_t(slab_alignment()));
+    }
+    void free_slab(void* mem) const noexcept { ::operator delete(mem, std::align_val_t(slab_alignment())); }
+
+    QS_NOINLINE void add_slab(void* mem) noexcept
+    {
+        for(; bump_ != bump_end_; bump_ += block_size_)
+            free_list_ = ::new(static_cast<void*>(bump_)) free_block{free_list_};
+
+        slabs_ = ::new(mem) slab_header{slabs_};
+        ++slab_count_;
+
+        char* const base = static_cast<char*>(mem);
+        bump_            = base + round_up(sizeof(slab_header), block_align_);
+        bump_end_        = bump_ + blocks_per_slab() * block_size_;
+    }
+
+    std::size_t block_size() const noexcept { return block_size_; }
+    std::size_t block_alignment() const noexcept { return block_align_; }
+    std::size_t slab_size() const noexcept { return slab_size_; }
+    std::size_t slab_count() const noexcept { return slab_count_; }
+    std::size_t blocks_per_slab() const noexcept
+    {
+        return (slab_size_ - round_up(sizeof(slab_header), block_align_)) / block_size_;
+    }
+
+private:
+    std::size_t block_align_;
+    std::size_t block_size_;
+    std::size_t slab_size_;
+
+    free_block*  free_list_  = nullptr;
+    slab_header* slabs_      = nullptr;
+    char*        bump_       = nullptr;
+    char*        bump_end_   = nullptr;
+    std::size_t  slab_count_ = 0;
+
+    static constexpr std::size_t round_up(std::size_t n, std::size_t align) noexcept
+    {
+        return (n + align - 1) & ~(align - 1);
+    }
+
+    std::size_t slab_alignment() const noexcept { return std::max(block_align_, alignof(slab_header)); }
+};
+
+
+// Pool of `T` objects backed by a `slab_allocator`, single-threaded.
+template<class T>
+class object_pool
+{
+public:
+    using value_type = T;
+
+    explicit object_pool(std::size_t slab_size = default_slab_size)
+        : slabs_(sizeof(T), alignof(T), slab_size)
+    {}
+
+    QS_NODISCARD T* allocate() { return static_cast<T*>(slabs_.allocate()); }
+    void            deallocate(T* p) noexcept { slabs_.deallocate(p); }
+
+    template<class... Args>
+    QS_NODISCARD T* create(Args&&... args)
+    {
+        T*   p     = allocate();
+        auto guard = make_exception_guard([&] { deallocate(p); });
+        qs::construct_at(p, std::forward<Args>(args)...);
+        guard.complete();
+        return p;
+    }
+
+    void destroy(T* p) noexcept
+    {
+        qs::destroy_at(p);
+        deallocate(p);
+    }
+
+    slab_allocator&       slabs() noexcept { return slabs_; }
+    slab_allocator const& slabs() const noexcept { return slabs_; }
+
+private:
+    slab_allocator slabs_;
+};
+
+
+/**
+ * Thread-safe pool of `T` objects. The central slab allocator is protected by a `spin_lock`; threads that
+ * allocate heavily should go through a `local_cache`, which moves blocks to and from the central pool in
+ * batches so the lock is taken once per `batch` operations. New slabs are allocated outside the lock, so other
+ * threads never spin through a call to the system allocator.
+ */
+template<class T>
+class concurrent_object_pool
+{
+public:
+    using value_type = T;
+
+    class local_cache;
+
+    explicit concurrent_object_pool(std::size_t slab_size = default_slab_size)
+        : slabs_(sizeof(T), alignof(T), slab_size)
+    {}
+
+    QS_NODISCARD T* allocate()
+    {
+        for(;;)
+        {
+            {
+                std::lock_guard<spin_lock> lock(lock_);
+                if(void* p = slabs_.try_allocate())
+                    return static_cast<T*>(p);
+            }
+            refill();
+        }
+    }
+
+    void deallocate(T* p) noexcept
+    {
+        std::lock_guard<spin_lock> lock(lock_);
+        slabs_.deallocate(p);
+    }
+
+    // Per-thread cache of free blocks, must be used (and destroyed) by a single thread.
+    local_cache make_local_cache(std::size_t batch = 32) { return local_cache(*this, batch); }
+
+private:
+    spin_lock      lock_;
+    slab_allocator slabs_;
+
+    // Adds a slab allocated outside the lock, or frees it when another thread refilled the allocator meanwhile.
+    QS_NOINLINE void refill()
+    {
+        void* const slab    = slabs_.allocate_slab();
+        bool        adopted = false;
+        {
+            std::lock_guard<spin_lock> lock(lock_);
+            if(!slabs_.can_allocate())
+            {
+                slabs_.add_slab(slab);
+                adopted = true;
+            }
+        }
+        if(!adopted)
+            slabs_.free_slab(slab);
+    }
+
+    void allocate_batch(void** out, std::size_t n)
+    {
+        std::size_t i     = 0;
+        auto        guard = make_exception_guard([&] { deallocate_batch(out, i); });
+        for(;;)
+        {
+            {
+                std::lock_guard<spin_lock> lock(lock_);
+                for(; i < n; ++i)
+                {
+                    out[i] = slabs_.try_allocate();
+                    if(out[i] == nullptr)
+                        break;
+                }
+            }
+            if(i == n)
+                break;
+            refill();
+        }
+        guard.complete();
+    }
+
+    void deallocate_batch(void* const* in, std::size_t n) noexcept
+    {
+        std::lock_guard<spin_lock> lock(lock_);
+        for(std::size_t i = 0; i < n; ++i)
+            slabs_.deallocate(in[i]);
+    }
+};
+
+template<class T>
+class concurrent_object_pool<T>::local_cache
+{
+public:
+    local_cache(local_cache&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          blocks_(std::move(other.blocks_)),
+          size_(std::exchange(other.size_, 0)),
+          batch_(other.batch_)
+    {}
+
+    local_cache(local_cache const&)            = delete;
+    local_cache& operator=(local_cache const&) = delete;
+    local_cache& operator=(local_cache&&)      = delete;
+
+    ~local_cache()
+    {
+        if(pool_ != nullptr)
+            pool_->deallocate_batch(blocks_.get(), size_);
+    }
+
+    QS_NODISCARD T* allocate()
+    {
+        if(QS_UNLIKELY(size_ == 0))
+        {
+            pool_->allocate_batch(blocks_.get(), batch_);
+            size_ = batch_;
+        }
+        return static_cast<T*>(blocks_[--size_]);
+    }
+
+    void deallocate(T* p) noexcept
+    {
+        if(QS_UNLIKELY(size_ == 2 * batch_))
+        {
+            // keep the most recently freed (cache-hot) half, return the older half
+            pool_->deallocate_batch(blocks_.get(), batch_);
+            std::move(blocks_.get() + batch_, blocks_.get() + size_, blocks_.get());
+            size_ = batch_;
+        }
+        blocks_[size_++] = p;
+    }
+
+    template<class... Args>
+    QS_NODISCARD T* create(Args&&... args)
+    {
+        T*   p     = allocate();
+        auto guard = make_exception_guard([&] { deallocate(p); });
+        qs::construct_at(p, std::forward<Args>(args)...);
+        guard.complete();
+        return p;
+    }
+
+    void destroy(T* p) noexcept
+    {
+        qs::destroy_at(p);
+        deallocate(p);
+    }
+
+private:
+    friend class concurrent_object_pool<T>;
+
+    local_cache(concurrent_object_pool& pool, std::size_t batch)
+        : pool_(&pool),
+          blocks_(new void*[2 * std::max<std::size_t>(batch, 1)]),
+          batch_(std::max<std::size_t>(batch, 1))
+    {}
+
+    concurrent_object_pool*  pool_;
+    std::unique_ptr<void*[]> blocks_;
+    std::size_t              size_ = 0;
+    std::size_t              batch_;
+};
+
+
+/**
+ * Size-class pool: one `slab_allocator` per multiple of `granularity` up to `max_block_size`, larger requests
+ * go straight to `::operator new`. This is the memory resource behind `pool_allocator<T>`, and since it is
+ * not bound to a single type it survives allocator rebinding (node-based containers, `std::allocate_shared`).
+ */
+class pool_resource
+{
+public:
+    static constexpr std::size_t granularity    = 16;
+    static constexpr std::size_t max_block_size = 512;
+    static constexpr std::size_t class_count    = max_block_size / granularity;
+
+    explicit pool_resource(std::size_t slab_size = default_slab_size)
+        : slab_size_(slab_size)
+    {}
+
+    pool_resource(pool_resource const&)            = delete;
+    pool_resource& operator=(pool_resource const&) = delete;
+
+    ~pool_resource()
+    {
+        for(auto& cls: classes_)
+            if(cls != nullptr)
+                qs::destroy_at(cls);
+    }
+
+    QS_NODISCARD void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t))
+    {
+        if(bytes > max_block_size || align > granularity)
+            return ::operator new(bytes, std::align_val_t(align));
+        return size_class(bytes).allocate();
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t align = alignof(std::max_align_t)) noexcept
+    {
+        if(bytes > max_block_size || align > granularity)
+            return ::operator delete(p, std::align_val_t(align));
+        classes_[class_index(bytes)]->deallocate(p);
+    }
+
+private:
+    std::size_t     slab_size_;
+    slab_allocator* classes_[class_count] = {};
+    alignas(slab_allocator) unsigned char storage_[class_count][sizeof(slab_allocator)];
+
+    static constexpr std::size_t class_index(std::size_t bytes) noexcept
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / granularity;
+    }
+
+    slab_allocator& size_class(std::size_t bytes)
+    {
+        std::size_t const idx = class_index(bytes);
+        if(QS_UNLIKELY(classes_[idx] == nullptr))
+            classes_[idx] = ::new(static_cast<void*>(storage_[idx]))
+                slab_allocator((idx + 1) * granularity, granularity, std::max(slab_size_, 16 * (idx + 1) * granularity));
+        return *classes_[idx];
+    }
+};
+
+
+// Standard allocator adaptor over a `pool_resource`, e.g. `FenwickTree<int, pool_allocator<int>>`.
+template<class T>
+class pool_allocator
+{
+public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    template<class U>
+    struct rebind
+    {
+        using other = pool_allocator<U>;
+    };
+
+    pool_allocator(pool_resource& resource) noexcept
+        : resource_(&resource)
+    {}
+
+    template<class U>
+    pool_allocator(pool_allocator<U> const& other) noexcept
+        : resource_(other.resource())
+    {}
+
+    QS_NODISCARD T* allocate(std::size_t n)
+    {
+        if(n > static_cast<std::size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    pool_resource* resource() const noexcept { return resource_; }
+
+private:
+    pool_resource* resource_;
+};
+
+template<class T, class U>
+bool operator==(pool_allocator<T> const& lhs, pool_allocator<U> const& rhs) noexcept
+{
+    return lhs.resource() == rhs.resource();
+}
+
+template<class T, class U>
+bool operator!=(pool_allocator<T> const& lhs, pool_allocator<U> const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_MEMORY_OBJECT_POOL_H
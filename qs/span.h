@@ -6,6 +6,7 @@
 #include <qs/traits/iterator.h>
 #include <qs/traits/ranges.h>
 
+#include <limits>
 #include <stdexcept>
 #include <type_traits>
 
@@ -339,8 +340,9 @@ public:
           size_{N}
     {}
 
+    // [span.cons]/18: implicit, a span of any extent converts to a dynamic one (e.g. span<T> -> span<T const>)
     template<class V, size_t E, enable_if_t<intl::is_span_convertible<V, element_type>::value, int> = 0>
-    QS_CONSTEXPR11 explicit span(span<V, E> const& other) noexcept
+    QS_CONSTEXPR11 span(span<V, E> const& other) noexcept
         : data_{other.data()},
           size_{other.size()}
     {}
@@ -516,6 +518,51 @@ QS_ALWAYS_INLINE QS_CONSTEXPR11 auto as_writable_bytes(span<T, N> s) noexcept
 }
 
 
+namespace intl
+{
+    template<class B>
+    struct is_byte_like : std::integral_constant<bool, std::is_same<remove_cv_t<B>, byte>::value ||
+                                                           std::is_same<remove_cv_t<B>, unsigned char>::value ||
+                                                           std::is_same<remove_cv_t<B>, char>::value>
+    {};
+
+    // Trivially copyable types are implicit-lifetime: C++23 starts the lifetime of the array explicitly, earlier
+    // standards rely on the objects having been implicitly created by whatever wrote the bytes.
+    template<class U, class B>
+    QS_ALWAYS_INLINE U* start_lifetime_as_array(B* p, size_t n) noexcept
+    {
+#if defined(__cpp_lib_start_lifetime_as)
+        return std::start_lifetime_as_array<U>(p, n);
+#else
+        ignore_unused(n);
+        return qs::launder(reinterpret_cast<U*>(p));
+#endif
+    }
+} // namespace intl
+
+/**
+ * Zero-copy view of raw bytes as `U` objects, e.g. packed structs of a network buffer, instead of copying each one
+ * out with memcpy. The bytes must hold a whole number of `U` and be aligned to `alignof(U)` (checked), and hold valid
+ * object representations of `U` (not checked). Const bytes only give const objects.
+ *
+ *      span<wire_header const> headers = qs::span_cast<wire_header const>(qs::as_bytes(buffer));
+ */
+template<class U, class B, size_t N,
+         enable_if_t<intl::is_byte_like<B>::value && (std::is_const<U>::value || !std::is_const<B>::value), int> = 0>
+QS_ALWAYS_INLINE auto span_cast(span<B, N> bytes) noexcept(is_nothrow_contract_violation)
+    -> span<U, N == dynamic_extent ? dynamic_extent : N / sizeof(U)>
+{
+    static_assert(std::is_trivially_copyable<U>::value, "span_cast<U>(bytes): U must be trivially copyable");
+    static_assert(N == dynamic_extent || N % sizeof(U) == 0, "span_cast<U>(bytes): extent not a multiple of sizeof(U)");
+    QS_VERIFY(bytes.size() % sizeof(U) == 0, "span_cast<U>(bytes): size not a multiple of sizeof(U)");
+    QS_VERIFY(is_aligned(bytes.data(), alignof(U)), "span_cast<U>(bytes): bytes not aligned for U");
+
+    using result_span = span<U, N == dynamic_extent ? dynamic_extent : N / sizeof(U)>;
+    size_t const count = bytes.size() / sizeof(U);
+    return result_span{intl::start_lifetime_as_array<U>(bytes.data(), count), count};
+}
+
+
 // [span.comparison], span comparison operators
 
 // template<class ElementL, size_t ExtentL, class ElementR, size_t ExtentR>
@@ -0,0 +1,88 @@
+#ifndef QS_UTILS_CPU_FEATURES_H
+#define QS_UTILS_CPU_FEATURES_H
+
+#include <qs/config.h>
+
+#include <atomic>
+
+// Kernels for wider instruction sets are compiled with per-function target attributes and selected at runtime,
+// so the library does not need to be built with `-mavx2`/`-mavx512f` to use them.
+#if (QS_GCC_VERSION || QS_CLANG_VERSION) && QS_X86_64
+#include <immintrin.h>
+#define QS_HAS_X86_DISPATCH 1
+#define QS_TARGET_AVX2      __attribute__((target("avx2,bmi,bmi2,popcnt,lzcnt")))
+#define QS_TARGET_AVX512    __attribute__((target("avx2,bmi,bmi2,popcnt,lzcnt,avx512f,avx512bw,avx512vl,avx512dq")))
+#else
+#define QS_HAS_X86_DISPATCH 0
+#define QS_TARGET_AVX2
+#define QS_TARGET_AVX512
+#endif
+
+// Around the AVX-512 kernels: GCC flags the `_mm512_undefined_epi32()` pass-through operand of the unmasked
+// intrinsics as uninitialized (the reductions and 256-bit extracts even trip the definite warning), a false positive.
+#if QS_GCC_VERSION && !QS_CLANG_VERSION
+#define QS_SIMD_DIAGNOSTICS_BEGIN                                                                                      \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")                         \
+        _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")
+#define QS_SIMD_DIAGNOSTICS_END _Pragma("GCC diagnostic pop")
+#else
+#define QS_SIMD_DIAGNOSTICS_BEGIN
+#define QS_SIMD_DIAGNOSTICS_END
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+enum class simd_level
+{
+    scalar = 0,
+    avx2   = 1, // AVX2 + BMI2
+    avx512 = 2  // AVX-512 F/BW/VL/DQ
+};
+
+namespace intl
+{
+    QS_INLINE simd_level detect_simd_level() noexcept
+    {
+#if QS_HAS_X86_DISPATCH
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq"))
+            return simd_level::avx512;
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+            return simd_level::avx2;
+#endif
+        return simd_level::scalar;
+    }
+
+    QS_INLINE std::atomic<simd_level>& simd_level_limit() noexcept
+    {
+        static std::atomic<simd_level> limit{simd_level::avx512};
+        return limit;
+    }
+} // namespace intl
+
+// Widest instruction set supported by the running CPU, detected once.
+QS_INLINE simd_level detected_simd_level() noexcept
+{
+    static simd_level const level = intl::detect_simd_level();
+    return level;
+}
+
+// Instruction set used by the dispatched kernels: the detected one, capped by `limit_simd_level`.
+QS_INLINE simd_level active_simd_level() noexcept
+{
+    simd_level const limit = intl::simd_level_limit().load(std::memory_order_relaxed);
+    simd_level const level = detected_simd_level();
+    return limit < level ? limit : level;
+}
+
+// Caps the instruction set used by the dispatched kernels (for benchmarks, tests or to dodge AVX-512 downclocking).
+QS_INLINE void limit_simd_level(simd_level limit) noexcept
+{
+    intl::simd_level_limit().store(limit, std::memory_order_relaxed);
+}
+
+QS_NAMESPACE_END
+
+#endif // QS_UTILS_CPU_FEATURES_H
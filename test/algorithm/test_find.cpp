@@ -0,0 +1,101 @@
+#include <test/test_header.h>
+
+#include <qs/algorithm/find.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class FindTest : public simd_level_test
+    {
+    protected:
+        // Every element drawn from a few values, so that each of them occurs at irregular positions.
+        template<class T>
+        static std::vector<T> values(std::size_t n, std::uint64_t seed)
+        {
+            std::mt19937_64 gen(seed);
+            std::vector<T>  v(n);
+            for(auto& x: v)
+                x = static_cast<T>(gen() % 5);
+            return v;
+        }
+
+        // Sizes around the vector widths and the unrolled loops, and past the byte counters' flush.
+        static constexpr std::size_t sizes[] = {0, 1, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 9000};
+
+        template<class T>
+        static void check_matches_std()
+        {
+            for(std::size_t n: sizes)
+            {
+                auto const          v = values<T>(n, n);
+                span<T const> const s = make_span(v);
+                for(int x = 0; x <= 5; ++x)
+                {
+                    auto const value = static_cast<T>(x);
+                    EXPECT_EQ(find(s, value), std::find(v.data(), v.data() + n, value)) << n << ' ' << x;
+                    EXPECT_EQ(count(s, value), static_cast<std::size_t>(std::count(v.begin(), v.end(), value)))
+                        << n << ' ' << x;
+                }
+            }
+        }
+    };
+
+    TEST_P(FindTest, MatchesStd)
+    {
+        check_matches_std<std::uint8_t>();
+        check_matches_std<char>();
+        check_matches_std<std::int32_t>();
+        check_matches_std<std::uint32_t>();
+        check_matches_std<float>();
+        check_matches_std<std::int64_t>(); // no kernel, plain loop
+    }
+
+    TEST_P(FindTest, EveryPosition)
+    {
+        // A single match at each position finds that position, whichever vector or tail it falls in.
+        for(std::size_t n: {1u, 70u, 300u})
+        {
+            std::vector<std::int32_t> v(n, 1);
+            std::vector<char>         bytes(n, 'a');
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                v[i]     = -7;
+                bytes[i] = '\n';
+                EXPECT_EQ(find(make_span(v), -7) - v.data(), static_cast<std::ptrdiff_t>(i));
+                EXPECT_EQ(find(make_span(bytes), '\n') - bytes.data(), static_cast<std::ptrdiff_t>(i));
+                v[i]     = 1;
+                bytes[i] = 'a';
+            }
+        }
+    }
+
+    TEST_P(FindTest, FloatEquality)
+    {
+        std::vector<float> const v = {1.f, -0.f, std::numeric_limits<float>::quiet_NaN(), 2.f, 0.f, 3.f, 4.f, 5.f, 6.f};
+        EXPECT_EQ(find(make_span(v), 0.f), v.data() + 1);
+        EXPECT_EQ(count(make_span(v), 0.f), 2u);
+        EXPECT_EQ(find(make_span(v), std::numeric_limits<float>::quiet_NaN()), v.data() + v.size());
+        EXPECT_EQ(count(make_span(v), std::numeric_limits<float>::quiet_NaN()), 0u);
+    }
+
+    TEST_P(FindTest, ByteCountersDoNotWrap)
+    {
+        // 255 vectors of matches fill the byte counters, longer runs must be flushed in between.
+        std::vector<std::uint8_t> const v(100000, 42);
+        EXPECT_EQ(count(make_span(v), std::uint8_t(42)), v.size());
+        EXPECT_EQ(find(make_span(v), std::uint8_t(0)), v.data() + v.size());
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, FindTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
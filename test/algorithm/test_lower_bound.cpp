@@ -0,0 +1,59 @@
+#include <test/test_header.h>
+
+#include <qs/algorithm/lower_bound.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    // Every size up to a few powers of two, duplicates included, searched for every value and both neighbours.
+    TEST(LowerBound, MatchesStd)
+    {
+        for(std::size_t n = 0; n <= 130; ++n)
+        {
+            std::vector<int> v(n);
+            for(std::size_t i = 0; i < n; ++i)
+                v[i] = static_cast<int>(i / 3 * 2);
+            span<int const> const s = make_span(v);
+            for(int x = -1; x <= static_cast<int>(n) + 1; ++x)
+                ASSERT_EQ(lower_bound(s, x), std::lower_bound(v.data(), v.data() + n, x)) << n << ' ' << x;
+        }
+    }
+
+    TEST(LowerBound, Random)
+    {
+        std::mt19937_64           gen(5);
+        std::vector<std::int64_t> v(100003);
+        for(auto& x: v)
+            x = static_cast<std::int64_t>(gen() % 1000000) - 500000;
+        std::sort(v.begin(), v.end());
+        for(int q = 0; q < 10000; ++q)
+        {
+            auto const x = static_cast<std::int64_t>(gen() % 1100000) - 550000;
+            ASSERT_EQ(lower_bound(make_span(v), x), std::lower_bound(v.begin(), v.end(), x) - v.begin() + v.data());
+        }
+    }
+
+    TEST(LowerBound, Comparator)
+    {
+        std::vector<int> const descending = {9, 7, 7, 4, 1, 0};
+        EXPECT_EQ(lower_bound(make_span(descending), 7, std::greater<>()), descending.data() + 1);
+        EXPECT_EQ(lower_bound(make_span(descending), 5, std::greater<>()), descending.data() + 3);
+        EXPECT_EQ(lower_bound(make_span(descending), -1, std::greater<>()), descending.data() + 6);
+
+        // Heterogeneous key, as with `std::lower_bound`.
+        std::vector<std::string> const words = {"ask", "bid", "fill", "quote"};
+        auto const by_first = [](std::string const& w, char c) { return w.front() < c; };
+        EXPECT_EQ(lower_bound(make_span(words), 'c', by_first), words.data() + 2);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
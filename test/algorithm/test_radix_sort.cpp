@@ -0,0 +1,194 @@
+#include <test/test_header.h>
+
+#include <qs/algorithm/radix_sort.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    // Past the insertion sort, and past the size of the buffered scatters.
+    static constexpr std::size_t radix_sizes[] = {0, 1, 2, 3, 63, 64, 65, 257, 1000, 70000, 300001};
+    static_assert(300001 >= intl::radix_buffered_min, "buffered scatters not covered");
+
+    template<class T>
+    static std::vector<T> random_keys(std::size_t n, std::uint64_t seed, std::uint64_t range = 0)
+    {
+        std::mt19937_64 gen(seed);
+        std::vector<T>  v(n);
+        for(auto& x: v)
+        {
+            std::uint64_t const r = range ? gen() % range : gen();
+            if(std::is_floating_point<T>::value)
+                x = static_cast<T>(static_cast<double>(static_cast<std::int64_t>(r)) * 1e-9);
+            else
+                x = static_cast<T>(r);
+        }
+        return v;
+    }
+
+    template<class T>
+    static void check_matches_std_sort(std::uint64_t range = 0)
+    {
+        for(std::size_t n: radix_sizes)
+        {
+            auto keys     = random_keys<T>(n, n, range);
+            auto expected = keys;
+            std::sort(expected.begin(), expected.end());
+            radix_sort(make_span(keys));
+            EXPECT_EQ(keys, expected) << n;
+        }
+    }
+
+    TEST(RadixSort, MatchesStdSort)
+    {
+        check_matches_std_sort<std::uint8_t>();
+        check_matches_std_sort<std::uint16_t>();
+        check_matches_std_sort<std::uint32_t>();
+        check_matches_std_sort<std::uint64_t>();
+        check_matches_std_sort<std::int8_t>();
+        check_matches_std_sort<std::int32_t>();
+        check_matches_std_sort<std::int64_t>();
+        check_matches_std_sort<float>();
+        check_matches_std_sort<double>();
+    }
+
+    // Digits shared by every key are skipped, which leaves odd numbers of passes to copy back.
+    TEST(RadixSort, FewDistinctDigits)
+    {
+        check_matches_std_sort<std::uint32_t>(1);
+        check_matches_std_sort<std::uint32_t>(200);
+        check_matches_std_sort<std::uint32_t>(1 << 12);
+        check_matches_std_sort<std::uint32_t>(1 << 20);
+        check_matches_std_sort<std::uint64_t>(1 << 20);
+    }
+
+    TEST(RadixSort, FloatOrder)
+    {
+        using limits           = std::numeric_limits<float>;
+        float const        inf = limits::infinity();
+        std::vector<float> v   = {3.5f, -0.f, inf, -1e-30f, 0.f, -inf, 1e-30f, -2.f, limits::max(), limits::lowest(),
+                                  limits::denorm_min()};
+        v.resize(1000, 1.f);
+        radix_sort(make_span(v));
+        EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+        EXPECT_EQ(v.front(), -inf);
+        EXPECT_EQ(v.back(), inf);
+        auto const zero = std::find(v.begin(), v.end(), 0.f);
+        ASSERT_NE(zero, v.end());
+        EXPECT_TRUE(std::signbit(zero[0]));
+        EXPECT_FALSE(std::signbit(zero[1]));
+    }
+
+    // Stable: equal keys keep the order of their payloads.
+    TEST(RadixSort, ByKeyIsStable)
+    {
+        for(std::size_t n: radix_sizes)
+        {
+            auto                                                keys = random_keys<std::int32_t>(n, n, 100);
+            std::vector<std::uint64_t>                          values(n);
+            std::vector<std::pair<std::int32_t, std::uint64_t>> expected(n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                values[i]   = i;
+                expected[i] = {keys[i] - 50, i};
+                keys[i] -= 50;
+            }
+            std::stable_sort(expected.begin(), expected.end(),
+                             [](auto const& a, auto const& b) { return a.first < b.first; });
+
+            radix_sort_by_key(make_span(keys), make_span(values));
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                ASSERT_EQ(keys[i], expected[i].first) << n << " " << i;
+                ASSERT_EQ(values[i], expected[i].second) << n << " " << i;
+            }
+        }
+    }
+
+    // Payloads too large for the buffered scatters.
+    TEST(RadixSort, ByKeyLargePayload)
+    {
+        struct payload
+        {
+            std::uint32_t index;
+            char          data[60];
+        };
+
+        std::size_t const    n    = 100000;
+        auto                 keys = random_keys<std::uint32_t>(n, 3, 1000);
+        std::vector<payload> values(n);
+        for(std::size_t i = 0; i < n; ++i)
+            values[i].index = static_cast<std::uint32_t>(i);
+        auto const original = keys;
+
+        radix_sort_by_key(make_span(keys), make_span(values));
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            ASSERT_EQ(original[values[i].index], keys[i]) << i;
+            if(i > 0 && keys[i] == keys[i - 1])
+            {
+                ASSERT_LT(values[i - 1].index, values[i].index) << i;
+            }
+        }
+    }
+
+    // Caller scratch, at an offset that puts the destination lines of the buffered scatters off their alignment.
+    TEST(RadixSort, Scratch)
+    {
+        for(std::size_t offset: {0, 1, 3})
+        {
+            std::size_t const          n        = 300007;
+            auto                       keys     = random_keys<std::uint32_t>(n, offset);
+            auto                       expected = keys;
+            std::vector<std::uint32_t> scratch(n + offset);
+            std::sort(expected.begin(), expected.end());
+            radix_sort(make_span(keys), make_span(scratch).subspan(offset));
+            EXPECT_EQ(keys, expected) << offset;
+
+            std::vector<std::uint16_t> values(n), value_scratch(n + offset);
+            keys = random_keys<std::uint32_t>(n, offset);
+            for(std::size_t i = 0; i < n; ++i)
+                values[i] = static_cast<std::uint16_t>(keys[i]);
+            radix_sort_by_key(make_span(keys), make_span(values), make_span(scratch).subspan(offset),
+                              make_span(value_scratch).subspan(offset));
+            EXPECT_EQ(keys, expected) << offset;
+            for(std::size_t i = 0; i < n; ++i)
+                ASSERT_EQ(values[i], static_cast<std::uint16_t>(keys[i])) << i;
+        }
+
+        if(QS_DEBUG) // without the checks, the sort would write past the end of `small`
+        {
+            std::vector<int> keys(100), small(99);
+            EXPECT_DEATH(radix_sort(make_span(keys), make_span(small)),
+                         testing::HasSubstr("radix_sort: scratch smaller than keys"));
+            EXPECT_DEATH(radix_sort_by_key(make_span(keys), make_span(small)),
+                         testing::HasSubstr("radix_sort_by_key: keys and values size mismatch"));
+        }
+    }
+
+    TEST(RadixSort, ThreadedCounts)
+    {
+        std::size_t const n        = 3 * intl::radix_parallel_min_part + 17;
+        auto const        original = random_keys<std::int64_t>(n, 11);
+        auto              expected = original;
+        std::sort(expected.begin(), expected.end());
+        for(unsigned threads: {0u, 2u, 3u, 16u})
+        {
+            auto keys = original;
+            radix_sort(make_span(keys), threads);
+            EXPECT_EQ(keys, expected) << threads;
+        }
+    }
+} // namespace test
+
+QS_NAMESPACE_END
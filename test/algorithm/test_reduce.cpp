@@ -0,0 +1,145 @@
+#include <test/test_header.h>
+
+#include <qs/algorithm/reduce.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class ReduceTest : public simd_level_test
+    {
+    protected:
+        // Uniform over the whole range of `T`, small integers for floats so that their sums are exact.
+        template<class T>
+        static std::vector<T> values(std::size_t n, std::uint64_t seed)
+        {
+            std::mt19937_64 gen(seed);
+            std::vector<T>  v(n);
+            for(auto& x: v)
+                if constexpr(std::is_floating_point<T>::value)
+                    x = static_cast<T>(static_cast<int>(gen() % 2001) - 1000);
+                else
+                    x = static_cast<T>(gen());
+            return v;
+        }
+
+        // Second operands of the dot products, small enough for the products of the first ones to add up in 64 bits.
+        template<class T>
+        static std::vector<T> small_values(std::size_t n, std::uint64_t seed)
+        {
+            std::mt19937_64 gen(seed);
+            std::vector<T>  v(n);
+            for(auto& x: v)
+                x = static_cast<T>(gen() % 101);
+            return v;
+        }
+
+        static constexpr std::size_t sizes[] = {1, 2, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, 4097};
+
+        template<class T>
+        static void check_matches_std()
+        {
+            using result = intl::sum_result_t<T>;
+            for(std::size_t n: sizes)
+            {
+                auto const          a = values<T>(n, n);
+                auto const          b = small_values<T>(n, n + 1);
+                span<T const> const s = make_span(a);
+
+                auto const [lo, hi] = std::minmax_element(a.begin(), a.end());
+                EXPECT_EQ(min_value(s), *lo) << n;
+                EXPECT_EQ(max_value(s), *hi) << n;
+                EXPECT_EQ(minmax_value(s), std::make_pair(*lo, *hi)) << n;
+                EXPECT_EQ(argmin(s), static_cast<std::size_t>(lo - a.begin())) << n;
+                EXPECT_EQ(argmax(s), static_cast<std::size_t>(std::max_element(a.begin(), a.end()) - a.begin()))
+                    << n;
+
+                result expected_sum = 0, expected_dot = 0;
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    expected_sum += static_cast<result>(a[i]);
+                    expected_dot += static_cast<result>(a[i]) * static_cast<result>(b[i]);
+                }
+                EXPECT_EQ(sum(s), expected_sum) << n;
+                EXPECT_EQ(dot(s, make_span(b)), expected_dot) << n;
+            }
+        }
+    };
+
+    TEST_P(ReduceTest, MatchesStd)
+    {
+        check_matches_std<std::int32_t>();
+        check_matches_std<std::uint32_t>();
+        check_matches_std<std::uint8_t>();
+        check_matches_std<float>();
+        check_matches_std<std::int16_t>(); // no kernel, plain loops
+        check_matches_std<double>();
+    }
+
+    TEST_P(ReduceTest, FirstExtremum)
+    {
+        // Ties resolve to the first occurrence, whichever vector lane holds it.
+        std::vector<std::int32_t> v(200, 5);
+        v[150] = v[77] = -3;
+        v[190] = v[33] = 9;
+        EXPECT_EQ(argmin(make_span(v)), 77u);
+        EXPECT_EQ(argmax(make_span(v)), 33u);
+
+        std::vector<std::uint8_t> const single = {42};
+        EXPECT_EQ(argmin(make_span(single)), 0u);
+        EXPECT_EQ(minmax_value(make_span(single)), std::make_pair(std::uint8_t(42), std::uint8_t(42)));
+    }
+
+    TEST_P(ReduceTest, IntegerSumsDoNotOverflow)
+    {
+        std::vector<std::int32_t> const  big(1000, std::numeric_limits<std::int32_t>::max());
+        std::vector<std::uint8_t> const  bytes(100000, 255);
+        std::vector<std::uint32_t> const words(100, std::numeric_limits<std::uint32_t>::max());
+        EXPECT_EQ(sum(make_span(big)), 1000 * std::int64_t(std::numeric_limits<std::int32_t>::max()));
+        EXPECT_EQ(sum(make_span(bytes)), 100000u * 255u);
+        EXPECT_EQ(sum(make_span(words)), 100 * std::uint64_t(std::numeric_limits<std::uint32_t>::max()));
+        std::vector<std::int32_t> const wide(1000, -100000); // products past 32 bits
+        EXPECT_EQ(dot(make_span(wide), make_span(wide)), 1000 * std::int64_t(100000) * 100000);
+    }
+
+    TEST_P(ReduceTest, FloatSumsCloseToSerial)
+    {
+        std::mt19937                          gen(7);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        std::vector<float>                    a(10007), b(a.size());
+        for(std::size_t i = 0; i < a.size(); ++i)
+            a[i] = dist(gen), b[i] = dist(gen);
+
+        double expected_sum = 0, expected_dot = 0;
+        for(std::size_t i = 0; i < a.size(); ++i)
+            expected_sum += a[i], expected_dot += double(a[i]) * b[i];
+        EXPECT_NEAR(sum(make_span(a)), expected_sum, 1e-3);
+        EXPECT_NEAR(dot(make_span(a), make_span(b)), expected_dot, 1e-3);
+        EXPECT_EQ(sum(span<float const>()), 0.f);
+    }
+
+    TEST_P(ReduceTest, EmptySpan)
+    {
+        span<std::int32_t const> const empty;
+        EXPECT_EQ(sum(empty), 0);
+        EXPECT_EQ(dot(empty, empty), 0);
+        if(QS_DEBUG) // without the check, the empty span would be read
+        {
+            EXPECT_DEATH((void)min_value(empty), testing::HasSubstr("minmax_value: empty span"));
+        }
+        std::vector<std::int32_t> const one(1);
+        EXPECT_DEBUG_DEATH((void)dot(empty, make_span(one)), testing::HasSubstr("dot: span size mismatch"));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, ReduceTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,141 @@
+#include <test/test_header.h>
+
+#include <qs/algorithm/scan.h>
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class ScanTest : public simd_level_test
+    {
+    protected:
+        // Small integers for floats, so that every prefix sum is exact whatever the order of the additions.
+        template<class T>
+        static std::vector<T> values(std::size_t n, std::uint64_t seed)
+        {
+            std::mt19937_64 gen(seed);
+            std::vector<T>  v(n);
+            for(auto& x: v)
+                x = static_cast<T>(static_cast<int>(gen() % 201) - 100);
+            return v;
+        }
+
+        static constexpr std::size_t sizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 1000, 4097};
+
+        template<class T>
+        static void check_matches_std()
+        {
+            for(std::size_t n: sizes)
+            {
+                auto const     in = values<T>(n, n);
+                std::vector<T> expected(n), out(n), in_place = in;
+                std::partial_sum(in.begin(), in.end(), expected.begin());
+
+                inclusive_scan<T>(make_span(in), make_span(out));
+                EXPECT_EQ(out, expected) << n;
+                inclusive_scan(make_span(in_place));
+                EXPECT_EQ(in_place, expected) << n;
+            }
+        }
+
+        template<class T>
+        static void check_exclusive_matches_std()
+        {
+            for(std::size_t n: sizes)
+            {
+                auto const     in = values<T>(n, n);
+                std::vector<T> expected(n), out(n), in_place = in;
+                T              acc = T(5);
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    expected[i] = acc;
+                    acc += in[i];
+                }
+
+                exclusive_scan<T>(make_span(in), make_span(out), T(5));
+                EXPECT_EQ(out, expected) << n;
+                exclusive_scan(make_span(in_place), T(5));
+                EXPECT_EQ(in_place, expected) << n;
+            }
+        }
+    };
+
+    TEST_P(ScanTest, MatchesPartialSum)
+    {
+        check_matches_std<std::int32_t>();
+        check_matches_std<float>();
+        check_matches_std<std::int64_t>(); // no kernel, plain loop
+        check_matches_std<double>();
+    }
+
+    TEST_P(ScanTest, ExclusiveMatchesSerial)
+    {
+        check_exclusive_matches_std<std::int32_t>();
+        check_exclusive_matches_std<float>();
+        check_exclusive_matches_std<std::int64_t>();
+        check_exclusive_matches_std<double>();
+    }
+
+    // Past the size at which the parts get a thread each, with uneven parts.
+    TEST_P(ScanTest, Threaded)
+    {
+        std::size_t const         n  = 3 * intl::parallel_scan_min_part + 1001;
+        auto const                in = values<std::int32_t>(n, 7);
+        std::vector<std::int32_t> inclusive(n), exclusive(n);
+        std::partial_sum(in.begin(), in.end(), inclusive.begin());
+        for(std::size_t i = 0; i < n; ++i)
+            exclusive[i] = inclusive[i] - in[i] - 1;
+
+        for(unsigned threads: {0u, 1u, 2u, 3u, 8u})
+        {
+            std::vector<std::int32_t> out(n), in_place = in;
+            inclusive_scan<std::int32_t>(make_span(in), make_span(out), threads);
+            EXPECT_EQ(out, inclusive) << threads;
+            inclusive_scan(make_span(in_place), threads);
+            EXPECT_EQ(in_place, inclusive) << threads;
+
+            in_place = in;
+            exclusive_scan<std::int32_t>(make_span(in), make_span(out), -1, threads);
+            EXPECT_EQ(out, exclusive) << threads;
+            exclusive_scan(make_span(in_place), -1, threads);
+            EXPECT_EQ(in_place, exclusive) << threads;
+        }
+
+        // no kernel for 64-bit integers, same split
+        std::vector<std::int64_t> const wide(in.begin(), in.end());
+        std::vector<std::int64_t>       out(n), expected(n);
+        std::partial_sum(wide.begin(), wide.end(), expected.begin());
+        inclusive_scan<std::int64_t>(make_span(wide), make_span(out), 4);
+        EXPECT_EQ(out, expected);
+    }
+
+    TEST_P(ScanTest, UnsignedWraps)
+    {
+        std::vector<std::uint32_t> v(40, std::numeric_limits<std::uint32_t>::max());
+        inclusive_scan(make_span(v));
+        for(std::size_t i = 0; i < v.size(); ++i)
+            EXPECT_EQ(v[i], std::uint32_t(0) - static_cast<std::uint32_t>(i + 1));
+    }
+
+    TEST_P(ScanTest, SizeMismatch)
+    {
+        std::vector<int> const in(3);
+        std::vector<int>       out(2);
+        EXPECT_DEBUG_DEATH(inclusive_scan<int>(make_span(in), make_span(out)),
+                           testing::HasSubstr("inclusive_scan: span size mismatch"));
+        EXPECT_DEBUG_DEATH(exclusive_scan<int>(make_span(in), make_span(out)),
+                           testing::HasSubstr("exclusive_scan: span size mismatch"));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, ScanTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
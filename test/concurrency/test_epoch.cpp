@@ -0,0 +1,194 @@
+#include <test/test_header.h>
+
+#include <qs/concurrency/epoch.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static std::atomic<std::size_t> epoch_live_nodes{0};
+
+    struct EpochNode
+    {
+        explicit EpochNode(int v)
+            : value(v)
+        {
+            epoch_live_nodes.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~EpochNode() { epoch_live_nodes.fetch_sub(1, std::memory_order_relaxed); }
+
+        int        value;
+        EpochNode* next = nullptr;
+    };
+
+    // Treiber stack, pop() is only safe because popped nodes are retired through the epoch domain
+    struct EpochStack
+    {
+        std::atomic<EpochNode*> head{nullptr};
+
+        void push(epoch_handle& h, int v)
+        {
+            auto  guard = h.pin();
+            auto* node  = new EpochNode(v);
+            node->next  = head.load(std::memory_order_relaxed);
+            while(!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+            {}
+        }
+
+        bool pop(epoch_handle& h, int& out)
+        {
+            auto       guard = h.pin();
+            EpochNode* node  = head.load(std::memory_order_acquire);
+            while(node != nullptr &&
+                  !head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_acquire))
+            {}
+            if(node == nullptr)
+                return false;
+            out = node->value;
+            h.retire(node);
+            return true;
+        }
+    };
+
+    TEST(Epoch, RetireIsDeferredWhilePinned)
+    {
+        epoch_domain domain(4, 1);
+        auto         reader = domain.register_thread();
+        auto         writer = domain.register_thread();
+
+        epoch_live_nodes = 0;
+        {
+            auto guard = reader.pin();
+            writer.retire(new EpochNode(1));
+            writer.collect();
+            writer.collect();
+            writer.collect();
+            EXPECT_EQ(epoch_live_nodes.load(), 1u);
+            EXPECT_EQ(writer.pending(), 1u);
+        }
+        writer.flush();
+        EXPECT_EQ(epoch_live_nodes.load(), 0u);
+        EXPECT_EQ(writer.pending(), 0u);
+    }
+
+    TEST(Epoch, RetireWithFunctionPointer)
+    {
+        epoch_domain domain(4, 64);
+        auto         h = domain.register_thread();
+
+        epoch_live_nodes = 0;
+        void (*del)(void*) = [](void* p) { delete static_cast<EpochNode*>(p); };
+        h.retire(new EpochNode(1), del);
+        h.retire(new EpochNode(2), +[](void* p) { delete static_cast<EpochNode*>(p); });
+        EXPECT_EQ(h.pending(), 2u);
+        h.flush();
+        EXPECT_EQ(epoch_live_nodes.load(), 0u);
+    }
+
+    TEST(Epoch, NestedPin)
+    {
+        epoch_domain domain(2);
+        auto         h = domain.register_thread();
+        {
+            auto g1 = h.pin();
+            {
+                auto g2 = h.pin();
+                EXPECT_TRUE(h.is_pinned());
+            }
+            EXPECT_TRUE(h.is_pinned());
+        }
+        EXPECT_FALSE(h.is_pinned());
+    }
+
+    TEST(Epoch, BatchedReclamation)
+    {
+        epoch_domain domain(1, 16);
+        auto         h = domain.register_thread();
+
+        epoch_live_nodes = 0;
+        for(int i = 0; i < 1000; ++i)
+            h.retire(new EpochNode(i));
+        EXPECT_LT(h.pending(), 1000u);
+        h.flush();
+        EXPECT_EQ(epoch_live_nodes.load(), 0u);
+    }
+
+    TEST(Epoch, OrphanedRetiredObjectsAreReclaimed)
+    {
+        epoch_live_nodes = 0;
+        {
+            epoch_domain domain(4);
+            auto         keeper = domain.register_thread();
+            {
+                auto guard = keeper.pin();
+                auto tmp   = domain.register_thread();
+                tmp.retire(new EpochNode(1));
+            }
+            EXPECT_EQ(epoch_live_nodes.load(), 1u);
+            keeper.flush();
+            domain.try_advance();
+            domain.try_advance();
+            domain.collect_orphans();
+            EXPECT_EQ(epoch_live_nodes.load(), 0u);
+        }
+        EXPECT_EQ(epoch_live_nodes.load(), 0u);
+    }
+
+    TEST(Epoch, RegisterTooManyThreads)
+    {
+        epoch_domain domain(1);
+        auto         h = domain.register_thread();
+        EXPECT_THROW(domain.register_thread(), std::length_error);
+    }
+
+    TEST(Epoch, StressTreiberStack)
+    {
+        constexpr int n_threads = 8;
+        constexpr int n_ops     = 20000;
+
+        epoch_live_nodes = 0;
+        {
+            epoch_domain     domain(n_threads);
+            EpochStack       stack;
+            std::atomic<int> popped_sum{0};
+
+            std::vector<std::thread> threads;
+            for(int t = 0; t < n_threads; ++t)
+            {
+                threads.emplace_back(
+                    [&, t]
+                    {
+                        auto h     = domain.register_thread();
+                        int  local = 0;
+                        for(int i = 0; i < n_ops; ++i)
+                        {
+                            stack.push(h, 1);
+                            int v = 0;
+                            if((i + t) % 2 == 0 && stack.pop(h, v))
+                                local += v;
+                        }
+                        popped_sum.fetch_add(local, std::memory_order_relaxed);
+                    });
+            }
+            for(auto& th: threads)
+                th.join();
+
+            auto h     = domain.register_thread();
+            int  v     = 0;
+            int  total = popped_sum.load();
+            while(stack.pop(h, v))
+                total += v;
+            h.flush();
+
+            EXPECT_EQ(total, n_threads * n_ops);
+        }
+        EXPECT_EQ(epoch_live_nodes.load(), 0u);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,98 @@
+#include <test/test_header.h>
+
+#include <qs/concurrency/seqlock.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    struct SeqlockSnapshot
+    {
+        std::uint64_t values[20]; // spans three cache lines
+        std::uint32_t tail;
+    };
+
+    TEST(Seqlock, LoadStore)
+    {
+        seqlock<SeqlockSnapshot> lock;
+        EXPECT_EQ(lock.version(), 0u);
+
+        SeqlockSnapshot s{};
+        for(std::uint64_t i = 0; i < 20; ++i)
+            s.values[i] = i;
+        s.tail = 7;
+        lock.store(s);
+        EXPECT_EQ(lock.version(), 2u);
+
+        SeqlockSnapshot r = lock.load();
+        for(std::uint64_t i = 0; i < 20; ++i)
+            EXPECT_EQ(r.values[i], i);
+        EXPECT_EQ(r.tail, 7u);
+
+        lock.update([](SeqlockSnapshot& v) { v.tail = 9; });
+        EXPECT_TRUE(lock.try_load(r));
+        EXPECT_EQ(r.tail, 9u);
+        EXPECT_EQ(r.values[19], 19u);
+        EXPECT_EQ(lock.version(), 4u);
+    }
+
+    TEST(Seqlock, OddSizedPayload)
+    {
+        struct Small
+        {
+            char c[3];
+        };
+        seqlock<Small> lock(Small{{'a', 'b', 'c'}});
+        Small const    r = lock.load();
+        EXPECT_EQ(r.c[0], 'a');
+        EXPECT_EQ(r.c[2], 'c');
+    }
+
+    TEST(Seqlock, ReadersNeverObserveTornSnapshots)
+    {
+        seqlock<SeqlockSnapshot> lock;
+        std::atomic<bool>        done{false};
+        std::atomic<int>         torn{0};
+
+        std::vector<std::thread> readers;
+        for(int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back(
+                [&]
+                {
+                    while(!done.load(std::memory_order_relaxed))
+                    {
+                        SeqlockSnapshot const s = lock.load();
+                        for(auto v: s.values)
+                            if(v != s.values[0])
+                                torn.fetch_add(1, std::memory_order_relaxed);
+                        if(s.tail != static_cast<std::uint32_t>(s.values[0]))
+                            torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+        }
+
+        for(std::uint64_t n = 1; n <= 200000; ++n)
+        {
+            SeqlockSnapshot s;
+            for(auto& v: s.values)
+                v = n;
+            s.tail = static_cast<std::uint32_t>(n);
+            lock.store(s);
+        }
+        done = true;
+        for(auto& th: readers)
+            th.join();
+
+        EXPECT_EQ(torn.load(), 0);
+        EXPECT_EQ(lock.load().values[0], 200000u);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
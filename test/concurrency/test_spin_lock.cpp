@@ -0,0 +1,69 @@
+#include <test/test_header.h>
+
+#include <qs/concurrency/spin_lock.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    template<class Lockable>
+    struct SpinLockTest : testing::Test
+    {};
+
+    using LockTypes = testing::Types<spin_lock, hybrid_mutex, basic_hybrid_mutex<0>>;
+    TYPED_TEST_SUITE(SpinLockTest, LockTypes);
+
+    TYPED_TEST(SpinLockTest, IsCacheLinePadded)
+    {
+        EXPECT_EQ(alignof(TypeParam), static_cast<std::size_t>(QS_CACHELINE_SIZE));
+        EXPECT_EQ(sizeof(TypeParam), static_cast<std::size_t>(QS_CACHELINE_SIZE));
+    }
+
+    TYPED_TEST(SpinLockTest, TryLock)
+    {
+        TypeParam m;
+        EXPECT_TRUE(m.try_lock());
+        EXPECT_FALSE(m.try_lock());
+        m.unlock();
+        {
+            std::lock_guard<TypeParam> lock(m);
+            EXPECT_FALSE(m.try_lock());
+        }
+        EXPECT_TRUE(m.try_lock());
+        m.unlock();
+    }
+
+    TYPED_TEST(SpinLockTest, MutualExclusion)
+    {
+        constexpr int n_threads = 8;
+        constexpr int n_iters   = 20000;
+
+        TypeParam m;
+        long      counter = 0;
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < n_threads; ++t)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for(int i = 0; i < n_iters; ++i)
+                    {
+                        std::lock_guard<TypeParam> lock(m);
+                        ++counter;
+                    }
+                });
+        }
+        for(auto& th: threads)
+            th.join();
+
+        EXPECT_EQ(counter, static_cast<long>(n_threads) * n_iters);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
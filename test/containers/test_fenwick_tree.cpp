@@ -1,5 +1,6 @@
 #include "test/test_header.h"
 
+#include <algorithm>
 #include <vector>
 #include "qs/containers/fenwick_tree.h"
 
@@ -70,6 +71,35 @@ namespace test
         }
     }
 
+    // The bulk builds (a scan and differences for 32-bit integers, in-place otherwise) against single updates.
+    template<class T>
+    static void check_builds_match_updates()
+    {
+        for(size_t sz = 1; sz <= lst1.size(); ++sz)
+        {
+            std::vector<T> const vec(lst1.begin(), lst1.begin() + sz);
+            FenwickTree<T>       expected(vec.size());
+            for(size_t i = 0; i < vec.size(); ++i)
+                expected.update(i, vec[i]);
+
+            FenwickTree<T> const tree(vec.begin(), vec.end());
+            EXPECT_TRUE(std::equal(tree.data(), tree.data() + sz + 1, expected.data())) << sz;
+
+            FenwickTree<T> filled(sz, T(3)), filled_expected(sz);
+            for(size_t i = 0; i < sz; ++i)
+                filled_expected.update(i, T(3));
+            EXPECT_TRUE(std::equal(filled.data(), filled.data() + sz + 1, filled_expected.data())) << sz;
+        }
+    }
+
+    TEST(FenwickTree, BuildMatchesUpdates)
+    {
+        check_builds_match_updates<int>();
+        check_builds_match_updates<unsigned>();
+        check_builds_match_updates<long long>();
+        check_builds_match_updates<double>();
+    }
+
     TEST(FenwickTree, Resize)
     {
         for(size_t sz = 1; sz <= lst1.size(); ++sz)
@@ -0,0 +1,257 @@
+#include <test/test_header.h>
+
+#include <qs/containers/flat_hash_map.h>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    template<class Map, class Reference>
+    static void expect_same(Map const& map, Reference const& reference)
+    {
+        ASSERT_EQ(map.size(), reference.size());
+        std::size_t visited = 0;
+        for(auto const& kv: map)
+        {
+            auto const it = reference.find(kv.first);
+            ASSERT_NE(it, reference.end());
+            EXPECT_EQ(kv.second, it->second);
+            ++visited;
+        }
+        EXPECT_EQ(visited, reference.size());
+    }
+
+    TEST(FlatHashMap, MatchesUnorderedMap)
+    {
+        std::mt19937_64                                gen(5);
+        flat_hash_map<std::uint64_t, std::string>      map;
+        std::unordered_map<std::uint64_t, std::string> reference;
+        for(int step = 0; step < 20000; ++step)
+        {
+            std::uint64_t const key = gen() % 2000;
+            switch(gen() % 4)
+            {
+                case 0:
+                {
+                    std::string const value = std::to_string(step);
+                    EXPECT_EQ(map.try_emplace(key, value).second, reference.try_emplace(key, value).second);
+                    break;
+                }
+                case 1: EXPECT_EQ(map.erase(key), reference.erase(key)); break;
+                case 2:
+                    map[key] += "x";
+                    reference[key] += "x";
+                    break;
+                case 3:
+                    EXPECT_EQ(map.count(key), reference.count(key));
+                    if(map.contains(key))
+                    {
+                        EXPECT_EQ(map.at(key), reference.at(key));
+                    }
+                    break;
+            }
+        }
+        expect_same(map, reference);
+        EXPECT_LE(map.size(), map.capacity() - map.capacity() / 8);
+    }
+
+    // Every key in one probe sequence: the lookups rely on the control bytes and the tombstones alone.
+    TEST(FlatHashMap, Collisions)
+    {
+        struct constant_hash
+        {
+            std::size_t operator()(int) const noexcept { return 42; }
+        };
+        flat_hash_map<int, int, constant_hash> map;
+        for(int k = 0; k < 300; ++k)
+            EXPECT_TRUE(map.insert({k, -k}).second);
+        for(int k = 0; k < 300; k += 2)
+            EXPECT_EQ(map.erase(k), 1u);
+        for(int k = 0; k < 300; ++k)
+            EXPECT_EQ(map.contains(k), k % 2 == 1);
+        for(int k = 0; k < 300; k += 2)
+            EXPECT_TRUE(map.try_emplace(k, k).second);
+        EXPECT_EQ(map.size(), 300u);
+        EXPECT_EQ(map.at(7), -7);
+        EXPECT_EQ(map.at(8), 8);
+    }
+
+    TEST(FlatHashMap, ReserveDoesNotRehash)
+    {
+        flat_hash_map<std::uint32_t, std::uint32_t> map;
+        map.reserve(1000);
+        std::size_t const capacity = map.capacity();
+        EXPECT_GE(capacity - capacity / 8, 1000u);
+        auto const* first = &*map.try_emplace(0u, 0u).first;
+        for(std::uint32_t k = 1; k < 1000; ++k)
+            map.try_emplace(k, k);
+        EXPECT_EQ(map.capacity(), capacity);
+        EXPECT_EQ(&*map.find(0u), first);
+
+        map.reserve(500);
+        EXPECT_EQ(map.capacity(), capacity);
+        map.clear();
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(map.capacity(), capacity);
+        EXPECT_EQ(map.begin(), map.end());
+    }
+
+    // Doubling the capacity for such a count would wrap to zero.
+    TEST(FlatHashMap, ReserveTooManyThrows)
+    {
+        flat_hash_map<std::uint32_t, std::uint32_t> map;
+        EXPECT_THROW(map.reserve(SIZE_MAX), std::length_error);
+        EXPECT_THROW(map.reserve(SIZE_MAX / 2), std::length_error);
+        EXPECT_THROW((flat_hash_map<std::uint32_t, std::uint32_t>(SIZE_MAX / 4)), std::length_error);
+        EXPECT_EQ(map.capacity(), 0u);
+        map.try_emplace(1u, 1u);
+        EXPECT_EQ(map.at(1u), 1u);
+    }
+
+    // Tombstones leave too little room for `reserve(n)` with `n` below the load: the table is rebuilt, not shrunk.
+    TEST(FlatHashMap, ReserveNeverShrinks)
+    {
+        struct constant_hash
+        {
+            std::size_t operator()(int) const noexcept { return 42; }
+        };
+        flat_hash_map<int, int, constant_hash> map;
+        for(int k = 0; k < 112; ++k) // 7/8 of 128, every group full but the last
+            map.try_emplace(k, -k);
+        std::size_t const capacity = map.capacity();
+        ASSERT_EQ(capacity, 128u);
+        for(int k = 0; k < 100; ++k)
+            EXPECT_EQ(map.erase(k), 1u);
+
+        map.reserve(50);
+        EXPECT_EQ(map.capacity(), capacity);
+        EXPECT_EQ(map.size(), 12u);
+        for(int k = 100; k < 112; ++k)
+            EXPECT_EQ(map.at(k), -k);
+        for(int k = 0; k < 38; ++k)
+            map.try_emplace(k, k);
+        EXPECT_EQ(map.capacity(), capacity);
+    }
+
+    // Keys that are not standard layout are copied rather than moved by a rehash.
+    TEST(FlatHashMap, NonStandardLayoutKey)
+    {
+        struct key
+        {
+            std::string name;
+
+            explicit key(std::string s)
+                : name(std::move(s))
+            {}
+            bool operator==(key const& other) const { return name == other.name && tag_ == other.tag_; }
+
+        private:
+            int tag_ = 1;
+        };
+        struct key_hash
+        {
+            std::size_t operator()(key const& k) const { return std::hash<std::string>()(k.name); }
+        };
+        static_assert(!std::is_standard_layout<key>::value, "");
+
+        flat_hash_map<key, int, key_hash> map;
+        for(int i = 0; i < 1000; ++i)
+            map.try_emplace(key(std::string(20, 'k') + std::to_string(i)), i);
+        for(int i = 0; i < 1000; ++i)
+            EXPECT_EQ(map.at(key(std::string(20, 'k') + std::to_string(i))), i);
+    }
+
+    // Integers are not iterators: no iterator-pair overloads for them.
+    static_assert(!std::is_constructible<flat_hash_map<int, int>, int, int>::value, "");
+    static_assert(std::is_constructible<flat_hash_map<int, int>, std::pair<int, int> const*,
+                                        std::pair<int, int> const*>::value,
+                  "");
+
+    // Erase-insert churn at a fixed size reuses or purges the tombstones instead of growing the table.
+    TEST(FlatHashMap, ChurnKeepsCapacity)
+    {
+        flat_hash_map<std::uint64_t, std::uint64_t> map;
+        for(std::uint64_t k = 0; k < 1000; ++k)
+            map.try_emplace(k, k);
+        std::size_t const capacity = map.capacity();
+        for(std::uint64_t k = 1000; k < 100000; ++k)
+        {
+            EXPECT_EQ(map.erase(k - 1000), 1u);
+            map.try_emplace(k, k);
+        }
+        EXPECT_EQ(map.size(), 1000u);
+        EXPECT_EQ(map.capacity(), capacity);
+        for(std::uint64_t k = 99000; k < 100000; ++k)
+            EXPECT_EQ(map.at(k), k);
+    }
+
+    TEST(FlatHashMap, Heterogeneous)
+    {
+        flat_hash_map<std::string, int, string_hash, std::equal_to<>> map = {{"AAPL", 1}, {"MSFT", 2}};
+        std::string_view const                                       symbol = "MSFT";
+        EXPECT_EQ(map.find(symbol)->second, 2);
+        EXPECT_TRUE(map.contains("AAPL"));
+        EXPECT_EQ(map.count(std::string_view("GOOG")), 0u);
+        EXPECT_EQ(map.at("AAPL"), 1);
+        EXPECT_THROW(static_cast<void>(map.at("GOOG")), std::out_of_range);
+
+        EXPECT_TRUE(map.try_emplace(std::string_view("GOOG"), 3).second);
+        EXPECT_FALSE(map.try_emplace(std::string_view("GOOG"), 4).second);
+        EXPECT_EQ(map[std::string("GOOG")], 3);
+        EXPECT_EQ(map.erase(symbol), 1u);
+        EXPECT_FALSE(map.contains(symbol));
+        EXPECT_EQ(map.size(), 2u);
+    }
+
+    TEST(FlatHashMap, EraseWhileIterating)
+    {
+        flat_hash_map<int, std::string> map;
+        for(int k = 0; k < 500; ++k)
+            map.try_emplace(k, std::to_string(k));
+        for(auto it = map.begin(); it != map.end();)
+            it = it->first % 3 == 0 ? map.erase(it) : std::next(it);
+        EXPECT_EQ(map.size(), 333u);
+        for(int k = 0; k < 500; ++k)
+            EXPECT_EQ(map.contains(k), k % 3 != 0);
+    }
+
+    TEST(FlatHashMap, CopyAndMove)
+    {
+        flat_hash_map<int, std::string> map;
+        for(int k = 0; k < 100; ++k)
+            map.insert_or_assign(k, std::string(40, static_cast<char>('a' + k % 26)));
+        std::unordered_map<int, std::string> const reference(map.begin(), map.end());
+
+        flat_hash_map<int, std::string> copy(map);
+        expect_same(copy, reference);
+        flat_hash_map<int, std::string> moved(std::move(map));
+        expect_same(moved, reference);
+        EXPECT_TRUE(map.empty()); // NOLINT(bugprone-use-after-move)
+        EXPECT_EQ(map.begin(), map.end());
+
+        map = moved;
+        expect_same(map, reference);
+        copy.clear();
+        copy = std::move(moved);
+        expect_same(copy, reference);
+
+        flat_hash_map<int, std::string> const empty;
+        EXPECT_EQ(empty.find(3), empty.end());
+        EXPECT_EQ(empty.begin(), empty.end());
+        map = empty;
+        EXPECT_TRUE(map.empty());
+    }
+} // namespace test
+
+QS_NAMESPACE_END
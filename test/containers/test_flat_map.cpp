@@ -0,0 +1,207 @@
+#include <test/test_header.h>
+
+#include <qs/containers/flat_map.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    template<class Map, class Reference>
+    static void expect_same(Map const& map, Reference const& reference)
+    {
+        ASSERT_EQ(map.size(), reference.size());
+        auto it = map.begin();
+        for(auto const& kv: reference)
+        {
+            EXPECT_EQ(it->first, kv.first);
+            EXPECT_EQ(it->second, kv.second);
+            ++it;
+        }
+        EXPECT_EQ(it, map.end());
+    }
+
+    TEST(FlatMap, MatchesStdMap)
+    {
+        std::mt19937_64    gen(1);
+        flat_map<int, int> map;
+        std::map<int, int> reference;
+        for(int step = 0; step < 5000; ++step)
+        {
+            int const key = static_cast<int>(gen() % 500);
+            switch(gen() % 4)
+            {
+                case 0: EXPECT_EQ(map.insert({key, step}).second, reference.insert({key, step}).second); break;
+                case 1: EXPECT_EQ(map.erase(key), reference.erase(key)); break;
+                case 2: map[key] += step, reference[key] += step; break;
+                case 3:
+                    EXPECT_EQ(map.contains(key), reference.count(key) == 1);
+                    EXPECT_EQ(map.lower_bound(key) - map.begin(),
+                              std::distance(reference.begin(), reference.lower_bound(key)));
+                    EXPECT_EQ(map.upper_bound(key) - map.begin(),
+                              std::distance(reference.begin(), reference.upper_bound(key)));
+                    break;
+            }
+        }
+        expect_same(map, reference);
+    }
+
+    // Batches with duplicates, keys already in the map, keys before, between and after them.
+    TEST(FlatMap, InsertRange)
+    {
+        std::mt19937_64    gen(2);
+        flat_map<int, int> map;
+        std::map<int, int> reference;
+        for(std::size_t batch_size: {0, 1, 7, 100, 1000, 3})
+        {
+            std::vector<std::pair<int, int>> batch(batch_size);
+            for(auto& kv: batch)
+                kv = {static_cast<int>(gen() % 2000) - 1000, static_cast<int>(gen() % 100)};
+            map.insert_range(batch);
+            reference.insert(batch.begin(), batch.end()); // keeps the first of equivalent keys too
+            expect_same(map, reference);
+            EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+        }
+    }
+
+    TEST(FlatMap, Access)
+    {
+        flat_map<std::string, int> map = {{"bid", 1}, {"ask", 2}, {"bid", 3}};
+        EXPECT_EQ(map.size(), 2u);
+        EXPECT_EQ(map.at("bid"), 1);
+        EXPECT_THROW(static_cast<void>(map.at("fill")), std::out_of_range);
+        map["fill"] = 5;
+        EXPECT_EQ(map.insert_or_assign("ask", 7).second, false);
+        EXPECT_EQ(map.try_emplace("ask", 9).second, false);
+        EXPECT_EQ((std::vector<std::string>(map.keys().begin(), map.keys().end())),
+                  (std::vector<std::string>{"ask", "bid", "fill"}));
+        EXPECT_EQ((std::vector<int>(map.values().begin(), map.values().end())), (std::vector<int>{7, 1, 5}));
+
+        auto it = map.erase(map.find("ask"));
+        EXPECT_EQ(it->first, "bid");
+        EXPECT_EQ(map.find("ask"), map.end());
+        for(auto kv: map)
+            kv.second *= 10;
+        EXPECT_EQ(map.at("fill"), 50);
+
+        flat_map<std::string, int> const&          const_map = map;
+        flat_map<std::string, int>::const_iterator cit       = map.begin();
+        EXPECT_EQ(cit, const_map.find("bid"));
+        EXPECT_EQ(const_map.at("bid"), 10);
+    }
+
+    TEST(FlatMap, Heterogeneous)
+    {
+        flat_map<std::string, int, std::less<>> map = {{"quote", 1}, {"fill", 2}};
+        EXPECT_TRUE(map.contains("quote"));
+        EXPECT_EQ(map.find(std::string_view("fill"))->second, 2);
+        EXPECT_EQ(map.lower_bound("g")->first, "quote");
+
+        flat_map<int, int, std::greater<int>> descending = {{1, 1}, {3, 3}, {2, 2}};
+        EXPECT_EQ(descending.begin()->first, 3);
+        EXPECT_EQ(descending.lower_bound(2)->first, 2);
+    }
+
+    // Integers are not iterators: no iterator-pair overloads for them.
+    static_assert(!std::is_constructible<flat_map<int, int>, int, int>::value, "");
+    static_assert(std::is_constructible<flat_map<int, int>, std::pair<int, int>*, std::pair<int, int>*>::value, "");
+
+    // std::vector<bool> has no contiguous storage to iterate over, flags go in bytes or in place.
+    static_assert(!intl::has_contiguous_data<std::vector<bool>>::value, "");
+    static_assert(intl::has_contiguous_data<inplace_vector<bool, 4>>::value, "");
+
+    TEST(FlatMap, FlagsInBytes)
+    {
+        flat_map<std::string, std::uint8_t, std::less<>> halted = {{"MSFT", 0}, {"AAPL", 1}};
+        halted["GOOG"] = true;
+        EXPECT_TRUE(halted.at("AAPL"));
+        EXPECT_FALSE(halted.at("MSFT"));
+        EXPECT_TRUE(halted.find(std::string_view("GOOG"))->second);
+    }
+
+    // Copies fail once the budget runs out, moves may throw (not noexcept) and leave -1 behind.
+    struct ThrowingCopy
+    {
+        static int copy_budget;
+
+        int v = 0;
+
+        ThrowingCopy(int x)
+            : v(x)
+        {}
+        ThrowingCopy(ThrowingCopy const& o)
+            : v(o.v)
+        {
+            if(copy_budget-- == 0)
+                throw std::runtime_error("copy");
+        }
+        ThrowingCopy(ThrowingCopy&& o) // NOLINT(performance-noexcept-move-constructor)
+            : v(std::exchange(o.v, -1))
+        {}
+        ThrowingCopy& operator=(ThrowingCopy const&) = default;
+        ThrowingCopy& operator=(ThrowingCopy&& o) // NOLINT(performance-noexcept-move-constructor)
+        {
+            v = std::exchange(o.v, -1);
+            return *this;
+        }
+        friend bool operator==(ThrowingCopy const& l, ThrowingCopy const& r) { return l.v == r.v; }
+    };
+    int ThrowingCopy::copy_budget = -1;
+
+    TEST(FlatMap, InsertRangeThrowLeavesMapIntact)
+    {
+        flat_map<int, ThrowingCopy> map = {{1, 10}, {3, 30}, {5, 50}};
+        std::vector<std::pair<int, ThrowingCopy>> batch = {{2, 20}, {4, 40}};
+
+        // the batch is copied in, then the first element of the map, the second one throws
+        ThrowingCopy::copy_budget = 3;
+        EXPECT_THROW(map.insert_range(batch), std::runtime_error);
+        ThrowingCopy::copy_budget = -1;
+        expect_same(map, std::map<int, ThrowingCopy>{{1, 10}, {3, 30}, {5, 50}});
+
+        map.insert_range(batch);
+        expect_same(map, std::map<int, ThrowingCopy>{{1, 10}, {2, 20}, {3, 30}, {4, 40}, {5, 50}});
+    }
+
+    TEST(FlatMap, Inplace)
+    {
+        inplace_flat_map<std::int64_t, std::uint32_t, 4> map;
+        map.insert({30, 3});
+        map.insert_range(std::vector<std::pair<std::int64_t, std::uint32_t>>{{10, 1}, {20, 2}, {30, 9}});
+        map[40] = 4;
+        expect_same(map, std::map<std::int64_t, std::uint32_t>{{10, 1}, {20, 2}, {30, 3}, {40, 4}});
+
+        // Full: a new key throws and leaves the map as it was, existing ones are still found.
+        EXPECT_THROW(map.insert({50, 5}), std::bad_alloc);
+        EXPECT_THROW(map.insert_range(std::vector<std::pair<std::int64_t, std::uint32_t>>{{20, 0}, {5, 0}}),
+                     std::bad_alloc);
+        EXPECT_FALSE(map.insert({20, 0}).second);
+        expect_same(map, std::map<std::int64_t, std::uint32_t>{{10, 1}, {20, 2}, {30, 3}, {40, 4}});
+
+        // Batches longer than the capacity stage only their new keys, the first of equivalent ones.
+        inplace_flat_map<int, int, 2> small;
+        small.insert({{1, 1}, {1, 2}, {2, 2}, {1, 3}, {2, 4}, {2, 5}});
+        expect_same(small, std::map<int, int>{{1, 1}, {2, 2}});
+        small.insert_range(std::vector<std::pair<int, int>>(10, {2, 0}));
+        expect_same(small, std::map<int, int>{{1, 1}, {2, 2}});
+
+        auto copy = map;
+        copy.erase(20);
+        EXPECT_EQ(copy.size(), 3u);
+        EXPECT_EQ(map.size(), 4u);
+        EXPECT_EQ(copy.find(30)->second, 3u);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,97 @@
+#include <test/test_header.h>
+
+#include <qs/containers/flat_set.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    TEST(FlatSet, MatchesStdSet)
+    {
+        std::mt19937_64    gen(3);
+        flat_set<unsigned> set;
+        std::set<unsigned> reference;
+        for(int step = 0; step < 5000; ++step)
+        {
+            unsigned const key = static_cast<unsigned>(gen() % 300);
+            switch(gen() % 3)
+            {
+                case 0: EXPECT_EQ(set.insert(key).second, reference.insert(key).second); break;
+                case 1: EXPECT_EQ(set.erase(key), reference.erase(key)); break;
+                case 2:
+                    EXPECT_EQ(set.count(key), reference.count(key));
+                    EXPECT_EQ(set.upper_bound(key) - set.begin(),
+                              std::distance(reference.begin(), reference.upper_bound(key)));
+                    break;
+            }
+        }
+        EXPECT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+    }
+
+    TEST(FlatSet, InsertRange)
+    {
+        std::mt19937_64           gen(4);
+        flat_set<std::int64_t>    set = {5, 1, 5, 3};
+        std::set<std::int64_t>    reference(set.begin(), set.end());
+        std::vector<std::int64_t> batch;
+        for(std::size_t batch_size: {0, 1, 10, 1000, 1000})
+        {
+            batch.resize(batch_size);
+            for(auto& k: batch)
+                k = static_cast<std::int64_t>(gen() % 3000) - 1000;
+            set.insert_range(batch);
+            reference.insert(batch.begin(), batch.end());
+            EXPECT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+        }
+    }
+
+    TEST(FlatSet, Heterogeneous)
+    {
+        flat_set<std::string, std::less<>> const set = {"ask", "bid", "fill"};
+        EXPECT_TRUE(set.contains("bid"));
+        EXPECT_EQ(set.count("quote"), 0u);
+        EXPECT_EQ(*set.lower_bound("b"), "bid");
+        EXPECT_EQ(set.upper_bound("bid") - set.begin(), 2);
+    }
+
+    // Integers are not iterators: no iterator-pair overloads for them.
+    static_assert(!std::is_constructible<flat_set<int>, int, int>::value, "");
+    static_assert(std::is_constructible<flat_set<int>, int const*, int const*>::value, "");
+
+    TEST(FlatSet, Inplace)
+    {
+        inplace_flat_set<int, 4> set = {3, 1};
+        set.insert_range(std::vector<int>{2, 3, 2});
+        EXPECT_EQ((std::vector<int>(set.begin(), set.end())), (std::vector<int>{1, 2, 3}));
+
+        // The batch does not fit: the set is left as it was.
+        EXPECT_THROW(set.insert_range(std::vector<int>{7, 8}), std::bad_alloc);
+        EXPECT_EQ((std::vector<int>(set.begin(), set.end())), (std::vector<int>{1, 2, 3}));
+        EXPECT_TRUE(set.insert(0).second);
+        EXPECT_THROW(set.insert(9), std::bad_alloc);
+        set.insert_range(std::vector<int>{3, 0, 1, 3, 3, 0, 1, 1});
+        EXPECT_EQ((std::vector<int>(set.begin(), set.end())), (std::vector<int>{0, 1, 2, 3}));
+        EXPECT_EQ(set.erase(2), 1u);
+        EXPECT_EQ((std::vector<int>(set.begin(), set.end())), (std::vector<int>{0, 1, 3}));
+    }
+
+    TEST(FlatSet, InplaceBool)
+    {
+        inplace_flat_set<bool, 2> flags = {true, false, true};
+        EXPECT_EQ(flags.size(), 2u);
+        EXPECT_EQ(*flags.begin(), false);
+        EXPECT_TRUE(flags.contains(true));
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,94 @@
+#include <test/test_header.h>
+
+#include <qs/containers/inplace_vector.h>
+
+#include <list>
+#include <new>
+#include <string>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    template<class Vector>
+    static std::vector<typename Vector::value_type> elements(Vector const& v)
+    {
+        return {v.begin(), v.end()};
+    }
+
+    TEST(InplaceVector, InsertErase)
+    {
+        inplace_vector<int, 8> v;
+        v.push_back(1);
+        v.emplace_back(3);
+        v.insert(v.begin() + 1, 2);
+        v.insert(v.begin(), 0);
+        v.insert(v.end(), 4);
+        EXPECT_EQ(elements(v), (std::vector<int>{0, 1, 2, 3, 4}));
+        EXPECT_EQ(*v.erase(v.begin() + 1), 2);
+        auto const last = v.erase(v.begin() + 2, v.end());
+        EXPECT_EQ(last, v.end());
+        EXPECT_EQ(elements(v), (std::vector<int>{0, 2}));
+    }
+
+    TEST(InplaceVector, NonTrivial)
+    {
+        inplace_vector<std::string, 4> v(2, "x");
+        v.insert(v.begin(), "a");
+        v.insert(v.begin() + 1, v[0]); // the inserted value aliases an element
+        EXPECT_EQ(elements(v), (std::vector<std::string>{"a", "a", "x", "x"}));
+        v.erase(v.begin() + 1, v.begin() + 3);
+        EXPECT_EQ(elements(v), (std::vector<std::string>{"a", "x"}));
+
+        std::list<std::string> const         l = {"p", "q"};
+        inplace_vector<std::string, 4> const from_list(l.begin(), l.end());
+        EXPECT_EQ(elements(from_list), (std::vector<std::string>{"p", "q"}));
+    }
+
+    // Copies point into their own storage.
+    TEST(InplaceVector, Copy)
+    {
+        inplace_vector<int, 4> a(3, 7);
+        inplace_vector<int, 4> b(a);
+        a[0] = 1;
+        EXPECT_NE(b.data(), a.data());
+        EXPECT_EQ(elements(b), (std::vector<int>{7, 7, 7}));
+        b = a;
+        a.clear();
+        EXPECT_EQ(elements(b), (std::vector<int>{1, 7, 7}));
+    }
+
+    // Growing assignments overwrite the live elements and append the rest behind them.
+    TEST(InplaceVector, AssignOverNonEmpty)
+    {
+        inplace_vector<int, 8> v{1, 2};
+        v.assign(5, 7);
+        EXPECT_EQ(elements(v), (std::vector<int>(5, 7)));
+        v.assign(2, 3);
+        EXPECT_EQ(elements(v), (std::vector<int>{3, 3}));
+        std::vector<int> const src = {4, 5, 6, 7};
+        v.assign(src.begin(), src.end());
+        EXPECT_EQ(elements(v), src);
+        v.assign({8, 9});
+        EXPECT_EQ(elements(v), (std::vector<int>{8, 9}));
+
+        inplace_vector<std::string, 8> s(2, "a");
+        s.assign(4, "b");
+        EXPECT_EQ(elements(s), (std::vector<std::string>(4, "b")));
+    }
+
+    TEST(InplaceVector, Full)
+    {
+        inplace_vector<int, 2> v;
+        v.push_back(1);
+        EXPECT_NE(v.try_emplace_back(2), nullptr);
+        EXPECT_EQ(v.try_emplace_back(3), nullptr);
+        EXPECT_THROW(v.push_back(3), std::bad_alloc);
+        EXPECT_THROW(v.insert(v.begin(), 0), std::bad_alloc);
+        EXPECT_EQ(elements(v), (std::vector<int>{1, 2}));
+    }
+} // namespace test
+
+QS_NAMESPACE_END
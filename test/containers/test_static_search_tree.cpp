@@ -0,0 +1,115 @@
+#include <test/test_header.h>
+
+#include <qs/containers/static_search_tree.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class StaticSearchTreeTest : public simd_level_test
+    {
+    protected:
+        // Sorted keys with runs of duplicates, spread over a range wider than their count.
+        template<class T>
+        static std::vector<T> sorted_keys(std::size_t n, std::uint64_t seed)
+        {
+            std::mt19937_64 gen(seed);
+            std::vector<T>  v(n);
+            for(auto& x: v)
+                x = static_cast<T>(static_cast<std::int64_t>(gen() % (2 * n + 1)) - static_cast<std::int64_t>(n / 2));
+            std::sort(v.begin(), v.end());
+            return v;
+        }
+
+        // Sizes around a node, a full level of children (16 + 17 * 16 keys) and a few more levels.
+        static constexpr std::size_t sizes[] = {0, 1, 2, 15, 16, 17, 31, 32, 33, 287, 288, 289, 1000, 5000, 70001};
+
+        template<class T>
+        static void check_matches_std()
+        {
+            for(std::size_t n: sizes)
+            {
+                auto const                  v = sorted_keys<T>(n, n);
+                static_search_tree<T> const tree(make_span(v));
+                EXPECT_EQ(tree.size(), n);
+                EXPECT_EQ(tree.empty(), n == 0);
+                long long const lo = -static_cast<long long>(n) - 2;
+                long long const hi = 2 * static_cast<long long>(n) + 2;
+                for(long long q = lo; q <= hi; ++q)
+                {
+                    if(std::is_unsigned<T>::value && q < 0)
+                        continue;
+                    auto const        x        = static_cast<T>(q);
+                    std::size_t const expected = static_cast<std::size_t>(std::lower_bound(v.begin(), v.end(), x) -
+                                                                          v.begin());
+                    ASSERT_EQ(tree.lower_bound(x), expected) << n << ' ' << q;
+                    ASSERT_EQ(tree.contains(x), expected < n && v[expected] == x) << n << ' ' << q;
+                }
+            }
+        }
+    };
+
+    TEST_P(StaticSearchTreeTest, MatchesStd)
+    {
+        check_matches_std<std::int32_t>();
+        check_matches_std<std::uint32_t>();
+        check_matches_std<float>();
+        check_matches_std<std::int64_t>(); // 8 keys to a node, no kernel
+        check_matches_std<std::int16_t>(); // 32 keys to a node, no kernel
+    }
+
+    // Keys at the extremes of the type, which the unsigned AVX2 comparison must not order as signed.
+    TEST_P(StaticSearchTreeTest, Extremes)
+    {
+        using limits                        = std::numeric_limits<std::uint32_t>;
+        std::vector<std::uint32_t> const  v = {0, 1, 0x7FFFFFFF, 0x80000000, 0x80000001, limits::max()};
+        static_search_tree<std::uint32_t> tree(make_span(v));
+        for(std::uint32_t x: {0u, 1u, 2u, 0x7FFFFFFFu, 0x80000000u, 0x80000001u, 0x90000000u, limits::max()})
+            EXPECT_EQ(tree.lower_bound(x), static_cast<std::size_t>(std::lower_bound(v.begin(), v.end(), x) -
+                                                                    v.begin()))
+                << x;
+
+        std::vector<std::int32_t> const s = {std::numeric_limits<std::int32_t>::min(), -1, 0,
+                                             std::numeric_limits<std::int32_t>::max()};
+        static_search_tree<std::int32_t> signed_tree(make_span(s));
+        EXPECT_EQ(signed_tree.lower_bound(std::numeric_limits<std::int32_t>::min()), 0u);
+        EXPECT_EQ(signed_tree.lower_bound(-2), 1u);
+        EXPECT_EQ(signed_tree.lower_bound(std::numeric_limits<std::int32_t>::max()), 3u);
+    }
+
+    TEST_P(StaticSearchTreeTest, Comparator)
+    {
+        // Any comparator but `std::less` takes the scalar search, whatever the key type.
+        std::vector<std::int32_t> v(1000);
+        for(std::size_t i = 0; i < v.size(); ++i)
+            v[i] = static_cast<std::int32_t>(2000 - 2 * i);
+        static_search_tree<std::int32_t, std::greater<>> const tree(make_span(v));
+        EXPECT_EQ(tree.lower_bound(2001), 0u);
+        EXPECT_EQ(tree.lower_bound(1001), 500u);
+        EXPECT_EQ(tree.lower_bound(1000), 500u);
+        EXPECT_EQ(tree.lower_bound(1), 1000u);
+        EXPECT_TRUE(tree.contains(2));
+        EXPECT_FALSE(tree.contains(3));
+    }
+
+    TEST(StaticSearchTree, DefaultConstructed)
+    {
+        static_search_tree<float> const tree;
+        EXPECT_TRUE(tree.empty());
+        EXPECT_EQ(tree.lower_bound(1.f), 0u);
+        EXPECT_FALSE(tree.contains(1.f));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, StaticSearchTreeTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
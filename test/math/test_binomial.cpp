@@ -0,0 +1,126 @@
+#include <test/test_header.h>
+
+#include <qs/math/binomial.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    using mint = mod_int<998244353>;
+
+    constexpr binomial_table<mint, 64> compile_time_table;
+    static_assert(compile_time_table(10, 3) == mint(120), "built at compile time");
+    static_assert(compile_time_table(3, 10) == mint(0), "k > n");
+    static_assert(compile_time_table(63, 31) == mint(320977407), "C(63, 31) mod p");
+
+    // C(n, k) mod m from Pascal's triangle, rows 0..n_max.
+    static std::vector<std::vector<std::uint32_t>> pascal(std::size_t n_max, std::uint32_t m)
+    {
+        std::vector<std::vector<std::uint32_t>> rows(n_max + 1);
+        for(std::size_t n = 0; n <= n_max; ++n)
+        {
+            rows[n].assign(n + 1, 1 % m);
+            for(std::size_t k = 1; k < n; ++k)
+                rows[n][k] = (rows[n - 1][k - 1] + rows[n - 1][k]) % m;
+        }
+        return rows;
+    }
+
+    TEST(BinomialTable, MatchesPascal)
+    {
+        binomial_table<mint> const table(300);
+        auto const                 rows = pascal(300, mint::mod());
+        ASSERT_EQ(table.size(), 301u);
+        for(std::size_t n = 0; n <= 300; ++n)
+        {
+            for(std::size_t k = 0; k <= n; ++k)
+                ASSERT_EQ(table(n, k).value(), rows[n][k]) << n << " " << k;
+            EXPECT_EQ(table(n, n + 1), mint(0));
+        }
+    }
+
+    TEST(BinomialTable, FactorialsAndInverses)
+    {
+        binomial_table<mint> const table(1000);
+        for(std::size_t n = 1; n < table.size(); ++n)
+        {
+            EXPECT_EQ(table.factorial(n), table.factorial(n - 1) * mint(n));
+            EXPECT_EQ(table.factorial(n) * table.inverse_factorial(n), mint(1));
+            EXPECT_EQ(table.inverse(n) * mint(n), mint(1));
+        }
+    }
+
+    TEST(BinomialTable, LucasSmallPrime)
+    {
+        using small_mint = mod_int<13>;
+        binomial_table<small_mint> const     table(1000000); // capped at p - 1
+        binomial_table<small_mint, 13> const static_table;
+        auto const                           rows = pascal(400, 13);
+        EXPECT_EQ(table.size(), 13u);
+        for(std::size_t n = 0; n <= 400; ++n)
+        {
+            for(std::size_t k = 0; k <= n; ++k)
+            {
+                ASSERT_EQ(table(n, k).value(), rows[n][k]) << n << " " << k;
+                ASSERT_EQ(static_table(n, k).value(), rows[n][k]) << n << " " << k;
+            }
+        }
+    }
+
+    TEST(BinomialTable, LucasLargeArguments)
+    {
+        using small_mint = mod_int<7>;
+        binomial_table<small_mint> const table(6);
+        // C(7^20, 7^19) = C(10, 1) * ... in base 7: digits (1, 0, ..., 0) and (0, 1, 0, ..., 0) -> C(0, 1) = 0
+        std::uint64_t p20 = 1;
+        for(int i = 0; i < 20; ++i)
+            p20 *= 7;
+        EXPECT_EQ(table(p20, p20 / 7), small_mint(0));
+        EXPECT_EQ(table(p20, p20), small_mint(1));
+        EXPECT_EQ(table(p20 + 3 * 7 + 5, 2 * 7 + 4), small_mint(3 * 5)); // C(3, 2) * C(5, 4)
+    }
+
+    // A table smaller than `p` still answers arguments past it, the digits it lacks computed directly.
+    TEST(BinomialTable, LucasPastSmallTable)
+    {
+        using small_mint = mod_int<13>;
+        binomial_table<small_mint> const    table(5);
+        binomial_table<small_mint, 3> const static_table;
+        auto const                          rows = pascal(400, 13);
+        EXPECT_EQ(table.size(), 6u);
+        for(std::size_t n = 0; n <= 400; ++n)
+        {
+            for(std::size_t k = 0; k <= n; ++k)
+            {
+                ASSERT_EQ(table(n, k).value(), rows[n][k]) << n << " " << k;
+                ASSERT_EQ(static_table(n, k).value(), rows[n][k]) << n << " " << k;
+            }
+        }
+        EXPECT_EQ(binomial_table<mint>(10)(1000, 3), mint(166167000));
+    }
+
+    TEST(BinomialTable, BatchInverse)
+    {
+        std::mt19937_64   gen(9);
+        std::vector<mint> a(1000);
+        for(auto& x: a)
+            x = mint(1 + gen() % (mint::mod() - 1));
+        std::vector<mint> inv(a.size());
+        batch_inverse(span<mint const>(a.data(), a.size()), make_span(inv));
+        for(std::size_t i = 0; i < a.size(); ++i)
+            EXPECT_EQ(a[i] * inv[i], mint(1)) << i;
+        batch_inverse(span<mint const>(), span<mint>());
+
+        // `Mod` is deduced from `out` alone, a span over mutable data converts to the input
+        std::vector<mint> inv2(a.size());
+        batch_inverse(make_span(a), make_span(inv2));
+        EXPECT_EQ(inv2, inv);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
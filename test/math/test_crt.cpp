@@ -0,0 +1,129 @@
+#include <test/test_header.h>
+
+#include <qs/math/crt.h>
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(*crt({2, 3}, {3, 5}) == congruence{8, 15}, "coprime moduli");
+    static_assert(*crt({2, 4}, {4, 6}) == congruence{10, 12}, "non-coprime moduli");
+    static_assert(!crt({1, 4}, {2, 6}), "contradicting congruences");
+
+    TEST(Crt, MatchesBruteForce)
+    {
+        for(std::uint64_t m1 = 1; m1 <= 24; ++m1)
+            for(std::uint64_t m2 = 1; m2 <= 24; ++m2)
+                for(std::uint64_t r1 = 0; r1 < m1; ++r1)
+                    for(std::uint64_t r2 = 0; r2 < m2; ++r2)
+                    {
+                        std::uint64_t const l = std::lcm(m1, m2);
+                        std::uint64_t       x = 0;
+                        while(x < l && (x % m1 != r1 || x % m2 != r2))
+                            ++x;
+                        auto const r = crt({r1, m1}, {r2, m2});
+                        if(x == l)
+                            ASSERT_FALSE(r) << r1 << " mod " << m1 << ", " << r2 << " mod " << m2;
+                        else
+                            ASSERT_EQ(*r, (congruence{x, l})) << r1 << " mod " << m1 << ", " << r2 << " mod " << m2;
+                    }
+    }
+
+    TEST(Crt, LargeModuli)
+    {
+        congruence const cs[] = {{123456789012345ull, 4294967291ull}, {987654321ull, 4294967279ull}};
+        auto const       r    = crt(make_span(cs)); // lcm just below 2^64
+        ASSERT_TRUE(r);
+        EXPECT_EQ(r->modulus, 4294967291ull * 4294967279ull);
+        for(auto const& c: cs)
+            EXPECT_EQ(r->remainder % c.modulus, c.remainder % c.modulus);
+        EXPECT_EQ(*crt(span<congruence const>()), congruence{});
+    }
+
+    static void check_basis(std::vector<std::uint32_t> const& moduli, std::uint64_t seed)
+    {
+        crt_basis const basis(make_span(moduli));
+        ASSERT_EQ(basis.size(), moduli.size());
+        std::uint64_t lcm = 1;
+        bool          fits = true;
+        for(std::uint32_t m: moduli)
+        {
+            std::uint64_t const g = std::gcd(lcm, std::uint64_t(m));
+            fits                  = fits && (lcm / g) <= ~std::uint64_t(0) / m;
+            lcm                   = lcm / g * m;
+        }
+        EXPECT_EQ(basis.exact(), fits);
+        if(fits)
+        {
+            EXPECT_EQ(basis.modulus(), lcm);
+        }
+
+        std::mt19937_64            gen(seed);
+        std::size_t const          n = 500;
+        std::vector<std::uint64_t> values(n);
+        std::vector<std::uint32_t> residues;
+        for(auto& v: values)
+        {
+            v = fits ? gen() % lcm : gen();
+            for(std::uint32_t m: moduli)
+                residues.push_back(static_cast<std::uint32_t>(v % m));
+        }
+        std::vector<std::uint64_t> out(n);
+        basis.reconstruct(make_span(residues), make_span(out));
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            if(fits)
+            {
+                ASSERT_EQ(out[i], values[i]);
+            }
+            else // the value is congruent to the true one modulo every modulus
+            {
+                for(std::size_t j = 0; j < moduli.size(); ++j)
+                    ASSERT_EQ(out[i] % moduli[j], values[i] % moduli[j]);
+            }
+            ASSERT_EQ(basis.reconstruct(make_span(residues).subspan(i * moduli.size(), moduli.size())), out[i]);
+        }
+    }
+
+    TEST(CrtBasis, CoprimeModuli)
+    {
+        check_basis({998244353}, 1);
+        check_basis({998244353, 1000000007}, 2);
+        check_basis({4294967291u, 4294967279u}, 3);
+        check_basis({2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}, 4);
+    }
+
+    TEST(CrtBasis, NonCoprimeModuli)
+    {
+        check_basis({12, 18}, 5);
+        check_basis({4, 2, 8, 6}, 6);
+        check_basis({1, 1, 30}, 7);
+        check_basis({1u << 31, 3u << 29, 720720, 65536 * 27}, 8);
+        check_basis({4294967295u, 4294967291u, 65537, 255}, 9);
+    }
+
+    TEST(CrtBasis, ManyModuli)
+    {
+        // more factors than the inline scratch space, values modulo 2^64
+        std::vector<std::uint32_t> primes;
+        for(std::uint32_t p = 3; primes.size() < 20; p += 2)
+        {
+            bool prime = true;
+            for(std::uint32_t d = 3; d * d <= p; d += 2)
+                prime = prime && p % d != 0;
+            if(prime)
+                primes.push_back(p);
+        }
+        check_basis(primes, 10);
+        check_basis({998244353, 1000000007, 1000000009, 754974721, 469762049, 167772161, 2147483647, 4294967291u},
+                    11);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
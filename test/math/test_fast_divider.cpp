@@ -0,0 +1,151 @@
+#include <test/test_header.h>
+
+#include <qs/math/fast_divider.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(fast_divider<std::uint32_t>(7).divide(100) == 14, "unsigned division");
+    static_assert(100u % fast_divider<std::uint32_t>(7) == 2, "unsigned remainder");
+    static_assert(-100 / fast_divider<std::int32_t>(7) == -14 && -100 % fast_divider<std::int32_t>(7) == -2,
+                  "signed division truncates toward zero");
+    static_assert(100 / fast_divider<std::int64_t>(-7) == -14, "negative divisor");
+    static_assert(fast_divider<std::uint64_t>(~0ull).divide(~0ull) == 1, "largest divisor");
+
+    template<class T>
+    static std::vector<T> divisors()
+    {
+        using limits = std::numeric_limits<T>;
+        std::vector<T> d;
+        for(T x = 1; x <= 70; ++x)
+            d.push_back(x);
+        for(int s = 7; s < limits::digits; ++s)
+        {
+            d.push_back(static_cast<T>(T(1) << s));
+            d.push_back(static_cast<T>((T(1) << s) - 1));
+            d.push_back(static_cast<T>((T(1) << s) + 1));
+        }
+        d.push_back(limits::max());
+        d.push_back(static_cast<T>(limits::max() - 1));
+        d.push_back(T(1000000007));
+        if constexpr(limits::is_signed)
+        {
+            for(std::size_t i = 0, n = d.size(); i < n; ++i)
+                d.push_back(static_cast<T>(-d[i]));
+            d.push_back(limits::min());
+        }
+        return d;
+    }
+
+    template<class T>
+    static std::vector<T> dividends(std::size_t n, std::uint64_t seed)
+    {
+        using limits = std::numeric_limits<T>;
+        std::mt19937_64 gen(seed);
+        std::vector<T>  v = {T(0), T(1), T(2), limits::max(), static_cast<T>(limits::max() - 1), limits::min(),
+                            static_cast<T>(limits::min() + 1)};
+        while(v.size() < n)
+            v.push_back(static_cast<T>(gen() >> (gen() % 64))); // all magnitudes
+        return v;
+    }
+
+    template<class T>
+    static void check_scalar()
+    {
+        auto const values = dividends<T>(2000, sizeof(T));
+        for(T d: divisors<T>())
+        {
+            fast_divider<T> const f(d);
+            ASSERT_EQ(f.divisor(), d);
+            for(T n: values)
+            {
+                if(std::is_signed<T>::value && d == T(-1))
+                    continue; // `min / -1` overflows
+                ASSERT_EQ(n / f, n / d) << n << " / " << d;
+                ASSERT_EQ(n % f, n % d) << n << " % " << d;
+            }
+        }
+    }
+
+    TEST(FastDivider, Unsigned32) { check_scalar<std::uint32_t>(); }
+    TEST(FastDivider, Signed32) { check_scalar<std::int32_t>(); }
+    TEST(FastDivider, Unsigned64) { check_scalar<std::uint64_t>(); }
+    TEST(FastDivider, Signed64) { check_scalar<std::int64_t>(); }
+
+    TEST(FastDivider, MinusOneWraps)
+    {
+        fast_divider<std::int32_t> const f(-1);
+        EXPECT_EQ(f.divide(std::numeric_limits<std::int32_t>::min()), std::numeric_limits<std::int32_t>::min());
+        EXPECT_EQ(f.divide(5), -5);
+        EXPECT_EQ(f.remainder(std::numeric_limits<std::int32_t>::min()), 0);
+    }
+
+    TEST(FastDivider, ZeroDivisor)
+    {
+        EXPECT_DEBUG_DEATH((void)fast_divider<std::uint32_t>(0), testing::HasSubstr("fast_divider: zero divisor"));
+        EXPECT_DEBUG_DEATH((void)fast_divider<std::int64_t>(0), testing::HasSubstr("fast_divider: zero divisor"));
+    }
+
+    TEST(FastDivider, Exhaustive16BitDividends)
+    {
+        for(std::uint32_t d = 1; d < 300; ++d)
+        {
+            fast_divider<std::uint32_t> const f(d);
+            for(std::uint32_t n = 0; n < 65536; ++n)
+                ASSERT_EQ(n / f, n / d);
+        }
+    }
+
+    class FastDividerBatchTest : public simd_level_test
+    {
+    protected:
+        template<class T>
+        static void check_batch()
+        {
+            for(T d: divisors<T>())
+            {
+                fast_divider<T> const f(d);
+                for(std::size_t n: {0u, 1u, 7u, 8u, 15u, 16u, 17u, 100u})
+                {
+                    auto const     in = dividends<T>(n, n);
+                    std::vector<T> out(in.size());
+                    f.divide(make_span(in), make_span(out));
+                    for(std::size_t i = 0; i < in.size(); ++i)
+                        ASSERT_EQ(out[i], static_cast<T>(f.divide(in[i]))) << in[i] << " / " << d;
+                }
+            }
+        }
+    };
+
+    TEST_P(FastDividerBatchTest, MatchesScalar)
+    {
+        check_batch<std::uint32_t>();
+        check_batch<std::int32_t>();
+        check_batch<std::uint64_t>();
+        check_batch<std::int64_t>();
+    }
+
+    TEST_P(FastDividerBatchTest, InPlace)
+    {
+        fast_divider<std::int32_t> const f(-3);
+        std::vector<std::int32_t>        v(37);
+        for(std::size_t i = 0; i < v.size(); ++i)
+            v[i] = static_cast<std::int32_t>(i * 1001) - 20000;
+        auto const expected = v;
+        f.divide(make_span(v), make_span(v));
+        for(std::size_t i = 0; i < v.size(); ++i)
+            EXPECT_EQ(v[i], expected[i] / -3);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, FastDividerBatchTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
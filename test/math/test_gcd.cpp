@@ -0,0 +1,114 @@
+#include <test/test_header.h>
+
+#include <qs/math/gcd.h>
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(gcd(12, 18) == 6, "gcd");
+    static_assert(gcd(-12, 18) == 6, "gcd of negative values is non-negative");
+    static_assert(gcd(0u, 7u) == 7u && gcd(7, 0) == 7 && gcd(0, 0) == 0, "gcd with zero");
+    static_assert(binary_extended_gcd(240, 46).first == 2, "binary extended gcd");
+    static_assert(240 * std::get<0>(binary_extended_gcd(240, 46).second) +
+                          46 * std::get<1>(binary_extended_gcd(240, 46).second) ==
+                      2,
+                  "Bezout identity");
+
+    TEST(Gcd, MatchesStdGcd)
+    {
+        std::mt19937_64 gen(1);
+        for(int i = 0; i < 100000; ++i)
+        {
+            // vary the magnitudes and force common powers of two
+            std::uint64_t const a = (gen() >> (gen() % 64)) << (i % 5);
+            std::uint64_t const b = (gen() >> (gen() % 64)) << (i % 3);
+            ASSERT_EQ(gcd(a, b), std::gcd(a, b)) << a << " " << b;
+            ASSERT_EQ(gcd(std::uint32_t(a), std::uint32_t(b)), std::gcd(std::uint32_t(a), std::uint32_t(b)));
+            ASSERT_EQ(gcd(std::int64_t(a), -std::int64_t(b >> 1)), std::gcd(std::int64_t(a), -std::int64_t(b >> 1)));
+        }
+    }
+
+    template<class T>
+    static void check_extended(T a, T b)
+    {
+        auto const r = binary_extended_gcd(a, b);
+        T const    x = std::get<0>(r.second);
+        T const    y = std::get<1>(r.second);
+        ASSERT_EQ(r.first, std::gcd(a, b)) << a << " " << b;
+        ASSERT_EQ(a * x + b * y, r.first) << a << " " << b;
+        ASSERT_EQ(r.first, extended_gcd(a, b).first < 0 ? -extended_gcd(a, b).first : extended_gcd(a, b).first);
+    }
+
+    TEST(Gcd, BinaryExtendedGcd)
+    {
+        check_extended<std::int64_t>(0, 0);
+        check_extended<std::int64_t>(0, 5);
+        check_extended<std::int64_t>(-5, 0);
+        check_extended<std::int64_t>(1, 1);
+        check_extended<std::int64_t>(-240, 46);
+        check_extended<std::int64_t>(240, -46);
+
+        std::mt19937_64 gen(2);
+        for(int i = 0; i < 100000; ++i)
+        {
+            // |a|, |b| < 2^31 so that a*x + b*y cannot overflow in the check
+            auto const a = static_cast<std::int64_t>(gen() >> (33 + gen() % 31)) << (i % 4);
+            auto const b = static_cast<std::int64_t>(gen() >> (33 + gen() % 31)) << (i % 3);
+            check_extended(i % 2 ? a : -a, i % 3 ? b : -b);
+        }
+    }
+
+    class BatchGcdTest : public simd_level_test
+    {
+    };
+
+    TEST_P(BatchGcdTest, MatchesScalar32)
+    {
+        std::mt19937_64 gen(3);
+        for(std::size_t n: {0u, 1u, 7u, 8u, 9u, 16u, 17u, 1000u})
+        {
+            std::vector<std::uint32_t> a(n), b(n), out(n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                a[i] = static_cast<std::uint32_t>(gen() >> (32 + gen() % 33)) << (i % 4);
+                b[i] = static_cast<std::uint32_t>(gen() >> (32 + gen() % 33)) << (i % 3);
+            }
+            if(n > 4)
+                a[0] = 0, b[1] = 0, a[2] = b[2] = 0, a[3] = b[3] = 1u << 31;
+            gcd(make_span(a), make_span(b), make_span(out));
+            for(std::size_t i = 0; i < n; ++i)
+                ASSERT_EQ(out[i], std::gcd(a[i], b[i])) << a[i] << " " << b[i];
+        }
+    }
+
+    TEST_P(BatchGcdTest, MatchesScalar64)
+    {
+        std::mt19937_64 gen(4);
+        for(std::size_t n: {0u, 1u, 7u, 8u, 9u, 1000u})
+        {
+            std::vector<std::uint64_t> a(n), b(n), out(n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                a[i] = (gen() >> (gen() % 64)) << (i % 4);
+                b[i] = (gen() >> (gen() % 64)) << (i % 3);
+            }
+            if(n > 4)
+                a[0] = 0, b[1] = 0, a[2] = b[2] = 0, a[3] = b[3] = std::uint64_t(1) << 63;
+            gcd(make_span(a), make_span(b), make_span(out));
+            for(std::size_t i = 0; i < n; ++i)
+                ASSERT_EQ(out[i], std::gcd(a[i], b[i])) << a[i] << " " << b[i];
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, BatchGcdTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,74 @@
+#include <test/test_header.h>
+
+#include <qs/math/mod_arithmetic.h>
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    template<class T>
+    static T bezout_sum(std::vector<T> const& values, std::vector<T> const& coefficients)
+    {
+        T sum = 0;
+        for(std::size_t i = 0; i < values.size(); ++i)
+            sum += values[i] * coefficients[i];
+        return sum;
+    }
+
+    TEST(ExtendedGcd, VariadicBezoutIdentity)
+    {
+        auto const r = extended_gcd(12, 18, 27);
+        EXPECT_EQ(r.first, 3);
+        EXPECT_EQ(12 * std::get<0>(r.second) + 18 * std::get<1>(r.second) + 27 * std::get<2>(r.second), 3);
+    }
+
+    TEST(ExtendedGcd, RangeEmptyAndSingle)
+    {
+        std::vector<int> values, coefficients;
+        EXPECT_EQ(extended_gcd(make_span(values), make_span(coefficients)), 0);
+
+        values       = {42};
+        coefficients = {0};
+        EXPECT_EQ(extended_gcd(make_span(values), make_span(coefficients)), 42);
+        EXPECT_EQ(coefficients[0], 1);
+    }
+
+    TEST(ExtendedGcd, RangeMatchesVariadic)
+    {
+        std::vector<std::int64_t> const values = {240, 46, 18, -30, 0, 12};
+        std::vector<std::int64_t>       coefficients(values.size());
+
+        auto const g        = extended_gcd(make_span(values), make_span(coefficients));
+        auto const variadic = extended_gcd(values[0], values[1], values[2], values[3], values[4], values[5]);
+        EXPECT_EQ(g < 0 ? -g : g, variadic.first < 0 ? -variadic.first : variadic.first);
+        EXPECT_EQ(bezout_sum(values, coefficients), g);
+    }
+
+    TEST(ExtendedGcd, RangeRandom)
+    {
+        std::mt19937_64 gen(5);
+        for(std::size_t n: {2u, 3u, 17u, 1000u, 100000u})
+        {
+            std::int64_t const        common = static_cast<std::int64_t>(gen() % 1000) + 1;
+            std::vector<std::int64_t> values(n), coefficients(n);
+            std::int64_t              expected = 0;
+            for(auto& v: values)
+            {
+                v        = common * (static_cast<std::int64_t>(gen() % 2000001) - 1000000);
+                expected = std::gcd(expected, v);
+            }
+
+            auto const g = extended_gcd(make_span(values), make_span(coefficients));
+            EXPECT_EQ(g < 0 ? -g : g, expected) << n;
+            EXPECT_EQ(bezout_sum(values, coefficients), g) << n;
+        }
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,123 @@
+#include <test/test_header.h>
+
+#include <qs/math/mod_batch.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class ModBatchTest : public simd_level_test
+    {
+    protected:
+        static std::vector<std::uint32_t> residues(std::size_t n, std::uint32_t m, std::uint64_t seed)
+        {
+            std::mt19937_64            gen(seed);
+            std::vector<std::uint32_t> v(n);
+            for(auto& x: v)
+                x = static_cast<std::uint32_t>(gen() % m);
+            return v;
+        }
+
+        static std::uint64_t naive_pow(std::uint64_t a, std::uint64_t e, std::uint64_t m)
+        {
+            std::uint64_t r = 1 % m;
+            for(; e != 0; e >>= 1, a = a * a % m)
+                if(e & 1)
+                    r = r * a % m;
+            return r;
+        }
+    };
+
+    static constexpr std::uint32_t moduli[] = {1u, 2u, 3u, 1000u, 65521u, 998244353u, 2147483647u, 4294967291u,
+                                               4294967295u};
+
+    TEST_P(ModBatchTest, AddMulMatchNaive)
+    {
+        for(std::uint32_t m: moduli)
+        {
+            dynamic_modulus const mod(m);
+            for(std::size_t n: {0u, 1u, 7u, 8u, 15u, 16u, 17u, 100u, 1000u})
+            {
+                auto const                 a = residues(n, m, n);
+                auto const                 b = residues(n, m, n + 1);
+                std::vector<std::uint32_t> sum(n), prod(n);
+                add_mod(make_span(a), make_span(b), make_span(sum), mod);
+                mul_mod(make_span(a), make_span(b), make_span(prod), mod);
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    ASSERT_EQ(sum[i], (std::uint64_t(a[i]) + b[i]) % m) << "m=" << m << " i=" << i;
+                    ASSERT_EQ(prod[i], std::uint64_t(a[i]) * b[i] % m) << "m=" << m << " i=" << i;
+                }
+            }
+        }
+    }
+
+    TEST_P(ModBatchTest, PowMatchesNaive)
+    {
+        for(std::uint32_t m: moduli)
+        {
+            dynamic_modulus const mod(m);
+            auto const            a = residues(203, m, m);
+            std::vector<std::uint32_t> out(a.size());
+            for(std::uint64_t e: {std::uint64_t(0), std::uint64_t(1), std::uint64_t(2), std::uint64_t(65537),
+                                  std::uint64_t(m) - 2, ~std::uint64_t(0)})
+            {
+                pow_mod(make_span(a), e, make_span(out), mod);
+                for(std::size_t i = 0; i < a.size(); ++i)
+                    ASSERT_EQ(out[i], naive_pow(a[i], e, m)) << "m=" << m << " e=" << e << " i=" << i;
+            }
+        }
+    }
+
+    TEST_P(ModBatchTest, InPlace)
+    {
+        dynamic_modulus const      mod(998244353);
+        auto                       a = residues(77, mod.modulus(), 5);
+        auto const                 b = residues(77, mod.modulus(), 6);
+        std::vector<std::uint32_t> expected(a.size());
+        for(std::size_t i = 0; i < a.size(); ++i)
+            expected[i] = mod.mul(a[i], b[i]);
+        mul_mod(make_span(a), make_span(b), make_span(a), mod);
+        EXPECT_EQ(a, expected);
+    }
+
+    TEST_P(ModBatchTest, ModInt)
+    {
+        using odd  = mod_int<1000000007>;
+        using even = mod_int<1u << 30>;
+
+        std::vector<odd>  a, b, out(300);
+        std::vector<even> c, d, out2(300);
+        for(int i = 0; i < 300; ++i)
+        {
+            a.emplace_back(i * 7919 + 1), b.emplace_back(i * 104729 + 3);
+            c.emplace_back(i * 7919 + 1), d.emplace_back(i * 104729 + 3);
+        }
+
+        mul_mod(make_span(a), make_span(b), make_span(out));
+        mul_mod(make_span(c), make_span(d), make_span(out2));
+        for(std::size_t i = 0; i < out.size(); ++i)
+        {
+            EXPECT_EQ(out[i], a[i] * b[i]);
+            EXPECT_EQ(out2[i], c[i] * d[i]);
+        }
+
+        add_mod(make_span(a), make_span(b), make_span(out));
+        for(std::size_t i = 0; i < out.size(); ++i)
+            EXPECT_EQ(out[i], a[i] + b[i]);
+
+        pow_mod(make_span(a), odd::mod() - 2, make_span(out));
+        for(std::size_t i = 0; i < out.size(); ++i)
+            EXPECT_EQ(out[i] * a[i], odd(1));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, ModBatchTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,108 @@
+#include <test/test_header.h>
+
+#include <qs/math/mod_int.h>
+
+#include <cstdint>
+#include <random>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    // compile-time evaluation
+    static_assert(mod_int<998244353>(3).pow(998244352) == mod_int<998244353>(1), "Fermat's little theorem");
+    static_assert((mod_int<1000000007>(5) * mod_int<1000000007>(-5)).value() == 1000000007 - 25, "product");
+    static_assert(mod_int<10>(-3).value() == 7, "negative values are normalized");
+    static_assert(mod_int<1>(12345).value() == 0, "trivial modulus");
+
+    template<class Mod>
+    class ModIntTest : public ::testing::Test
+    {};
+
+    using ModIntTypes = ::testing::Types<mod_int<998244353>, mod_int<1000000007>, mod_int<4294967291u>,
+                                         mod_int<4294967294u>, mod_int<65536>, mod_int<3>, mod_int<2>>;
+    TYPED_TEST_SUITE(ModIntTest, ModIntTypes);
+
+    TYPED_TEST(ModIntTest, ArithmeticMatchesNaive)
+    {
+        using mint          = TypeParam;
+        std::uint64_t const m = mint::mod();
+
+        std::mt19937_64 gen(7);
+        for(int i = 0; i < 10000; ++i)
+        {
+            std::uint64_t const a = gen(), b = gen();
+            mint const          x(a), y(b);
+            EXPECT_EQ(x.value(), a % m);
+            EXPECT_EQ((x + y).value(), (a % m + b % m) % m);
+            EXPECT_EQ((x - y).value(), (a % m + m - b % m) % m);
+            EXPECT_EQ((x * y).value(), (a % m) * (b % m) % m);
+            EXPECT_EQ((-x).value(), (m - a % m) % m);
+        }
+    }
+
+    TYPED_TEST(ModIntTest, Pow)
+    {
+        using mint            = TypeParam;
+        std::uint64_t const m = mint::mod();
+
+        std::mt19937_64 gen(11);
+        for(int i = 0; i < 200; ++i)
+        {
+            std::uint64_t const a = gen() % m;
+            std::uint64_t const e = gen() % 100;
+            std::uint64_t       r = 1 % m;
+            for(std::uint64_t k = 0; k < e; ++k)
+                r = r * a % m;
+            EXPECT_EQ(mint(a).pow(e).value(), r);
+        }
+    }
+
+    TEST(ModInt, InverseAndDivision)
+    {
+        using mint = mod_int<1000000007>;
+        for(std::uint32_t a = 1; a < 2000; ++a)
+        {
+            EXPECT_EQ((mint(a) * mint(a).inverse()).value(), 1u);
+            EXPECT_EQ((mint(a) / mint(a)).value(), 1u);
+        }
+        EXPECT_EQ(mint(7).inverse(), mint(7).pow(mint::mod() - 2));
+    }
+
+    TEST(DynamicModulus, MatchesNaive)
+    {
+        std::mt19937_64 gen(3);
+        for(std::uint32_t m: {1u, 2u, 3u, 1000u, 65521u, 998244353u, 2147483647u, 2147483648u, 4294967291u,
+                              4294967295u})
+        {
+            dynamic_modulus const mod(m);
+            for(int i = 0; i < 10000; ++i)
+            {
+                std::uint64_t const a = gen() % m, b = gen() % m, c = gen();
+                EXPECT_EQ(mod.mul(a, b), a * b % m);
+                EXPECT_EQ(mod.add(a, b), (a + b) % m);
+                EXPECT_EQ(mod.sub(a, b), (a + m - b) % m);
+                EXPECT_EQ(mod.reduce(c), c % m);
+            }
+            // around `m^2` and the top of the range, where Barrett's quotient estimate is tightest
+            std::uint64_t const top = static_cast<std::uint64_t>(-1);
+            for(std::uint64_t x: {std::uint64_t(m) * m - 1, std::uint64_t(m) * m, std::uint64_t(m) * m + 1,
+                                  top - m - 1, top - m, top - m + 1, top - m + 2, top - 1, top})
+                EXPECT_EQ(mod.reduce(x), x % m) << m << " " << x;
+        }
+    }
+
+    TEST(DynamicModulus, PowAndInverse)
+    {
+        dynamic_modulus const mod(998244353);
+        EXPECT_EQ(mod.pow(3, 998244352), 1u);
+        for(std::uint32_t a = 1; a < 1000; ++a)
+            EXPECT_EQ(mod.mul(a, mod.inverse(a)), 1u);
+
+        dynamic_modulus const even(1u << 20);
+        EXPECT_EQ(even.mul(3, even.inverse(3)), 1u);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,158 @@
+#include <test/test_header.h>
+
+#include <qs/math/ntt.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    using mint = mod_int<998244353>;
+
+    static_assert(intl::primitive_root(998244353) == 3, "primitive root");
+    static_assert(intl::primitive_root(754974721) == 11, "primitive root");
+    static_assert(ntt<998244353>::max_log_size == 23, "2-adic valuation of M - 1");
+
+    static std::vector<mint> random_mints(std::size_t n, std::uint64_t seed)
+    {
+        std::mt19937_64   gen(seed);
+        std::vector<mint> v(n);
+        for(auto& x: v)
+            x = mint(gen());
+        return v;
+    }
+
+    static std::vector<mint> naive_convolution(std::vector<mint> const& a, std::vector<mint> const& b)
+    {
+        std::vector<mint> c(a.size() + b.size() - 1);
+        for(std::size_t i = 0; i < a.size(); ++i)
+            for(std::size_t j = 0; j < b.size(); ++j)
+                c[i + j] += a[i] * b[j];
+        return c;
+    }
+
+    TEST(Ntt, ForwardMatchesDftInBitReversedOrder)
+    {
+        std::size_t const    n = 32;
+        ntt<998244353> const plan(n);
+        auto const           a = random_mints(n, 1);
+        auto                 t = a;
+        plan.forward(make_span(t));
+
+        mint const w = mint(ntt<998244353>::root).pow((998244353 - 1) / n);
+        for(std::size_t k = 0; k < n; ++k)
+        {
+            mint expected(0);
+            for(std::size_t i = 0; i < n; ++i)
+                expected += a[i] * w.pow(i * k);
+            std::size_t rev = 0;
+            for(std::size_t b = 0; b < 5; ++b)
+                rev |= ((k >> b) & 1) << (4 - b);
+            EXPECT_EQ(t[rev], expected) << k;
+        }
+    }
+
+    TEST(Ntt, ConvolveOutputTooSmall)
+    {
+        auto const                 a = random_mints(8, 2);
+        std::vector<mint>          c(a.size() + a.size() - 2);
+        std::vector<std::uint32_t> x(8, 1u);
+        std::vector<std::uint64_t> z(x.size());
+        EXPECT_DEBUG_DEATH(convolve<998244353>(make_span(a), make_span(a), make_span(c)),
+                           testing::HasSubstr("convolve: output too small"));
+        EXPECT_DEBUG_DEATH(convolve_exact(make_span(x), make_span(x), make_span(z)),
+                           testing::HasSubstr("convolve_exact: output too small"));
+    }
+
+    // 96 = 3 * 2^5, so mod 97 transforms stop at 32 points.
+    TEST(Ntt, SizeBeyondModulus)
+    {
+        static_assert(ntt<97>::max_log_size == 5, "2-adic valuation of M - 1");
+        using small_mint = mod_int<97>;
+
+        EXPECT_DEBUG_DEATH(ntt<97>(64), testing::HasSubstr("ntt: max_size must be a power of two dividing M - 1"));
+        std::vector<small_mint> v(64);
+        EXPECT_DEBUG_DEATH(ntt<97>(32).forward(make_span(v)),
+                           testing::HasSubstr("ntt: size must be a power of two <= max_size()"));
+
+        std::vector<small_mint> a(20, small_mint(1)), c(39);
+        EXPECT_DEBUG_DEATH(convolve<97>(make_span(a), make_span(a), make_span(c)),
+                           testing::HasSubstr("convolve: result too long for the modulus"));
+        a.resize(16);
+        convolve<97>(make_span(a), make_span(a), make_span(c)); // 31 points fit
+        EXPECT_EQ(c[15], small_mint(16));
+
+        std::vector<std::uint32_t> x(std::size_t(1) << 24, 1u), y(2, 1u);
+        std::vector<std::uint64_t> z;
+        EXPECT_DEBUG_DEATH(convolve_exact(make_span(x), make_span(y), make_span(z)),
+                           testing::HasSubstr("convolve_exact: result longer than 2^24"));
+    }
+
+    class NttTest : public simd_level_test
+    {
+    };
+
+    TEST_P(NttTest, RoundTrip)
+    {
+        // covers radix-2 + radix-4, and sizes above the cache block
+        ntt<998244353> const plan(std::size_t(1) << 17);
+        for(std::size_t n = 1; n <= plan.max_size(); n *= 2)
+        {
+            auto const a = random_mints(n, n);
+            auto       t = a;
+            plan.forward(make_span(t));
+            plan.inverse(make_span(t));
+            ASSERT_EQ(t, a) << n;
+        }
+    }
+
+    TEST_P(NttTest, ConvolutionMatchesNaive)
+    {
+        for(std::size_t const na: {1u, 2u, 7u, 64u, 300u})
+        {
+            for(std::size_t const nb: {1u, 5u, 129u})
+            {
+                auto const        a = random_mints(na, na);
+                auto const        b = random_mints(nb, nb + 100);
+                std::vector<mint> c(na + nb + 3);
+                convolve<998244353>(make_span(a), make_span(b), make_span(c));
+
+                auto const expected = naive_convolution(a, b);
+                for(std::size_t i = 0; i < c.size(); ++i)
+                    ASSERT_EQ(c[i], i < expected.size() ? expected[i] : mint(0)) << na << " " << nb << " " << i;
+            }
+        }
+    }
+
+    TEST_P(NttTest, ConvolveExact)
+    {
+        std::mt19937               gen(3);
+        std::vector<std::uint32_t> a(1000), b(777);
+        for(auto& x: a)
+            x = static_cast<std::uint32_t>(gen());
+        for(auto& x: b)
+            x = static_cast<std::uint32_t>(gen());
+        a[0] = b[0] = 0xFFFFFFFFu;
+
+        std::vector<std::uint64_t> c(a.size() + b.size() - 1);
+        convolve_exact(make_span(a), make_span(b), make_span(c));
+
+        // true sums are below 2^74, compared modulo 2^64
+        for(std::size_t k = 0; k < c.size(); ++k)
+        {
+            std::uint64_t expected = 0;
+            for(std::size_t i = k < b.size() ? 0 : k - b.size() + 1; i < a.size() && i <= k; ++i)
+                expected += std::uint64_t(a[i]) * b[k - i];
+            ASSERT_EQ(c[k], expected) << k;
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SimdLevels, NttTest,
+                             ::testing::Values(simd_level::scalar, simd_level::avx2, simd_level::avx512));
+} // namespace test
+
+QS_NAMESPACE_END
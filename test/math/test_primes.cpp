@@ -0,0 +1,129 @@
+#include <test/test_header.h>
+
+#include <qs/math/primes.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(is_prime(2) && is_prime(3) && is_prime(998244353) && is_prime(4294967291u), "primes");
+    static_assert(!is_prime(0) && !is_prime(1) && !is_prime(561) && !is_prime(4294967295u), "non primes");
+    static_assert(is_prime(18446744073709551557ull), "largest 64-bit prime");
+
+    static std::vector<bool> naive_sieve(std::size_t n)
+    {
+        std::vector<bool> composite(n, false);
+        for(std::size_t i = 2; i * i < n; ++i)
+            if(!composite[i])
+                for(std::size_t j = i * i; j < n; j += i)
+                    composite[j] = true;
+        std::vector<bool> prime(n);
+        for(std::size_t i = 2; i < n; ++i)
+            prime[i] = !composite[i];
+        return prime;
+    }
+
+    static bool trial_division(std::uint64_t n)
+    {
+        if(n < 2)
+            return false;
+        for(std::uint64_t d = 2; d * d <= n; ++d)
+            if(n % d == 0)
+                return false;
+        return true;
+    }
+
+    TEST(IsPrime, MatchesSieve)
+    {
+        auto const prime = naive_sieve(1 << 20);
+        for(std::uint64_t n = 0; n < prime.size(); ++n)
+            ASSERT_EQ(is_prime(n), prime[n]) << n;
+    }
+
+    TEST(IsPrime, LargeValues)
+    {
+        // strong pseudoprimes to several bases, and products of two close primes
+        EXPECT_FALSE(is_prime(3215031751ull));
+        EXPECT_FALSE(is_prime(3825123056546413051ull));
+        EXPECT_FALSE(is_prime(341550071728321ull));
+        EXPECT_FALSE(is_prime(2152302898747ull));
+        EXPECT_FALSE(is_prime(4294967291ull * 4294967279ull));
+        EXPECT_TRUE(is_prime(1000000000000000003ull));
+        EXPECT_TRUE(is_prime((std::uint64_t(1) << 61) - 1));
+
+        std::mt19937_64 gen(5);
+        for(int i = 0; i < 2000; ++i)
+        {
+            std::uint64_t const n = (gen() >> 24) | 1; // up to 40 bits, trial division stays fast
+            ASSERT_EQ(is_prime(n), trial_division(n)) << n;
+        }
+    }
+
+    TEST(PrimeSieve, MatchesNaiveSieve)
+    {
+        constexpr std::size_t      n     = 3'000'000;
+        auto const                 prime = naive_sieve(n);
+        std::vector<std::uint64_t> expected;
+        for(std::uint64_t i = 0; i < n; ++i)
+            if(prime[i])
+                expected.push_back(i);
+
+        std::vector<std::uint64_t> visited;
+        for_each_prime(0, n, [&](std::uint64_t p) { visited.push_back(p); });
+        EXPECT_EQ(visited, expected);
+        EXPECT_EQ(generate_primes(0, n), expected);
+        EXPECT_EQ(count_primes(0, n), expected.size());
+    }
+
+    TEST(PrimeSieve, RangeEdges)
+    {
+        auto const prime = naive_sieve(5000);
+        for(std::uint64_t lo = 0; lo < 200; lo += 7)
+        {
+            for(std::uint64_t hi = lo; hi < 5000; hi += 331)
+            {
+                std::vector<std::uint32_t> expected;
+                for(std::uint64_t i = lo; i < hi; ++i)
+                    if(prime[i])
+                        expected.push_back(static_cast<std::uint32_t>(i));
+                ASSERT_EQ(generate_primes<std::uint32_t>(lo, hi), expected) << lo << ", " << hi;
+            }
+        }
+    }
+
+    TEST(PrimeSieve, KnownCounts)
+    {
+        EXPECT_EQ(count_primes(0, 10), 4u);
+        EXPECT_EQ(count_primes(0, 100'000'000), 5'761'455u);
+        // window far from the origin, checked against Miller-Rabin
+        std::uint64_t const lo = 1'000'000'000'000ull, hi = lo + 2'000'000;
+        std::uint64_t       n  = 0;
+        for_each_prime(lo, hi, [&](std::uint64_t p) {
+            ASSERT_TRUE(is_prime(p)) << p;
+            ++n;
+        });
+        std::uint64_t expected = 0;
+        for(std::uint64_t i = lo; i < hi; ++i)
+            expected += is_prime(i);
+        EXPECT_EQ(n, expected);
+    }
+
+    TEST(PrimeSieve, Threads)
+    {
+        std::uint64_t const lo = 12'345, hi = 20'000'000;
+        auto const          expected = generate_primes(lo, hi);
+        for(unsigned threads: {0u, 2u, 3u, 8u})
+        {
+            EXPECT_EQ(generate_primes(lo, hi, threads), expected);
+            EXPECT_EQ(count_primes(lo, hi, threads), expected.size());
+        }
+        EXPECT_EQ(count_primes(0, 100, 64), 25u); // more threads than segments
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,168 @@
+#include <test/test_header.h>
+
+#include <qs/containers/fenwick_tree.h>
+#include <qs/memory/huge_page_allocator.h>
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    class MapPagesTest : public ::testing::TestWithParam<page_size>
+    {};
+
+    TEST_P(MapPagesTest, MapsZeroedWritableMemory)
+    {
+        huge_page_options opts;
+        opts.pages = GetParam();
+
+        std::size_t const bytes = (std::size_t(3) << 20) + 123;
+        page_mapping      m     = map_pages(bytes, opts);
+        ASSERT_NE(m.ptr, nullptr);
+        EXPECT_GE(m.size, bytes);
+
+        auto* p = static_cast<unsigned char*>(m.ptr);
+        EXPECT_EQ(p[0], 0);
+        EXPECT_EQ(p[bytes - 1], 0);
+        std::memset(p, 0x5a, bytes);
+        EXPECT_EQ(p[bytes / 2], 0x5a);
+
+        if(m.pages != page_size::standard)
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.ptr) % (std::size_t(2) << 20), 0u);
+        }
+        if(opts.pages == page_size::standard)
+        {
+            EXPECT_EQ(m.pages, page_size::standard);
+        }
+        // only 1G hugetlb pages round the length to 1G, the fallbacks keep 2M granularity
+        std::size_t const granule = m.pages == page_size::huge_1g ? std::size_t(1) << 30
+                                    : opts.pages == page_size::standard ? std::size_t(4096)
+                                                                        : std::size_t(2) << 20;
+        EXPECT_EQ(m.size, (bytes + granule - 1) / granule * granule);
+        unmap_pages(m);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(HugePages, MapPagesTest,
+                             ::testing::Values(page_size::standard, page_size::huge_2m, page_size::huge_1g));
+
+    TEST(HugePageAllocator, ZeroBytesIsNullMapping)
+    {
+        page_mapping m = map_pages(0);
+        EXPECT_EQ(m.ptr, nullptr);
+        unmap_pages(m); // no-op
+    }
+
+    // Rounding a size near SIZE_MAX up to the page size would wrap to a tiny (or empty) mapping.
+    TEST(HugePageAllocator, HugeSizeIsNullMapping)
+    {
+        for(page_size pages : {page_size::standard, page_size::huge_2m, page_size::huge_1g})
+        {
+            huge_page_options opts;
+            opts.pages     = pages;
+            page_mapping m = map_pages(SIZE_MAX - 100, opts);
+            EXPECT_EQ(m.ptr, nullptr);
+            EXPECT_EQ(m.size, 0u);
+        }
+
+        huge_page_allocator<char> alloc;
+        EXPECT_THROW((void)alloc.allocate(SIZE_MAX - 100), std::bad_alloc);
+    }
+
+    TEST(HugePageAllocator, NumaBindToNodeZero)
+    {
+        huge_page_options opts;
+        opts.policy    = numa_policy::bind;
+        opts.node_mask = 1;
+
+        page_mapping m = map_pages(std::size_t(4) << 20, opts);
+        ASSERT_NE(m.ptr, nullptr);
+        std::memset(m.ptr, 1, m.size);
+#if defined(__linux__)
+        int           mode = -1;
+        unsigned long mask = 0;
+        bool const    queried =
+            ::syscall(SYS_get_mempolicy, &mode, &mask, sizeof(mask) * 8, m.ptr, MPOL_F_ADDR) == 0;
+        unmap_pages(m);
+        // mbind may be unavailable (containers, kernels without NUMA), which is reported and not fatal
+        if(!m.numa_applied)
+            GTEST_SKIP() << "mbind not available";
+        ASSERT_TRUE(queried);
+        EXPECT_EQ(mode, MPOL_BIND);
+        EXPECT_EQ(mask, 1u);
+#else
+        unmap_pages(m);
+        EXPECT_FALSE(m.numa_applied);
+#endif
+    }
+
+    TEST(HugePageAllocator, OneGigRequestFallbackKeepsSize)
+    {
+        huge_page_options opts;
+        opts.pages = page_size::huge_1g;
+
+        huge_page_allocator<char> alloc(opts);
+        std::size_t const         n = std::size_t(10) << 20;
+        char*                     p = alloc.allocate(n);
+        p[0] = 1, p[n - 1] = 2;
+        EXPECT_EQ(p[0] + p[n - 1], 3);
+        alloc.deallocate(p, n); // unmaps the length actually mapped, whichever fallback served the request
+    }
+
+    TEST(HugePageAllocator, SmallAllocationsUseOperatorNew)
+    {
+        huge_page_allocator<int> alloc;
+        int*                     p = alloc.allocate(16);
+        p[0] = 1, p[15] = 2;
+        EXPECT_EQ(p[0] + p[15], 3);
+        alloc.deallocate(p, 16);
+    }
+
+    TEST(HugePageAllocator, VectorGrowth)
+    {
+        std::vector<std::uint64_t, huge_page_allocator<std::uint64_t>> v;
+        for(std::uint64_t i = 0; i < (1u << 20); ++i)
+            v.push_back(i);
+        EXPECT_EQ(v.front(), 0u);
+        EXPECT_EQ(v.back(), (1u << 20) - 1);
+    }
+
+    TEST(HugePageAllocator, RebindAndEquality)
+    {
+        huge_page_options opts;
+        opts.pages = page_size::standard;
+
+        huge_page_allocator<int>  a(opts);
+        huge_page_allocator<long> b(a);
+        EXPECT_TRUE(a == b);
+        EXPECT_TRUE(a != huge_page_allocator<int>());
+    }
+
+    TEST(HugePageAllocator, FenwickTree)
+    {
+        std::size_t const n = std::size_t(1) << 20;
+
+        huge_page_options opts;
+        opts.pages = page_size::huge_2m;
+        FenwickTree<int, huge_page_allocator<int>> tree(n, huge_page_allocator<int>(opts));
+        for(std::size_t i = 0; i < n; i += 1024)
+            tree.update(i, 1);
+        EXPECT_EQ(tree.query(n), static_cast<int>(n / 1024));
+        EXPECT_EQ(tree.query(4096), 4);
+        tree.update(0, 5);
+        EXPECT_EQ(tree.query(4096), 9);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,207 @@
+#include <test/test_header.h>
+
+#include <qs/containers/fenwick_tree.h>
+#include <qs/memory/object_pool.h>
+
+#include <cstdint>
+#include <list>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    struct PoolOrder
+    {
+        PoolOrder(std::uint64_t id, double px)
+            : id(id),
+              price(px)
+        {}
+
+        std::uint64_t id;
+        double        price;
+        char          pad[40];
+    };
+
+    TEST(SlabAllocator, ReusesFreedBlocks)
+    {
+        slab_allocator slabs(24, 8);
+        EXPECT_EQ(slabs.block_size(), 24u);
+        EXPECT_EQ(slabs.slab_count(), 0u);
+
+        void* a = slabs.allocate();
+        void* b = slabs.allocate();
+        EXPECT_NE(a, b);
+        EXPECT_EQ(slabs.slab_count(), 1u);
+
+        slabs.deallocate(a);
+        EXPECT_EQ(slabs.allocate(), a); // LIFO free list
+        slabs.deallocate(b);
+    }
+
+    TEST(SlabAllocator, GrowsBySlab)
+    {
+        slab_allocator     slabs(64, 64, 4096);
+        std::set<void*>    seen;
+        std::size_t const  n = 3 * slabs.blocks_per_slab() + 1;
+        std::vector<void*> blocks;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            void* p = slabs.allocate();
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+            EXPECT_TRUE(seen.insert(p).second);
+            blocks.push_back(p);
+        }
+        EXPECT_EQ(slabs.slab_count(), 4u);
+        for(void* p: blocks)
+            slabs.deallocate(p);
+        EXPECT_EQ(slabs.slab_count(), 4u);
+    }
+
+    TEST(SlabAllocator, TwoStepGrowth)
+    {
+        slab_allocator slabs(32, 32, 4096);
+        EXPECT_FALSE(slabs.can_allocate());
+        EXPECT_EQ(slabs.try_allocate(), nullptr);
+        EXPECT_EQ(slabs.slab_count(), 0u);
+
+        slabs.add_slab(slabs.allocate_slab());
+        EXPECT_EQ(slabs.slab_count(), 1u);
+        std::vector<void*> blocks;
+        while(slabs.can_allocate())
+            blocks.push_back(slabs.try_allocate());
+        EXPECT_EQ(blocks.size(), slabs.blocks_per_slab());
+        EXPECT_EQ(slabs.try_allocate(), nullptr);
+
+        slabs.free_slab(slabs.allocate_slab()); // unused slabs go back as they came
+        slabs.deallocate(blocks.back());
+        EXPECT_EQ(slabs.try_allocate(), blocks.back());
+        EXPECT_EQ(slabs.slab_count(), 1u);
+    }
+
+    TEST(SlabAllocator, EarlyAddSlabKeepsCurrentBlocks)
+    {
+        slab_allocator slabs(32, 32, 4096);
+        void* const    first = slabs.allocate();
+        slabs.add_slab(slabs.allocate_slab());
+        EXPECT_EQ(slabs.slab_count(), 2u);
+
+        std::set<void*> seen{first};
+        while(slabs.can_allocate())
+            EXPECT_TRUE(seen.insert(slabs.try_allocate()).second);
+        EXPECT_EQ(seen.size(), 2 * slabs.blocks_per_slab());
+    }
+
+    // Refills race: each thread allocates its slab outside the lock, the losers free theirs.
+    TEST(ObjectPool, ConcurrentDirectAllocate)
+    {
+        concurrent_object_pool<PoolOrder>    pool(1024);
+        std::vector<std::vector<PoolOrder*>> owned(4);
+        std::vector<std::thread>             threads;
+        for(int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [&pool, &owned, t]
+                {
+                    for(int i = 0; i < 5000; ++i)
+                    {
+                        PoolOrder* p = pool.allocate();
+                        p->id        = static_cast<std::uint64_t>(t);
+                        owned[static_cast<std::size_t>(t)].push_back(p);
+                    }
+                });
+        }
+        for(auto& th: threads)
+            th.join();
+
+        std::set<PoolOrder*> seen;
+        for(std::size_t t = 0; t < owned.size(); ++t)
+        {
+            for(PoolOrder* p: owned[t])
+            {
+                EXPECT_EQ(p->id, t);
+                EXPECT_TRUE(seen.insert(p).second);
+                pool.deallocate(p);
+            }
+        }
+    }
+
+    TEST(ObjectPool, CreateDestroy)
+    {
+        object_pool<PoolOrder> pool;
+        std::vector<PoolOrder*> orders;
+        for(std::uint64_t i = 0; i < 1000; ++i)
+            orders.push_back(pool.create(i, 1.5 * i));
+        for(std::uint64_t i = 0; i < 1000; ++i)
+        {
+            EXPECT_EQ(orders[i]->id, i);
+            EXPECT_EQ(orders[i]->price, 1.5 * i);
+        }
+        for(auto* o: orders)
+            pool.destroy(o);
+    }
+
+    TEST(ObjectPool, ConcurrentWithLocalCaches)
+    {
+        concurrent_object_pool<PoolOrder> pool;
+        std::vector<std::thread>          threads;
+        for(int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [&pool, t]
+                {
+                    auto                    cache = pool.make_local_cache(16);
+                    std::vector<PoolOrder*> live;
+                    for(int i = 0; i < 10000; ++i)
+                    {
+                        live.push_back(cache.create(static_cast<std::uint64_t>(t), 0.0));
+                        if(i % 3 == 0)
+                        {
+                            EXPECT_EQ(live.back()->id, static_cast<std::uint64_t>(t));
+                            cache.destroy(live.back());
+                            live.pop_back();
+                        }
+                    }
+                    for(auto* o: live)
+                    {
+                        EXPECT_EQ(o->id, static_cast<std::uint64_t>(t));
+                        cache.destroy(o);
+                    }
+                });
+        }
+        for(auto& th: threads)
+            th.join();
+    }
+
+    TEST(PoolAllocator, StandardContainers)
+    {
+        pool_resource resource;
+
+        std::list<int, pool_allocator<int>> lst{pool_allocator<int>(resource)};
+        for(int i = 0; i < 100; ++i)
+            lst.push_back(i);
+        EXPECT_EQ(lst.size(), 100u);
+        EXPECT_EQ(lst.back(), 99);
+
+        std::vector<double, pool_allocator<double>> vec{pool_allocator<double>(resource)};
+        for(int i = 0; i < 1000; ++i) // grows past max_block_size, falls back to operator new
+            vec.push_back(i);
+        EXPECT_EQ(vec[999], 999.0);
+
+        EXPECT_EQ(pool_allocator<int>(resource), pool_allocator<double>(resource));
+    }
+
+    TEST(PoolAllocator, FenwickTree)
+    {
+        pool_resource                           resource;
+        FenwickTree<int, pool_allocator<int>>   tree(8, pool_allocator<int>(resource));
+        for(std::size_t i = 0; i < tree.size(); ++i)
+            tree.update(i, 1);
+        EXPECT_EQ(tree.query(8), 8);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
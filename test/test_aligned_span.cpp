@@ -0,0 +1,111 @@
+#include <test/test_header.h>
+
+#include <qs/aligned_span.h>
+#include <qs/config.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(aligned_span<float, 64>::block_size == 16, "one block per cache line");
+    static_assert(aligned_span<double const, 32>::block_size == 4, "const elements");
+    static_assert(aligned_span<char[3], 4>::block_size == 4, "element size not dividing the alignment");
+
+    struct alignas(64) aligned_buffer
+    {
+        int values[64];
+    };
+
+    TEST(AlignedSpan, Construction)
+    {
+        aligned_buffer buffer{};
+        std::iota(buffer.values, buffer.values + 64, 0);
+
+        aligned_span<int, 64> const s(buffer.values, 64);
+        EXPECT_EQ(s.data(), buffer.values);
+        EXPECT_EQ(s.size(), 64u);
+        EXPECT_EQ(s[10], 10);
+        EXPECT_EQ(s.back(), 63);
+        EXPECT_EQ(std::accumulate(s.begin(), s.end(), 0), 63 * 64 / 2);
+
+        aligned_span<int const, 16> const weaker = s;
+        span<int const> const             plain  = weaker;
+        EXPECT_EQ(plain.data(), buffer.values);
+        EXPECT_EQ(plain.size(), 64u);
+
+        aligned_span<int, 64, 8> const fixed = s.first<8>();
+        EXPECT_EQ(fixed.back(), 7);
+        EXPECT_EQ(s.first(5).size(), 5u);
+        EXPECT_EQ(s.subspan(3, 2)[0], 3);
+        EXPECT_TRUE((aligned_span<int, 64>().empty()));
+
+        EXPECT_TRUE(is_aligned(buffer.values, 64));
+        EXPECT_FALSE(is_aligned(buffer.values + 1, 8));
+        EXPECT_EQ(assume_aligned<64>(buffer.values), buffer.values);
+
+        auto const matcher = testing::HasSubstr("aligned_span: data not aligned to Align bytes");
+        EXPECT_DEBUG_DEATH((aligned_span<int, 64>(buffer.values + 1, 4)), matcher);
+        EXPECT_DEBUG_DEATH((aligned_span<int, 16>(make_span(buffer.values).subspan(2))), matcher);
+        EXPECT_DEBUG_DEATH((void)s[64], testing::HasSubstr("aligned_span::operator[](index): index out of range"));
+    }
+
+    TEST(AlignedSpan, Blocks)
+    {
+        aligned_buffer buffer{};
+        std::iota(buffer.values, buffer.values + 64, 1);
+        for(std::size_t n: {0u, 3u, 16u, 37u, 64u})
+        {
+            aligned_span<int const, 64> const s(buffer.values, n);
+            std::size_t                       visited = 0;
+            long                              sum     = 0;
+            s.for_each_block([&](span<int const, 16> block) {
+                EXPECT_EQ(block.data(), buffer.values + visited);
+                EXPECT_TRUE(is_aligned(block.data(), 64));
+                visited += block.size();
+                sum += std::accumulate(block.begin(), block.end(), 0L);
+            });
+            EXPECT_EQ(visited, n / 16 * 16);
+            EXPECT_EQ(s.tail().data(), buffer.values + visited);
+            EXPECT_EQ(s.tail().size(), n % 16);
+            sum += std::accumulate(s.tail().begin(), s.tail().end(), 0L);
+            EXPECT_EQ(sum, long(n * (n + 1) / 2)) << n;
+        }
+    }
+
+    TEST(AlignedSpan, Split)
+    {
+        aligned_buffer buffer{};
+        for(std::size_t offset = 0; offset < 20; ++offset)
+        {
+            for(std::size_t n: {0u, 1u, 5u, 30u})
+            {
+                auto const [head, body] = split_aligned<32>(span<int>(buffer.values + offset, n));
+                EXPECT_EQ(head.data(), buffer.values + offset);
+                EXPECT_EQ(head.size() + body.size(), n);
+                EXPECT_LT(head.size(), 8u);
+                if(!body.empty())
+                {
+                    EXPECT_EQ(body.data(), head.data() + head.size());
+                    EXPECT_TRUE(is_aligned(body.data(), 32));
+                }
+            }
+        }
+
+        // elements of 3 bytes: the fourth byte starts the aligned part, the third one never does
+        using triple    = char[3];
+        char* const raw = reinterpret_cast<char*>(buffer.values);
+        auto const  one = split_aligned<4>(span<triple>(reinterpret_cast<triple*>(raw + 1), 8));
+        EXPECT_EQ(one.first.size(), 1u);
+        EXPECT_EQ(one.second.size(), 7u);
+        auto const none = split_aligned<4>(span<triple>(reinterpret_cast<triple*>(raw + 2), 8));
+        EXPECT_EQ(none.first.size(), 8u);
+        EXPECT_TRUE(none.second.empty());
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -0,0 +1,112 @@
+#include <test/test_header.h>
+
+#include <qs/chunks.h>
+#include <qs/config.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    static_assert(std::is_same<decltype(*chunks<4>(span<int>()).begin()), span<int, 4>>::value, "static extent");
+    static_assert(std::is_same<decltype(chunks(span<int const>(), 3)[0]), span<int const>>::value, "dynamic");
+
+    TEST(Chunks, StaticExtent)
+    {
+        std::vector<int> values(23);
+        std::iota(values.begin(), values.end(), 0);
+
+        auto const view = chunks<5>(make_span(values));
+        EXPECT_EQ(view.size(), 4u);
+        int expected = 0;
+        for(span<int, 5> chunk: view)
+        {
+            for(int x: chunk)
+                EXPECT_EQ(x, expected++);
+        }
+        EXPECT_EQ(expected, 20);
+        EXPECT_THAT(view.tail(), testing::ElementsAre(20, 21, 22));
+        EXPECT_EQ(view[3].data(), values.data() + 15);
+        EXPECT_EQ(view.end() - view.begin(), 4);
+        EXPECT_EQ((*(view.begin() + 2)).size(), 5u);
+    }
+
+    TEST(Chunks, Dynamic)
+    {
+        std::vector<int> values(10);
+        std::iota(values.begin(), values.end(), 0);
+
+        std::vector<std::vector<int>> pieces;
+        for(span<int> chunk: chunks(make_span(values), 4))
+            pieces.emplace_back(chunk.begin(), chunk.end());
+        EXPECT_THAT(pieces, testing::ElementsAre(testing::ElementsAre(0, 1, 2, 3), testing::ElementsAre(4, 5, 6, 7),
+                                                 testing::ElementsAre(8, 9)));
+
+        EXPECT_EQ(chunks(make_span(values), 5).size(), 2u);
+        EXPECT_EQ(chunks(make_span(values), 11).size(), 1u);
+        for(std::size_t n: {std::size_t(11), std::numeric_limits<std::size_t>::max() / 2 + 1,
+                            std::numeric_limits<std::size_t>::max()})
+        {
+            auto const view = chunks(make_span(values), n);
+            ASSERT_EQ(view.size(), 1u);
+            EXPECT_EQ(view[0].data(), values.data());
+            EXPECT_EQ(view[0].size(), values.size());
+            EXPECT_EQ(std::distance(view.begin(), view.end()), 1);
+        }
+        EXPECT_TRUE(chunks(span<int>(), 3).empty());
+        EXPECT_DEBUG_DEATH((void)chunks(make_span(values), 0), testing::HasSubstr("chunks(span, n): zero chunk size"));
+    }
+
+    TEST(Chunks, SplitEven)
+    {
+        std::vector<int> values(50);
+        for(std::size_t n = 0; n <= values.size(); ++n)
+        {
+            for(std::size_t parts = 1; parts <= 12; ++parts)
+            {
+                auto const  view = split_even(span<int>(values.data(), n), parts);
+                std::size_t next = 0, smallest = n, largest = 0;
+                ASSERT_EQ(view.size(), parts);
+                for(span<int> part: view)
+                {
+                    ASSERT_EQ(part.data(), values.data() + next); // consecutive and covering
+                    next += part.size();
+                    smallest = std::min(smallest, part.size());
+                    largest  = std::max(largest, part.size());
+                }
+                ASSERT_EQ(next, n);
+                ASSERT_LE(largest - smallest, 1u) << n << " / " << parts;
+                ASSERT_TRUE(std::is_sorted(view.begin(), view.end(), [](span<int> a, span<int> b) {
+                    return a.size() > b.size(); // larger parts first
+                }));
+            }
+        }
+        EXPECT_DEBUG_DEATH((void)split_even(make_span(values), 0),
+                           testing::HasSubstr("split_even(span, parts): zero parts"));
+    }
+
+    TEST(Chunks, IteratorArithmetic)
+    {
+        std::vector<int> values(12);
+        auto const       view  = chunks(make_span(values), 3);
+        auto             first = view.begin();
+        auto const       last  = view.end();
+        EXPECT_EQ(std::distance(first, last), 4);
+        EXPECT_EQ(first[2].data(), values.data() + 6);
+        EXPECT_EQ(last[-1].data(), values.data() + 9);
+        EXPECT_TRUE(first < last && last > first && first <= first && last >= first);
+        ++first;
+        first += 2;
+        EXPECT_EQ((*first).data(), values.data() + 9);
+        EXPECT_EQ((*std::reverse_iterator<decltype(first)>(last)).size(), 3u);
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -14,6 +14,7 @@
 #define QS_FRIEND_TEST(test_case_name, test_name) friend class ::qs::tests::test_case_name##_##test_name##_Test;
 
 #include <gmock/gmock.h>
+#include <qs/utils/cpu_features.h>
 
 #define EXPECT_STDOUT_EQ(expression, expected)                                                                         \
     do                                                                                                                 \
@@ -29,6 +30,28 @@
     }                                                                                                                  \
     while(0);
 
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    // Fixture for the dispatched kernels: each test runs once per `simd_level` parameter, and the levels this CPU
+    // does not support are skipped.
+    class simd_level_test : public ::testing::TestWithParam<simd_level>
+    {
+    protected:
+        void SetUp() override
+        {
+            if(GetParam() > detected_simd_level())
+                GTEST_SKIP() << "instruction set not supported by this CPU";
+            limit_simd_level(GetParam());
+        }
+
+        void TearDown() override { limit_simd_level(simd_level::avx512); }
+    };
+} // namespace test
+
+QS_NAMESPACE_END
+
 #else
 
 #define QS_FRIEND_TEST(...)
@@ -0,0 +1,167 @@
+#include <test/test_header.h>
+
+#include <qs/config.h>
+#include <qs/mdspan.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+QS_NAMESPACE_BEGIN
+
+namespace test
+{
+    using extents_3x5 = extents<int, 3, 5>;
+    using extents_3xn = extents<int, 3, dynamic_extent>;
+
+    static_assert(extents_3xn::rank() == 2 && extents_3xn::rank_dynamic() == 1, "rank");
+    static_assert(extents_3xn::static_extent(0) == 3 && extents_3xn::static_extent(1) == dynamic_extent, "static");
+    static_assert(extents_3xn(7).extent(1) == 7, "dynamic extent");
+    static_assert(std::is_same<dextents<int, 2>, extents<int, dynamic_extent, dynamic_extent>>::value, "dextents");
+    static_assert(std::is_empty<extents_3x5>::value || sizeof(extents_3x5) <= sizeof(int), "static extents stored");
+    static_assert(sizeof(mdspan<float, dextents<int, 2>>) == sizeof(float*) + 2 * sizeof(int), "mdspan size");
+
+    static_assert(layout_right::mapping<extents_3x5>()(2, 4) == 14, "row-major offset");
+    static_assert(layout_left::mapping<extents_3x5>()(2, 4) == 14, "column-major offset");
+    static_assert(layout_right::mapping<extents_3x5>().stride(0) == 5, "row-major stride");
+    static_assert(layout_left::mapping<extents_3x5>().stride(1) == 3, "column-major stride");
+
+    TEST(Extents, Construction)
+    {
+        extents<int, 2, dynamic_extent, 4, dynamic_extent> e(3, 5);
+        EXPECT_EQ(e.extent(0), 2);
+        EXPECT_EQ(e.extent(1), 3);
+        EXPECT_EQ(e.extent(2), 4);
+        EXPECT_EQ(e.extent(3), 5);
+        EXPECT_EQ(e, (extents<int, 2, dynamic_extent, 4, dynamic_extent>(2, 3, 4, 5))); // all extents
+        EXPECT_EQ(e, (extents<int, 2, dynamic_extent, 4, dynamic_extent>(std::array<long, 2>{3, 5})));
+
+        dextents<size_t, 4> const d(e); // static to dynamic
+        for(size_t r = 0; r < 4; ++r)
+            EXPECT_EQ(d.extent(r), size_t(e.extent(r)));
+
+        EXPECT_DEBUG_DEATH(extents_3xn(4, 7), testing::HasSubstr("extents: static extent mismatch"));
+    }
+
+    // Offsets of every index against the textbook formulas, and the strides matching them.
+    TEST(Layout, RightAndLeft)
+    {
+        dextents<int, 3> const                        e(3, 4, 5);
+        layout_right::mapping<dextents<int, 3>> const right(e);
+        layout_left::mapping<dextents<int, 3>> const  left(e);
+        EXPECT_EQ(right.required_span_size(), 60);
+        EXPECT_EQ(left.required_span_size(), 60);
+        for(int i = 0; i < 3; ++i)
+            for(int j = 0; j < 4; ++j)
+                for(int k = 0; k < 5; ++k)
+                {
+                    ASSERT_EQ(right(i, j, k), (i * 4 + j) * 5 + k);
+                    ASSERT_EQ(right(i, j, k), i * right.stride(0) + j * right.stride(1) + k * right.stride(2));
+                    ASSERT_EQ(left(i, j, k), i + 3 * (j + 4 * k));
+                    ASSERT_EQ(left(i, j, k), i * left.stride(0) + j * left.stride(1) + k * left.stride(2));
+                }
+    }
+
+    TEST(Layout, Stride)
+    {
+        using ext = dextents<int, 2>;
+        layout_stride::mapping<ext> const from_right(layout_right::mapping<ext>(ext(3, 4)));
+        EXPECT_EQ(from_right.strides(), (std::array<int, 2>{4, 1}));
+        EXPECT_TRUE(from_right.is_exhaustive());
+
+        // every other column of a 3 x 8 row-major matrix
+        layout_stride::mapping<ext> const m(ext(3, 4), std::array<int, 2>{8, 2});
+        EXPECT_EQ(m(2, 3), 22);
+        EXPECT_EQ(m.required_span_size(), 23);
+        EXPECT_FALSE(m.is_exhaustive());
+        EXPECT_EQ(layout_stride::mapping<ext>(ext(0, 4), std::array<int, 2>{8, 2}).required_span_size(), 0);
+    }
+
+    TEST(Mdspan, Access)
+    {
+        std::vector<int> buffer(12);
+        std::iota(buffer.begin(), buffer.end(), 0);
+
+        mdspan m(buffer.data(), 3, 4); // deduced as dynamic extents, row-major
+        static_assert(std::is_same<decltype(m), mdspan<int, dextents<size_t, 2>>>::value, "deduction guide");
+        EXPECT_EQ(m.size(), 12u);
+        EXPECT_EQ(m.extent(0), 3u);
+        EXPECT_EQ(m(1, 2), 6);
+        m(2, 3) = -1;
+        EXPECT_EQ(buffer[11], -1);
+
+        mdspan<int const, extents<int, 4, 3>, layout_left> const transposed(buffer.data());
+        for(int i = 0; i < 3; ++i)
+            for(int j = 0; j < 4; ++j)
+                EXPECT_EQ(transposed(j, i), m(i, j));
+
+        mdspan<int const, dextents<size_t, 2>> const c = m; // adding const
+        EXPECT_EQ(c(1, 1), 5);
+
+        using ext = dextents<int, 2>;
+        mdspan s(buffer.data(), layout_stride::mapping<ext>(ext(2, 2), std::array<int, 2>{8, 2}));
+        static_assert(std::is_same<decltype(s)::layout_type, layout_stride>::value, "deduction guide");
+        EXPECT_EQ(s(1, 1), 10);
+
+        EXPECT_DEBUG_DEATH((void)m(3, 0), testing::HasSubstr("mdspan::operator(): index out of range"));
+        EXPECT_DEBUG_DEATH((void)transposed(0, -1), testing::HasSubstr("mdspan::operator(): index out of range"));
+    }
+
+    TEST(Mdspan, RowsAndColumns)
+    {
+        std::vector<int> buffer(12);
+        std::iota(buffer.begin(), buffer.end(), 0);
+        mdspan<int, dextents<int, 2>> const m(buffer.data(), 3, 4);
+
+        strided_span<int> const r = row(m, 1);
+        EXPECT_EQ(r.stride(), 1);
+        EXPECT_THAT(r, testing::ElementsAre(4, 5, 6, 7));
+        strided_span<int> const c = column(m, 2);
+        EXPECT_EQ(c.stride(), 4);
+        EXPECT_THAT(c, testing::ElementsAre(2, 6, 10));
+
+        mdspan<int, dextents<int, 2>, layout_left> const l(buffer.data(), 4, 3);
+        EXPECT_THAT(column(l, 1), testing::ElementsAre(4, 5, 6, 7));
+        EXPECT_THAT(row(l, 1), testing::ElementsAre(1, 5, 9));
+    }
+
+    TEST(StridedSpan, Iteration)
+    {
+        std::vector<int> values(10);
+        std::iota(values.begin(), values.end(), 0);
+
+        strided_span<int> const evens(values.data(), 5, 2);
+        EXPECT_THAT(evens, testing::ElementsAre(0, 2, 4, 6, 8));
+        EXPECT_EQ(evens.end() - evens.begin(), 5);
+        EXPECT_EQ(evens.begin()[3], 6);
+        EXPECT_EQ(evens[4], 8);
+        EXPECT_EQ(evens.back(), 8);
+        EXPECT_EQ(std::accumulate(evens.begin(), evens.end(), 0), 20);
+        EXPECT_TRUE(std::is_sorted(evens.begin(), evens.end()));
+        EXPECT_THAT(std::vector<int>(evens.rbegin(), evens.rend()), testing::ElementsAre(8, 6, 4, 2, 0));
+
+        EXPECT_THAT(evens.reversed(), testing::ElementsAre(8, 6, 4, 2, 0));
+        EXPECT_THAT(evens.subspan(1, 3), testing::ElementsAre(2, 4, 6));
+        EXPECT_THAT(evens.every(2), testing::ElementsAre(0, 4, 8));
+        EXPECT_THAT(strided_span(make_span(values)).every(3), testing::ElementsAre(0, 3, 6, 9));
+        // steps past the size leave the first element, without wrapping `size + step - 1`
+        EXPECT_THAT(evens.every(5), testing::ElementsAre(0));
+        EXPECT_THAT(evens.every(6), testing::ElementsAre(0));
+        EXPECT_THAT(evens.every(std::numeric_limits<std::size_t>::max()), testing::ElementsAre(0));
+        EXPECT_TRUE(strided_span<int>().every(std::numeric_limits<std::size_t>::max()).empty());
+
+        // sorting through the view only permutes the viewed elements
+        strided_span<int> const odds(values.data() + 1, 5, 2);
+        std::sort(odds.rbegin(), odds.rend());
+        EXPECT_THAT(values, testing::ElementsAre(0, 9, 2, 7, 4, 5, 6, 3, 8, 1));
+
+        strided_span<int const> const constant = odds;
+        EXPECT_EQ(constant.front(), 9);
+        EXPECT_TRUE(strided_span<int>().empty());
+        EXPECT_DEBUG_DEATH((void)evens[5], testing::HasSubstr("strided_span::operator[](index): index out of range"));
+    }
+} // namespace test
+
+QS_NAMESPACE_END
@@ -4,6 +4,9 @@
 #include <qs/config.h>
 #include <qs/span.h>
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <deque>
 #include <vector>
 
@@ -205,6 +208,84 @@ namespace test
         EXPECT_THAT(sd, testing::Pointwise(testing::Eq(), {1, 2, 3, 4, 5}));
     }
 
+    TEST(Span, AsBytes)
+    {
+        std::uint32_t values[] = {0x01020304, 0x05060708};
+
+        span<byte const, 8> const bytes = as_bytes(make_span(values));
+        EXPECT_EQ(bytes.data(), reinterpret_cast<byte const*>(values));
+
+        span<byte, 8> const writable = as_writable_bytes(make_span(values));
+        std::memset(writable.data(), 0xff, 4);
+        EXPECT_EQ(values[0], 0xffffffff);
+        EXPECT_EQ(values[1], 0x05060708u);
+    }
+
+    TEST(Span, SpanCast)
+    {
+        struct record
+        {
+            std::uint32_t id;
+            std::uint16_t port;
+            std::uint16_t flags;
+        };
+
+        alignas(record) byte buffer[3 * sizeof(record)] = {};
+        record const     source[3]                       = {{1, 80, 0}, {2, 443, 1}, {3, 8080, 2}};
+        std::memcpy(buffer, source, sizeof(source));
+
+        span<record, 3> const records = span_cast<record>(make_span(buffer));
+        EXPECT_EQ(static_cast<void*>(records.data()), static_cast<void*>(buffer));
+        EXPECT_EQ(records[1].port, 443);
+        records[2].flags = 7;
+
+        span<record const> const view = span_cast<record const>(span<byte const>(buffer, sizeof(buffer)));
+        EXPECT_EQ(view.size(), 3u);
+        EXPECT_EQ(view[2].id, 3u);
+        EXPECT_EQ(view[2].flags, 7);
+
+        // Back and forth through bytes.
+        EXPECT_EQ(span_cast<record const>(as_bytes(view)).data(), view.data());
+
+        // Not a whole number of records, and misaligned.
+        span<byte> const bytes(buffer, sizeof(buffer));
+        EXPECT_DEBUG_DEATH((void)span_cast<record>(bytes.first(sizeof(record) + 1)),
+                           testing::HasSubstr("span_cast<U>(bytes): size not a multiple of sizeof(U)"));
+        EXPECT_DEBUG_DEATH((void)span_cast<record>(bytes.subspan(2, sizeof(record))),
+                           testing::HasSubstr("span_cast<U>(bytes): bytes not aligned for U"));
+    }
+
+    // A span of any extent converts implicitly to a dynamic-extent span of a compatible element type, as
+    // [span.cons] specifies; dynamic to static stays explicit, and constness is never dropped.
+    static_assert(std::is_convertible<span<int>, span<int const>>::value, "adds const");
+    static_assert(std::is_convertible<span<int, 4>, span<int>>::value, "static to dynamic");
+    static_assert(std::is_convertible<span<int, 4>, span<int const>>::value, "static to dynamic, adds const");
+    static_assert(std::is_convertible<span<int, 4>, span<int const, 4>>::value, "same extent, adds const");
+    static_assert(!std::is_convertible<span<int>, span<int, 4>>::value, "dynamic to static is explicit");
+    static_assert(std::is_constructible<span<int, 4>, span<int>>::value, "dynamic to static is explicit");
+    static_assert(!std::is_constructible<span<int>, span<int const>>::value, "drops const");
+    static_assert(!std::is_constructible<span<int const>, span<long>>::value, "other element type");
+    static_assert(!std::is_constructible<span<int const>, span<unsigned>>::value, "other element type");
+
+    static std::size_t count_const(span<int const> s) { return s.size(); }
+
+    TEST(Span, ImplicitConversionToDynamic)
+    {
+        int          values[] = {1, 2, 3, 4};
+        span<int, 4> fixed    = make_span(values);
+        span<int>    dynamic  = fixed;
+        EXPECT_EQ(dynamic.data(), values);
+        EXPECT_EQ(dynamic.size(), 4u);
+
+        EXPECT_EQ(count_const(dynamic), 4u);
+        EXPECT_EQ(count_const(fixed), 4u);
+        EXPECT_EQ(count_const(dynamic.first(2)), 2u);
+
+        span<int const> const view = dynamic;
+        EXPECT_EQ(view.data(), values);
+        EXPECT_THAT(view, testing::ElementsAre(1, 2, 3, 4));
+    }
+
 } // namespace test
 
 QS_NAMESPACE_END